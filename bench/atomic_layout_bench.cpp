@@ -0,0 +1,120 @@
+// Compares updating a tagged pointer (64-bit pointer, 48-bit version, 16 bits of flags) as one 128-bit layout with a
+// double-width compare-and-swap against splitting it into two 64-bit atomics, one for the pointer and one for the
+// version and flags. The split version needs two compare-and-swaps per update and cannot change both words at once.
+// The 128-bit layout designates its version with BIT_FIELD_VERSION, so atomic_layout increments it on every update.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+
+#include "bench.hpp"
+
+struct tagged_pointer : bf::bit_field_builder<tagged_pointer, bf::uint128_t> {
+    BIT_FIELD(pointer, 64, bf::bit_field_config<std::uint64_t>{});
+    BIT_FIELD(flags,   16, bf::bit_field_config<std::uint16_t>{});
+    BIT_FIELD_VERSION(version, 48, bf::bit_field_config<std::uint64_t>{});
+};
+
+struct version_flags : bf::bit_field_builder<version_flags, std::uint64_t> {
+    BIT_FIELD(version, 48);
+    BIT_FIELD(flags,   16);
+};
+
+struct split_pointer {
+    alignas(64) std::atomic<std::uint64_t> pointer{0};
+    std::atomic<std::uint64_t> tag{0};
+};
+
+// Replace the pointer and bump the version.
+void update(bf::atomic_layout<tagged_pointer>& word, const std::uint64_t pointer) {
+    word.set<tagged_pointer::pointer>(pointer);
+}
+
+void update(split_pointer& word, const std::uint64_t pointer) {
+    std::uint64_t expected = word.pointer.load(std::memory_order_relaxed);
+    while (!word.pointer.compare_exchange_weak(expected, pointer)) {
+    }
+    std::uint64_t tag = word.tag.load(std::memory_order_relaxed);
+    version_flags next{};
+    do {
+        next.raw_value = tag;
+        next.set_version(next.get_version() + 1);
+    } while (!word.tag.compare_exchange_weak(tag, next.raw_value));
+}
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 22;
+
+    std::printf("128-bit atomic layout is always lock free: %s\n",
+                bf::atomic_layout<tagged_pointer>::is_always_lock_free ? "yes" : "no");
+
+    alignas(64) bf::atomic_layout<tagged_pointer> wide;
+    split_pointer split;
+
+    bench::measure("128-bit load", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(wide.load().get_version());
+        }
+    });
+    bench::measure("64-bit split load (two loads, not a snapshot)", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(split.pointer.load() + split.tag.load());
+        }
+    });
+
+    bench::measure("128-bit modify (one DWCAS)", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            update(wide, i);
+        }
+    });
+    bench::measure("64-bit split modify (two CAS)", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            update(split, i);
+        }
+    });
+
+    bench::measure("128-bit optimistic read", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint64_t version = 0;
+            std::uint64_t pointer = 0;
+            do {
+                version = wide.read_begin();
+                pointer = wide.get<tagged_pointer::pointer>(std::memory_order_relaxed);
+            } while (!wide.validate(version));
+            bench::do_not_optimize(pointer);
+        }
+    });
+
+    bench::measure("128-bit set of two fields", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            wide.set<tagged_pointer::pointer, tagged_pointer::flags>(i, static_cast<std::uint16_t>(i));
+        }
+    });
+
+    for (const std::size_t threads : { 2, 4, 8 }) {
+        constexpr std::size_t per_thread = std::size_t{1} << 18;
+        char name[64];
+
+        const std::uint64_t start = wide.load().get_version();
+        std::snprintf(name, sizeof(name), "128-bit modify, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](const std::size_t thread) {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                update(wide, thread);
+            }
+        });
+        if (wide.load().get_version() - start != threads * per_thread * 5) {
+            std::printf("lost updates: version %llu\n", static_cast<unsigned long long>(wide.load().get_version()));
+            return 1;
+        }
+
+        std::snprintf(name, sizeof(name), "64-bit split modify, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](const std::size_t thread) {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                update(split, thread);
+            }
+        });
+    }
+}
@@ -0,0 +1,94 @@
+// Minimal timing helpers shared by the benchmarks. Each benchmark is a standalone program printing one line per
+// measurement, so results can be compared across machines and compilers without any third-party framework.
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+/// Prevent the compiler from optimizing away the computation of a value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Prevent the compiler from assuming anything about the contents of memory.
+inline void clobber() {
+    asm volatile("" : : : "memory");
+}
+
+/// Time a function several times and report the fastest run.
+///
+/// @param name       The name of the measurement.
+/// @param operations The number of operations one call of the function performs.
+/// @param function   The function to time.
+///
+/// @returns The fastest observed time per operation, in nanoseconds.
+template <typename TFunction>
+double measure(const char* name, const std::size_t operations, TFunction&& function) {
+    constexpr int runs = 7;
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        clobber();
+        const auto stop = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+        best = std::min(best, elapsed / static_cast<double>(operations));
+    }
+    std::printf("%-48s %10.3f ns/op %12.1f Mop/s\n", name, best, 1e3 / best);
+    return best;
+}
+
+/// Time a function running on several threads at once and report the fastest run. Threads start together, and a run
+/// lasts until the last thread finishes.
+///
+/// @param name       The name of the measurement.
+/// @param threads    The number of threads.
+/// @param operations The number of operations one call of the function performs.
+/// @param function   The function to time. Called once per thread per run, with the thread index.
+///
+/// @returns The fastest observed time per operation across all threads, in nanoseconds.
+template <typename TFunction>
+double measure_threads(const char* name, const std::size_t threads, const std::size_t operations,
+                       TFunction&& function) {
+    constexpr int runs = 5;
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; ++run) {
+        std::atomic<std::size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (std::size_t thread = 0; thread < threads; ++thread) {
+            workers.emplace_back([&, thread] {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                function(thread);
+            });
+        }
+        while (ready.load() != threads) {
+        }
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        const auto stop = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double, std::nano>(stop - start).count();
+        best = std::min(best, elapsed / static_cast<double>(operations * threads));
+    }
+    std::printf("%-48s %10.3f ns/op %12.1f Mop/s\n", name, best, 1e3 / best);
+    return best;
+}
+
+} // End namespace bench.
+
+#endif // BENCH_HPP
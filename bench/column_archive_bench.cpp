@@ -0,0 +1,105 @@
+// Compares a one-field query over an archive of packed records stored row by row, where every byte of every record is
+// read, against the same query over a column archive mapped from a file with mmap, where only the pages of the queried
+// column are read and decoded. The rows are already in memory, so they win on time here; the column archive wins on the
+// number of bytes a query has to bring in from storage, which is printed first.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "column_archive.hpp"
+
+#include "bench.hpp"
+
+struct trade : bf::bit_field_builder<trade, std::uint64_t> {
+    BIT_FIELD(price,  24);
+    BIT_FIELD(side,    1);
+    BIT_FIELD(venue,   7);
+    BIT_FIELD(volume, 32);
+};
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 22;
+
+    std::vector<trade> trades(count);
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    for (std::size_t i = 0; i < count; ++i) {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        trades[i].set_price(static_cast<std::uint32_t>(100'000 + (state >> 40) % 5'000));
+        trades[i].set_side((state >> 20 & 1) != 0);
+        trades[i].set_venue(static_cast<std::uint8_t>(i / 100'000 % 4));
+        trades[i].set_volume(static_cast<std::uint32_t>(state >> 32));
+    }
+
+    const std::vector<std::byte> bytes = bf::write_column_archive<trade>(trades);
+    const char* const path = "/tmp/bit_field_column_archive_bench";
+    const int descriptor = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (descriptor < 0 || ::write(descriptor, bytes.data(), bytes.size()) != static_cast<ssize_t>(bytes.size())) {
+        std::printf("could not write %s\n", path);
+        return 1;
+    }
+    void* const mapping = ::mmap(nullptr, bytes.size(), PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    ::unlink(path);
+    if (mapping == MAP_FAILED) {
+        return 1;
+    }
+    const std::span<const std::byte> file{ static_cast<const std::byte*>(mapping), bytes.size() };
+    const std::optional<bf::column_archive<trade>> archive = bf::column_archive<trade>::open(file);
+    if (!archive) {
+        return 1;
+    }
+
+    std::printf("row archive %zu bytes, column archive %zu bytes, side column %zu bytes, price column %zu bytes\n",
+                count * sizeof(trade), bytes.size(), archive->column_bytes<trade::side>(),
+                archive->column_bytes<trade::price>());
+
+    bench::measure("rows: count sells", count, [&] {
+        std::uint64_t sells = 0;
+        for (const trade& record : trades) {
+            sells += record.get_side();
+        }
+        bench::do_not_optimize(sells);
+    });
+    bench::measure("columns: count sells", count, [&] {
+        std::uint64_t sells = 0;
+        archive->scan<trade::side>([&](std::size_t, const std::span<const std::uint64_t> values) {
+            for (const std::uint64_t side : values) {
+                sells += side;
+            }
+        });
+        bench::do_not_optimize(sells);
+    });
+
+    bench::measure("rows: sum prices", count, [&] {
+        std::uint64_t sum = 0;
+        for (const trade& record : trades) {
+            sum += record.get_price();
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::measure("columns: sum prices", count, [&] {
+        std::uint64_t sum = 0;
+        archive->scan<trade::price>([&](std::size_t, const std::span<const std::uint64_t> values) {
+            for (const std::uint64_t price : values) {
+                sum += price;
+            }
+        });
+        bench::do_not_optimize(sum);
+    });
+
+    std::vector<trade> rebuilt(count);
+    bench::measure("columns: rebuild whole records", count, [&] {
+        archive->read_records(0, rebuilt);
+        bench::clobber();
+    });
+
+    ::munmap(mapping, bytes.size());
+}
@@ -0,0 +1,176 @@
+// Measures cuckoo filters of 2^18 buckets of four 8-bit, five 12-bit, or four 16-bit slots, filled to 95%: inserting,
+// looking up keys which were added and keys which were not, and the bits each key takes and the false positive rate.
+// A plain Bloom filter with the same false positive rate is measured for comparison.
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "cuckoo_filter.hpp"
+
+#include "bench.hpp"
+
+struct bucket_4x8 : bf::bit_field_builder<bucket_4x8, std::uint32_t> {
+    BIT_FIELD(slot0, 8);
+    BIT_FIELD(slot1, 8);
+    BIT_FIELD(slot2, 8);
+    BIT_FIELD(slot3, 8);
+};
+
+struct bucket_5x12 : bf::bit_field_builder<bucket_5x12, std::uint64_t> {
+    BIT_FIELD(slot0, 12);
+    BIT_FIELD(slot1, 12);
+    BIT_FIELD(slot2, 12);
+    BIT_FIELD(slot3, 12);
+    BIT_FIELD(slot4, 12);
+};
+
+struct bucket_4x16 : bf::bit_field_builder<bucket_4x16, std::uint64_t> {
+    BIT_FIELD(slot0, 16);
+    BIT_FIELD(slot1, 16);
+    BIT_FIELD(slot2, 16);
+    BIT_FIELD(slot3, 16);
+};
+
+namespace {
+
+constexpr std::size_t bucket_count = std::size_t{1} << 18;
+
+/// A Bloom filter with the optimal number of hashes for its size, derived from one 64-bit hash by double hashing.
+class bloom_filter {
+public:
+    bloom_filter(const std::size_t keys, const double false_positive_rate)
+        : bits_(static_cast<std::size_t>(std::ceil(-static_cast<double>(keys) * std::log(false_positive_rate) /
+                                                   (std::log(2.0) * std::log(2.0))))),
+          hashes_(static_cast<unsigned>(std::lround(std::log2(1.0 / false_positive_rate)))),
+          words_((bits_ + 63) / 64, 0) {}
+
+    void insert(const std::uint64_t key) {
+        const std::uint64_t hash = bf::detail::cuckoo_mix(key);
+        for (unsigned i = 0; i < hashes_; ++i) {
+            const std::size_t bit = index(hash, i);
+            words_[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    bool contains(const std::uint64_t key) const {
+        const std::uint64_t hash = bf::detail::cuckoo_mix(key);
+        for (unsigned i = 0; i < hashes_; ++i) {
+            const std::size_t bit = index(hash, i);
+            if ((words_[bit / 64] >> (bit % 64) & 1) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t memory_size() const {
+        return words_.size() * sizeof(std::uint64_t);
+    }
+
+private:
+    std::size_t index(const std::uint64_t hash, const unsigned i) const {
+        const std::uint64_t combined = (hash >> 32) + i * (hash & 0xFFFF'FFFFu);
+        return static_cast<std::size_t>(combined % bits_);
+    }
+
+    std::size_t bits_;
+    unsigned hashes_;
+    std::vector<std::uint64_t> words_;
+};
+
+/// Keys added, and keys never added.
+struct key_sets {
+    std::vector<std::uint64_t> present;
+    std::vector<std::uint64_t> absent;
+};
+
+key_sets make_keys(const std::size_t key_count) {
+    key_sets result{ std::vector<std::uint64_t>(key_count), std::vector<std::uint64_t>(key_count) };
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    for (std::size_t i = 0; i < key_count; ++i) {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        // Odd keys are added and even keys are not, so the two sets never overlap.
+        result.present[i] = state | 1;
+        result.absent[i] = state & ~std::uint64_t{1};
+    }
+    return result;
+}
+
+template <typename TBucket>
+void run(const char* const name) {
+    using filter_type = bf::cuckoo_filter<TBucket>;
+    const std::size_t key_count = bucket_count * filter_type::slots_per_bucket * 95 / 100;
+    const key_sets keys = make_keys(key_count);
+    char label[96];
+    filter_type filter;
+    std::snprintf(label, sizeof(label), "%s, insert", name);
+    bench::measure(label, key_count, [&] {
+        filter = filter_type{ key_count };
+        for (const std::uint64_t key : keys.present) {
+            filter.insert(key);
+        }
+    });
+
+    std::size_t missing = 0;
+    std::size_t false_positives = 0;
+    for (std::size_t i = 0; i < key_count; ++i) {
+        missing += filter.contains(keys.present[i]) ? 0 : 1;
+        false_positives += filter.contains(keys.absent[i]) ? 1 : 0;
+    }
+    const double rate = static_cast<double>(false_positives) / static_cast<double>(key_count);
+    std::printf("%s: %.2f bits per key, %.3f%% false positives, %.1f%% full, %zu missing\n", name,
+                8.0 * static_cast<double>(filter.memory_size()) / static_cast<double>(key_count), 100.0 * rate,
+                100.0 * static_cast<double>(filter.size()) / static_cast<double>(filter.slot_count()), missing);
+
+    std::snprintf(label, sizeof(label), "%s, lookup present", name);
+    bench::measure(label, key_count, [&] {
+        std::size_t found = 0;
+        for (const std::uint64_t key : keys.present) {
+            found += filter.contains(key) ? 1 : 0;
+        }
+        bench::do_not_optimize(found);
+    });
+    std::snprintf(label, sizeof(label), "%s, lookup absent", name);
+    bench::measure(label, key_count, [&] {
+        std::size_t found = 0;
+        for (const std::uint64_t key : keys.absent) {
+            found += filter.contains(key) ? 1 : 0;
+        }
+        bench::do_not_optimize(found);
+    });
+
+    bloom_filter bloom{ key_count, rate };
+    for (const std::uint64_t key : keys.present) {
+        bloom.insert(key);
+    }
+    std::printf("%s: Bloom filter with the same false positive rate takes %.2f bits per key\n", name,
+                8.0 * static_cast<double>(bloom.memory_size()) / static_cast<double>(key_count));
+    std::snprintf(label, sizeof(label), "%s, Bloom lookup present", name);
+    bench::measure(label, key_count, [&] {
+        std::size_t found = 0;
+        for (const std::uint64_t key : keys.present) {
+            found += bloom.contains(key) ? 1 : 0;
+        }
+        bench::do_not_optimize(found);
+    });
+    std::snprintf(label, sizeof(label), "%s, Bloom lookup absent", name);
+    bench::measure(label, key_count, [&] {
+        std::size_t found = 0;
+        for (const std::uint64_t key : keys.absent) {
+            found += bloom.contains(key) ? 1 : 0;
+        }
+        bench::do_not_optimize(found);
+    });
+}
+
+} // namespace
+
+int main() {
+    run<bucket_4x8>("4 x 8-bit slots");
+    run<bucket_5x12>("5 x 12-bit slots");
+    run<bucket_4x16>("4 x 16-bit slots");
+    return 0;
+}
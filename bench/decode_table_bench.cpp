@@ -0,0 +1,111 @@
+// Compares decoding narrow layouts field by field with shifts and masks against a single load from a decode_table, for
+// an 8-bit layout of three fields and for a 16-bit layout of enum fields and a signed, scaled reading. The 16-bit table
+// is 512 KiB, so it is measured with raw values spread over the whole table and with a few hot values.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "decode_table.hpp"
+
+#include "bench.hpp"
+
+struct control : bf::bit_field_builder<control, std::uint8_t> {
+    enum class channel_type : std::uint8_t { process, page, diagnosis, isdu };
+    enum class direction_type : std::uint8_t { write, read };
+
+    BIT_FIELD(address,   5, bf::bit_field_config<std::uint8_t>{});
+    BIT_FIELD(channel,   2, bf::bit_field_config<channel_type>{});
+    BIT_FIELD(direction, 1, bf::bit_field_config<direction_type>{});
+};
+
+struct decoded_control {
+    std::uint8_t address;
+    control::channel_type channel;
+    control::direction_type direction;
+};
+
+constexpr decoded_control decode_control(const control& layout) {
+    return { layout.get_address(), layout.get_channel(), layout.get_direction() };
+}
+
+struct sample : bf::bit_field_builder<sample, std::uint16_t> {
+    enum class mode_type : std::uint8_t { off, idle, run, fault };
+    enum class unit_type : std::uint8_t { none, celsius, kelvin, pascal, bar, volt, ampere, watt };
+    enum class quality_type : std::uint8_t { good, uncertain, bad, substituted };
+
+    BIT_FIELD(mode,    2, bf::bit_field_config<mode_type>{});
+    BIT_FIELD(unit,    3, bf::bit_field_config<unit_type>{});
+    BIT_FIELD(quality, 2, bf::bit_field_config<quality_type>{});
+    BIT_FIELD(alarm,   1, bf::bit_field_config<bool>{});
+    BIT_FIELD(level,   8, bf::bit_field_config<std::uint8_t>{});
+};
+
+struct decoded_sample {
+    sample::mode_type mode;
+    sample::unit_type unit;
+    sample::quality_type quality;
+    bool alarm;
+    float level;
+};
+
+/// The level is a two's complement 8-bit value in quarter units.
+constexpr decoded_sample decode_sample(const sample& layout) {
+    const auto raw = static_cast<std::int8_t>(layout.get_level());
+    return { layout.get_mode(), layout.get_unit(), layout.get_quality(), layout.get_alarm(),
+             static_cast<float>(raw) * 0.25f };
+}
+
+using control_table = bf::decode_table<control, &decode_control>;
+using sample_table = bf::decode_table<sample, &decode_sample>;
+
+namespace {
+
+/// Decode every layout into an array, field by field and then through the table.
+template <typename TLayout, typename TTable>
+void compare(const char* const fields_name, const char* const table_name, const std::vector<TLayout>& layouts,
+             auto&& decode_fields) {
+    std::vector<typename TTable::decoded_type> decoded(layouts.size());
+    bench::measure(fields_name, layouts.size(), [&] {
+        for (std::size_t i = 0; i < layouts.size(); ++i) {
+            decoded[i] = decode_fields(layouts[i]);
+        }
+        bench::do_not_optimize(decoded.data());
+    });
+    bench::measure(table_name, layouts.size(), [&] {
+        TTable::decode(layouts, decoded);
+        bench::do_not_optimize(decoded.data());
+    });
+}
+
+} // namespace
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 20;
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    const auto next = [&state] {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        return static_cast<std::uint32_t>(state >> 33);
+    };
+
+    std::vector<control> controls(count);
+    for (control& layout : controls) {
+        layout.raw_value = static_cast<std::uint8_t>(next());
+    }
+    // The decode functions are wrapped in lambdas so they inline, as the table's own decode does.
+    compare<control, control_table>("8-bit, 3 fields, shifts and masks", "8-bit, 3 fields, decode table", controls,
+                                    [](const control& layout) { return decode_control(layout); });
+
+    std::vector<sample> spread(count);
+    std::vector<sample> hot(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        spread[i].raw_value = static_cast<std::uint16_t>(next());
+        hot[i].raw_value = static_cast<std::uint16_t>(next() % 64 * 1031);
+    }
+    const auto decode_fields = [](const sample& layout) { return decode_sample(layout); };
+    compare<sample, sample_table>("16-bit, 5 fields, spread, shifts and masks",
+                                  "16-bit, 5 fields, spread, decode table", spread, decode_fields);
+    compare<sample, sample_table>("16-bit, 5 fields, 64 hot, shifts and masks",
+                                  "16-bit, 5 fields, 64 hot, decode table", hot, decode_fields);
+    return 0;
+}
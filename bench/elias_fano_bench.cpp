@@ -0,0 +1,219 @@
+// Compares a sorted sequence of 2^22 values with random gaps averaging 32, as in a posting list, stored three ways: a
+// plain std::vector<std::uint64_t>, deltas in variable-length bytes with the offset and value of every 128th value
+// sampled for seeking, and elias_fano. Measures the bits each value takes, random access, next_geq with random
+// targets, and decoding the whole sequence in runs of 4096 values.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "elias_fano.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t value_count = std::size_t{1} << 22;
+constexpr std::size_t query_count = std::size_t{1} << 20;
+constexpr std::size_t run_length = 4096;
+
+/// Deltas between values in LEB128 bytes, seven bits per byte, with every sample_interval-th value and its offset.
+class delta_varint {
+public:
+    static constexpr std::size_t sample_interval = 128;
+
+    explicit delta_varint(const std::span<const std::uint64_t> values) : size_(values.size()) {
+        std::uint64_t previous = 0;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (i % sample_interval == 0) {
+                samples_.push_back({ bytes_.size(), values[i] });
+                previous = values[i];
+                continue;
+            }
+            std::uint64_t delta = values[i] - previous;
+            previous = values[i];
+            for (; delta >= 0x80; delta >>= 7) {
+                bytes_.push_back(static_cast<std::uint8_t>(delta | 0x80));
+            }
+            bytes_.push_back(static_cast<std::uint8_t>(delta));
+        }
+        bytes_.resize(bytes_.size() + 16);
+    }
+
+    std::uint64_t operator[](const std::size_t index) const {
+        const sample& start = samples_[index / sample_interval];
+        const std::uint8_t* in = bytes_.data() + start.offset;
+        std::uint64_t value = start.value;
+        for (std::size_t i = index % sample_interval; i > 0; --i) {
+            value += read(in);
+        }
+        return value;
+    }
+
+    std::size_t next_geq(const std::uint64_t target) const {
+        // The last sample at or below the target, then a scan.
+        const auto after = std::upper_bound(samples_.begin(), samples_.end(), target,
+                                            [](const std::uint64_t value, const sample& each) {
+                                                return value < each.value;
+                                            });
+        if (after == samples_.begin()) {
+            return 0;
+        }
+        const std::size_t block = static_cast<std::size_t>(after - samples_.begin()) - 1;
+        const std::uint8_t* in = bytes_.data() + samples_[block].offset;
+        std::uint64_t value = samples_[block].value;
+        std::size_t index = block * sample_interval;
+        while (value < target && ++index < size_) {
+            value += index % sample_interval == 0 ? samples_[index / sample_interval].value - value : read(in);
+        }
+        return index;
+    }
+
+    void decode(const std::size_t first, const std::span<std::uint64_t> output) const {
+        std::size_t index = first - first % sample_interval;
+        const std::uint8_t* in = bytes_.data() + samples_[index / sample_interval].offset;
+        std::uint64_t value = samples_[index / sample_interval].value;
+        for (; index < first; ) {
+            ++index;
+            value = index % sample_interval == 0 ? samples_[index / sample_interval].value : value + read(in);
+        }
+        for (std::uint64_t& out : output) {
+            out = value;
+            ++index;
+            value = index % sample_interval == 0 ? samples_[index / sample_interval].value : value + read(in);
+        }
+    }
+
+    std::size_t memory_size() const {
+        return bytes_.size() + samples_.size() * sizeof(sample);
+    }
+
+private:
+    struct sample {
+        std::size_t offset;
+        std::uint64_t value;
+    };
+
+    static std::uint64_t read(const std::uint8_t*& in) {
+        std::uint64_t result = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            const std::uint8_t byte = *in++;
+            result |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                return result;
+            }
+        }
+    }
+
+    std::size_t size_;
+    std::vector<std::uint8_t> bytes_;
+    std::vector<sample> samples_;
+};
+
+std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+
+std::uint64_t next() {
+    state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+    return state >> 33;
+}
+
+template <typename TSequence>
+void measure(const char* const name, const TSequence& sequence, const std::size_t bytes,
+             const std::vector<std::size_t>& indexes, const std::vector<std::uint64_t>& targets) {
+    char label[96];
+    std::printf("%s: %.2f bits per value\n", name, 8.0 * static_cast<double>(bytes) / value_count);
+    std::snprintf(label, sizeof(label), "%s, random access", name);
+    bench::measure(label, indexes.size(), [&] {
+        std::uint64_t total = 0;
+        for (const std::size_t index : indexes) {
+            total += sequence[index];
+        }
+        bench::do_not_optimize(total);
+    });
+    std::snprintf(label, sizeof(label), "%s, next_geq", name);
+    bench::measure(label, targets.size(), [&] {
+        std::size_t total = 0;
+        for (const std::uint64_t target : targets) {
+            total += sequence.next_geq(target);
+        }
+        bench::do_not_optimize(total);
+    });
+    std::vector<std::uint64_t> run(run_length);
+    std::snprintf(label, sizeof(label), "%s, sequential decode", name);
+    bench::measure(label, value_count, [&] {
+        for (std::size_t first = 0; first < value_count; first += run_length) {
+            sequence.decode(first, run);
+            bench::do_not_optimize(run.data());
+        }
+    });
+}
+
+/// The plain vector, with the same interface.
+struct plain_vector {
+    const std::vector<std::uint64_t>& values;
+
+    std::uint64_t operator[](const std::size_t index) const {
+        return values[index];
+    }
+
+    std::size_t next_geq(const std::uint64_t target) const {
+        return static_cast<std::size_t>(std::lower_bound(values.begin(), values.end(), target) - values.begin());
+    }
+
+    void decode(const std::size_t first, const std::span<std::uint64_t> output) const {
+        std::copy_n(values.begin() + static_cast<std::ptrdiff_t>(first), output.size(), output.begin());
+    }
+};
+
+} // namespace
+
+int main() {
+    std::vector<std::uint64_t> values(value_count);
+    std::uint64_t value = 0;
+    for (std::uint64_t& each : values) {
+        value += next() % 64;
+        each = value;
+    }
+    std::vector<std::size_t> indexes(query_count);
+    std::vector<std::uint64_t> targets(query_count);
+    for (std::size_t i = 0; i < query_count; ++i) {
+        indexes[i] = next() % value_count;
+        targets[i] = next() % (values.back() + 1);
+    }
+
+    const delta_varint varint{ values };
+    const bf::elias_fano sequence{ values };
+    for (std::size_t i = 0; i < value_count; i += 4099) {
+        if (sequence[i] != values[i] || varint[i] != values[i] ||
+            varint.next_geq(values[i]) != sequence.next_geq(values[i])) {
+            std::printf("encodings disagree at %zu\n", i);
+            return 1;
+        }
+    }
+    // Check the block decoder (the AVX2 gather, where available) against every value, as the sequential decode
+    // timing reads them: in runs from the start, then in shorter runs at odd offsets, which end mid-block.
+    std::vector<std::uint64_t> run(run_length);
+    for (std::size_t first = 0; first < value_count; first += run_length) {
+        const std::span<std::uint64_t> output{ run.data(), std::min(run_length, value_count - first) };
+        sequence.decode(first, output);
+        if (!std::equal(output.begin(), output.end(), values.begin() + static_cast<std::ptrdiff_t>(first))) {
+            std::printf("decode disagrees in the run from %zu\n", first);
+            return 1;
+        }
+    }
+    for (std::size_t first = 3; first + 1001 <= value_count; first += 100'003) {
+        const std::span<std::uint64_t> output{ run.data(), 1001 };
+        sequence.decode(first, output);
+        if (!std::equal(output.begin(), output.end(), values.begin() + static_cast<std::ptrdiff_t>(first))) {
+            std::printf("decode disagrees in the run from %zu\n", first);
+            return 1;
+        }
+    }
+
+    measure("std::vector", plain_vector{ values }, values.size() * sizeof(std::uint64_t), indexes, targets);
+    measure("delta+varint", varint, varint.memory_size(), indexes, targets);
+    measure("elias_fano", sequence, sequence.memory_size(), indexes, targets);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Measures encoding and decoding IO-Link M-sequences: the table-driven checksum against computing the compression bit
+// by bit, one port's master and device messages, and a gateway cycle over many ports with the batch functions.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "io_link.hpp"
+
+#include "bench.hpp"
+
+namespace io_link = bf::io_link;
+
+namespace {
+
+/// The checksum as the specification draws it, compressing the bits of the XOR with shifts on every call.
+std::uint8_t checksum_by_bits(const std::span<const std::byte> message) {
+    unsigned value = 0x52;
+    for (const std::byte octet : message) {
+        value ^= static_cast<unsigned>(octet);
+    }
+    const auto bit = [value](const unsigned index) { return (value >> index) & 1u; };
+    return static_cast<std::uint8_t>((bit(7) ^ bit(5) ^ bit(3) ^ bit(1)) << 5 |
+                                     (bit(6) ^ bit(4) ^ bit(2) ^ bit(0)) << 4 |
+                                     (bit(7) ^ bit(6)) << 3 | (bit(5) ^ bit(4)) << 2 |
+                                     (bit(3) ^ bit(2)) << 1 | (bit(1) ^ bit(0)));
+}
+
+} // namespace
+
+int main() {
+    constexpr std::size_t frames = 1 << 16;
+    constexpr auto format = io_link::type_2_v(4, 4, 1);
+
+    // Device messages of a TYPE_2_V port with four octets of process data each way, as received over a cycle.
+    std::vector<io_link::m_sequence_control> controls(frames);
+    std::vector<std::byte> replies(frames * 8);
+    std::vector<std::size_t> reply_offsets(frames + 1);
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    for (std::size_t i = 0; i < frames; ++i) {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        controls[i].set_direction(state >> 63 ? io_link::transmission_direction::read
+                                              : io_link::transmission_direction::write);
+        controls[i].set_channel(io_link::communication_channel::process);
+        controls[i].set_address(static_cast<std::uint8_t>(state >> 40) & 0x1F);
+        const std::array<std::byte, 5> data{ static_cast<std::byte>(state), static_cast<std::byte>(state >> 8),
+                                             static_cast<std::byte>(state >> 16), static_cast<std::byte>(state >> 24),
+                                             static_cast<std::byte>(state >> 32) };
+        const std::size_t on_request =
+            controls[i].get_direction() == io_link::transmission_direction::read ? 1 : 0;
+        reply_offsets[i + 1] = reply_offsets[i] +
+                               io_link::encode_device(format, controls[i],
+                                                      { std::span{ data }.first(on_request),
+                                                        std::span{ data }.subspan(1), false, false },
+                                                      std::span{ replies }.subspan(reply_offsets[i]));
+    }
+    replies.resize(reply_offsets[frames]);
+    const auto reply = [&](const std::size_t i) {
+        return std::span<const std::byte>{ replies }.subspan(reply_offsets[i], reply_offsets[i + 1] - reply_offsets[i]);
+    };
+
+    bench::measure("checksum, computed bit by bit", frames, [&] {
+        unsigned total = 0;
+        for (std::size_t i = 0; i < frames; ++i) {
+            total += checksum_by_bits(reply(i));
+        }
+        bench::do_not_optimize(total);
+    });
+    bench::measure("checksum, table", frames, [&] {
+        unsigned total = 0;
+        for (std::size_t i = 0; i < frames; ++i) {
+            total += io_link::checksum(reply(i));
+        }
+        bench::do_not_optimize(total);
+    });
+
+    // One port: encode the master message and decode the device's reply, once per cycle.
+    const std::array<std::byte, 4> output{ std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4} };
+    const std::array<std::byte, 1> on_request{ std::byte{0x55} };
+    bench::measure("one port, encode master + decode device", frames, [&] {
+        std::array<std::byte, 16> frame{};
+        std::size_t valid = 0;
+        for (std::size_t i = 0; i < frames; ++i) {
+            const bool write = controls[i].get_direction() == io_link::transmission_direction::write;
+            valid += io_link::encode_master(format,
+                                            { controls[i], output, std::span{ on_request }.first(write ? 1 : 0) },
+                                            frame);
+            bench::clobber();
+            const auto decoded = io_link::decode_device(format, controls[i], reply(i));
+            valid += decoded ? decoded->process_data.size() : 0;
+        }
+        bench::do_not_optimize(valid);
+    });
+
+    // A gateway cycle: every port's master message into one buffer, then every reply out of another.
+    constexpr std::size_t ports = 512;
+    const std::vector<io_link::m_sequence_format> formats(ports, format);
+    std::vector<io_link::master_message> messages(ports);
+    for (std::size_t port = 0; port < ports; ++port) {
+        const bool write = controls[port].get_direction() == io_link::transmission_direction::write;
+        messages[port] = { controls[port], output, std::span{ on_request }.first(write ? 1 : 0) };
+    }
+    const std::span<const std::byte> cycle_replies = std::span{ replies }.first(reply_offsets[ports]);
+    std::vector<std::byte> master_frames(ports * 8);
+    std::vector<std::optional<io_link::device_message>> decoded(ports);
+    const std::span<const io_link::m_sequence_control> cycle_controls = std::span{ controls }.first(ports);
+    bench::measure("gateway, 512 ports, encode master messages", ports, [&] {
+        bench::do_not_optimize(io_link::encode_master_messages(formats, messages, master_frames));
+    });
+    bench::measure("gateway, 512 ports, decode device messages", ports, [&] {
+        bench::do_not_optimize(io_link::decode_device_messages(formats, cycle_controls, cycle_replies, decoded));
+    });
+    std::printf("%zu of %zu replies valid\n",
+                io_link::decode_device_messages(formats, cycle_controls, cycle_replies, decoded), ports);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Compares classifying records against 10, 100, and 1000 rules of the form channel == X && address in [a, b] &&
+// direction == Y by testing the rules in order, each with per-field gets, against a compiled layout_classifier.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "layout_classifier.hpp"
+
+#include "bench.hpp"
+
+struct frame : bf::bit_field_builder<frame, std::uint32_t> {
+    BIT_FIELD(direction, 1);
+    BIT_FIELD(channel,   2);
+    BIT_FIELD(kind,      5);
+    BIT_FIELD(address,  16);
+    BIT_FIELD(port,      8);
+};
+
+namespace {
+
+/// A rule as it would be written by hand.
+struct plain_rule {
+    std::uint32_t channel;
+    std::uint32_t low;
+    std::uint32_t high;
+    std::uint32_t direction;
+};
+
+std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+
+std::uint32_t next() {
+    state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+    return static_cast<std::uint32_t>(state >> 33);
+}
+
+void run(const std::size_t rule_count) {
+    std::vector<plain_rule> plain(rule_count);
+    std::vector<bf::classifier_rule<frame>> rules(rule_count);
+    for (std::size_t i = 0; i < rule_count; ++i) {
+        const std::uint32_t low = next() % 65536;
+        plain[i] = { next() % 4, low, low + next() % 256, next() % 2 };
+        rules[i].where<frame::channel>(plain[i].channel)
+                .where<frame::address>(plain[i].low, plain[i].high)
+                .where<frame::direction>(plain[i].direction);
+    }
+
+    constexpr std::size_t count = std::size_t{1} << 16;
+    std::vector<frame> records(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const plain_rule& near = plain[next() % rule_count];
+        records[i].set_channel(next() % 4);
+        records[i].set_direction(next() % 2);
+        // Half the records fall in some rule's address range; the rest are anywhere.
+        records[i].set_address(next() % 2 == 0 ? near.low + next() % 256 : next() % 65536);
+        records[i].set_kind(next() % 32);
+    }
+
+    const auto linear = [&](const frame& record) {
+        for (std::size_t rule = 0; rule < rule_count; ++rule) {
+            if (record.get_channel() == plain[rule].channel && record.get_address() >= plain[rule].low &&
+                record.get_address() <= plain[rule].high && record.get_direction() == plain[rule].direction) {
+                return rule;
+            }
+        }
+        return bf::layout_classifier<frame>::no_match;
+    };
+
+    bf::layout_classifier<frame> classifier;
+    char name[64];
+    std::snprintf(name, sizeof(name), "%zu rules, compile classifier", rule_count);
+    bench::measure(name, 1, [&] {
+        classifier = bf::layout_classifier<frame>{ rules };
+    });
+
+    std::vector<std::size_t> results(count);
+    classifier.classify(records, results);
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (results[i] != linear(records[i])) {
+            std::printf("classifier disagrees on record %zu\n", i);
+            return;
+        }
+        matched += results[i] != bf::layout_classifier<frame>::no_match ? 1 : 0;
+    }
+    std::printf("%zu rules: %zu of %zu records match a rule\n", rule_count, matched, count);
+
+    std::snprintf(name, sizeof(name), "%zu rules, rules in order", rule_count);
+    bench::measure(name, count, [&] {
+        std::size_t total = 0;
+        for (const frame& record : records) {
+            total += linear(record);
+        }
+        bench::do_not_optimize(total);
+    });
+    std::snprintf(name, sizeof(name), "%zu rules, classifier", rule_count);
+    bench::measure(name, count, [&] {
+        std::size_t total = 0;
+        for (const frame& record : records) {
+            total += classifier.classify(record);
+        }
+        bench::do_not_optimize(total);
+    });
+    std::snprintf(name, sizeof(name), "%zu rules, classifier, batched", rule_count);
+    bench::measure(name, count, [&] {
+        classifier.classify(records, results);
+        bench::do_not_optimize(results.data());
+    });
+}
+
+} // namespace
+
+int main() {
+    run(10);
+    run(100);
+    run(1000);
+    return 0;
+}
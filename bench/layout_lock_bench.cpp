@@ -0,0 +1,93 @@
+// Compares a bit lock and a reader-writer lock embedded in an atomic_layout word against std::mutex and
+// std::shared_mutex guarding the same data, with several threads contending for the lock. The reader-writer runs do one
+// write for every seven reads.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+
+#include "bench.hpp"
+
+struct locked_node : bf::bit_field_builder<locked_node, std::uint64_t> {
+    BIT_FIELD_LOCK(lock);
+    BIT_FIELD(refs, 30);
+    BIT_FIELD(next, 32);
+};
+
+struct shared_table : bf::bit_field_builder<shared_table, std::uint64_t> {
+    BIT_FIELD_SHARED_LOCK(lock, 10);
+    BIT_FIELD(size, 54);
+};
+
+// The data protected by each lock: two counters which must stay equal.
+struct protected_data {
+    std::uint64_t first = 0;
+    std::uint64_t second = 0;
+};
+
+template <typename TMutex>
+struct alignas(BIT_FIELD_CACHE_LINE_SIZE) guarded {
+    TMutex mutex;
+    protected_data data;
+};
+
+template <typename TMutex>
+void exclusive(guarded<TMutex>& target, const std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::lock_guard<TMutex> guard{ target.mutex };
+        ++target.data.first;
+        ++target.data.second;
+    }
+}
+
+template <typename TMutex>
+void mostly_shared(guarded<TMutex>& target, const std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 8 == 0) {
+            const std::lock_guard<TMutex> guard{ target.mutex };
+            ++target.data.first;
+            ++target.data.second;
+        } else {
+            const std::shared_lock<TMutex> guard{ target.mutex };
+            bench::do_not_optimize(target.data.first - target.data.second);
+        }
+    }
+}
+
+int main() {
+    constexpr std::size_t per_thread = std::size_t{1} << 18;
+
+    static guarded<bf::atomic_layout<locked_node>> bit_lock;
+    static guarded<std::mutex> mutex;
+    static guarded<bf::atomic_layout<shared_table>> packed_rw_lock;
+    static guarded<std::shared_mutex> shared_mutex;
+
+    std::printf("%-48s %10zu bytes\n", "bit lock and its word", sizeof(bf::atomic_layout<locked_node>));
+    std::printf("%-48s %10zu bytes\n", "std::mutex", sizeof(std::mutex));
+    std::printf("%-48s %10zu bytes\n", "std::shared_mutex", sizeof(std::shared_mutex));
+
+    for (const std::size_t threads : { 1, 2, 4, 8 }) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "bit lock, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](std::size_t) { exclusive(bit_lock, per_thread); });
+        std::snprintf(name, sizeof(name), "std::mutex, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](std::size_t) { exclusive(mutex, per_thread); });
+        std::snprintf(name, sizeof(name), "packed rw lock, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](std::size_t) {
+            mostly_shared(packed_rw_lock, per_thread);
+        });
+        std::snprintf(name, sizeof(name), "std::shared_mutex, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](std::size_t) {
+            mostly_shared(shared_mutex, per_thread);
+        });
+    }
+
+    if (bit_lock.data.first != bit_lock.data.second || packed_rw_lock.data.first != packed_rw_lock.data.second) {
+        std::printf("lost updates\n");
+        return 1;
+    }
+}
@@ -0,0 +1,73 @@
+// Compares storing three five-state values as a mixed-radix group (7 bits, one byte per record) against storing them
+// as three ordinary 3-bit fields (9 bits, two bytes per record).
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "mixed_radix.hpp"
+
+#include "bench.hpp"
+
+struct radix_record : bf::bit_field_builder<radix_record, std::uint8_t> {
+    BIT_FIELD_MIXED_RADIX(states, 5, 5, 5);
+};
+
+struct plain_record : bf::bit_field_builder<plain_record, std::uint16_t> {
+    BIT_FIELD(a, 3);
+    BIT_FIELD(b, 3);
+    BIT_FIELD(c, 3);
+};
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 22;
+
+    std::vector<std::uint8_t> radix(count);
+    std::vector<std::uint16_t> plain(count);
+    std::uint32_t seed = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const std::uint64_t a = (seed >> 8) % 5, b = (seed >> 16) % 5, c = (seed >> 24) % 5;
+        radix[i] = bf::mixed_radix<5, 5, 5>::pack({ a, b, c });
+        plain_record record{0};
+        record.set_a(a);
+        record.set_b(b);
+        record.set_c(c);
+        plain[i] = record.raw_value;
+    }
+
+    std::printf("%-48s %10zu bytes\n", "mixed radix storage", radix.size() * sizeof(radix[0]));
+    std::printf("%-48s %10zu bytes\n", "plain bit field storage", plain.size() * sizeof(plain[0]));
+
+    bench::measure("mixed radix decode all digits (scalar)", count, [&] {
+        unsigned sum = 0;
+        for (const std::uint8_t value : radix) {
+            sum += radix_record::states::get<0>(value) + radix_record::states::get<1>(value) +
+                   radix_record::states::get<2>(value);
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    bench::measure("plain bit fields decode all fields (scalar)", count, [&] {
+        unsigned sum = 0;
+        for (const std::uint16_t value : plain) {
+            sum += plain_record::a::get(value) + plain_record::b::get(value) + plain_record::c::get(value);
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    std::vector<std::uint8_t> digits(count);
+    bench::measure("mixed radix bulk decode of one digit", count, [&] {
+        radix_record::states::get<1>(std::span<const std::uint8_t>(radix), std::span<std::uint8_t>(digits));
+        bench::do_not_optimize(digits.data());
+    });
+
+    std::vector<std::uint16_t> fields(count);
+    bench::measure("plain bit fields bulk decode of one field", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            fields[i] = plain_record::b::get(plain[i]);
+        }
+        bench::do_not_optimize(fields.data());
+    });
+}
@@ -0,0 +1,90 @@
+// Compares many threads each updating its own 2-bit status field, first with every field packed into one shared
+// 64-bit word, and then with the same layout in a partitioned_record which gives each thread's field a domain of its
+// own, so that every writer has a cache line to itself. The shared word's cache line moves between cores on every
+// update, so its cost per update grows with the number of writers; the partitioned record's should stay flat until
+// writers outnumber cores.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+#include "partitioned_record.hpp"
+
+#include "bench.hpp"
+
+constexpr std::size_t max_writers = 32;
+
+struct worker_states : bf::bit_field_builder<worker_states, std::uint64_t> {
+    BIT_FIELD_PAD(64);
+};
+
+// The status field of a writer.
+template <std::size_t NIndex>
+using worker_state = bf::bit_field<2, 2 * NIndex>;
+
+// A partitioned_record with each writer's field in a domain of its own.
+template <std::size_t... NIndices>
+auto make_partitioned(std::index_sequence<NIndices...>)
+    -> bf::partitioned_record<worker_states, bf::domain<worker_state<NIndices>>...>;
+
+using partitioned_states = decltype(make_partitioned(std::make_index_sequence<max_writers>{}));
+
+// The writer index is only known at run time, but fields are chosen at compile time, so each benchmark builds a table
+// with one update loop per writer.
+template <typename TUpdate, std::size_t... NIndices>
+constexpr auto make_table(std::index_sequence<NIndices...>) {
+    return std::array<void (*)(void*, std::size_t), max_writers>{ &TUpdate::template run<NIndices>... };
+}
+
+struct shared_update {
+    template <std::size_t NIndex>
+    static void run(void* const word, const std::size_t count) {
+        auto& states = *static_cast<bf::atomic_layout<worker_states>*>(word);
+        for (std::size_t i = 0; i < count; ++i) {
+            states.set<worker_state<NIndex>>(static_cast<std::uint64_t>(i & 3));
+        }
+    }
+};
+
+struct partitioned_update {
+    template <std::size_t NIndex>
+    static void run(void* const record, const std::size_t count) {
+        auto& states = *static_cast<partitioned_states*>(record);
+        for (std::size_t i = 0; i < count; ++i) {
+            states.template set<worker_state<NIndex>>(static_cast<std::uint64_t>(i & 3));
+        }
+    }
+};
+
+int main() {
+    constexpr std::size_t per_thread = std::size_t{1} << 18;
+    constexpr auto shared_table = make_table<shared_update>(std::make_index_sequence<max_writers>{});
+    constexpr auto partitioned_table = make_table<partitioned_update>(std::make_index_sequence<max_writers>{});
+
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) bf::atomic_layout<worker_states> shared;
+    static partitioned_states partitioned;
+
+    std::printf("%-48s %10zu bytes\n", "shared word storage", sizeof(shared));
+    std::printf("%-48s %10zu bytes\n", "partitioned record storage", sizeof(partitioned));
+
+    for (std::size_t writers = 2; writers <= max_writers; writers *= 2) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "shared word, %zu writers", writers);
+        bench::measure_threads(name, writers, per_thread, [&](const std::size_t thread) {
+            shared_table[thread](&shared, per_thread);
+        });
+        std::snprintf(name, sizeof(name), "partitioned record, %zu writers", writers);
+        bench::measure_threads(name, writers, per_thread, [&](const std::size_t thread) {
+            partitioned_table[thread](&partitioned, per_thread);
+        });
+    }
+
+    bench::measure("partitioned record snapshot", per_thread, [&] {
+        for (std::size_t i = 0; i < per_thread; ++i) {
+            bench::do_not_optimize(worker_state<max_writers - 1>::get(partitioned.snapshot().raw_value));
+        }
+    });
+}
@@ -0,0 +1,322 @@
+// Decodes a locally generated pcap capture end to end, Ethernet and VLAN tags through IPv4 or IPv6 to TCP or UDP, with
+// the predefined network header layouts and with a hand-written byte parser, and reports packets per second per core.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "byte_order.hpp"
+#include "layout_block.hpp"
+#include "network_headers.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+namespace net = bf::net;
+
+/// What both decoders compute from every packet, so their results can be compared.
+struct summary {
+    std::uint64_t tcp{0};
+    std::uint64_t udp{0};
+    std::uint64_t syn{0};
+    std::uint64_t ports{0};
+    std::uint64_t dscp{0};
+    std::uint64_t payload{0};
+
+    bool operator==(const summary&) const = default;
+};
+
+constexpr std::size_t global_header_size = 24;
+constexpr std::size_t record_header_size = 16;
+
+void put16(std::vector<std::uint8_t>& out, const std::uint32_t value) {
+    out.push_back(static_cast<std::uint8_t>(value >> 8));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void put32(std::vector<std::uint8_t>& out, const std::uint32_t value) {
+    put16(out, value >> 16);
+    put16(out, value & 0xFFFF);
+}
+
+void put_native32(std::vector<std::uint8_t>& out, const std::uint32_t value) {
+    std::uint8_t bytes[4];
+    std::memcpy(bytes, &value, 4);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+/// Write a capture of a mix of packets: a quarter VLAN-tagged, a quarter IPv6, IPv4 headers with and without options,
+/// and TCP segments with and without options, each with a short payload.
+bool write_capture(const char* const path, const std::size_t packets) {
+    std::vector<std::uint8_t> file;
+    put_native32(file, 0xA1B2C3D4);
+    put_native32(file, 0x0004'0002);
+    put_native32(file, 0);
+    put_native32(file, 0);
+    put_native32(file, 65535);
+    put_native32(file, 1);
+
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    std::vector<std::uint8_t> packet;
+    for (std::size_t i = 0; i < packets; ++i) {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        const auto random = static_cast<std::uint32_t>(state >> 32);
+        const bool vlan = random % 4 == 0;
+        const bool ipv6 = (random >> 2) % 4 == 0;
+        const bool tcp = (random >> 4) % 3 != 0;
+        const std::uint32_t ip_options = (random >> 6) % 8 == 0 ? 2 : 0;
+        const std::uint32_t tcp_options = (random >> 9) % 4;
+        const std::uint32_t payload = (random >> 11) % 65;
+
+        packet.clear();
+        for (int byte = 0; byte < 12; ++byte) {
+            packet.push_back(static_cast<std::uint8_t>(random >> byte));
+        }
+        if (vlan) {
+            put16(packet, 0x8100);
+            put16(packet, (random >> 17) & 0xFFFF);
+        }
+        put16(packet, ipv6 ? 0x86DD : 0x0800);
+        const std::uint32_t transport = (tcp ? 20 + 4 * tcp_options : 8) + payload;
+        const std::uint32_t protocol = tcp ? 6 : 17;
+        const std::uint32_t dscp = (random >> 20) % 64;
+        if (ipv6) {
+            put32(packet, 6u << 28 | dscp << 22 | (random & 0xFFFFF));
+            put32(packet, transport << 16 | protocol << 8 | 64);
+            for (int byte = 0; byte < 32; ++byte) {
+                packet.push_back(static_cast<std::uint8_t>(random * static_cast<std::uint32_t>(byte)));
+            }
+        } else {
+            const std::uint32_t ihl = 5 + ip_options;
+            put32(packet, 4u << 28 | ihl << 24 | dscp << 18 | (ihl * 4 + transport));
+            put32(packet, (random & 0xFFFF) << 16 | 0x4000);
+            put32(packet, 64u << 24 | protocol << 16);
+            put32(packet, random);
+            put32(packet, ~random);
+            for (std::uint32_t word = 0; word < ip_options; ++word) {
+                put32(packet, 0x01010101);
+            }
+        }
+        const std::uint32_t source_port = random & 0xFFFF;
+        const std::uint32_t destination_port = (random >> 7) % 1024;
+        put32(packet, source_port << 16 | destination_port);
+        if (tcp) {
+            put32(packet, random);
+            put32(packet, ~random);
+            const std::uint32_t flags = (random >> 24) % 16 == 0 ? 0x002 : 0x010;
+            put32(packet, (5 + tcp_options) << 28 | flags << 16 | 0xFFFF);
+            put32(packet, 0);
+            for (std::uint32_t word = 0; word < tcp_options; ++word) {
+                put32(packet, 0x01010101);
+            }
+        } else {
+            put32(packet, (8 + payload) << 16);
+        }
+        packet.insert(packet.end(), payload, static_cast<std::uint8_t>(i));
+
+        put_native32(file, static_cast<std::uint32_t>(i / 1'000'000));
+        put_native32(file, static_cast<std::uint32_t>(i % 1'000'000));
+        put_native32(file, static_cast<std::uint32_t>(packet.size()));
+        put_native32(file, static_cast<std::uint32_t>(packet.size()));
+        file.insert(file.end(), packet.begin(), packet.end());
+    }
+
+    std::FILE* const stream = std::fopen(path, "wb");
+    if (stream == nullptr) {
+        return false;
+    }
+    const bool written = std::fwrite(file.data(), 1, file.size(), stream) == file.size();
+    return std::fclose(stream) == 0 && written;
+}
+
+std::vector<std::byte> read_capture(const char* const path) {
+    std::vector<std::byte> file;
+    std::FILE* const stream = std::fopen(path, "rb");
+    if (stream == nullptr) {
+        return file;
+    }
+    std::byte buffer[1 << 16];
+    for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), stream)) != 0;) {
+        file.insert(file.end(), buffer, buffer + read);
+    }
+    std::fclose(stream);
+    return file;
+}
+
+/// Call a function with each packet of a capture in native byte order.
+template <typename TFunction>
+void for_each_packet(const std::span<const std::byte> file, TFunction&& function) {
+    std::size_t offset = global_header_size;
+    while (offset + record_header_size <= file.size()) {
+        const auto length = bf::load_bytes<std::uint32_t, std::endian::native>(file.data() + offset + 8);
+        offset += record_header_size;
+        if (length > file.size() - offset) {
+            break;
+        }
+        function(file.subspan(offset, length));
+        offset += length;
+    }
+}
+
+/// Decode with the predefined layouts, viewed in place with block_view.
+summary decode_with_layouts(const std::span<const std::byte> file) {
+    summary result;
+    for_each_packet(file, [&](const std::span<const std::byte> packet) {
+        if (packet.size() < net::ethernet_header_size) {
+            return;
+        }
+        const std::byte* const data = packet.data();
+        std::size_t at = net::ethernet_header_size;
+        auto type = bf::block_view<net::ethernet_header, const std::byte>{ data }.load<net::ethernet_type>().get_type();
+        if (type == net::ether_type::vlan) {
+            if (packet.size() < at + net::vlan_tag_size) {
+                return;
+            }
+            type = bf::block_view<net::vlan_tag, const std::byte>{ data + at }.load<net::ethernet_type>().get_type();
+            at += net::vlan_tag_size;
+        }
+        net::ip_protocol protocol;
+        if (type == net::ether_type::ipv4) {
+            if (packet.size() < at + net::ipv4_header::size) {
+                return;
+            }
+            const bf::block_view<net::ipv4_header, const std::byte> ip{ data + at };
+            const auto word0 = ip.load<net::ipv4_word0>();
+            result.dscp += word0.get_dscp();
+            protocol = ip.load<net::ipv4_word2>().get_protocol();
+            at += std::size_t{ word0.get_ihl() } * 4;
+        } else if (type == net::ether_type::ipv6) {
+            if (packet.size() < at + net::ipv6_header_size) {
+                return;
+            }
+            const bf::block_view<net::ipv6_header, const std::byte> ip{ data + at };
+            result.dscp += ip.load<net::ipv6_word0>().get_dscp();
+            protocol = ip.load<net::ipv6_word1>().get_next_header();
+            at += net::ipv6_header_size;
+        } else {
+            return;
+        }
+        if (protocol == net::ip_protocol::tcp) {
+            if (packet.size() < at + net::tcp_header::size) {
+                return;
+            }
+            const bf::block_view<net::tcp_header, const std::byte> tcp{ data + at };
+            const auto ports = tcp.load<net::transport_ports>();
+            const auto control = tcp.load<net::tcp_control>();
+            ++result.tcp;
+            result.syn += control.get_syn() ? 1 : 0;
+            result.ports += ports.get_source_port() + ports.get_destination_port();
+            at += std::size_t{ control.get_data_offset() } * 4;
+        } else if (protocol == net::ip_protocol::udp) {
+            if (packet.size() < at + net::udp_header::size) {
+                return;
+            }
+            const bf::block_view<net::udp_header, const std::byte> udp{ data + at };
+            const auto ports = udp.load<net::transport_ports>();
+            ++result.udp;
+            result.ports += ports.get_source_port() + ports.get_destination_port();
+            at += net::udp_header::size;
+        } else {
+            return;
+        }
+        result.payload += packet.size() > at ? packet.size() - at : 0;
+    });
+    return result;
+}
+
+std::uint32_t read16(const std::byte* const data) {
+    return static_cast<std::uint32_t>(data[0]) << 8 | static_cast<std::uint32_t>(data[1]);
+}
+
+/// Decode with shifts and masks written out by hand, as a baseline.
+summary decode_by_hand(const std::span<const std::byte> file) {
+    summary result;
+    for_each_packet(file, [&](const std::span<const std::byte> packet) {
+        if (packet.size() < 14) {
+            return;
+        }
+        const std::byte* const data = packet.data();
+        std::size_t at = 14;
+        std::uint32_t type = read16(data + 12);
+        if (type == 0x8100) {
+            if (packet.size() < at + 4) {
+                return;
+            }
+            type = read16(data + at + 2);
+            at += 4;
+        }
+        std::uint32_t protocol;
+        if (type == 0x0800) {
+            if (packet.size() < at + 20) {
+                return;
+            }
+            result.dscp += static_cast<std::uint32_t>(data[at + 1]) >> 2;
+            protocol = static_cast<std::uint32_t>(data[at + 9]);
+            at += (static_cast<std::size_t>(data[at]) & 0x0F) * 4;
+        } else if (type == 0x86DD) {
+            if (packet.size() < at + 40) {
+                return;
+            }
+            result.dscp += (read16(data + at) >> 6) & 0x3F;
+            protocol = static_cast<std::uint32_t>(data[at + 6]);
+            at += 40;
+        } else {
+            return;
+        }
+        if (protocol == 6) {
+            if (packet.size() < at + 20) {
+                return;
+            }
+            ++result.tcp;
+            result.syn += (static_cast<std::uint32_t>(data[at + 13]) >> 1) & 1;
+            result.ports += read16(data + at) + read16(data + at + 2);
+            at += (static_cast<std::size_t>(data[at + 12]) >> 4) * 4;
+        } else if (protocol == 17) {
+            if (packet.size() < at + 8) {
+                return;
+            }
+            ++result.udp;
+            result.ports += read16(data + at) + read16(data + at + 2);
+            at += 8;
+        } else {
+            return;
+        }
+        result.payload += packet.size() > at ? packet.size() - at : 0;
+    });
+    return result;
+}
+
+} // namespace
+
+int main() {
+    constexpr std::size_t packets = std::size_t{1} << 21;
+    const char* const path = "/tmp/bit_field_pcap_bench.pcap";
+    if (!write_capture(path, packets)) {
+        std::perror("write capture");
+        return 1;
+    }
+    const std::vector<std::byte> file = read_capture(path);
+    std::remove(path);
+    std::printf("%zu packets, %zu bytes\n", packets, file.size());
+
+    const summary expected = decode_by_hand(file);
+    const summary decoded = decode_with_layouts(file);
+    if (!(decoded == expected) || expected.tcp + expected.udp != packets) {
+        std::printf("decoders disagree\n");
+        return 1;
+    }
+    std::printf("%llu TCP (%llu SYN), %llu UDP\n", static_cast<unsigned long long>(expected.tcp),
+                static_cast<unsigned long long>(expected.syn), static_cast<unsigned long long>(expected.udp));
+
+    // Mop/s is millions of packets per second on one core.
+    bench::measure("decode, hand-written parser", packets, [&] {
+        bench::do_not_optimize(decode_by_hand(file));
+    });
+    bench::measure("decode, network header layouts", packets, [&] {
+        bench::do_not_optimize(decode_with_layouts(file));
+    });
+    return 0;
+}
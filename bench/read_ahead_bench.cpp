@@ -0,0 +1,117 @@
+// Compares scanning a file of packed records with scan_records, which reads chunks on other threads while the scan
+// runs, against a loop of read calls into one buffer, where reading and scanning take turns, and against mapping the
+// file with mmap and scanning it sequentially. The file is written first, so it is usually in the page cache; the
+// O_DIRECT measurements bypass the cache where the file system supports it.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "read_ahead.hpp"
+
+#include "bench.hpp"
+
+struct sample : bf::bit_field_builder<sample, std::uint64_t> {
+    BIT_FIELD(channel,  8);
+    BIT_FIELD(reading, 24);
+    BIT_FIELD(time,    32);
+};
+
+std::uint64_t kernel(const std::span<const sample> records) {
+    std::uint64_t sum = 0;
+    for (const sample& record : records) {
+        sum += record.get_channel() == 7 ? record.get_reading() : 0;
+    }
+    return sum;
+}
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 25;
+    constexpr std::size_t chunk_size = std::size_t{1} << 20;
+    const char* const path = "/tmp/bit_field_read_ahead_bench";
+
+    {
+        std::vector<sample> records(chunk_size / sizeof(sample));
+        const int descriptor = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        for (std::size_t written = 0; written < count; written += records.size()) {
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                records[i].set_channel(static_cast<std::uint8_t>((written + i) * 37));
+                records[i].set_reading(static_cast<std::uint32_t>(written + i) & 0xFF'FFFF);
+            }
+            if (descriptor < 0 || ::write(descriptor, records.data(), chunk_size) != static_cast<ssize_t>(chunk_size)) {
+                std::printf("could not write %s\n", path);
+                return 1;
+            }
+        }
+        ::close(descriptor);
+    }
+
+    const int descriptor = ::open(path, O_RDONLY);
+    bench::measure("mmap, sequential scan", count, [&] {
+        void* const mapping = ::mmap(nullptr, count * sizeof(sample), PROT_READ, MAP_SHARED, descriptor, 0);
+        bench::do_not_optimize(kernel({ static_cast<const sample*>(mapping), count }));
+        ::munmap(mapping, count * sizeof(sample));
+    });
+
+    std::vector<sample> buffer(chunk_size / sizeof(sample));
+    bench::measure("read loop, one buffer", count, [&] {
+        std::uint64_t sum = 0;
+        for (off_t offset = 0;; offset += static_cast<off_t>(chunk_size)) {
+            const ssize_t size = ::pread(descriptor, buffer.data(), chunk_size, offset);
+            if (size <= 0) {
+                break;
+            }
+            sum += kernel({ buffer.data(), static_cast<std::size_t>(size) / sizeof(sample) });
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    for (const std::size_t readers : { 1, 2 }) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "scan_records, %zu reader(s)", readers);
+        bench::measure(name, count, [&] {
+            std::uint64_t sum = 0;
+            bf::scan_records<sample>(bf::pread_source{ descriptor }, [&](const std::span<const sample> records) {
+                sum += kernel(records);
+            }, { .chunk_size = chunk_size, .depth = 4, .readers = readers });
+            bench::do_not_optimize(sum);
+        });
+    }
+    ::close(descriptor);
+
+#if defined(O_DIRECT)
+    const int direct = ::open(path, O_RDONLY | O_DIRECT);
+    if (direct >= 0) {
+        // With a single buffer, the reader waits for the scan, so reading and scanning take turns.
+        bench::measure("scan_records, O_DIRECT, no read-ahead", count, [&] {
+            std::uint64_t sum = 0;
+            bf::scan_records<sample>(bf::pread_source{ direct }, [&](const std::span<const sample> records) {
+                sum += kernel(records);
+            }, { .chunk_size = chunk_size, .depth = 1 });
+            bench::do_not_optimize(sum);
+        });
+        for (const std::size_t readers : { 1, 2 }) {
+            char name[64];
+            std::snprintf(name, sizeof(name), "scan_records, O_DIRECT, %zu reader(s)", readers);
+            bench::measure(name, count, [&] {
+                std::uint64_t sum = 0;
+                bf::scan_records<sample>(bf::pread_source{ direct }, [&](const std::span<const sample> records) {
+                    sum += kernel(records);
+                }, { .chunk_size = chunk_size, .depth = 4, .readers = readers });
+                bench::do_not_optimize(sum);
+            });
+        }
+        ::close(direct);
+    } else {
+        std::printf("O_DIRECT is not supported here\n");
+    }
+#endif
+
+    ::unlink(path);
+}
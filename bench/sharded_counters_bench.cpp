@@ -0,0 +1,54 @@
+// Compares counting requests from several threads in a sharded_counters layout, where each thread adds to its own
+// shard with plain loads and stores, against counting them in one shared atomic word updated with compare-and-swap.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+#include "sharded_counters.hpp"
+
+#include "bench.hpp"
+
+struct request_stats : bf::bit_field_builder<request_stats, std::uint64_t> {
+    BIT_FIELD(accepted, 16);
+    BIT_FIELD(rejected, 8);
+    BIT_FIELD(timeouts, 8);
+    BIT_FIELD(bytes, 32);
+};
+
+int main() {
+    constexpr std::size_t per_thread = std::size_t{1} << 20;
+
+    static bf::sharded_counters<request_stats> sharded;
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) bf::atomic_layout<request_stats> shared;
+
+    for (const std::size_t threads : { 1, 2, 4, 8 }) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "sharded add, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](const std::size_t) {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                sharded.add<request_stats::accepted>();
+            }
+        });
+
+        std::snprintf(name, sizeof(name), "shared atomic word add, %zu threads", threads);
+        bench::measure_threads(name, threads, per_thread, [&](const std::size_t) {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                shared.modify([](request_stats& value) { value.set_accepted(value.get_accepted() + 1u); });
+            }
+        });
+    }
+
+    bench::measure("sharded read of all four fields", per_thread, [&] {
+        for (std::size_t i = 0; i < per_thread; ++i) {
+            bench::do_not_optimize(sharded.read_all<request_stats::accepted, request_stats::rejected,
+                                                    request_stats::timeouts, request_stats::bytes>());
+        }
+    });
+    bench::measure("shared atomic word read", per_thread, [&] {
+        for (std::size_t i = 0; i < per_thread; ++i) {
+            bench::do_not_optimize(shared.load().raw_value);
+        }
+    });
+}
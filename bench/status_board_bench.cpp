@@ -0,0 +1,92 @@
+// Compares reading worker status from a status_board in POSIX shared memory against polling a worker for its status
+// over a socket, which costs system calls and a wakeup of the worker per poll. Workers here are forked processes which
+// update their own records as they answer the polls.
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include "bit_field_builder.hpp"
+#include "status_board.hpp"
+
+#include "bench.hpp"
+
+struct worker_status : bf::bit_field_builder<worker_status, std::uint64_t> {
+    BIT_FIELD(state,     4);
+    BIT_FIELD(load,     12);
+    BIT_FIELD(heartbeat, 48);
+};
+
+using board_type = bf::status_board<worker_status>;
+
+int main() {
+    constexpr std::size_t workers = 4;
+    constexpr std::size_t count = std::size_t{1} << 20;
+    constexpr const char* name = "/bit_field_status_bench";
+
+    bf::shared_memory::unlink(name);
+    std::optional<bf::shared_memory> mapping = bf::shared_memory::create(name, board_type::bytes_for(workers));
+    if (!mapping || !board_type::create(mapping->bytes(), workers)) {
+        std::printf("could not create shared memory\n");
+        return 1;
+    }
+    const board_type board = *board_type::attach(mapping->bytes());
+
+    // Each worker waits for requests on its socket, updating its record and answering each one, until told to stop.
+    int sockets[workers][2];
+    pid_t children[workers];
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[worker]) != 0) {
+            return 1;
+        }
+        children[worker] = ::fork();
+        if (children[worker] == 0) {
+            std::optional<bf::shared_memory> own = bf::shared_memory::open(name);
+            const board_type own_board = *board_type::attach(own->bytes());
+            const int socket = sockets[worker][1];
+            char request = 0;
+            for (std::uint64_t beat = 0; ::recv(socket, &request, 1, 0) == 1 && request != 'q'; ++beat) {
+                own_board[worker].set<worker_status::state, worker_status::heartbeat>(1, beat);
+                const std::uint64_t status = own_board[worker].load(std::memory_order_relaxed).raw_value;
+                ::send(socket, &status, sizeof(status), 0);
+            }
+            ::_exit(0);
+        }
+    }
+
+    bench::measure("status_board record load", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            bench::do_not_optimize(board[i % workers].get<worker_status::heartbeat>());
+        }
+    });
+
+    worker_status statuses[workers]{};
+    bench::measure("status_board snapshot of 4 records", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            board.snapshot(statuses);
+            bench::clobber();
+        }
+    });
+
+    constexpr std::size_t polls = std::size_t{1} << 12;
+    bench::measure("socket status poll", polls, [&] {
+        for (std::size_t i = 0; i < polls; ++i) {
+            const int socket = sockets[i % workers][0];
+            std::uint64_t status = 0;
+            ::send(socket, "s", 1, 0);
+            ::recv(socket, &status, sizeof(status), MSG_WAITALL);
+            bench::do_not_optimize(status);
+        }
+    });
+
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+        ::send(sockets[worker][0], "q", 1, 0);
+        ::waitpid(children[worker], nullptr, 0);
+    }
+    bf::shared_memory::unlink(name);
+}
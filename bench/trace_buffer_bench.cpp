@@ -0,0 +1,97 @@
+// Compares recording trace events into a trace_buffer, with a 32-bit header built from a bit field layout and written
+// with one store, against formatting each event as a line of text. The collector's cost of draining the buffer once
+// every 1024 events is included. Decoding the drained events is measured separately.
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+
+#include "bit_field_builder.hpp"
+#include "trace_buffer.hpp"
+
+#include "bench.hpp"
+
+struct event_header : bf::bit_field_builder<event_header, std::uint32_t> {
+    BIT_FIELD(delta, 20);
+    BIT_FIELD(type,   8);
+    BIT_FIELD(length, 4);
+
+    using delta_field = delta;
+    using type_field = type;
+    using length_field = length;
+};
+
+std::uint64_t now() {
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 20;
+    constexpr std::size_t batch = 1024;
+
+    static bf::trace_buffer<event_header, std::size_t{1} << 16> buffer;
+    static std::byte dump[std::size_t{1} << 16];
+    static char text[std::size_t{1} << 16];
+
+    bench::measure("binary event, counter timestamp", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            buffer.record(i * 3, static_cast<unsigned>(i & 0x7F));
+            if (i % batch == batch - 1) {
+                bench::do_not_optimize(buffer.drain(dump));
+            }
+        }
+    });
+
+    bench::measure("binary event, 8 byte payload, counter timestamp", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::byte payload[8];
+            std::memcpy(payload, &i, sizeof(payload));
+            buffer.record(i * 3, static_cast<unsigned>(i & 0x7F), payload);
+            if (i % batch == batch - 1) {
+                bench::do_not_optimize(buffer.drain(dump));
+            }
+        }
+    });
+
+    bench::measure("binary event, steady_clock timestamp", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            buffer.record(now(), static_cast<unsigned>(i & 0x7F));
+            if (i % batch == batch - 1) {
+                bench::do_not_optimize(buffer.drain(dump));
+            }
+        }
+    });
+
+    bench::measure("text event, steady_clock timestamp", count, [&] {
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const int length = std::snprintf(text + used, sizeof(text) - used, "%llu event=%u value=%zu\n",
+                                             static_cast<unsigned long long>(now()), static_cast<unsigned>(i & 0x7F),
+                                             i);
+            used += static_cast<std::size_t>(length);
+            if (i % batch == batch - 1) {
+                bench::do_not_optimize(text[0]);
+                used = 0;
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < batch; ++i) {
+        buffer.record(i * 3, static_cast<unsigned>(i & 0x7F));
+    }
+    const std::size_t size = buffer.drain(dump);
+    bench::measure("decode event", batch * 64, [&] {
+        for (std::size_t round = 0; round < 64; ++round) {
+            bf::trace_decoder<event_header> decoder;
+            std::uint64_t sum = 0;
+            decoder.decode(std::span{ dump }.first(size), [&](const bf::trace_event& event) {
+                sum += event.timestamp + event.type;
+            });
+            bench::do_not_optimize(sum);
+        }
+    });
+
+    std::printf("dropped %llu events\n", static_cast<unsigned long long>(buffer.dropped()));
+}
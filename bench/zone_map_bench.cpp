@@ -0,0 +1,81 @@
+// Compares searching an array of packed records for a rare field value with a full scan against a scan which consults
+// a zone_map first and skips blocks that cannot match. Queries are timed whole; building the map is timed per record.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "zone_map.hpp"
+
+#include "bench.hpp"
+
+struct reading : bf::bit_field_builder<reading, std::uint64_t> {
+    BIT_FIELD(status,    2);
+    BIT_FIELD(sensor,    8);
+    BIT_FIELD(level,    22);
+    BIT_FIELD(timestamp, 32);
+};
+
+int main() {
+    constexpr std::size_t count = std::size_t{1} << 24;
+
+    // Status 3 (a fault) occurs in about one block in a thousand. Timestamps increase, as in an append-only log.
+    std::vector<reading> readings(count);
+    std::uint64_t state = 0x9E37'79B9'7F4A'7C15u;
+    for (std::size_t i = 0; i < count; ++i) {
+        state = state * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+        readings[i].set_status(static_cast<std::uint8_t>((state >> 60) % 3));
+        readings[i].set_sensor(static_cast<std::uint8_t>(state >> 40));
+        readings[i].set_level(static_cast<std::uint32_t>(state >> 20) & 0x3F'FFFF);
+        readings[i].set_timestamp(static_cast<std::uint32_t>(i));
+        if ((state >> 8) % 4'000'000 == 0) {
+            readings[i].set_status(3);
+        }
+    }
+
+    bf::zone_map<reading> zones;
+    bench::measure("build zone map", count, [&] {
+        zones = bf::zone_map<reading>{ readings };
+    });
+    std::size_t candidates = 0;
+    for (std::size_t block = 0; block < zones.block_count(); ++block) {
+        candidates += zones.may_contain<reading::status>(block, 3) ? 1 : 0;
+    }
+    std::printf("%zu of %zu blocks may hold status 3\n", candidates, zones.block_count());
+
+    bench::measure("query, full scan: status == 3", 1, [&] {
+        std::size_t matches = 0;
+        for (const reading& record : readings) {
+            matches += record.get_status() == 3 ? 1 : 0;
+        }
+        bench::do_not_optimize(matches);
+    });
+    bench::measure("query, zone map scan: status == 3", 1, [&] {
+        bench::do_not_optimize(zones.count_matches<reading::status>(readings, 3, 3));
+    });
+
+    constexpr std::uint64_t from = count / 2;
+    constexpr std::uint64_t to = from + 10'000;
+    bench::measure("query, full scan: timestamp range", 1, [&] {
+        std::size_t matches = 0;
+        for (const reading& record : readings) {
+            matches += record.get_timestamp() >= from && record.get_timestamp() <= to ? 1 : 0;
+        }
+        bench::do_not_optimize(matches);
+    });
+    bench::measure("query, zone map scan: timestamp range", 1, [&] {
+        bench::do_not_optimize(zones.count_matches<reading::timestamp>(readings, from, to));
+    });
+
+    bench::measure("query, full scan: sensor == 7", 1, [&] {
+        std::size_t matches = 0;
+        for (const reading& record : readings) {
+            matches += record.get_sensor() == 7 ? 1 : 0;
+        }
+        bench::do_not_optimize(matches);
+    });
+    bench::measure("query, zone map scan: sensor == 7 (no skipping)", 1, [&] {
+        bench::do_not_optimize(zones.count_matches<reading::sensor>(readings, 7, 7));
+    });
+}
@@ -38,6 +38,17 @@ limitations under the License.
 #  define BIT_FIELD_DEFAULT_STRATEGY mask
 #endif
 
+// Allow the user to define the default store width used when setting fields before they include the header file.
+#ifndef BIT_FIELD_DEFAULT_STORE_WIDTH
+#  define BIT_FIELD_DEFAULT_STORE_WIDTH full
+#endif
+
+// Allow the user to define the cache line size used to keep concurrently written words apart before they include the
+// header file. 64 bytes suits most x86-64 and AArch64 processors; 128 also covers adjacent-line prefetching.
+#ifndef BIT_FIELD_CACHE_LINE_SIZE
+#  define BIT_FIELD_CACHE_LINE_SIZE 64
+#endif
+
 // Allow the user to define what namespace everything goes into.
 #ifndef BIT_FIELD_NAMESPACE
 #  define BIT_FIELD_NAMESPACE bf
@@ -52,6 +63,8 @@ limitations under the License.
 #include <climits>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace BIT_FIELD_NAMESPACE {
 
@@ -61,6 +74,34 @@ namespace BIT_FIELD_NAMESPACE {
 template <typename T>
 constexpr std::size_t bits = sizeof(T) * CHAR_BIT;
 
+#if defined(__SIZEOF_INT128__)
+/// The 128-bit unsigned integer provided by GCC and Clang as an extension. It can be used as bit field storage.
+__extension__ using uint128_t = unsigned __int128;
+
+/// The 128-bit signed integer provided by GCC and Clang as an extension.
+__extension__ using int128_t = __int128;
+#endif
+
+namespace detail {
+
+/// Satisfied by integral types, including the 128-bit extension integers, which the standard library does not consider
+/// integral in strict conformance modes.
+template <typename T>
+concept integral = std::integral<T>
+#if defined(__SIZEOF_INT128__)
+    || std::is_same_v<std::remove_cv_t<T>, uint128_t> || std::is_same_v<std::remove_cv_t<T>, int128_t>
+#endif
+    ;
+
+/// The smallest unsigned integer type capable of holding NBits bits.
+template <std::size_t NBits>
+using uint_least_t = std::conditional_t<(NBits <= 8),  std::uint8_t,
+                     std::conditional_t<(NBits <= 16), std::uint16_t,
+                     std::conditional_t<(NBits <= 32), std::uint32_t,
+                                                       std::uint64_t>>>;
+
+} // End namespace detail.
+
 /// Construct a bit mask of type T with NCount consecutive set bits starting at NStart (from LSB).
 ///
 /// @tparam T      The result type of the bit mask. Must be integral or std::byte.
@@ -69,11 +110,11 @@ constexpr std::size_t bits = sizeof(T) * CHAR_BIT;
 ///
 /// @returns A value of the requested type T representing the desired bit mask.
 template <typename T, unsigned NStart, unsigned NCount>
-    requires ((std::integral<T> || std::is_same_v<T, std::byte>) && NCount > 0 && NStart + NCount <= bits<T>)
+    requires ((detail::integral<T> || std::is_same_v<T, std::byte>) && NCount > 0 && NStart + NCount <= bits<T>)
 constexpr T bit_mask = []() constexpr {
     T value{0};
     for (unsigned i = NStart; i < NStart + NCount; ++i) {
-        value |= static_cast<T>(1 << i);
+        value |= static_cast<T>(T{1} << i);
     }
     return value;
 }();
@@ -104,8 +145,8 @@ template <std::size_t NBits,
           std::size_t NDestinationOffset = 0,
           bool        BSkipMask = false>
     requires (
-        (std::integral<TSource> || std::is_enum_v<TSource> || std::is_same_v<TSource, std::byte>) &&
-        (std::integral<TDestination> || std::is_enum_v<TDestination> || std::is_same_v<TDestination, std::byte>) &&
+        (detail::integral<TSource> || std::is_enum_v<TSource> || std::is_same_v<TSource, std::byte>) &&
+        (detail::integral<TDestination> || std::is_enum_v<TDestination> || std::is_same_v<TDestination, std::byte>) &&
         (NBits > 0) &&
         (bits<TSource> >= NBits + NSourceOffset) &&
         (bits<TDestination> >= NBits + NDestinationOffset)
@@ -150,9 +191,12 @@ constexpr TDestination extract_bits(const TSource source) noexcept {
 #define BIT_FIELD_HPP
 
 
+#include <bit>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <limits>
+#include <type_traits>
 #if BIT_FIELD_EXCEPTIONS_ENABLED
 #  include <stdexcept>
 #endif
@@ -185,6 +229,25 @@ enum class bit_field_assignment_strategy {
     no_override
 };
 
+/// Enum allowing the width of the memory access made by "set" to be selected at compile-time. Like the assignment
+/// strategy, it is set first as a class-wide default, which can be overridden per field and on individual "set" calls.
+enum class bit_field_store_width {
+    /// Read the whole storage value, modify it, and write the whole value back. This is the default behavior.
+    full,
+
+    /// If the field is exactly 8, 16, or 32 bits wide and its offset is a multiple of its width, it occupies whole,
+    /// naturally aligned bytes of the storage. Such fields are written with a single store of just those bytes, which
+    /// avoids the load of the surrounding value and the store-forwarding stall of reading it back soon after a store
+    /// of another field. This is not a concurrency guarantee: the storage is still an ordinary object, and setting
+    /// two of its fields from different threads without synchronization is a data race. Other fields, storage which
+    /// is volatile, and constant evaluation all fall back to the full width behavior.
+    narrow,
+
+    /// This is not an actual store width that can be employed. It is a sentinel value indicating that the default
+    /// value for the current context should be used.
+    no_override
+};
+
 /// A sentinel value that can be used in a bit_field_config type to indicate that the default offset should be used.
 /// The default chosen is context-sensitive. There's a global default and a field-level default. If using the
 /// bit_field_builder class there's also a class-level default.
@@ -216,6 +279,9 @@ struct bit_field_config {
 
     /// Strategy to use when setting fields.
     bit_field_assignment_strategy strategy{bit_field_assignment_strategy::no_override};
+
+    /// Width of the memory access to use when setting fields.
+    bit_field_store_width store_width{bit_field_store_width::no_override};
 };
 
 /// A type representing a single field within the bit field.
@@ -270,6 +336,27 @@ public:
         }
     }();
 
+    /// Determines the actual store width to use based on the passed in bit_field_config.
+    template <auto TConfig>
+    static constexpr bit_field_store_width effective_store_width = []() constexpr {
+        if constexpr (TConfig.store_width == bit_field_store_width::no_override) {
+            if constexpr (default_config.store_width == bit_field_store_width::no_override) {
+                return bit_field_store_width::BIT_FIELD_DEFAULT_STORE_WIDTH;
+            } else {
+                return default_config.store_width;
+            }
+        } else {
+            return TConfig.store_width;
+        }
+    }();
+
+    /// True if setting the field in a TStorage with the passed in bit_field_config writes only the bytes of the field.
+    template <auto TConfig, typename TStorage>
+    static constexpr bool uses_narrow_store =
+        effective_store_width<TConfig> == bit_field_store_width::narrow && detail::integral<TStorage> &&
+        (NBits == 8 || NBits == 16 || NBits == 32) && NBits < 8 * sizeof(TStorage) && NOffset % NBits == 0 &&
+        (std::endian::native == std::endian::little || std::endian::native == std::endian::big);
+
     /// Determines the actual result type to use based on the passed in bit_field_config.
     template <auto TConfig, typename TStorage>
     using effective_storage =
@@ -292,6 +379,8 @@ public:
     static constexpr auto get(const auto value) noexcept {
         static_assert(TConfig.strategy == bit_field_assignment_strategy::no_override,
                       "Overriding the strategy in TConfig does nothing.");
+        static_assert(TConfig.store_width == bit_field_store_width::no_override,
+                      "Overriding the store width in TConfig does nothing.");
         using TStorage = std::remove_const_t<decltype(value)>;
         return extract_bits<bits, offset, TStorage, effective_storage<TConfig, TStorage>, effective_offset<TConfig>>(
             value);
@@ -348,8 +437,21 @@ private:
         // the compiler is smart enough to inline it since it's a single statement, and it's only used locally. In the
         // default case we skip masking the value inside extract_bits because we've either already done that in the case
         // of the return_bool and exception strategies, or we're not doing it at all in the case of the unchecked
-        // strategy. The only strategy that does do masking is the mask strategy itself.
+        // strategy. The only strategy that does do masking is the mask strategy itself. Narrow stores copy just the
+        // field's bytes into place through a byte pointer, which is always allowed to alias the storage.
         auto set_helper = [&]<bool skip_mask = true>() {
+            if constexpr (uses_narrow_store<TConfig, TStorage> &&
+                          !std::is_volatile_v<std::remove_reference_t<decltype(into)>>) {
+                if (!std::is_constant_evaluated()) {
+                    constexpr std::size_t byte_offset = std::endian::native == std::endian::little
+                                                      ? offset / 8 : sizeof(TStorage) - offset / 8 - bits / 8;
+                    using TBytes = detail::uint_least_t<bits>;
+                    const auto field_bytes =
+                        extract_bits<bits, effective_offset<TConfig>, TValue, TBytes, 0, skip_mask>(value);
+                    std::memcpy(reinterpret_cast<unsigned char*>(&into) + byte_offset, &field_bytes, sizeof(TBytes));
+                    return;
+                }
+            }
             into = static_cast<TStorage>(into & ~bit_mask<TStorage, offset, bits>) |
                    extract_bits<bits, effective_offset<TConfig>, TValue, TStorage, offset, skip_mask>(value);
         };
@@ -512,10 +614,14 @@ static constexpr auto make_config = []() constexpr {
         constexpr bit_field_assignment_strategy effective_strategy =
             given_config.strategy != bit_field_assignment_strategy::no_override
             ? given_config.strategy : TDefaultConfig.strategy;
+        constexpr bit_field_store_width effective_store_width =
+            given_config.store_width != bit_field_store_width::no_override
+            ? given_config.store_width : TDefaultConfig.store_width;
         using effective_type = std::conditional_t<std::is_void_v<typename decltype(given_config)::type>,
                                                   typename decltype(TDefaultConfig)::type,
                                                   typename decltype(given_config)::type>;
-        return bit_field_config<effective_type>{ .offset = effective_offset, .strategy = effective_strategy };
+        return bit_field_config<effective_type>{
+            .offset = effective_offset, .strategy = effective_strategy, .store_width = effective_store_width };
     }
 }();
 
@@ -528,10 +634,11 @@ static constexpr auto make_config = []() constexpr {
 ///
 /// @tparam TDerived       Place the class deriving from bit_field here. This is basically only used as a tag to make
 ///                        the bit_field type unique so it can internally use multiple compile-time counters.
-/// @tparam T              The underlying storage type of the bit field. Must be integral or std::byte.
+/// @tparam T              The underlying storage type of the bit field. Must be integral (including the 128-bit
+///                        extension integers) or std::byte.
 /// @tparam TDefaultConfig The default configuration for any field that does not override settings.
 template <typename TDerived, typename T, bit_field_config TDefaultConfig = bit_field_config{}>
-    requires (std::integral<T> || std::is_same_v<T, std::byte>)
+    requires (detail::integral<T> || std::is_same_v<T, std::byte>)
 struct bit_field_builder {
     using value_type = T;
 
@@ -546,12 +653,26 @@ struct bit_field_builder {
         return COUNTER_VALUE(TDerived::count, max_field) == max_field;
     }
 
+    /// Returns the number of bits allocated so far by fields and padding. Once the derived class is complete, this is
+    /// the number of bits the layout occupies, starting from the least significant bit.
+    static constexpr unsigned allocated_bits() {
+        return COUNTER_VALUE(TDerived::count, max_field);
+    }
+
     // Compile-time counter to count the number of bits allocated so far.
     COUNTER_INITIALIZE(count, 0);
 
     T raw_value{0};
 };
 
+/// Satisfied by layout types defined by deriving from bit_field_builder.
+///
+/// @tparam T The type to check.
+template <typename T>
+concept bit_field_layout =
+    requires { typename T::value_type; T::default_config; } &&
+    std::is_base_of_v<bit_field_builder<T, typename T::value_type, T::default_config>, T>;
+
 /// Increment the bit counter by num_bits without adding a new field. Used to represent padding bits.
 ///
 /// @param self     The "self" type derived from bit_field_builder. This parameter is only needed when the derived class
@@ -627,3 +748,6272 @@ struct bit_field_builder {
 } // End namespace BIT_FIELD_NAMESPACE.
 
 #endif // BIT_FIELD_BUILDER_HPP
+/// Fields whose raw bits are converted to and from some other value type by a codec.
+#ifndef CODEC_FIELD_HPP
+#define CODEC_FIELD_HPP
+
+
+#include <concepts>
+#include <cstddef>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A codec describes how the raw bits of a field map to a value of some other type. It must expose:
+///
+///   bits       -- The number of bits in an encoded value.
+///   raw_type   -- An unsigned integral type which holds an encoded value in its low "bits" bits.
+///   value_type -- The decoded type.
+///   decode     -- A static function converting a raw_type to a value_type.
+///   encode     -- A static function converting a value_type to a raw_type. Must not set bits above "bits".
+///
+/// @tparam T The codec type.
+template <typename T>
+concept field_codec = requires (const typename T::raw_type raw, const typename T::value_type value) {
+    { T::bits } -> std::convertible_to<std::size_t>;
+    { T::decode(raw) } -> std::same_as<typename T::value_type>;
+    { T::encode(value) } -> std::same_as<typename T::raw_type>;
+} && std::unsigned_integral<typename T::raw_type>;
+
+/// A field whose raw bits are described by a bit_field, and whose value is converted by a codec.
+///
+/// @tparam TField The bit_field describing where the raw bits are stored. Must be exactly as wide as the codec.
+/// @tparam TCodec The codec converting between the raw bits and the value type.
+template <typename TField, field_codec TCodec>
+    requires (TField::bits == TCodec::bits)
+struct codec_field {
+    using field = TField;
+    using codec = TCodec;
+    using value_type = typename TCodec::value_type;
+
+    static constexpr std::size_t offset = TField::offset;
+    static constexpr std::size_t bits = TField::bits;
+
+    /// Extract the raw bits from a value and decode them.
+    ///
+    /// @param value The value from which the raw bits will be extracted.
+    ///
+    /// @returns The decoded value.
+    static constexpr value_type get(const auto value) noexcept {
+        return TCodec::decode(TField::template get<get_config>(value));
+    }
+
+    /// Encode a value and insert the raw bits into some storage.
+    ///
+    /// @param into  The storage to update.
+    /// @param value The value to encode.
+    static constexpr void set(auto& into, const value_type value) noexcept {
+        TField::template set<set_config>(into, TCodec::encode(value));
+    }
+
+private:
+    /// Raw bits are always exchanged with the codec at offset zero. The codec guarantees that no extraneous bits are
+    /// set, so no checking is required on insertion.
+    static constexpr auto get_config = bit_field_config<typename TCodec::raw_type>{ .offset = 0 };
+    static constexpr auto set_config =
+        bit_field_config{ .offset = 0, .strategy = bit_field_assignment_strategy::unchecked };
+};
+
+/// Define a new codec field. The number of bits consumed is dictated by the codec.
+///
+/// @param self  The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param name  The name of the field. Used to generate the below symbol names.
+/// @param ...   The codec type, which must satisfy field_codec. Variadic so that template arguments containing commas
+///              do not need extra parentheses.
+///
+/// This creates the following symbols at the current scope (replacing "name" with the given name of the field):
+///     name     -- A codec_field type definition.
+///     get_name -- Member function accessor for the field returning the decoded value.
+///     set_name -- Member function mutator for the field taking the value to encode.
+#define BIT_FIELD_CODEC_DEP(self, name, ...)                                                                           \
+    static_assert(COUNTER_VALUE(self count, self max_field) + __VA_ARGS__::bits <= self max_field);                    \
+                                                                                                                       \
+    using name = ::BIT_FIELD_NAMESPACE::codec_field<                                                                   \
+        ::BIT_FIELD_NAMESPACE::bit_field<__VA_ARGS__::bits, COUNTER_VALUE(self count, self max_field)>,                \
+        __VA_ARGS__>;                                                                                                  \
+                                                                                                                       \
+    constexpr typename name::value_type get_##name() const noexcept {                                                  \
+        return name::get(self raw_value);                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    constexpr void set_##name(const typename name::value_type value) noexcept {                                        \
+        name::set(self raw_value, value);                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    BIT_FIELD_PAD_DEP(self, name::bits)
+
+/// Same as BIT_FIELD_CODEC_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_CODEC(name, ...) \
+    BIT_FIELD_CODEC_DEP(, name, __VA_ARGS__)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CODEC_FIELD_HPP
+/// Low-precision floating point formats which can be stored in bit fields.
+#ifndef MINI_FLOAT_HPP
+#define MINI_FLOAT_HPP
+
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#if defined(__F16C__)
+#  include <immintrin.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Portable conversion between float and a mini_float encoding using integer manipulation of the float representation.
+/// See mini_float for a description of the template parameters.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned>
+struct mini_float_impl {
+    static constexpr std::size_t bits = (BSigned ? 1 : 0) + NExponent + NMantissa;
+    static constexpr int bias = (1 << (NExponent - 1)) - 1;
+    static constexpr std::uint32_t raw_mask = static_cast<std::uint32_t>((std::uint64_t{1} << bits) - 1);
+    static constexpr std::uint32_t exponent_max = (1u << NExponent) - 1;
+    static constexpr std::uint32_t mantissa_mask = (1u << NMantissa) - 1;
+    static constexpr unsigned mantissa_shift = 23 - NMantissa;
+    static constexpr std::uint32_t infinity = exponent_max << NMantissa;
+
+    static constexpr float decode(const std::uint32_t raw) noexcept {
+        const std::uint32_t value = raw & raw_mask;
+        const std::uint32_t sign = BSigned ? (value >> (NExponent + NMantissa)) << 31 : 0;
+        const std::uint32_t exponent = (value >> NMantissa) & exponent_max;
+        const std::uint32_t mantissa = value & mantissa_mask;
+
+        if (exponent == 0) {
+            // Zero or subnormal: the mantissa times 2^(1 - bias - NMantissa). With eight exponent bits the scale is
+            // below the smallest normal float, so it is built as a float subnormal. It is never below the smallest
+            // float subnormal, 2^-149, and the product is a multiple of the scale with fewer than 24 significant
+            // bits, so the product is exact.
+            constexpr int scale_exponent = 1 - bias - static_cast<int>(NMantissa);
+            constexpr float scale = scale_exponent < -126
+                                        ? std::bit_cast<float>(1u << (scale_exponent + 149))
+                                        : std::bit_cast<float>(static_cast<std::uint32_t>(scale_exponent + 127) << 23);
+            const float magnitude = static_cast<float>(mantissa) * scale;
+            return std::bit_cast<float>(std::bit_cast<std::uint32_t>(magnitude) | sign);
+        } else if (exponent == exponent_max) {
+            // Infinity or NaN, keeping the NaN payload.
+            return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << mantissa_shift));
+        } else {
+            return std::bit_cast<float>(sign | ((exponent + 127 - bias) << 23) | (mantissa << mantissa_shift));
+        }
+    }
+
+    /// Shift right, rounding to nearest with ties to even.
+    static constexpr std::uint32_t round_shift(const std::uint32_t value, const unsigned shift) noexcept {
+        if (shift == 0) {
+            return value;
+        }
+        const std::uint32_t half_minus_one = (1u << (shift - 1)) - 1;
+        return (value + half_minus_one + ((value >> shift) & 1u)) >> shift;
+    }
+
+    static constexpr std::uint32_t encode(const float value) noexcept {
+        const std::uint32_t float_bits = std::bit_cast<std::uint32_t>(value);
+        const std::uint32_t magnitude = float_bits & 0x7FFFFFFFu;
+        const std::uint32_t sign = BSigned ? (float_bits >> 31) << (NExponent + NMantissa) : 0;
+
+        if (magnitude > 0x7F800000u) {
+            // NaN. Produce a quiet NaN of the same sign.
+            return sign | infinity | (1u << (NMantissa - 1));
+        }
+        if constexpr (!BSigned) {
+            if (float_bits >> 31) {
+                return 0;
+            }
+        }
+
+        const int float_exponent = static_cast<int>(magnitude >> 23);
+        const int exponent = float_exponent - 127 + bias;
+
+        if (exponent >= static_cast<int>(exponent_max)) {
+            return sign | infinity;
+        } else if (exponent > 0) {
+            // Normal in the target format. Rounding may carry into the exponent, which correctly produces the next
+            // binade, or infinity.
+            const std::uint32_t combined = (static_cast<std::uint32_t>(exponent) << 23) | (magnitude & 0x7FFFFFu);
+            return sign | round_shift(combined, mantissa_shift);
+        } else {
+            // Subnormal or zero in the target format. Rounding may carry into the smallest normal, which is also
+            // encoded correctly.
+            const std::uint32_t mantissa = float_exponent == 0 ? magnitude : (magnitude & 0x7FFFFFu) | 0x800000u;
+            const int shift = float_exponent == 0 ? 150 - bias - static_cast<int>(NMantissa)
+                                                  : 1 - exponent + static_cast<int>(mantissa_shift);
+            return sign | (shift > 24 ? 0 : round_shift(mantissa, static_cast<unsigned>(shift)));
+        }
+    }
+};
+
+/// Every decoded value of a format of at most eight bits, indexed by the encoded value.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned>
+constexpr auto mini_float_table = []() constexpr {
+    using impl = mini_float_impl<NExponent, NMantissa, BSigned>;
+    std::array<float, (std::size_t{1} << impl::bits)> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        table[i] = impl::decode(static_cast<std::uint32_t>(i));
+    }
+    return table;
+}();
+
+} // End namespace detail.
+
+/// An IEEE 754-like binary floating point format with a configurable number of exponent and mantissa bits, optionally
+/// without a sign bit. The format has subnormals, and the all-ones exponent encodes infinity and NaN, exactly like the
+/// IEEE interchange formats. With five exponent bits and ten mantissa bits the format is exactly IEEE binary16.
+///
+/// Values are converted to and from float. Every value of every supported format is exactly representable as a float,
+/// so decoding is exact. Encoding rounds to nearest, ties to even, and overflows to infinity. Unsigned formats clamp
+/// negative values to zero.
+///
+/// Formats with at most eight bits decode through a constexpr table of every possible value. IEEE binary16 decodes and
+/// encodes with the F16C instructions when they are available and the call is not constant-evaluated.
+///
+/// A mini_float satisfies the field_codec concept, so it can be stored in a bit_field_builder with BIT_FIELD_CODEC.
+///
+/// @tparam NExponent The number of exponent bits, from 2 to 8.
+/// @tparam NMantissa The number of explicit mantissa bits, from 1 to 22.
+/// @tparam BSigned   Whether the format has a sign bit in its most significant position.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned = true>
+    requires (NExponent >= 2 && NExponent <= 8 && NMantissa >= 1 && NMantissa <= 22)
+struct mini_float {
+    using value_type = float;
+
+    static constexpr unsigned exponent_bits = NExponent;
+    static constexpr unsigned mantissa_bits = NMantissa;
+    static constexpr bool is_signed = BSigned;
+
+    /// The total number of bits in an encoded value.
+    static constexpr std::size_t bits = (BSigned ? 1 : 0) + NExponent + NMantissa;
+
+    /// The type used to hold an encoded value. Only the low "bits" bits are used.
+    using raw_type = detail::uint_least_t<bits>;
+
+    /// The exponent bias of the format.
+    static constexpr int bias = (1 << (NExponent - 1)) - 1;
+
+    /// Whether the format is exactly IEEE binary16, which some hardware converts natively.
+    static constexpr bool is_ieee_half = NExponent == 5 && NMantissa == 10 && BSigned;
+
+    /// Decode a single value. Bits of raw above the format width are ignored.
+    ///
+    /// @param raw The encoded value.
+    ///
+    /// @returns The exact float representation of the encoded value.
+    static constexpr float decode(const raw_type raw) noexcept {
+        if constexpr (bits <= 8) {
+            return detail::mini_float_table<NExponent, NMantissa, BSigned>[raw & impl::raw_mask];
+        } else {
+#if defined(__F16C__)
+            if constexpr (is_ieee_half) {
+                if (!std::is_constant_evaluated()) {
+                    return _cvtsh_ss(raw);
+                }
+            }
+#endif
+            return impl::decode(raw);
+        }
+    }
+
+    /// Encode a single value, rounding to nearest with ties to even.
+    ///
+    /// @param value The value to encode.
+    ///
+    /// @returns The encoded value in the low "bits" bits.
+    static constexpr raw_type encode(const float value) noexcept {
+#if defined(__F16C__)
+        if constexpr (is_ieee_half) {
+            if (!std::is_constant_evaluated()) {
+                return static_cast<raw_type>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+            }
+        }
+#endif
+        return static_cast<raw_type>(impl::encode(value));
+    }
+
+    /// Decode a run of values. The output must be at least as large as the input. IEEE binary16 converts eight values
+    /// per instruction when F16C and AVX are available. Other formats use the single value path, which the compiler is
+    /// free to vectorize.
+    ///
+    /// @param input  The encoded values.
+    /// @param output Receives the decoded values.
+    static void decode(const std::span<const raw_type> input, const std::span<float> output) noexcept {
+        std::size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+        if constexpr (is_ieee_half) {
+            for (const std::size_t end = input.size() & ~std::size_t{7}; i < end; i += 8) {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+                _mm256_storeu_ps(output.data() + i, _mm256_cvtph_ps(packed));
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = decode(input[i]);
+        }
+    }
+
+    /// Encode a run of values. The output must be at least as large as the input.
+    ///
+    /// @param input  The values to encode.
+    /// @param output Receives the encoded values.
+    static void encode(const std::span<const float> input, const std::span<raw_type> output) noexcept {
+        std::size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+        if constexpr (is_ieee_half) {
+            for (const std::size_t end = input.size() & ~std::size_t{7}; i < end; i += 8) {
+                const __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(input.data() + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), packed);
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = encode(input[i]);
+        }
+    }
+
+private:
+    using impl = detail::mini_float_impl<NExponent, NMantissa, BSigned>;
+};
+
+/// IEEE 754 binary16.
+using half_float = mini_float<5, 10>;
+
+/// The bfloat16 format, the upper half of an IEEE binary32.
+using brain_float = mini_float<8, 7>;
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // MINI_FLOAT_HPP
+/// Codecs mapping small codes to values through a lookup table.
+#ifndef CODE_TABLE_HPP
+#define CODE_TABLE_HPP
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#if defined(__SSSE3__)
+#  include <immintrin.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A codec for non-linearly encoded fields, such as logarithmic or companded sensor values. Each of the 2^NBits codes
+/// indexes a constant table of values. Decoding is a single masked table load. Encoding finds the code whose value is
+/// nearest to the requested value (preferring the smaller value on ties) by binary searching a compile-time sorted copy
+/// of the table, so the table itself does not need to be monotonic.
+///
+/// The table is a template parameter object, so it has static storage and is constant-initialized.
+///
+/// A code_table satisfies the field_codec concept, so it can be stored in a bit_field_builder with BIT_FIELD_CODEC.
+///
+/// @tparam NBits  The number of bits in a code.
+/// @tparam TTable A std::array of exactly 2^NBits arithmetic values, indexed by code.
+template <std::size_t NBits, auto TTable>
+    requires (NBits > 0 && NBits <= 16 && TTable.size() == (std::size_t{1} << NBits) &&
+              std::is_arithmetic_v<typename decltype(TTable)::value_type>)
+struct code_table {
+    using value_type = typename decltype(TTable)::value_type;
+    using raw_type = detail::uint_least_t<NBits>;
+
+    static constexpr std::size_t bits = NBits;
+
+    /// The values indexed by code.
+    static constexpr const auto& table = TTable;
+
+    /// Decode a single code. Bits of raw above the code width are ignored.
+    ///
+    /// @param raw The code.
+    ///
+    /// @returns The value the code maps to.
+    static constexpr value_type decode(const raw_type raw) noexcept {
+        return table[raw & code_mask];
+    }
+
+    /// Encode a value as the code whose table value is nearest to it.
+    ///
+    /// @param value The value to encode.
+    ///
+    /// @returns The nearest code.
+    static constexpr raw_type encode(const value_type value) noexcept {
+        // Binary search for the first sorted entry which is not less than the value.
+        std::size_t low = 0;
+        std::size_t high = sorted.size();
+        while (low < high) {
+            const std::size_t middle = low + (high - low) / 2;
+            if (table[sorted[middle]] < value) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low == sorted.size()) {
+            return sorted[low - 1];
+        } else if (low == 0) {
+            return sorted[0];
+        }
+
+        using difference = std::conditional_t<std::is_floating_point_v<value_type>, value_type, std::int64_t>;
+        const difference below = static_cast<difference>(value) - static_cast<difference>(table[sorted[low - 1]]);
+        const difference above = static_cast<difference>(table[sorted[low]]) - static_cast<difference>(value);
+        return above < below ? sorted[low] : sorted[low - 1];
+    }
+
+    /// Decode a run of codes, one code per raw_type. The output must be at least as large as the input.
+    ///
+    /// When SSSE3 is available, tables of at most sixteen one or two byte values are decoded sixteen codes at a time
+    /// with pshufb, treating the table as a register-resident shuffle control.
+    ///
+    /// @param input  The codes.
+    /// @param output Receives the decoded values.
+    static void decode(const std::span<const raw_type> input, const std::span<value_type> output) noexcept {
+        std::size_t i = 0;
+#if defined(__SSSE3__)
+        if constexpr (NBits <= 4 && std::is_integral_v<value_type> && sizeof(value_type) <= 2) {
+            const __m128i mask = _mm_set1_epi8(static_cast<char>(code_mask));
+            const __m128i low_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_tables[0].data()));
+            const __m128i high_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_tables[1].data()));
+            for (const std::size_t end = input.size() & ~std::size_t{15}; i < end; i += 16) {
+                const __m128i codes =
+                    _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i)), mask);
+                const __m128i low = _mm_shuffle_epi8(low_bytes, codes);
+                if constexpr (sizeof(value_type) == 1) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), low);
+                } else {
+                    const __m128i high = _mm_shuffle_epi8(high_bytes, codes);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), _mm_unpacklo_epi8(low, high));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i + 8), _mm_unpackhi_epi8(low, high));
+                }
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = decode(input[i]);
+        }
+    }
+
+private:
+    static constexpr raw_type code_mask = static_cast<raw_type>((std::size_t{1} << NBits) - 1);
+
+    /// Every code, ordered by the value it maps to.
+    static constexpr auto sorted = []() constexpr {
+        std::array<raw_type, TTable.size()> codes{};
+        for (std::size_t i = 0; i < codes.size(); ++i) {
+            codes[i] = static_cast<raw_type>(i);
+        }
+        // Insertion sort is fine at compile time for tables this small, and it is stable so equal values keep the
+        // lowest code first.
+        for (std::size_t i = 1; i < codes.size(); ++i) {
+            const raw_type code = codes[i];
+            std::size_t j = i;
+            for (; j > 0 && TTable[code] < TTable[codes[j - 1]]; --j) {
+                codes[j] = codes[j - 1];
+            }
+            codes[j] = code;
+        }
+        return codes;
+    }();
+
+    /// The low and high bytes of each table value, padded to sixteen entries, for use as pshufb tables.
+    static constexpr auto shuffle_tables = []() constexpr {
+        std::array<std::array<std::uint8_t, 16>, 2> bytes{};
+        if constexpr (NBits <= 4 && std::is_integral_v<value_type> && sizeof(value_type) <= 2) {
+            for (std::size_t i = 0; i < TTable.size(); ++i) {
+                const auto value = static_cast<std::uint16_t>(TTable[i]);
+                bytes[0][i] = static_cast<std::uint8_t>(value);
+                bytes[1][i] = static_cast<std::uint8_t>(value >> 8);
+            }
+        }
+        return bytes;
+    }();
+};
+
+/// The ITU-T G.711 A-law expansion table, mapping each 8-bit A-law code to a 16-bit linear sample.
+constexpr auto alaw_table = []() constexpr {
+    std::array<std::int16_t, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        const unsigned code = static_cast<unsigned>(i) ^ 0x55u;
+        const unsigned segment = (code & 0x70u) >> 4;
+        unsigned magnitude = (code & 0x0Fu) << 4;
+        if (segment == 0) {
+            magnitude += 8;
+        } else {
+            magnitude = (magnitude + 0x108u) << (segment - 1);
+        }
+        const int sample = static_cast<int>(magnitude);
+        table[i] = static_cast<std::int16_t>((code & 0x80u) ? sample : -sample);
+    }
+    return table;
+}();
+
+/// A codec for ITU-T G.711 A-law samples.
+using alaw = code_table<8, alaw_table>;
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CODE_TABLE_HPP
+/// Packing of several bounded values into a shared run of bits using mixed-radix arithmetic.
+#ifndef MIXED_RADIX_HPP
+#define MIXED_RADIX_HPP
+
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The product of a list of radices, or zero if the product does not fit in 64 bits.
+template <std::size_t... NRadices>
+constexpr std::uint64_t radix_product = []() constexpr {
+    std::uint64_t product = 1;
+    for (const std::uint64_t radix : std::array<std::uint64_t, sizeof...(NRadices)>{ NRadices... }) {
+        if (product > std::numeric_limits<std::uint64_t>::max() / radix) {
+            return std::uint64_t{0};
+        }
+        product *= radix;
+    }
+    return product;
+}();
+
+/// Divide by a constant using a multiplication and a shift which are exact for every dividend up to NMax. Compilers
+/// already do this for scalar code, but spelling it out in 32-bit arithmetic lets narrow bulk loops vectorize, since
+/// vector units generally lack integer division and 8-bit multiplication.
+///
+/// @tparam NDivisor The divisor.
+/// @tparam NMax     The largest dividend which must divide exactly.
+template <std::uint64_t NDivisor, std::uint64_t NMax>
+struct constant_divisor {
+    /// Find the smallest shift whose rounded-up reciprocal has an error small enough for every dividend up to NMax.
+    static constexpr unsigned shift = []() constexpr {
+        for (unsigned candidate = 0; candidate < 32; ++candidate) {
+            const std::uint64_t power = std::uint64_t{1} << candidate;
+            const std::uint64_t multiplier = (power + NDivisor - 1) / NDivisor;
+            if ((multiplier * NDivisor - power) * NMax < power) {
+                return candidate;
+            }
+        }
+        return 32u;
+    }();
+
+    static constexpr std::uint64_t multiplier = ((std::uint64_t{1} << shift) + NDivisor - 1) / NDivisor;
+
+    /// Whether the product of any dividend and the multiplier fits in 32 bits.
+    static constexpr bool is_narrow = shift < 32 && NMax * multiplier <= std::numeric_limits<std::uint32_t>::max();
+
+    template <typename T>
+    static constexpr T divide(const T dividend) noexcept {
+        if constexpr (is_narrow) {
+            const auto wide = static_cast<std::uint32_t>(dividend);
+            return static_cast<T>((wide * static_cast<std::uint32_t>(multiplier)) >> shift);
+        } else {
+            return static_cast<T>(dividend / NDivisor);
+        }
+    }
+};
+
+} // End namespace detail.
+
+/// Several bounded values ("digits") packed into one integer as a mixed-radix number. Digit zero is the least
+/// significant, so three digits with radices A, B, and C are packed as d0 + A * (d1 + B * d2). This wastes less than
+/// one bit in total, where giving each digit its own run of bits wastes up to one bit per digit. For example, three
+/// digits with five states each need 7 bits rather than 9.
+///
+/// All divisors are compile-time constants, so digit extraction compiles to multiplications and shifts. For groups of
+/// up to 16 bits these are done in 32-bit arithmetic so that bulk extraction vectorizes.
+///
+/// @tparam NRadices The number of states of each digit, least significant first. Each must be at least two.
+template <std::size_t... NRadices>
+    requires (sizeof...(NRadices) > 0 && ((NRadices >= 2) && ...) && detail::radix_product<NRadices...> != 0)
+struct mixed_radix {
+    /// The number of digits.
+    static constexpr std::size_t count = sizeof...(NRadices);
+
+    /// The number of states of each digit.
+    static constexpr std::array<std::uint64_t, count> radices{ NRadices... };
+
+    /// The number of distinct packed values.
+    static constexpr std::uint64_t states = detail::radix_product<NRadices...>;
+
+    /// The number of bits required to store a packed value.
+    static constexpr std::size_t bits = static_cast<std::size_t>(std::bit_width(states - 1));
+
+    /// The type holding a packed value.
+    using raw_type = detail::uint_least_t<bits>;
+
+    /// The place value of each digit.
+    template <std::size_t NIndex>
+        requires (NIndex < count)
+    static constexpr raw_type weight = []() constexpr {
+        std::uint64_t product = 1;
+        for (std::size_t i = 0; i < NIndex; ++i) {
+            product *= radices[i];
+        }
+        return static_cast<raw_type>(product);
+    }();
+
+    /// Extract a digit from a packed value.
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    ///
+    /// @returns The digit, less than its radix.
+    template <std::size_t NIndex>
+    static constexpr raw_type get(const raw_type packed) noexcept {
+        using quotient = detail::constant_divisor<weight<NIndex>, states - 1>;
+        if constexpr (NIndex == count - 1) {
+            return quotient::divide(packed);
+        } else {
+            using remainder = detail::constant_divisor<radices[NIndex], (states - 1) / weight<NIndex>>;
+            const raw_type shifted = quotient::divide(packed);
+            return static_cast<raw_type>(shifted - remainder::divide(shifted) * static_cast<raw_type>(radices[NIndex]));
+        }
+    }
+
+    /// Replace a digit in a packed value. The digit is reduced modulo its radix, mirroring the mask assignment strategy
+    /// of ordinary bit fields.
+    ///
+    /// @tparam NIndex The index of the digit to replace.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    /// @param digit  The new digit.
+    ///
+    /// @returns The updated packed value.
+    template <std::size_t NIndex>
+    static constexpr raw_type set(const raw_type packed, const std::uint64_t digit) noexcept {
+        const auto reduced = static_cast<raw_type>(digit % radices[NIndex]);
+        return static_cast<raw_type>(packed - get<NIndex>(packed) * weight<NIndex> + reduced * weight<NIndex>);
+    }
+
+    /// Pack every digit at once.
+    ///
+    /// @param digits The digits, least significant first. Each is reduced modulo its radix.
+    ///
+    /// @returns The packed value.
+    static constexpr raw_type pack(const std::array<std::uint64_t, count>& digits) noexcept {
+        std::uint64_t packed = 0;
+        for (std::size_t i = count; i-- > 0;) {
+            packed = packed * radices[i] + digits[i] % radices[i];
+        }
+        return static_cast<raw_type>(packed);
+    }
+
+    /// Unpack every digit at once.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    ///
+    /// @returns The digits, least significant first.
+    static constexpr std::array<raw_type, count> unpack(const raw_type packed) noexcept {
+        return [packed]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return std::array<raw_type, count>{ get<NIndices>(packed)... };
+        }(std::make_index_sequence<count>{});
+    }
+};
+
+/// A field which stores a mixed-radix group in a run of bits described by a bit_field.
+///
+/// @tparam TField The bit_field describing where the packed value is stored. Must be exactly as wide as the group.
+/// @tparam TRadix The mixed_radix describing the digits.
+template <typename TField, typename TRadix>
+    requires (TField::bits == TRadix::bits)
+struct mixed_radix_field {
+    using field = TField;
+    using radix = TRadix;
+    using raw_type = typename TRadix::raw_type;
+
+    static constexpr std::size_t offset = TField::offset;
+    static constexpr std::size_t bits = TField::bits;
+
+    /// Extract a digit from the group stored in a value.
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param value The value containing the group.
+    ///
+    /// @returns The digit.
+    template <std::size_t NIndex>
+    static constexpr raw_type get(const auto value) noexcept {
+        return TRadix::template get<NIndex>(TField::template get<get_config>(value));
+    }
+
+    /// Replace a digit of the group stored in a value.
+    ///
+    /// @tparam NIndex The index of the digit to replace.
+    ///
+    /// @param into  The value containing the group.
+    /// @param digit The new digit, reduced modulo its radix.
+    template <std::size_t NIndex>
+    static constexpr void set(auto& into, const std::uint64_t digit) noexcept {
+        TField::template set<set_config>(
+            into, TRadix::template set<NIndex>(TField::template get<get_config>(into), digit));
+    }
+
+    /// Extract one digit from the group in each of a run of values. The loop has no dependencies between iterations
+    /// and divides by constants using 32-bit multiplications, so compilers vectorize it (GCC does so at -O3).
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param input  The values containing the group.
+    /// @param output Receives the digits. Must be at least as large as the input.
+    template <std::size_t NIndex, typename TStorage>
+    static void get(const std::span<const TStorage> input, const std::span<raw_type> output) noexcept {
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            output[i] = get<NIndex>(input[i]);
+        }
+    }
+
+private:
+    static constexpr auto get_config = bit_field_config<raw_type>{ .offset = 0 };
+    /// Packed values are only valid below TRadix::states, so a packed value can never exceed the field width unless the
+    /// stored group was already invalid. Masking anyway keeps an invalid group from corrupting neighboring fields.
+    static constexpr auto set_config = bit_field_config{ .offset = 0, .strategy = bit_field_assignment_strategy::mask };
+};
+
+/// Define a mixed-radix group consuming as many bits as the product of its radices requires.
+///
+/// @param self The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param name The name of the group. Used to generate the below symbol names.
+/// @param ...  The radix of each digit, least significant first.
+///
+/// This creates the following symbols at the current scope (replacing "name" with the given name of the group):
+///     name     -- A mixed_radix_field type definition.
+///     get_name -- Member function template taking a digit index and returning the digit.
+///     set_name -- Member function template taking a digit index and the new digit.
+#define BIT_FIELD_MIXED_RADIX_DEP(self, name, ...)                                                                     \
+    using name = ::BIT_FIELD_NAMESPACE::mixed_radix_field<                                                             \
+        ::BIT_FIELD_NAMESPACE::bit_field<::BIT_FIELD_NAMESPACE::mixed_radix<__VA_ARGS__>::bits,                        \
+                                         COUNTER_VALUE(self count, self max_field)>,                                   \
+        ::BIT_FIELD_NAMESPACE::mixed_radix<__VA_ARGS__>>;                                                              \
+                                                                                                                       \
+    static_assert(COUNTER_VALUE(self count, self max_field) + name::bits <= self max_field);                           \
+                                                                                                                       \
+    template <std::size_t NIndex>                                                                                      \
+    constexpr typename name::raw_type get_##name() const noexcept {                                                    \
+        return name::template get<NIndex>(self raw_value);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    template <std::size_t NIndex>                                                                                      \
+    constexpr void set_##name(const std::uint64_t digit) noexcept {                                                    \
+        name::template set<NIndex>(self raw_value, digit);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    BIT_FIELD_PAD_DEP(self, name::bits)
+
+/// Same as BIT_FIELD_MIXED_RADIX_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_MIXED_RADIX(name, ...) \
+    BIT_FIELD_MIXED_RADIX_DEP(, name, __VA_ARGS__)
+
+/// Give a digit of a mixed-radix group its own accessors. Consumes no bits.
+///
+/// @param self  The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param group The name of a group defined with BIT_FIELD_MIXED_RADIX.
+/// @param name  The name of the digit.
+/// @param index The index of the digit within the group.
+///
+/// This creates get_name and set_name member functions at the current scope.
+#define BIT_FIELD_RADIX_DIGIT_DEP(self, group, name, index)                                                            \
+    constexpr typename group::raw_type get_##name() const noexcept {                                                   \
+        return group::template get<index>(self raw_value);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    constexpr void set_##name(const std::uint64_t digit) noexcept {                                                    \
+        group::template set<index>(self raw_value, digit);                                                             \
+    }
+
+/// Same as BIT_FIELD_RADIX_DIGIT_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_RADIX_DIGIT(group, name, index) \
+    BIT_FIELD_RADIX_DIGIT_DEP(, group, name, index)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // MIXED_RADIX_HPP
+/// Loading and storing integers and bit field layouts from byte buffers in a chosen byte order.
+#ifndef BYTE_ORDER_HPP
+#define BYTE_ORDER_HPP
+
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Reverse the bytes of an unsigned integer, including uint128_t.
+template <integral T>
+constexpr T byte_swap(const T value) noexcept {
+#if defined(__GNUC__)
+    if constexpr (sizeof(T) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(T) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(T) == 8) {
+        return __builtin_bswap64(value);
+    } else if constexpr (sizeof(T) == 16) {
+        return static_cast<T>((static_cast<T>(__builtin_bswap64(static_cast<std::uint64_t>(value))) << 64) |
+                              __builtin_bswap64(static_cast<std::uint64_t>(value >> 64)));
+    }
+#endif
+    T result{0};
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        result = static_cast<T>(result | (((value >> (8 * i)) & T{0xFF}) << (8 * (sizeof(T) - 1 - i))));
+    }
+    return result;
+}
+
+/// The unsigned integer which load_bytes and store_bytes move the bytes of a T through, as wide as T.
+template <typename T>
+#if defined(__SIZEOF_INT128__)
+using byte_order_word = std::conditional_t<(bits<T> > 64), uint128_t, uint_least_t<bits<T>>>;
+#else
+using byte_order_word = uint_least_t<bits<T>>;
+#endif
+
+} // End namespace detail.
+
+/// Load an integer from a byte buffer. At run time this is a single unaligned load, followed by a byte swap if TOrder
+/// is not the native order. In constant evaluation the bytes are combined one at a time.
+///
+/// @tparam T      The integral type (or std::byte) to load, including the 128-bit integers.
+/// @tparam TOrder The byte order of the buffer.
+///
+/// @param data Points at the first of sizeof(T) bytes to load.
+///
+/// @returns The loaded value.
+template <typename T, std::endian TOrder = std::endian::native>
+    requires (detail::integral<std::remove_cv_t<T>> || std::is_same_v<std::remove_cv_t<T>, std::byte>)
+constexpr std::remove_cv_t<T> load_bytes(const std::byte* const data) noexcept {
+    using TUnsigned = detail::byte_order_word<T>;
+    TUnsigned value{0};
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            const std::size_t shift = 8 * (TOrder == std::endian::big ? sizeof(T) - 1 - i : i);
+            value = static_cast<TUnsigned>(value | (static_cast<TUnsigned>(data[i]) << shift));
+        }
+    } else {
+        std::memcpy(&value, data, sizeof(T));
+        if constexpr (TOrder != std::endian::native) {
+            value = detail::byte_swap(value);
+        }
+    }
+    return static_cast<std::remove_cv_t<T>>(value);
+}
+
+/// Store an integer into a byte buffer. The counterpart of load_bytes.
+///
+/// @tparam TOrder The byte order of the buffer.
+/// @tparam T      The integral type (or std::byte) to store, including the 128-bit integers.
+///
+/// @param data  Points at the first of sizeof(T) bytes to store.
+/// @param value The value to store.
+template <std::endian TOrder = std::endian::native, typename T>
+    requires (detail::integral<T> || std::is_same_v<T, std::byte>)
+constexpr void store_bytes(std::byte* const data, const T value) noexcept {
+    using TUnsigned = detail::byte_order_word<T>;
+    auto bytes = static_cast<TUnsigned>(value);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            const std::size_t shift = 8 * (TOrder == std::endian::big ? sizeof(T) - 1 - i : i);
+            data[i] = static_cast<std::byte>(bytes >> shift);
+        }
+    } else {
+        if constexpr (TOrder != std::endian::native) {
+            bytes = detail::byte_swap(bytes);
+        }
+        std::memcpy(data, &bytes, sizeof(T));
+    }
+}
+
+/// Load a bit field layout from a byte buffer.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TOrder  The byte order of the buffer.
+///
+/// @param data Points at the first of sizeof(TLayout::value_type) bytes to load.
+///
+/// @returns The loaded layout.
+template <bit_field_layout TLayout, std::endian TOrder = std::endian::native>
+constexpr TLayout load_layout(const std::byte* const data) noexcept {
+    TLayout layout{};
+    layout.raw_value = load_bytes<typename TLayout::value_type, TOrder>(data);
+    return layout;
+}
+
+/// Store a bit field layout into a byte buffer.
+///
+/// @tparam TOrder  The byte order of the buffer.
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+///
+/// @param data   Points at the first of sizeof(TLayout::value_type) bytes to store.
+/// @param layout The layout to store.
+template <std::endian TOrder = std::endian::native, bit_field_layout TLayout>
+constexpr void store_layout(std::byte* const data, const TLayout& layout) noexcept {
+    store_bytes<TOrder>(data, static_cast<std::remove_cv_t<typename TLayout::value_type>>(layout.raw_value));
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // BYTE_ORDER_HPP
+/// Decoding chains of variable-length segments, such as protocol headers whose length is given by one of their fields.
+#ifndef LAYOUT_CURSOR_HPP
+#define LAYOUT_CURSOR_HPP
+
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A length rule computing the total length of a segment in bytes from a field of its fixed prefix, as
+/// field * NScale + NBias. For example, the IPv4 header length is the IHL field times four, and a TLV record with a
+/// two byte type and a two byte length counting only the value is length_from<0, length, 1, 4>.
+///
+/// @tparam NLayoutIndex The index of the prefix layout containing the length field.
+/// @tparam TField       The field holding the length, typically "layout::name" for a field defined with BIT_FIELD.
+/// @tparam NScale       The number of bytes per unit of the length field.
+/// @tparam NBias        A constant number of bytes added to the scaled length field.
+template <std::size_t NLayoutIndex, typename TField, std::size_t NScale = 1, std::size_t NBias = 0>
+struct length_from {
+    static constexpr std::size_t layout_index = NLayoutIndex;
+
+    /// Compute the length of a segment.
+    ///
+    /// @param prefix The tuple of decoded prefix layouts.
+    ///
+    /// @returns The total length of the segment in bytes, including the prefix.
+    static constexpr std::size_t length(const auto& prefix) noexcept {
+        const auto value = TField::template get<length_config>(std::get<NLayoutIndex>(prefix).raw_value);
+        return static_cast<std::size_t>(value) * NScale + NBias;
+    }
+
+private:
+    static constexpr auto length_config = bit_field_config<std::size_t>{};
+};
+
+/// A segment is a fixed prefix, made of one or more layouts stored back to back in the given byte order, followed by a
+/// variable number of bytes whose extent is given by a length rule. The fixed prefix keeps all of the compile-time
+/// masks and shifts of its layouts; only the position of the next segment is computed at run time.
+///
+/// @tparam TOrder    The byte order of the layouts in the prefix.
+/// @tparam TLength   The length rule. Must provide a static length function taking the prefix tuple, such as
+///                   length_from.
+/// @tparam TLayouts  The layouts making up the fixed prefix, in order.
+template <std::endian TOrder, typename TLength, bit_field_layout... TLayouts>
+    requires (sizeof...(TLayouts) > 0)
+struct segment {
+    /// The decoded fixed prefix.
+    using prefix_type = std::tuple<TLayouts...>;
+
+    static constexpr std::endian byte_order = TOrder;
+
+    /// The number of bytes in the fixed prefix, and therefore the smallest valid segment length.
+    static constexpr std::size_t prefix_size = (sizeof(typename TLayouts::value_type) + ...);
+
+    /// Decode the fixed prefix. No bounds checking is done.
+    ///
+    /// @param data Points at the first of prefix_size bytes.
+    ///
+    /// @returns The decoded prefix layouts.
+    static constexpr prefix_type decode(const std::byte* const data) noexcept {
+        return decode_impl(data, std::index_sequence_for<TLayouts...>{});
+    }
+
+    /// Encode the fixed prefix. No bounds checking is done.
+    ///
+    /// @param data   Points at the first of prefix_size bytes.
+    /// @param prefix The prefix layouts to encode.
+    static constexpr void encode(std::byte* const data, const prefix_type& prefix) noexcept {
+        encode_impl(data, prefix, std::index_sequence_for<TLayouts...>{});
+    }
+
+    /// Compute the total length of the segment, including the prefix, from its decoded prefix.
+    ///
+    /// @param prefix The decoded prefix.
+    ///
+    /// @returns The length of the segment in bytes.
+    static constexpr std::size_t length(const prefix_type& prefix) noexcept {
+        return TLength::length(prefix);
+    }
+
+private:
+    /// The byte offset of each prefix layout.
+    static constexpr std::array<std::size_t, sizeof...(TLayouts)> offsets = []() constexpr {
+        std::array<std::size_t, sizeof...(TLayouts)> result{};
+        std::size_t offset = 0;
+        std::size_t i = 0;
+        ((result[i++] = offset, offset += sizeof(typename TLayouts::value_type)), ...);
+        return result;
+    }();
+
+    template <std::size_t... NIndices>
+    static constexpr prefix_type decode_impl(const std::byte* const data, std::index_sequence<NIndices...>) noexcept {
+        return prefix_type{ load_layout<TLayouts, TOrder>(data + offsets[NIndices])... };
+    }
+
+    template <std::size_t... NIndices>
+    static constexpr void encode_impl(std::byte* const data, const prefix_type& prefix,
+                                      std::index_sequence<NIndices...>) noexcept {
+        (store_layout<TOrder>(data + offsets[NIndices], std::get<NIndices>(prefix)), ...);
+    }
+};
+
+/// A decoded segment: its prefix layouts, and all of its bytes.
+///
+/// @tparam TSegment The segment type.
+template <typename TSegment>
+struct segment_view {
+    typename TSegment::prefix_type prefix{};
+
+    /// Every byte of the segment, including the prefix. Empty if the segment is not valid.
+    std::span<const std::byte> bytes{};
+
+    /// Get one of the prefix layouts.
+    ///
+    /// @tparam NIndex The index of the layout in the prefix.
+    template <std::size_t NIndex>
+    constexpr const auto& get() const noexcept {
+        return std::get<NIndex>(prefix);
+    }
+
+    /// The bytes after the fixed prefix, such as IPv4 options or a TLV value.
+    constexpr std::span<const std::byte> body() const noexcept {
+        return bytes.empty() ? bytes : bytes.subspan(TSegment::prefix_size);
+    }
+
+    /// Returns true if the segment was decoded successfully.
+    constexpr bool valid() const noexcept {
+        return !bytes.empty();
+    }
+};
+
+/// Walks a byte buffer, decoding segments one after another. Each segment is bounds checked once for its whole fixed
+/// prefix, and once for its computed length, rather than once per field.
+class layout_cursor {
+public:
+    /// Construct a cursor at the beginning of a buffer.
+    ///
+    /// @param buffer The bytes to decode. Must outlive the cursor and any segment_view it returns.
+    constexpr explicit layout_cursor(const std::span<const std::byte> buffer) noexcept
+        : remaining_(buffer) {
+    }
+
+    /// Decode the segment at the cursor and advance past it.
+    ///
+    /// @tparam TSegment The segment type expected at the cursor.
+    ///
+    /// @returns The decoded segment, or an empty optional if the buffer is too short for the prefix, or the length rule
+    ///          produces a length shorter than the prefix or longer than the rest of the buffer. In that case the
+    ///          cursor does not move.
+    template <typename TSegment>
+    constexpr std::optional<segment_view<TSegment>> next() noexcept {
+        segment_view<TSegment> view = peek<TSegment>();
+        if (!view.valid()) {
+            return std::nullopt;
+        }
+        remaining_ = remaining_.subspan(view.bytes.size());
+        consumed_ += view.bytes.size();
+        return view;
+    }
+
+    /// Decode the segment at the cursor without advancing.
+    ///
+    /// @tparam TSegment The segment type expected at the cursor.
+    ///
+    /// @returns The decoded segment. It is not valid under the same conditions that next would fail.
+    template <typename TSegment>
+    constexpr segment_view<TSegment> peek() const noexcept {
+        return decode_segment<TSegment>(remaining_);
+    }
+
+    /// Decode a single layout at the cursor and advance past it.
+    ///
+    /// @tparam TLayout The layout type.
+    /// @tparam TOrder  The byte order of the layout in the buffer.
+    ///
+    /// @returns The layout, or an empty optional if the buffer is too short, in which case the cursor does not move.
+    template <bit_field_layout TLayout, std::endian TOrder = std::endian::native>
+    constexpr std::optional<TLayout> read() noexcept {
+        constexpr std::size_t size = sizeof(typename TLayout::value_type);
+        if (remaining_.size() < size) {
+            return std::nullopt;
+        }
+        const TLayout layout = load_layout<TLayout, TOrder>(remaining_.data());
+        remaining_ = remaining_.subspan(size);
+        consumed_ += size;
+        return layout;
+    }
+
+    /// Advance the cursor by a number of bytes.
+    ///
+    /// @param count The number of bytes to skip.
+    ///
+    /// @returns True if the bytes were skipped, or false if fewer bytes remain, in which case the cursor does not move.
+    constexpr bool skip(const std::size_t count) noexcept {
+        if (remaining_.size() < count) {
+            return false;
+        }
+        remaining_ = remaining_.subspan(count);
+        consumed_ += count;
+        return true;
+    }
+
+    /// The bytes which have not been decoded yet.
+    constexpr std::span<const std::byte> remaining() const noexcept {
+        return remaining_;
+    }
+
+    /// The number of bytes decoded so far.
+    constexpr std::size_t position() const noexcept {
+        return consumed_;
+    }
+
+    /// Returns true if every byte has been decoded.
+    constexpr bool empty() const noexcept {
+        return remaining_.empty();
+    }
+
+    /// Decode the segment at the start of a buffer.
+    ///
+    /// @tparam TSegment The segment type.
+    ///
+    /// @param buffer The bytes to decode.
+    ///
+    /// @returns The decoded segment, which is not valid if it does not fit in the buffer.
+    template <typename TSegment>
+    static constexpr segment_view<TSegment> decode_segment(const std::span<const std::byte> buffer) noexcept {
+        if (buffer.size() < TSegment::prefix_size) {
+            return {};
+        }
+        segment_view<TSegment> view{ .prefix = TSegment::decode(buffer.data()) };
+        const std::size_t length = TSegment::length(view.prefix);
+        if (length < TSegment::prefix_size || length > buffer.size()) {
+            return {};
+        }
+        view.bytes = buffer.first(length);
+        return view;
+    }
+
+private:
+    std::span<const std::byte> remaining_;
+    std::size_t consumed_{0};
+};
+
+/// Decode a run of back-to-back segments of the same type, such as a sequence of TLV records, calling a function for
+/// each one.
+///
+/// @tparam TSegment The segment type.
+///
+/// @param buffer The bytes to decode.
+/// @param fn     Called with each segment_view, in order. If it returns bool, returning false stops the walk.
+///
+/// @returns The number of bytes consumed. Equal to the buffer size if every byte formed a valid segment.
+template <typename TSegment>
+constexpr std::size_t for_each_segment(const std::span<const std::byte> buffer, auto&& fn) {
+    layout_cursor cursor{ buffer };
+    while (!cursor.empty()) {
+        const std::optional<segment_view<TSegment>> view = cursor.next<TSegment>();
+        if (!view) {
+            break;
+        }
+        if constexpr (std::is_same_v<decltype(fn(*view)), bool>) {
+            if (!fn(*view)) {
+                break;
+            }
+        } else {
+            fn(*view);
+        }
+    }
+    return cursor.position();
+}
+
+/// Decode the leading segment of many independent frames, such as the IP header of each captured packet.
+///
+/// @tparam TSegment The segment type at the start of every frame.
+///
+/// @param frames The frames to decode.
+/// @param output Receives the decoded segment of each frame. Must be at least as large as frames. Frames which are too
+///               short for their segment produce a segment_view which is not valid.
+///
+/// @returns The number of valid segments.
+template <typename TSegment>
+constexpr std::size_t decode_segments(const std::span<const std::span<const std::byte>> frames,
+                                      const std::span<segment_view<TSegment>> output) noexcept {
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        output[i] = layout_cursor::decode_segment<TSegment>(frames[i]);
+        valid += output[i].valid() ? std::size_t{1} : std::size_t{0};
+    }
+    return valid;
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_CURSOR_HPP
+/// Views of bit field layouts stored at arbitrary bit offsets within byte buffers.
+#ifndef BIT_VIEW_HPP
+#define BIT_VIEW_HPP
+
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Shift the 128-bit value high:low right by shift bits, keeping the low 64 bits. Compiles to shrd on x86-64 and extr
+/// on AArch64.
+///
+/// @param low   The low half.
+/// @param high  The high half.
+/// @param shift The shift amount, from 0 to 63.
+constexpr std::uint64_t funnel_shift_right(const std::uint64_t low, const std::uint64_t high,
+                                           const unsigned shift) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    return static_cast<std::uint64_t>(((static_cast<uint128>(high) << 64) | low) >> (shift & 63));
+#else
+    return (low >> shift) | ((high << 1) << (63 - shift));
+#endif
+}
+
+} // End namespace detail.
+
+/// A view of a bit_field_builder layout stored at any bit position in a byte buffer, as found in packed streams where
+/// structures are concatenated without byte alignment. Bits are numbered from the least significant bit of the first
+/// byte, so the layout's least significant bit is bit (bit_offset % 8) of byte (bit_offset / 8), and the layout
+/// occupies exactly TLayout::allocated_bits() bits.
+///
+/// Loading does one unaligned 64-bit load and a shift, plus one more byte and a funnel shift for layouts wider than 57
+/// bits, after which the layout's fields are extracted with their usual compile-time masks and shifts. Storing writes
+/// back only the bytes the layout overlaps, and preserves the bits of those bytes outside the layout. Near the end of
+/// the buffer, where a 64-bit load would run past it, the bytes are accessed one at a time instead.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TByte   std::byte for a mutable view, or const std::byte for a read-only view.
+template <bit_field_layout TLayout, typename TByte = std::byte>
+    requires (std::is_same_v<std::remove_const_t<TByte>, std::byte> && bits<typename TLayout::value_type> <= 64)
+class bit_view {
+public:
+    /// The number of bits the layout occupies in the buffer.
+    static constexpr std::size_t width = TLayout::allocated_bits();
+
+    static_assert(width > 0, "The layout must allocate at least one bit.");
+
+    /// Check whether a layout fits in a buffer at a bit offset.
+    ///
+    /// @param buffer     The buffer.
+    /// @param bit_offset The bit offset of the layout.
+    ///
+    /// @returns True if every bit of the layout lies within the buffer.
+    static constexpr bool fits(const std::span<const std::byte> buffer, const std::size_t bit_offset) noexcept {
+        return bit_offset <= buffer.size() * 8 && width <= buffer.size() * 8 - bit_offset;
+    }
+
+    /// Construct a view. The layout must fit in the buffer at the given offset (see fits), which is not checked.
+    ///
+    /// @param buffer     The buffer holding the layout. Must outlive the view.
+    /// @param bit_offset The bit offset of the least significant bit of the layout.
+    constexpr bit_view(const std::span<TByte> buffer, const std::size_t bit_offset) noexcept
+        : buffer_(buffer), byte_(bit_offset / 8), shift_(static_cast<unsigned>(bit_offset % 8)) {
+    }
+
+    /// Load the layout.
+    ///
+    /// @returns A copy of the layout. Bits above width are zero.
+    constexpr TLayout load() const noexcept {
+        std::uint64_t word = 0;
+        if (!std::is_constant_evaluated() && byte_ + load_bytes_count <= buffer_.size()) {
+            word = load_bytes<std::uint64_t, std::endian::little>(buffer_.data() + byte_);
+            if constexpr (wide) {
+                const auto high = static_cast<std::uint64_t>(buffer_[byte_ + 8]);
+                word = detail::funnel_shift_right(word, high, shift_);
+            } else {
+                word >>= shift_;
+            }
+        } else {
+            word = load_slow();
+        }
+
+        TLayout layout{};
+        layout.raw_value = static_cast<value_type>(word & value_mask);
+        return layout;
+    }
+
+    /// Store the layout, writing only the bytes it overlaps. Bits of the layout above width are ignored.
+    ///
+    /// @param layout The layout to store.
+    constexpr void store(const TLayout& layout) const noexcept requires (!std::is_const_v<TByte>) {
+        const auto value = static_cast<std::uint64_t>(static_cast<unsigned_type>(layout.raw_value)) & value_mask;
+        if (!std::is_constant_evaluated() && byte_ + load_bytes_count <= buffer_.size()) {
+            std::byte* const data = buffer_.data() + byte_;
+            const std::uint64_t word = load_bytes<std::uint64_t, std::endian::little>(data);
+            const std::uint64_t updated = (word & ~(value_mask << shift_)) | (value << shift_);
+            if constexpr (wide) {
+                const auto high = static_cast<std::uint64_t>(data[8]);
+                const std::uint64_t high_mask = (value_mask >> 1) >> (63 - shift_);
+                const std::uint64_t high_bits = (value >> 1) >> (63 - shift_);
+                store_bytes<std::endian::little>(data, updated);
+                if (shift_ + width > 64) {
+                    data[8] = static_cast<std::byte>((high & ~high_mask) | high_bits);
+                }
+            } else if (min_bytes == 8 || shift_ + width <= min_bytes * 8) {
+                store_low_bytes<min_bytes>(data, updated);
+            } else {
+                store_low_bytes<(min_bytes < 8 ? min_bytes + 1 : 8)>(data, updated);
+            }
+        } else {
+            store_slow(value);
+        }
+    }
+
+    /// Load the layout, let a function modify it, and store it back.
+    ///
+    /// @param fn Called with a reference to the loaded layout.
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        TLayout layout = load();
+        fn(layout);
+        store(layout);
+    }
+
+    /// The bit offset of the bit immediately after the layout, where a following layout would start.
+    constexpr std::size_t end_bit_offset() const noexcept {
+        return byte_ * 8 + shift_ + width;
+    }
+
+private:
+    using value_type = typename TLayout::value_type;
+    using unsigned_type = detail::uint_least_t<bits<value_type>>;
+
+    /// Layouts whose bits can extend past the first eight bytes need a ninth byte and a funnel shift.
+    static constexpr bool wide = width + 7 > 64;
+
+    /// The number of bytes which must be present for the fast path, which always loads a whole word.
+    static constexpr std::size_t load_bytes_count = wide ? 9 : 8;
+
+    /// The fewest bytes the layout can overlap, when it starts on a byte boundary.
+    static constexpr std::size_t min_bytes = (width + 7) / 8;
+
+    static constexpr std::uint64_t value_mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+
+    /// Store the low NBytes bytes of a little-endian word, using as few stores as the size allows.
+    template <std::size_t NBytes>
+    static constexpr void store_low_bytes(std::byte* const data, const std::uint64_t word) noexcept {
+        if constexpr (NBytes == 8) {
+            store_bytes<std::endian::little>(data, word);
+        } else if constexpr (NBytes >= 4) {
+            store_bytes<std::endian::little>(data, static_cast<std::uint32_t>(word));
+            store_low_bytes<NBytes - 4>(data + 4, word >> 32);
+        } else if constexpr (NBytes >= 2) {
+            store_bytes<std::endian::little>(data, static_cast<std::uint16_t>(word));
+            store_low_bytes<NBytes - 2>(data + 2, word >> 16);
+        } else if constexpr (NBytes == 1) {
+            data[0] = static_cast<std::byte>(word);
+        }
+    }
+
+    /// The number of bytes the layout actually overlaps.
+    constexpr std::size_t overlapped_bytes() const noexcept {
+        return (shift_ + width + 7) / 8;
+    }
+
+    constexpr std::uint64_t load_slow() const noexcept {
+        std::uint64_t low = 0;
+        std::uint64_t high = 0;
+        const std::size_t count = overlapped_bytes();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto byte = static_cast<std::uint64_t>(buffer_[byte_ + i]);
+            if (i < 8) {
+                low |= byte << (8 * i);
+            } else {
+                high = byte;
+            }
+        }
+        return detail::funnel_shift_right(low, high, shift_);
+    }
+
+    constexpr void store_slow(const std::uint64_t value) const noexcept {
+        // The value and its mask shifted into place, as a 64-bit low part and the byte above it.
+        const std::uint64_t low_value = value << shift_;
+        const std::uint64_t low_mask = value_mask << shift_;
+        const std::uint64_t high_value = (value >> 1) >> (63 - shift_);
+        const std::uint64_t high_mask = (value_mask >> 1) >> (63 - shift_);
+
+        const std::size_t count = overlapped_bytes();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto bits_value = static_cast<std::uint8_t>(i < 8 ? low_value >> (8 * i) : high_value);
+            const auto bits_mask = static_cast<std::uint8_t>(i < 8 ? low_mask >> (8 * i) : high_mask);
+            const auto old = static_cast<std::uint8_t>(buffer_[byte_ + i]);
+            buffer_[byte_ + i] = static_cast<std::byte>((old & ~bits_mask) | bits_value);
+        }
+    }
+
+    std::span<TByte> buffer_;
+    std::size_t byte_;
+    unsigned shift_;
+};
+
+/// Load a layout stored at a bit offset in a buffer. See bit_view.
+///
+/// @tparam TLayout The layout type.
+///
+/// @param buffer     The buffer. The layout must fit at the given offset.
+/// @param bit_offset The bit offset of the least significant bit of the layout.
+///
+/// @returns The loaded layout.
+template <bit_field_layout TLayout>
+constexpr TLayout load_layout_at_bit(const std::span<const std::byte> buffer, const std::size_t bit_offset) noexcept {
+    return bit_view<TLayout, const std::byte>{ buffer, bit_offset }.load();
+}
+
+/// Store a layout at a bit offset in a buffer, touching only the bytes it overlaps. See bit_view.
+///
+/// @param buffer     The buffer. The layout must fit at the given offset.
+/// @param bit_offset The bit offset of the least significant bit of the layout.
+/// @param layout     The layout to store.
+template <bit_field_layout TLayout>
+constexpr void store_layout_at_bit(const std::span<std::byte> buffer, const std::size_t bit_offset,
+                                   const TLayout& layout) noexcept {
+    bit_view<TLayout>{ buffer, bit_offset }.store(layout);
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // BIT_VIEW_HPP
+/// Atomic storage for bit field layouts, including 128-bit layouts updated with a double-width compare-and-swap.
+#ifndef ATOMIC_LAYOUT_HPP
+#define ATOMIC_LAYOUT_HPP
+
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__) && defined(__AVX__)
+#  include <immintrin.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// An atomic integer of up to 64 bits. A thin wrapper around std::atomic with the interface used by atomic_layout.
+template <typename T>
+class atomic_word {
+public:
+    static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+    constexpr atomic_word() noexcept = default;
+
+    constexpr explicit atomic_word(const T value) noexcept
+        : value_(value) {
+    }
+
+    T load(const std::memory_order order) const noexcept {
+        return value_.load(order);
+    }
+
+    void store(const T value, const std::memory_order order) noexcept {
+        value_.store(value, order);
+    }
+
+    bool compare_exchange_weak(T& expected, const T desired, const std::memory_order success,
+                               const std::memory_order failure) noexcept {
+        return value_.compare_exchange_weak(expected, desired, success, failure);
+    }
+
+    bool compare_exchange_strong(T& expected, const T desired, const std::memory_order success,
+                                 const std::memory_order failure) noexcept {
+        return value_.compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    T fetch_or(const T value, const std::memory_order order) noexcept {
+        return value_.fetch_or(value, order);
+    }
+
+    T fetch_and(const T value, const std::memory_order order) noexcept {
+        return value_.fetch_and(value, order);
+    }
+
+    void wait(const T old, const std::memory_order order) const noexcept {
+        value_.wait(old, order);
+    }
+
+    void notify_one() noexcept {
+        value_.notify_one();
+    }
+
+    void notify_all() noexcept {
+        value_.notify_all();
+    }
+
+private:
+    std::atomic<T> value_{0};
+};
+
+#if defined(__SIZEOF_INT128__)
+/// A 128-bit atomic integer. Compare-and-swap is a single cmpxchg16b on x86-64 built with -mcx16 (or any -march which
+/// implies it), and casp or an ldxp/stxp loop on AArch64. Elsewhere the compiler's 16-byte atomic builtins are used,
+/// which may require linking libatomic. All operations are sequentially consistent regardless of the requested order.
+///
+/// Loads use a single 16-byte vmovdqa on x86-64 processors with AVX, which Intel and AMD guarantee to be atomic for
+/// aligned addresses. Otherwise a load is a compare-and-swap which does not change the value.
+template <>
+class atomic_word<uint128_t> {
+public:
+#  if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+    static constexpr bool is_always_lock_free = true;
+#  else
+    static constexpr bool is_always_lock_free = false;
+#  endif
+
+    constexpr atomic_word() noexcept = default;
+
+    constexpr explicit atomic_word(const uint128_t value) noexcept
+        : value_(value) {
+    }
+
+    uint128_t load(const std::memory_order) const noexcept {
+#  if defined(__x86_64__) && defined(__AVX__)
+        __m128i result;
+        asm volatile("vmovdqa %1, %0" : "=x"(result) : "m"(value_) : "memory");
+        return std::bit_cast<uint128_t>(result);
+#  else
+        uint128_t expected = 0;
+        cas(expected, 0);
+        return expected;
+#  endif
+    }
+
+    void store(const uint128_t value, const std::memory_order) noexcept {
+        // A failed compare-and-swap loads the current value into expected, so the guess needs no racy plain read.
+        uint128_t expected = 0;
+        while (!cas(expected, value)) {
+        }
+    }
+
+    bool compare_exchange_weak(uint128_t& expected, const uint128_t desired, const std::memory_order,
+                               const std::memory_order) noexcept {
+        return cas(expected, desired);
+    }
+
+    bool compare_exchange_strong(uint128_t& expected, const uint128_t desired, const std::memory_order,
+                                 const std::memory_order) noexcept {
+        return cas(expected, desired);
+    }
+
+private:
+    bool cas(uint128_t& expected, const uint128_t desired) const noexcept {
+#  if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+        const uint128_t previous = __sync_val_compare_and_swap(&value_, expected, desired);
+        const bool success = previous == expected;
+        expected = previous;
+        return success;
+#  else
+        return __atomic_compare_exchange_n(&value_, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#  endif
+    }
+
+    // Mutable so that a load can be implemented as a compare-and-swap which leaves the value unchanged.
+    alignas(16) mutable uint128_t value_{0};
+};
+#endif
+
+/// Tell the processor that the calling thread is spinning, to save power and yield to another hardware thread.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // End namespace detail.
+
+/// Satisfied by layouts which designate a version field with BIT_FIELD_VERSION.
+///
+/// @tparam T The type to check.
+template <typename T>
+concept versioned_layout = bit_field_layout<T> && requires { typename T::version_field; };
+
+/// Atomic storage for a bit_field_builder layout. Layouts of up to 64 bits are stored in a std::atomic. 128-bit layouts
+/// (using uint128_t storage) are updated with a double-width compare-and-swap, so that, for example, a 64-bit pointer,
+/// a 48-bit version, and 16 bits of flags can all change together.
+///
+/// Updates are compare-and-swap loops. For set, the masks of all of the fields being written and the bits of their new
+/// values are computed before the loop, so each retry is just an and, an or, and the compare-and-swap.
+///
+/// If the layout designates a version field (see BIT_FIELD_VERSION), every update through this class increments the
+/// version in the same compare-and-swap, wrapping around within the field, so that a word which changes from A to B
+/// and back to A is still seen to have changed. When the version is the most significant field, the increment is a
+/// single add folded into the desired value; otherwise the carry is masked off so it cannot spill into the next field.
+/// Whatever a modify function or a compare_exchange caller puts in the version field is replaced.
+///
+/// If the layout has a lock field (see BIT_FIELD_LOCK and BIT_FIELD_SHARED_LOCK), the atomic_layout is also a mutex,
+/// usable with std::lock_guard, std::unique_lock, and (for a shared lock) std::shared_lock. The lock lives in the same
+/// word as the data it protects, so there is no separate mutex object and no extra cache line to fetch. Acquiring the
+/// lock spins briefly, then sets a waiters bit and parks the thread with std::atomic::wait (a futex on Linux.)
+/// Unlocking only notifies when the waiters bit is set. Holding the lock does not stop other threads reading any field,
+/// so the other fields can still be read optimistically (with get, load, or read_begin and validate) while the lock is
+/// held. Nor does it stop other threads updating the other fields, but no update can change the lock field: store,
+/// compare_exchange, and modify keep the lock field of the word they replace, whatever the new value holds there, and
+/// set refuses to set it. Only locking and unlocking change it.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+template <bit_field_layout TLayout>
+class atomic_layout {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// Whether every operation is lock free on this platform.
+    static constexpr bool is_always_lock_free = detail::atomic_word<value_type>::is_always_lock_free;
+
+    /// Whether updates increment a version field.
+    static constexpr bool is_versioned = versioned_layout<TLayout>;
+
+    /// Whether the layout has an exclusive lock field.
+    static constexpr bool has_lock = requires { typename TLayout::lock_field; };
+
+    /// Whether the layout has a reader-writer lock field.
+    static constexpr bool has_shared_lock = requires { typename TLayout::shared_lock_field; };
+
+    static_assert(!(has_lock && has_shared_lock), "A layout may have an exclusive lock or a shared lock, not both.");
+    static_assert(!(has_lock || has_shared_lock) || bits<value_type> <= 64,
+                  "Lock fields require a layout of at most 64 bits, which can be waited on.");
+
+    /// Construct with every bit zero.
+    constexpr atomic_layout() noexcept = default;
+
+    /// Construct with an initial value.
+    ///
+    /// @param layout The initial value.
+    constexpr explicit atomic_layout(const TLayout& layout) noexcept
+        : word_(layout.raw_value) {
+    }
+
+    atomic_layout(const atomic_layout&) = delete;
+    atomic_layout& operator=(const atomic_layout&) = delete;
+
+    /// Atomically load the whole layout.
+    ///
+    /// @param order The memory order of the load.
+    ///
+    /// @returns A snapshot of every field.
+    TLayout load(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return make_layout(word_.load(order));
+    }
+
+    /// Atomically replace the whole layout, but for the version and lock fields, which are kept as described above.
+    ///
+    /// @param layout The new value.
+    /// @param order  The memory order of the store.
+    void store(const TLayout& layout, const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        if constexpr (preserved_mask != 0) {
+            value_type expected = word_.load(std::memory_order_relaxed);
+            while (!word_.compare_exchange_weak(expected, next_value(layout.raw_value, expected), order,
+                                                std::memory_order_relaxed)) {
+            }
+        } else {
+            word_.store(layout.raw_value, order);
+        }
+    }
+
+    /// Atomically replace the layout if it is equal to an expected value. Weak, so it may fail spuriously. For a
+    /// versioned layout, the version of desired is ignored, and the stored version is that of expected plus one. For a
+    /// layout with a lock field, the lock field of desired is ignored, and that of expected is stored.
+    ///
+    /// @param expected The expected value. Updated with the current value on failure.
+    /// @param desired  The new value.
+    /// @param success  The memory order on success.
+    /// @param failure  The memory order on failure.
+    ///
+    /// @returns True if the layout was replaced.
+    bool compare_exchange_weak(TLayout& expected, const TLayout& desired,
+                               const std::memory_order success = std::memory_order_seq_cst,
+                               const std::memory_order failure = std::memory_order_seq_cst) noexcept {
+        return word_.compare_exchange_weak(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                           success, failure);
+    }
+
+    /// Same as compare_exchange_weak, but never fails spuriously.
+    bool compare_exchange_strong(TLayout& expected, const TLayout& desired,
+                                 const std::memory_order success = std::memory_order_seq_cst,
+                                 const std::memory_order failure = std::memory_order_seq_cst) noexcept {
+        return word_.compare_exchange_strong(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                             success, failure);
+    }
+
+    /// Atomically load a single field.
+    ///
+    /// @tparam TField  The field, such as "layout::name" for a field defined with BIT_FIELD.
+    /// @tparam TConfig The field configuration to use for the result. See bit_field::get.
+    ///
+    /// @param order The memory order of the load.
+    ///
+    /// @returns The value of the field.
+    template <typename TField, auto TConfig = bit_field_config{}>
+    auto get(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return TField::template get<TConfig>(word_.load(order));
+    }
+
+    /// Atomically set one or more fields, leaving the others unchanged. Values are masked to the width of their field.
+    ///
+    /// @tparam TFields The fields to set, such as "layout::name" for fields defined with BIT_FIELD.
+    ///
+    /// @param values The new value of each field, in the same order as TFields.
+    ///
+    /// @returns The layout as it was immediately before the update.
+    template <typename... TFields>
+        requires (sizeof...(TFields) > 0)
+    TLayout set(const auto... values) noexcept requires (sizeof...(values) == sizeof...(TFields)) {
+        constexpr value_type mask = (bit_mask<value_type, TFields::offset, TFields::bits> | ...);
+        static_assert((mask & version_mask) == 0, "The version field is updated automatically and cannot be set.");
+        static_assert((mask & lock_mask) == 0, "The lock field is only changed by locking and unlocking.");
+        value_type bits{0};
+        (TFields::template set<set_config>(bits, values), ...);
+
+        // The fields being set do not overlap the version or the lock, so the desired value already carries the
+        // expected version and lock, and only needs the increment.
+        value_type expected = word_.load(std::memory_order_relaxed);
+        while (!word_.compare_exchange_weak(expected,
+                                            increment_version(static_cast<value_type>((expected & ~mask) | bits)),
+                                            std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        }
+        return make_layout(expected);
+    }
+
+    /// Atomically apply an arbitrary update. The function is called with a copy of the current layout, which it
+    /// modifies in place, and is called again with a fresh copy whenever another thread wins the race. It should
+    /// therefore have no side effects.
+    ///
+    /// If the function returns bool, returning false abandons the update.
+    ///
+    /// @param fn The update, called with a TLayout&.
+    ///
+    /// @returns The layout as it was immediately before the update, or before it was abandoned.
+    TLayout modify(auto&& fn) noexcept(noexcept(fn(std::declval<TLayout&>()))) {
+        TLayout expected = make_layout(word_.load(std::memory_order_relaxed));
+        while (true) {
+            TLayout desired = expected;
+            if constexpr (std::is_same_v<decltype(fn(desired)), bool>) {
+                if (!fn(desired)) {
+                    return expected;
+                }
+            } else {
+                fn(desired);
+            }
+            if (word_.compare_exchange_weak(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                            std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return expected;
+            }
+        }
+    }
+
+    /// Atomically increment the version without changing any other field, so that every optimistic read which began
+    /// before it fails validation.
+    ///
+    /// @returns The layout as it was immediately before the update.
+    TLayout bump_version() noexcept requires is_versioned {
+        value_type expected = word_.load(std::memory_order_relaxed);
+        while (!word_.compare_exchange_weak(expected, increment_version(expected), std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+        }
+        return make_layout(expected);
+    }
+
+    /// Acquire the lock exclusively: the lock bit for BIT_FIELD_LOCK, or the writer bit for BIT_FIELD_SHARED_LOCK.
+    /// For a shared lock, the writer bit is taken first, which stops new readers, and then the readers already holding
+    /// the lock are waited for.
+    void lock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            if ((word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) != 0) {
+                lock_slow();
+            }
+        } else {
+            value_type value = word_.load(std::memory_order_relaxed);
+            if ((value & (writer_bit | reader_mask)) != 0 ||
+                !word_.compare_exchange_strong(value, value | writer_bit, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                lock_slow();
+            }
+        }
+    }
+
+    /// Try to acquire the lock exclusively without waiting.
+    ///
+    /// @returns True if the lock was acquired.
+    bool try_lock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            return (word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) == 0;
+        } else {
+            value_type value = word_.load(std::memory_order_relaxed);
+            return (value & (writer_bit | reader_mask)) == 0 &&
+                   word_.compare_exchange_strong(value, value | writer_bit, std::memory_order_acquire,
+                                                 std::memory_order_relaxed);
+        }
+    }
+
+    /// Release the exclusive lock, waking waiting threads if there are any.
+    void unlock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            if ((word_.fetch_and(static_cast<value_type>(~(lock_bit | waiters_bit)), std::memory_order_release) &
+                 waiters_bit) != 0) {
+                word_.notify_one();
+            }
+        } else {
+            if ((word_.fetch_and(static_cast<value_type>(~(writer_bit | waiters_bit)), std::memory_order_release) &
+                 waiters_bit) != 0) {
+                word_.notify_all();
+            }
+        }
+    }
+
+    /// Acquire the lock shared, as one of any number of readers. Waits while a writer holds or is waiting for the
+    /// lock, so a steady stream of readers cannot starve writers.
+    void lock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        for (unsigned spin = 0;; ++spin) {
+            if ((value & writer_bit) == 0 && (value & reader_mask) != reader_mask) {
+                if (word_.compare_exchange_weak(value, static_cast<value_type>(value + reader_one),
+                                                std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+            } else {
+                value = pause(value, spin);
+            }
+        }
+    }
+
+    /// Try to acquire the lock shared without waiting.
+    ///
+    /// @returns True if the lock was acquired.
+    bool try_lock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        while ((value & writer_bit) == 0 && (value & reader_mask) != reader_mask) {
+            if (word_.compare_exchange_weak(value, static_cast<value_type>(value + reader_one),
+                                            std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Release a shared lock. The last reader out wakes waiting threads if there are any.
+    void unlock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        value_type desired{};
+        do {
+            desired = static_cast<value_type>(value - reader_one);
+            if ((desired & reader_mask) == 0) {
+                desired = static_cast<value_type>(desired & ~waiters_bit);
+            }
+        } while (!word_.compare_exchange_weak(value, desired, std::memory_order_release, std::memory_order_relaxed));
+        if ((desired & reader_mask) == 0 && (value & waiters_bit) != 0) {
+            word_.notify_all();
+        }
+    }
+
+    /// Returns true if the lock is held exclusively, or for a shared lock, if a writer holds or is waiting for it.
+    bool is_locked(const std::memory_order order = std::memory_order_seq_cst) const noexcept
+            requires (has_lock || has_shared_lock) {
+        return (word_.load(order) & lock_bit) != 0;
+    }
+
+    /// Begin an optimistic read. Read the word, and anything reached through it, then call validate with the returned
+    /// version. If validate returns false, an update happened in between and the read should be retried:
+    ///
+    ///     do {
+    ///         version = word.read_begin();
+    ///         ... read fields, follow pointers held in the word, and so on ...
+    ///     } while (!word.validate(version));
+    ///
+    /// A single load always gives a consistent snapshot of the word itself. The version extends that to several loads
+    /// of the word, and to memory reached through pointers held in it, provided that memory never changes once it is
+    /// published and is not freed while a reader may still follow the pointer. Memory which writers change in place is
+    /// not covered: nothing orders those writes against the version, so a read torn by one can still validate, and the
+    /// reads race with the writes. Such data needs the lock.
+    ///
+    /// @returns The current version.
+    auto read_begin() const noexcept requires is_versioned {
+        return TLayout::version_field::template get<bit_field_config{}>(word_.load(std::memory_order_acquire));
+    }
+
+    /// Finish an optimistic read.
+    ///
+    /// @param version The version returned by read_begin.
+    ///
+    /// @returns True if the word has not been updated since read_begin returned version. Since the version wraps, this
+    ///          is only certain if fewer than 2^bits updates could have happened in between.
+    bool validate(const auto version) const noexcept requires is_versioned {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return TLayout::version_field::template get<bit_field_config{}>(word_.load(std::memory_order_relaxed)) ==
+               version;
+    }
+
+private:
+    static constexpr auto set_config = bit_field_config{ .strategy = bit_field_assignment_strategy::mask };
+
+    /// The number of times to check a held lock before parking the thread.
+    static constexpr unsigned spin_limit = 100;
+
+    /// The bits of the lock field. BIT_FIELD_LOCK is a lock bit and a waiters bit. BIT_FIELD_SHARED_LOCK is a writer
+    /// bit, a waiters bit, and a count of readers in the remaining bits.
+    static constexpr unsigned lock_offset = []() constexpr {
+        if constexpr (has_lock) {
+            return TLayout::lock_field::offset;
+        } else if constexpr (has_shared_lock) {
+            return TLayout::shared_lock_field::offset;
+        } else {
+            return 0u;
+        }
+    }();
+    static constexpr value_type lock_bit = static_cast<value_type>(value_type{1} << lock_offset);
+    static constexpr value_type writer_bit = lock_bit;
+    static constexpr value_type waiters_bit = static_cast<value_type>(value_type{1} << (lock_offset + 1));
+    static constexpr value_type reader_one = static_cast<value_type>(value_type{1} << (lock_offset + 2));
+    static constexpr value_type reader_mask = []() constexpr {
+        if constexpr (has_shared_lock) {
+            return bit_mask<value_type, lock_offset + 2, TLayout::shared_lock_field::bits - 2>;
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// Every bit of the lock field, if there is one.
+    static constexpr value_type lock_mask = []() constexpr {
+        if constexpr (has_lock) {
+            return static_cast<value_type>(lock_bit | waiters_bit);
+        } else if constexpr (has_shared_lock) {
+            return static_cast<value_type>(writer_bit | waiters_bit | reader_mask);
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// Wait for a value of the word to change, spinning at first and then parking the thread. The waiters bit is set
+    /// before parking, so that whoever changes the lock knows to wake this thread.
+    ///
+    /// @param value The value last seen.
+    /// @param spin  The number of times this has already been called for the same wait.
+    ///
+    /// @returns A fresh value of the word.
+    value_type pause(value_type value, const unsigned spin) noexcept {
+        if (spin < spin_limit) {
+            detail::cpu_relax();
+            return word_.load(std::memory_order_relaxed);
+        }
+        if ((value & waiters_bit) == 0) {
+            if (!word_.compare_exchange_weak(value, static_cast<value_type>(value | waiters_bit),
+                                             std::memory_order_relaxed, std::memory_order_relaxed)) {
+                return value;
+            }
+            value = static_cast<value_type>(value | waiters_bit);
+        }
+        word_.wait(value, std::memory_order_relaxed);
+        return word_.load(std::memory_order_relaxed);
+    }
+
+    void lock_slow() noexcept {
+        if constexpr (has_lock) {
+            for (unsigned spin = 0; spin < spin_limit; ++spin) {
+                detail::cpu_relax();
+                if ((word_.load(std::memory_order_relaxed) & lock_bit) == 0 &&
+                    (word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) == 0) {
+                    return;
+                }
+            }
+            // Whoever takes the lock from here on sets the waiters bit, since it cannot know if it was the last waiter.
+            while (true) {
+                const value_type previous = word_.fetch_or(lock_bit | waiters_bit, std::memory_order_acquire);
+                if ((previous & lock_bit) == 0) {
+                    return;
+                }
+                word_.wait(static_cast<value_type>(previous | waiters_bit), std::memory_order_relaxed);
+            }
+        } else {
+            // Take the writer bit, which stops new readers.
+            value_type value = word_.load(std::memory_order_relaxed);
+            for (unsigned spin = 0;; ++spin) {
+                if ((value & writer_bit) == 0) {
+                    if (word_.compare_exchange_weak(value, static_cast<value_type>(value | writer_bit),
+                                                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else {
+                    value = pause(value, spin);
+                }
+            }
+            // Wait for the readers already holding the lock to leave.
+            value = word_.load(std::memory_order_acquire);
+            for (unsigned spin = 0; (value & reader_mask) != 0; ++spin) {
+                value = pause(value, spin);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+    }
+
+    static constexpr value_type version_mask = []() constexpr {
+        if constexpr (is_versioned) {
+            return bit_mask<value_type, TLayout::version_field::offset, TLayout::version_field::bits>;
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// The bits which an update keeps from the value it replaces, rather than taking from the new value.
+    static constexpr value_type preserved_mask = static_cast<value_type>(version_mask | lock_mask);
+
+    static_assert(!is_versioned || static_cast<value_type>(-1) > value_type{0},
+                  "A versioned layout must use unsigned storage so that the version can wrap around.");
+
+    /// Increment the version field of a value, wrapping around within the field.
+    static constexpr value_type increment_version(const value_type value) noexcept {
+        if constexpr (!is_versioned) {
+            return value;
+        } else {
+            using version = typename TLayout::version_field;
+            constexpr value_type one = static_cast<value_type>(value_type{1} << version::offset);
+            if constexpr (version::offset + version::bits == bits<value_type>) {
+                // The carry out of the top field falls off the end of the word.
+                return static_cast<value_type>(value + one);
+            } else {
+                return static_cast<value_type>((value & ~version_mask) | ((value + one) & version_mask));
+            }
+        }
+    }
+
+    /// The value to store in place of expected: desired, with the lock field of expected and the version of expected
+    /// plus one.
+    static constexpr value_type next_value(const value_type desired, const value_type expected) noexcept {
+        if constexpr (preserved_mask == 0) {
+            return desired;
+        } else {
+            return increment_version(
+                static_cast<value_type>((desired & ~preserved_mask) | (expected & preserved_mask)));
+        }
+    }
+
+    static constexpr TLayout make_layout(const value_type value) noexcept {
+        TLayout layout{};
+        layout.raw_value = value;
+        return layout;
+    }
+
+    detail::atomic_word<value_type> word_{};
+};
+
+/// Define a new field and designate it as the version of the layout. atomic_layout increments the version on every
+/// update. A layout may have at most one version field. The parameters and the symbols created are the same as for
+/// BIT_FIELD_DEP, and in addition:
+///     version_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_VERSION_DEP(self, name, num_bits, ...)                                                               \
+    BIT_FIELD_DEP(self, name, num_bits, __VA_ARGS__);                                                                  \
+    using version_field = name
+
+/// Same as BIT_FIELD_VERSION_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_VERSION(name, num_bits, ...) \
+    BIT_FIELD_VERSION_DEP(, name, num_bits, __VA_ARGS__)
+
+/// Define a two bit exclusive lock field: a lock bit, and above it a bit set when threads are parked waiting for the
+/// lock. An atomic_layout of the layout can then be locked and unlocked like a mutex. A layout may have at most one
+/// lock field. The parameters and the symbols created are the same as for BIT_FIELD_DEP (with num_bits fixed at 2), and
+/// in addition:
+///     lock_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_LOCK_DEP(self, name)                                                                                 \
+    BIT_FIELD_DEP(self, name, 2);                                                                                      \
+    using lock_field = name
+
+/// Same as BIT_FIELD_LOCK_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_LOCK(name) \
+    BIT_FIELD_LOCK_DEP(, name)
+
+/// Define a reader-writer lock field of num_bits bits: a writer bit, a waiters bit, and a count of readers in the
+/// remaining num_bits - 2 bits, which limits the number of simultaneous readers. An atomic_layout of the layout can
+/// then be locked like a std::shared_mutex. A layout may have at most one lock field. The parameters and the symbols
+/// created are the same as for BIT_FIELD_DEP, and in addition:
+///     shared_lock_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_SHARED_LOCK_DEP(self, name, num_bits)                                                                \
+    static_assert(num_bits >= 3, "A shared lock needs a writer bit, a waiters bit, and at least one reader bit.");     \
+    BIT_FIELD_DEP(self, name, num_bits);                                                                               \
+    using shared_lock_field = name
+
+/// Same as BIT_FIELD_SHARED_LOCK_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_SHARED_LOCK(name, num_bits) \
+    BIT_FIELD_SHARED_LOCK_DEP(, name, num_bits)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ATOMIC_LAYOUT_HPP
+/// Records whose fields are split by writer across cache lines, to avoid false sharing between concurrent writers.
+#ifndef PARTITIONED_RECORD_HPP
+#define PARTITIONED_RECORD_HPP
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// The fields of a partitioned_record written by one thread, or one group of threads.
+///
+/// @tparam TFields The fields, such as "layout::name" for fields defined with BIT_FIELD.
+template <typename... TFields>
+struct domain {
+    /// True if the field belongs to this domain.
+    template <typename TField>
+    static constexpr bool contains = (std::is_same_v<TField, TFields> || ...);
+
+    /// The bits of every field of this domain within a value of type T.
+    template <typename T>
+    static constexpr T mask = (T{0} | ... | bit_mask<T, TFields::offset, TFields::bits>);
+};
+
+namespace detail {
+
+template <typename T>
+constexpr bool is_domain = false;
+
+template <typename... TFields>
+constexpr bool is_domain<domain<TFields...>> = true;
+
+} // End namespace detail.
+
+/// A record with one logical layout whose fields are divided among writer domains. Each domain's fields are stored in
+/// their own atomic_layout<TLayout>, at their usual offsets, on their own cache line, so that writers in different
+/// domains never contend for the same line. Fields are read and written by name, as with atomic_layout, and each
+/// access goes to the word of the domain owning the field:
+///
+///     bf::partitioned_record<queue_state, bf::domain<queue_state::head, queue_state::closed>,
+///                            bf::domain<queue_state::tail, queue_state::waiting>> queue;
+///     queue.set<queue_state::head>(head);
+///
+/// snapshot reassembles a TLayout from the fields of every domain. Fields which belong to no domain read as zero.
+///
+/// If the layout has a version field (see BIT_FIELD_VERSION), it belongs to no domain: each domain's word keeps its
+/// own version, incremented by every update of that word, and snapshot uses them to tell when a domain changed and
+/// changed back. The version field of a snapshot is zero. Lock fields are not supported, since there is no single
+/// word for them to lock.
+///
+/// @tparam TLayout  The logical layout, derived from bit_field_builder.
+/// @tparam TDomains The writer domains, each a domain<...> of fields of TLayout. A field may belong to one domain.
+template <bit_field_layout TLayout, typename... TDomains>
+    requires (sizeof...(TDomains) > 0 && (detail::is_domain<TDomains> && ...))
+class partitioned_record {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// The number of writer domains.
+    static constexpr std::size_t domain_count = sizeof...(TDomains);
+
+    /// The bits of the fields of each domain.
+    static constexpr std::array<value_type, domain_count> domain_masks{ TDomains::template mask<value_type>... };
+
+    /// The index of the domain owning a field. The field must belong to exactly one domain.
+    template <typename TField>
+        requires ((TDomains::template contains<TField> + ...) == 1)
+    static constexpr std::size_t domain_index = []() constexpr {
+        std::size_t index = 0;
+        std::size_t i = 0;
+        ((TDomains::template contains<TField> ? (index = i, ++i) : ++i), ...);
+        return index;
+    }();
+
+    /// Whether every operation is lock free on this platform.
+    static constexpr bool is_always_lock_free = atomic_layout<TLayout>::is_always_lock_free;
+
+    static_assert(!atomic_layout<TLayout>::has_lock && !atomic_layout<TLayout>::has_shared_lock,
+                  "A partitioned record has no single word for a lock field to lock.");
+    static_assert([]() constexpr {
+        for (std::size_t i = 0; i < domain_count; ++i) {
+            for (std::size_t j = i + 1; j < domain_count; ++j) {
+                if ((domain_masks[i] & domain_masks[j]) != 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(), "Each field may belong to only one domain.");
+    static_assert([]() constexpr {
+        if constexpr (versioned_layout<TLayout>) {
+            return !(TDomains::template contains<typename TLayout::version_field> || ...);
+        } else {
+            return true;
+        }
+    }(), "The version field is kept separately in every domain's word and cannot belong to a domain.");
+
+    /// Construct with every field zero.
+    constexpr partitioned_record() noexcept = default;
+
+    partitioned_record(const partitioned_record&) = delete;
+    partitioned_record& operator=(const partitioned_record&) = delete;
+
+    /// Atomically load a single field from its domain. See atomic_layout::get.
+    template <typename TField, auto TConfig = bit_field_config{}>
+    auto get(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return slots_[domain_index<TField>].word.template get<TField, TConfig>(order);
+    }
+
+    /// Atomically set one or more fields of the same domain. See atomic_layout::set.
+    ///
+    /// @returns The domain's fields as they were immediately before the update, with every other field zero.
+    template <typename TField, typename... TFields>
+    TLayout set(const auto... values) noexcept requires (sizeof...(values) == 1 + sizeof...(TFields)) {
+        constexpr std::size_t index = domain_index<TField>;
+        static_assert(((domain_index<TFields> == index) && ...), "Fields set together must belong to one domain.");
+        return only(index, slots_[index].word.template set<TField, TFields...>(values...));
+    }
+
+    /// Atomically apply an arbitrary update to the fields of one domain. See atomic_layout::modify. The function is
+    /// called with a TLayout holding the domain's current fields, with every other field zero, and changes it makes to
+    /// fields outside the domain are discarded.
+    ///
+    /// @tparam NDomain The index of the domain, such as domain_index<layout::name> for a field of the domain.
+    ///
+    /// @returns The domain's fields as they were immediately before the update, with every other field zero.
+    template <std::size_t NDomain>
+        requires (NDomain < domain_count)
+    TLayout modify(auto&& fn) noexcept(noexcept(fn(std::declval<TLayout&>()))) {
+        // The other bits of the word are zero, but for the version, which atomic_layout replaces anyway.
+        const TLayout previous = slots_[NDomain].word.modify([&](TLayout& value) {
+            value = only(NDomain, value);
+            if constexpr (std::is_same_v<decltype(fn(value)), bool>) {
+                const bool result = fn(value);
+                value = only(NDomain, value);
+                return result;
+            } else {
+                fn(value);
+                value = only(NDomain, value);
+            }
+        });
+        return only(NDomain, previous);
+    }
+
+    /// Take a consistent snapshot of every field. The domains' words are read repeatedly until two passes in a row
+    /// agree, which means there was an instant between them at which every domain held the returned value. This is
+    /// lock free but not wait free: a reader can be held off indefinitely by writers which never pause.
+    ///
+    /// If a domain's value can change and then change back between two passes, the passes may agree on a state which
+    /// never existed as a whole. Giving the layout a version field (see BIT_FIELD_VERSION) rules this out.
+    ///
+    /// @returns The fields of every domain, as one layout.
+    TLayout snapshot() const noexcept {
+        constexpr auto indices = std::make_index_sequence<domain_count>{};
+        std::array<value_type, domain_count> previous = collect(indices);
+        if constexpr (domain_count > 1) {
+            for (std::array<value_type, domain_count> current = collect(indices); current != previous;
+                 current = collect(indices)) {
+                previous = current;
+            }
+        }
+        return merge(previous, indices);
+    }
+
+private:
+    /// One domain's word, alone on its cache line.
+    struct alignas(BIT_FIELD_CACHE_LINE_SIZE) slot {
+        atomic_layout<TLayout> word;
+    };
+
+    /// Keep only the fields of one domain.
+    static constexpr TLayout only(const std::size_t index, TLayout layout) noexcept {
+        layout.raw_value = static_cast<value_type>(layout.raw_value & domain_masks[index]);
+        return layout;
+    }
+
+    template <std::size_t... NIndices>
+    std::array<value_type, domain_count> collect(std::index_sequence<NIndices...>) const noexcept {
+        return { slots_[NIndices].word.load(std::memory_order_acquire).raw_value... };
+    }
+
+    /// Combine the fields of every domain's word into one layout.
+    template <std::size_t... NIndices>
+    static constexpr TLayout merge(const std::array<value_type, domain_count>& words,
+                                   std::index_sequence<NIndices...>) noexcept {
+        TLayout result{};
+        result.raw_value = static_cast<value_type>((value_type{0} | ... | (words[NIndices] & domain_masks[NIndices])));
+        return result;
+    }
+
+    std::array<slot, domain_count> slots_{};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // PARTITIONED_RECORD_HPP
+/// Packed statistics counters sharded per thread, updated without atomic read-modify-writes and summed on read.
+#ifndef SHARDED_COUNTERS_HPP
+#define SHARDED_COUNTERS_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Hands out small integers identifying threads. A thread's index is returned to the pool when the thread exits, and
+/// the smallest free index is always handed out first, so that a program's live threads keep to the lowest indexes.
+class thread_index_pool {
+public:
+    std::size_t acquire() {
+        const std::lock_guard<std::mutex> lock{ mutex_ };
+        if (free_.empty()) {
+            return next_++;
+        }
+        const auto smallest = std::min_element(free_.begin(), free_.end());
+        const std::size_t index = *smallest;
+        free_.erase(smallest);
+        return index;
+    }
+
+    void release(const std::size_t index) {
+        const std::lock_guard<std::mutex> lock{ mutex_ };
+        free_.push_back(index);
+    }
+
+    static thread_index_pool& instance() {
+        static thread_index_pool pool;
+        return pool;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::size_t> free_;
+    std::size_t next_{0};
+};
+
+/// Holds the calling thread's index for as long as the thread runs.
+struct thread_index_holder {
+    thread_index_holder() : pool(thread_index_pool::instance()), index(pool.acquire()) {
+    }
+
+    ~thread_index_holder() {
+        pool.release(index);
+    }
+
+    thread_index_holder(const thread_index_holder&) = delete;
+    thread_index_holder& operator=(const thread_index_holder&) = delete;
+
+    thread_index_pool& pool;
+    const std::size_t index;
+};
+
+/// A small integer identifying the calling thread. No two running threads have the same index.
+inline std::size_t thread_index() {
+    thread_local const thread_index_holder holder;
+    return holder.index;
+}
+
+} // End namespace detail.
+
+/// A bit_field_builder layout of counters, such as a subsystem's statistics, with a private copy (a shard) for each of
+/// NShards threads and one shared shard for any others. Each shard is on its own cache line. Threads are given small
+/// indexes which are reused when they exit, and a thread whose index is below NShards uses that shard.
+///
+/// A thread with its own shard adds to a field with a plain load, add, and store; no atomic read-modify-write is
+/// needed because nothing else writes that shard. Each field in a shard is kept below 2^(bits - headroom_bits), and
+/// when an add would reach that limit the field's value is moved into a 64-bit accumulator for the field instead. This
+/// leaves enough headroom in every field that the words of all of the shards can be summed with ordinary integer adds,
+/// which add every field at once without any carry crossing into the next field (a SWAR add.) A read is then one add
+/// per shard for the whole layout, plus the accumulators of the fields being read.
+///
+/// Reads taken while other threads are adding are approximate: an add which is moving a field into its accumulator
+/// may be missed or counted twice. Once the writers are quiet, reads are exact.
+///
+/// @tparam TLayout The layout. Its storage must be an unsigned integer of at most 64 bits.
+/// @tparam NShards The number of threads which get a shard of their own.
+template <bit_field_layout TLayout, std::size_t NShards = 16>
+    requires (NShards > 0 && std::is_unsigned_v<typename TLayout::value_type> &&
+              sizeof(typename TLayout::value_type) <= sizeof(std::uint64_t))
+class sharded_counters {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// The number of shards, including the one shared by threads without a shard of their own.
+    static constexpr std::size_t shard_count = NShards + 1;
+
+    /// The number of high bits of each field kept clear in every shard so that the shards can be summed.
+    static constexpr unsigned headroom_bits = static_cast<unsigned>(std::bit_width(shard_count - 1));
+
+    constexpr sharded_counters() noexcept = default;
+
+    sharded_counters(const sharded_counters&) = delete;
+    sharded_counters& operator=(const sharded_counters&) = delete;
+
+    /// Add to a field in the calling thread's shard.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param amount The amount to add.
+    template <typename TField>
+    void add(const std::uint64_t amount = 1) {
+        add_at<TField>(detail::thread_index(), amount);
+    }
+
+    /// Add to a field in a particular shard, for callers which already have a small, unique worker index.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param worker The index of the calling worker. Workers from 0 to NShards - 1 must each be used by only one
+    ///               thread at a time. Larger indexes use the shared shard.
+    /// @param amount The amount to add.
+    template <typename TField>
+    void add_at(const std::size_t worker, const std::uint64_t amount = 1) noexcept {
+        static_assert(TField::bits > headroom_bits, "The field is too narrow to sum this many shards.");
+        constexpr std::uint64_t limit = std::uint64_t{1} << (TField::bits - headroom_bits);
+
+        if (worker < NShards) {
+            shard& owned = shards_[worker];
+            value_type word = owned.word.load(std::memory_order_relaxed);
+            std::uint64_t sum = TField::template get<count_config>(word) + amount;
+            if (sum >= limit) {
+                std::atomic<std::uint64_t>& overflow = owned.accumulators[TField::offset];
+                overflow.store(overflow.load(std::memory_order_relaxed) + sum, std::memory_order_relaxed);
+                sum = 0;
+            }
+            TField::template set<store_config>(word, static_cast<value_type>(sum));
+            owned.word.store(word, std::memory_order_relaxed);
+        } else {
+            shard& shared = shards_[NShards];
+            value_type word = shared.word.load(std::memory_order_relaxed);
+            value_type desired{};
+            std::uint64_t sum = 0;
+            do {
+                desired = word;
+                sum = TField::template get<count_config>(word) + amount;
+                TField::template set<store_config>(desired, static_cast<value_type>(sum >= limit ? 0 : sum));
+            } while (!shared.word.compare_exchange_weak(word, desired, std::memory_order_relaxed));
+            if (sum >= limit) {
+                shared.accumulators[TField::offset].fetch_add(sum, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Read the total of one field across every shard.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @returns The total.
+    template <typename TField>
+    std::uint64_t read() const noexcept {
+        return read_all<TField>()[0];
+    }
+
+    /// Read the totals of several fields across every shard, summing the shards' words only once.
+    ///
+    /// @tparam TFields The fields.
+    ///
+    /// @returns The total of each field, in the same order as TFields.
+    template <typename... TFields>
+        requires (sizeof...(TFields) > 0)
+    std::array<std::uint64_t, sizeof...(TFields)> read_all() const noexcept {
+        static_assert(((TFields::bits > headroom_bits) && ...), "A field is too narrow to sum this many shards.");
+        std::uint64_t words = 0;
+        for (const shard& each : shards_) {
+            words += each.word.load(std::memory_order_relaxed);
+        }
+        std::array<std::uint64_t, sizeof...(TFields)> totals{
+            TFields::template get<count_config>(static_cast<value_type>(words))...
+        };
+        std::size_t i = 0;
+        ((totals[i++] += accumulated(TFields::offset)), ...);
+        return totals;
+    }
+
+private:
+    static constexpr auto count_config = bit_field_config<std::uint64_t>{};
+    static constexpr auto store_config = bit_field_config{ .strategy = bit_field_assignment_strategy::unchecked };
+
+    /// One thread's copy of the layout, and an accumulator for each bit offset at which a field may start.
+    struct alignas(BIT_FIELD_CACHE_LINE_SIZE) shard {
+        std::atomic<value_type> word{0};
+        std::array<std::atomic<std::uint64_t>, bits<value_type>> accumulators{};
+    };
+
+    std::uint64_t accumulated(const std::size_t offset) const noexcept {
+        std::uint64_t total = 0;
+        for (const shard& each : shards_) {
+            total += each.accumulators[offset].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::array<shard, shard_count> shards_{};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // SHARDED_COUNTERS_HPP
+/// Finding which fields differ between two values of a layout, and copying just those fields.
+#ifndef LAYOUT_DIFF_HPP
+#define LAYOUT_DIFF_HPP
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#if defined(__BMI2__)
+#  include <immintrin.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// The fields of a bit_field_builder layout, recovered at compile time from the layout's bit counter. Every BIT_FIELD
+/// (and every other macro which allocates bits) leaves a mark where it ends, so the boundaries between fields can be
+/// found without naming the fields. Padding counts as a field here: it has an index, and changes to it are reported.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+template <bit_field_layout TLayout>
+struct layout_fields {
+    using value_type = typename TLayout::value_type;
+
+private:
+    static constexpr unsigned width = TLayout::allocated_bits();
+
+    /// Returns true if a field ends at bit NEnd.
+    template <unsigned NEnd>
+    static constexpr bool ends_at() noexcept {
+        if constexpr (requires { TLayout::count(counter<NEnd>{}); }) {
+            return decltype(TLayout::count(counter<NEnd>{}))::value == NEnd;
+        } else {
+            return false;
+        }
+    }
+
+    template <unsigned... NEnds>
+    static constexpr std::size_t count_ends(std::integer_sequence<unsigned, NEnds...>) noexcept {
+        return (std::size_t{0} + ... + (ends_at<NEnds + 1>() ? 1 : 0));
+    }
+
+public:
+    /// The number of fields, including padding.
+    static constexpr std::size_t count = count_ends(std::make_integer_sequence<unsigned, width>{});
+
+    static_assert(count <= 64, "Layouts with more than 64 fields are not supported.");
+
+    /// A bitmask with one bit per field, where bit i stands for the field at index i.
+    using mask_type = detail::uint_least_t<(count > 0 ? count : 1)>;
+
+    /// The offset of each field, in increasing order. The field at index i occupies bits offsets[i] up to, but not
+    /// including, offsets[i + 1], or the end of the allocated bits for the last field.
+    static constexpr std::array<unsigned, count> offsets = []() constexpr {
+        std::array<unsigned, count> result{};
+        std::size_t i = 0;
+        unsigned start = 0;
+        [&]<unsigned... NEnds>(std::integer_sequence<unsigned, NEnds...>) constexpr {
+            ((ends_at<NEnds + 1>() ? (result[i++] = start, start = NEnds + 1, 0) : 0), ...);
+        }(std::make_integer_sequence<unsigned, width>{});
+        return result;
+    }();
+
+    /// The width of the field at an index.
+    static constexpr unsigned width_of(const std::size_t index) noexcept {
+        return (index + 1 < count ? offsets[index + 1] : width) - offsets[index];
+    }
+
+    /// The index of a field, given its type, such as "layout::name" for a field defined with BIT_FIELD.
+    template <typename TField>
+    static constexpr std::size_t index_of = []() constexpr {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (offsets[i] == TField::offset) {
+                return i;
+            }
+        }
+        return count;
+    }();
+
+    /// The bit standing for a field in a mask_type.
+    template <typename TField>
+        requires (index_of<TField> < count)
+    static constexpr mask_type bit = static_cast<mask_type>(mask_type{1} << index_of<TField>);
+
+    /// The lowest bit of every field.
+    static constexpr value_type low_bits = []() constexpr {
+        value_type result{0};
+        for (std::size_t i = 0; i < count; ++i) {
+            result = static_cast<value_type>(result | static_cast<value_type>(value_type{1} << offsets[i]));
+        }
+        return result;
+    }();
+
+    /// The highest bit of every field.
+    static constexpr value_type high_bits = []() constexpr {
+        value_type result{0};
+        for (std::size_t i = 0; i < count; ++i) {
+            const unsigned top = offsets[i] + width_of(i) - 1;
+            result = static_cast<value_type>(result | static_cast<value_type>(value_type{1} << top));
+        }
+        return result;
+    }();
+
+    /// Every allocated bit.
+    static constexpr value_type allocated = bit_mask<value_type, 0, width>;
+};
+
+/// A hash identifying the shape of a layout: its storage size and the offset of every field (see layout_fields.) Two
+/// programs built with different versions of a layout get different hashes, unless the change only renamed fields or
+/// changed their configured types.
+///
+/// @tparam TLayout The layout type.
+/// @tparam NTag    A value mixed into the hash, such as a schema version, to tell apart layouts of the same shape.
+template <bit_field_layout TLayout, std::uint64_t NTag = 0>
+constexpr std::uint64_t layout_hash = []() constexpr {
+    // 64-bit FNV-1a over the words describing the layout.
+    std::uint64_t hash = 0xCBF2'9CE4'8422'2325u;
+    const auto mix = [&hash](const std::uint64_t value) constexpr {
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 0x0000'0100'0000'01B3u;
+        }
+    };
+    mix(NTag);
+    mix(sizeof(typename TLayout::value_type));
+    mix(TLayout::allocated_bits());
+    for (const unsigned offset : layout_fields<TLayout>::offsets) {
+        mix(offset);
+    }
+    return hash;
+}();
+
+namespace detail {
+
+/// Gather the bits of value selected by a compile-time mask into the low bits of the result, like pext.
+template <typename T, typename TResult, T TMask>
+constexpr TResult gather_bits(const T value) noexcept {
+#if defined(__BMI2__)
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        if (!std::is_constant_evaluated()) {
+            return static_cast<TResult>(
+                _pext_u64(static_cast<std::uint64_t>(value), static_cast<std::uint64_t>(TMask)));
+        }
+    }
+#endif
+    TResult result{0};
+    T mask = TMask;
+    for (unsigned i = 0; mask != 0; ++i) {
+        const T lowest = static_cast<T>(mask & (~mask + 1));
+        if ((value & lowest) != 0) {
+            result = static_cast<TResult>(result | static_cast<TResult>(TResult{1} << i));
+        }
+        mask = static_cast<T>(mask & ~lowest);
+    }
+    return result;
+}
+
+/// Scatter the low bits of value to the positions of the bits set in a compile-time mask, like pdep.
+template <typename T, T TMask>
+constexpr T scatter_bits(const auto value) noexcept {
+#if defined(__BMI2__)
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        if (!std::is_constant_evaluated()) {
+            return static_cast<T>(_pdep_u64(static_cast<std::uint64_t>(value), static_cast<std::uint64_t>(TMask)));
+        }
+    }
+#endif
+    T result{0};
+    T mask = TMask;
+    for (unsigned i = 0; mask != 0; ++i) {
+        const T lowest = static_cast<T>(mask & (~mask + 1));
+        if (((value >> i) & 1) != 0) {
+            result = static_cast<T>(result | lowest);
+        }
+        mask = static_cast<T>(mask & ~lowest);
+    }
+    return result;
+}
+
+} // End namespace detail.
+
+/// Find which fields differ between two raw values of a layout. The values are compared with one XOR. Then each field
+/// of the difference is reduced to its highest bit in parallel: adding all ones below the highest bit of each field
+/// carries into that bit exactly when some lower bit is set, and never carries out of the field. Finally the highest
+/// bits are gathered into the mask with one pext on processors with BMI2, or a loop over the fields otherwise.
+///
+/// @tparam TLayout The layout type.
+///
+/// @param old_value The raw value before.
+/// @param new_value The raw value after.
+///
+/// @returns A mask with bit i set if the field at index i differs. See layout_fields.
+template <bit_field_layout TLayout>
+constexpr typename layout_fields<TLayout>::mask_type changed_fields(const typename TLayout::value_type old_value,
+                                                                    const typename TLayout::value_type new_value) {
+    using fields = layout_fields<TLayout>;
+    using value_type = typename fields::value_type;
+    constexpr value_type below_high = static_cast<value_type>(fields::allocated & ~fields::high_bits);
+
+    const auto difference = static_cast<value_type>(old_value ^ new_value);
+    const auto reduced = static_cast<value_type>(
+        static_cast<value_type>(static_cast<value_type>(difference & below_high) + below_high) | difference);
+    return detail::gather_bits<value_type, typename fields::mask_type, fields::high_bits>(reduced);
+}
+
+/// Find which fields differ between two values of a layout. See the overload taking raw values.
+template <bit_field_layout TLayout>
+constexpr typename layout_fields<TLayout>::mask_type changed_fields(const TLayout& old_value,
+                                                                    const TLayout& new_value) {
+    return changed_fields<TLayout>(old_value.raw_value, new_value.raw_value);
+}
+
+/// Find which fields differ in each pair of records of two equally sized arrays, such as two snapshots of a table.
+///
+/// @param old_values The records before.
+/// @param new_values The records after. Must be the same size as old_values.
+/// @param changes    Receives the mask of changed fields of each record. Must be at least as large as old_values.
+///
+/// @returns The number of records with at least one changed field.
+template <bit_field_layout TLayout>
+constexpr std::size_t changed_fields(const std::span<const TLayout> old_values,
+                                     const std::span<const TLayout> new_values,
+                                     const std::span<typename layout_fields<TLayout>::mask_type> changes) {
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < old_values.size(); ++i) {
+        changes[i] = changed_fields<TLayout>(old_values[i].raw_value, new_values[i].raw_value);
+        changed += changes[i] != 0 ? std::size_t{1} : std::size_t{0};
+    }
+    return changed;
+}
+
+/// Copy the selected fields of one value of a layout into another. The mask is expanded to cover whole fields by
+/// placing its bits at the lowest and highest bits of their fields (one pdep each with BMI2) and subtracting.
+///
+/// @param target  The value to update.
+/// @param source  The value to copy the fields from, such as the new value given to changed_fields.
+/// @param changes A mask with bit i set for each field index i to copy, such as the result of changed_fields.
+template <bit_field_layout TLayout>
+constexpr void apply_patch(TLayout& target, const TLayout& source,
+                           const typename layout_fields<TLayout>::mask_type changes) {
+    using fields = layout_fields<TLayout>;
+    using value_type = typename fields::value_type;
+
+    const value_type low = detail::scatter_bits<value_type, fields::low_bits>(changes);
+    const value_type high = detail::scatter_bits<value_type, fields::high_bits>(changes);
+    const auto mask = static_cast<value_type>(static_cast<value_type>(high - low) | high);
+    target.raw_value = static_cast<value_type>((target.raw_value & ~mask) | (source.raw_value & mask));
+}
+
+/// Copy the selected fields of each record of one array into the matching record of another.
+///
+/// @param targets The records to update.
+/// @param sources The records to copy fields from. Must be the same size as targets.
+/// @param changes The mask of fields to copy for each record. Must be the same size as targets.
+template <bit_field_layout TLayout>
+constexpr void apply_patch(const std::span<TLayout> targets, const std::span<const TLayout> sources,
+                           const std::span<const typename layout_fields<TLayout>::mask_type> changes) {
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (changes[i] != 0) {
+            apply_patch(targets[i], sources[i], changes[i]);
+        }
+    }
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_DIFF_HPP
+/// Arrays of small integer elements packed into atomic words, with atomic updates of individual elements.
+#ifndef CONCURRENT_PACKED_ARRAY_HPP
+#define CONCURRENT_PACKED_ARRAY_HPP
+
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// An array of NBits-bit unsigned elements packed into atomic words, which many threads may update at once, such as
+/// the visited states of a parallel breadth-first search or per-object reference tags. Elements never span two words:
+/// each word holds bits<TWord> / NBits whole elements, and any bits left over are unused.
+///
+/// Every update of an element is atomic and leaves the other elements of its word untouched. fetch_or and fetch_and
+/// are single atomic instructions on the word (lock or / lock and on x86-64), and test_and_set of a 1-bit element is a
+/// lock bts. Everything else is a compare-and-swap loop on the containing word, which only retries when another
+/// thread changed some element of the same word in between.
+///
+/// @tparam NBits The number of bits in an element.
+/// @tparam TWord The unsigned integer type of the words the elements are packed into.
+template <std::size_t NBits, std::unsigned_integral TWord = std::uint64_t>
+    requires (NBits > 0 && NBits <= bits<TWord>)
+class concurrent_packed_array {
+public:
+    using value_type = detail::uint_least_t<NBits>;
+    using word_type = TWord;
+
+    /// The number of bits in an element.
+    static constexpr std::size_t element_bits = NBits;
+
+    /// The number of elements in each word.
+    static constexpr std::size_t elements_per_word = bits<TWord> / NBits;
+
+    /// The largest value an element can hold.
+    static constexpr value_type max_value = static_cast<value_type>(bit_mask<TWord, 0, NBits>);
+
+    /// Returns the number of words needed to hold a number of elements.
+    static constexpr std::size_t words_for(const std::size_t size) noexcept {
+        return (size + elements_per_word - 1) / elements_per_word;
+    }
+
+    /// Construct an array with every element zero.
+    ///
+    /// @param size The number of elements.
+    explicit concurrent_packed_array(const std::size_t size)
+        : words_(std::make_unique<std::atomic<TWord>[]>(words_for(size))), size_(size) {
+    }
+
+    concurrent_packed_array(const concurrent_packed_array&) = delete;
+    concurrent_packed_array& operator=(const concurrent_packed_array&) = delete;
+
+    /// The number of elements.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Atomically load an element.
+    ///
+    /// @param index The index of the element. Not bounds checked.
+    /// @param order The memory order of the load.
+    value_type load(const std::size_t index, const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return extract(words_[word_index(index)].load(order), shift(index));
+    }
+
+    /// Atomically replace an element. Bits of the value above NBits are ignored.
+    ///
+    /// @param index The index of the element.
+    /// @param value The new value.
+    /// @param order The memory order of the update.
+    void store(const std::size_t index, const value_type value,
+               const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        exchange(index, value, order);
+    }
+
+    /// Atomically replace an element. Bits of the value above NBits are ignored.
+    ///
+    /// @returns The previous value of the element.
+    value_type exchange(const std::size_t index, const value_type value,
+                        const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](value_type) { return value; });
+    }
+
+    /// Atomically add to an element, wrapping around within its NBits bits.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_add(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](const value_type old) { return static_cast<value_type>(old + value); });
+    }
+
+    /// Atomically subtract from an element, wrapping around within its NBits bits.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_sub(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](const value_type old) { return static_cast<value_type>(old - value); });
+    }
+
+    /// Atomically OR bits into an element with a single atomic OR of the word.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_or(const std::size_t index, const value_type value,
+                        const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        return extract(words_[word_index(index)].fetch_or(place(value, offset), order), offset);
+    }
+
+    /// Atomically AND bits into an element with a single atomic AND of the word.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_and(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        const auto keep = static_cast<TWord>(~place(static_cast<value_type>(~value), offset));
+        return extract(words_[word_index(index)].fetch_and(keep, order), offset);
+    }
+
+    /// Atomically set a 1-bit element, as when marking a vertex visited.
+    ///
+    /// @returns True if the element was already set.
+    bool test_and_set(const std::size_t index, const std::memory_order order = std::memory_order_seq_cst) noexcept
+            requires (NBits == 1) {
+        const TWord bit = static_cast<TWord>(TWord{1} << shift(index));
+        return (words_[word_index(index)].fetch_or(bit, order) & bit) != 0;
+    }
+
+    /// Atomically replace an element if it holds an expected value.
+    ///
+    /// @param index    The index of the element.
+    /// @param expected The expected value. Updated with the current value on failure.
+    /// @param desired  The new value. Bits above NBits are ignored.
+    /// @param order    The memory order on success.
+    ///
+    /// @returns True if the element was replaced. Never fails because a different element of the word changed.
+    bool compare_exchange(const std::size_t index, value_type& expected, const value_type desired,
+                          const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        std::atomic<TWord>& word = words_[word_index(index)];
+        TWord current = word.load(std::memory_order_relaxed);
+        while (extract(current, offset) == static_cast<value_type>(expected & max_value)) {
+            const auto replaced = static_cast<TWord>((current & ~place(max_value, offset)) | place(desired, offset));
+            if (word.compare_exchange_weak(current, replaced, order, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        expected = extract(current, offset);
+        return false;
+    }
+
+    /// Atomically apply an arbitrary function to an element.
+    ///
+    /// @param index The index of the element.
+    /// @param fn    Called with the current value, returning the new value. Called again whenever another thread
+    ///              changes the word first, so it should have no side effects.
+    /// @param order The memory order of the update.
+    ///
+    /// @returns The previous value of the element.
+    value_type update(const std::size_t index, const std::memory_order order, auto&& fn) noexcept(noexcept(fn(0))) {
+        const unsigned offset = shift(index);
+        std::atomic<TWord>& word = words_[word_index(index)];
+        TWord current = word.load(std::memory_order_relaxed);
+        while (true) {
+            const value_type old = extract(current, offset);
+            const auto value = static_cast<value_type>(fn(old));
+            const auto replaced = static_cast<TWord>((current & ~place(max_value, offset)) | place(value, offset));
+            if (word.compare_exchange_weak(current, replaced, order, std::memory_order_relaxed)) {
+                return old;
+            }
+        }
+    }
+
+    /// The words holding the elements, for bulk scans such as counting the set elements of a bitmap.
+    std::span<std::atomic<TWord>> words() noexcept {
+        return { words_.get(), words_for(size_) };
+    }
+
+    std::span<const std::atomic<TWord>> words() const noexcept {
+        return { words_.get(), words_for(size_) };
+    }
+
+private:
+    static constexpr std::size_t word_index(const std::size_t index) noexcept {
+        return index / elements_per_word;
+    }
+
+    static constexpr unsigned shift(const std::size_t index) noexcept {
+        return static_cast<unsigned>(index % elements_per_word * NBits);
+    }
+
+    static constexpr value_type extract(const TWord word, const unsigned offset) noexcept {
+        return static_cast<value_type>((word >> offset) & bit_mask<TWord, 0, NBits>);
+    }
+
+    static constexpr TWord place(const value_type value, const unsigned offset) noexcept {
+        return static_cast<TWord>((static_cast<TWord>(value) & bit_mask<TWord, 0, NBits>) << offset);
+    }
+
+    std::unique_ptr<std::atomic<TWord>[]> words_;
+    std::size_t size_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CONCURRENT_PACKED_ARRAY_HPP
+/// Tables of atomic layout records placed in memory shared between processes.
+#ifndef STATUS_BOARD_HPP
+#define STATUS_BOARD_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define BIT_FIELD_HAS_POSIX_SHARED_MEMORY 1
+#else
+#  define BIT_FIELD_HAS_POSIX_SHARED_MEMORY 0
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Why a block of memory could not be attached as a status_board.
+enum class status_board_error {
+    none,            ///< The board is valid.
+    too_small,       ///< The memory is too small for the header, or for the records the header describes.
+    not_initialized, ///< No board has been created in the memory yet.
+    layout_mismatch, ///< The board was created for a different layout, record count, or cache line size.
+};
+
+/// A table of atomic layout records, one per worker for example, in a block of memory which may be shared between
+/// processes, such as a mapping from shared_memory. Readers in other processes see each record change with ordinary
+/// atomic loads instead of polling each worker over a socket.
+///
+/// The memory starts with a header holding a magic number, the layout_hash of the layout, the number of records, and
+/// the distance between records, followed by the records. Records are found by their offset from the start of the
+/// memory, so the memory may be mapped at a different address in every process. Each record is an atomic_layout on its
+/// own cache line, so workers updating their own records do not slow each other down, and updates are lock free.
+///
+/// The board itself is only a view of the memory, and may be copied freely.
+///
+/// @tparam TLayout The layout of a record. Its atomic_layout must be lock free, since a lock could not be shared
+///                 between processes.
+/// @tparam NTag    Mixed into the layout hash. See layout_hash.
+template <bit_field_layout TLayout, std::uint64_t NTag = 0>
+class status_board {
+public:
+    using record_type = atomic_layout<TLayout>;
+
+    static_assert(record_type::is_always_lock_free, "Shared records must be lock free.");
+
+    /// The hash stored in the header, which attaching processes must match.
+    static constexpr std::uint64_t hash = layout_hash<TLayout, NTag>;
+
+    /// The distance in bytes between consecutive records, and the size of the header.
+    static constexpr std::size_t stride = (sizeof(record_type) + BIT_FIELD_CACHE_LINE_SIZE - 1) /
+                                          BIT_FIELD_CACHE_LINE_SIZE * BIT_FIELD_CACHE_LINE_SIZE;
+
+    /// The number of bytes of memory needed for a board with a number of records.
+    static constexpr std::size_t bytes_for(const std::size_t records) noexcept {
+        return header_size + records * stride;
+    }
+
+    /// Create a board in a block of memory, with every record zero. No other process may use the memory until this
+    /// returns, after which they may attach to it.
+    ///
+    /// @param memory  The memory. Must be aligned to BIT_FIELD_CACHE_LINE_SIZE, as memory from mmap is.
+    /// @param records The number of records.
+    ///
+    /// @returns The board, or an empty optional if the memory is too small.
+    static std::optional<status_board> create(const std::span<std::byte> memory, const std::size_t records) noexcept {
+        if (!fits(memory, records)) {
+            return std::nullopt;
+        }
+        header* const head = ::new (memory.data()) header{};
+        head->layout_hash = hash;
+        head->record_count = records;
+        head->record_stride = stride;
+        for (std::size_t i = 0; i < records; ++i) {
+            ::new (memory.data() + header_size + i * stride) record_type{};
+        }
+        head->magic.store(magic, std::memory_order_release);
+        return status_board{ memory.data(), records };
+    }
+
+    /// Check whether a block of memory holds a board created for this layout.
+    ///
+    /// @param memory The memory.
+    ///
+    /// @returns Why the memory cannot be attached, or status_board_error::none if it can.
+    static status_board_error check(const std::span<std::byte> memory) noexcept {
+        if (memory.size() < header_size) {
+            return status_board_error::too_small;
+        }
+        const header* const head = std::launder(reinterpret_cast<const header*>(memory.data()));
+        if (head->magic.load(std::memory_order_acquire) != magic) {
+            return status_board_error::not_initialized;
+        }
+        if (head->layout_hash != hash || head->record_stride != stride) {
+            return status_board_error::layout_mismatch;
+        }
+        // The count comes from shared memory, so it is compared without computing bytes_for, which could overflow.
+        if (!fits(memory, head->record_count)) {
+            return status_board_error::too_small;
+        }
+        return status_board_error::none;
+    }
+
+    /// Attach to a board created in a block of memory, possibly by another process.
+    ///
+    /// @param memory The memory.
+    ///
+    /// @returns The board, or an empty optional if check reports an error.
+    static std::optional<status_board> attach(const std::span<std::byte> memory) noexcept {
+        if (check(memory) != status_board_error::none) {
+            return std::nullopt;
+        }
+        const header* const head = std::launder(reinterpret_cast<const header*>(memory.data()));
+        return status_board{ memory.data(), static_cast<std::size_t>(head->record_count) };
+    }
+
+    /// The number of records.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Access a record, to get, set, or modify its fields atomically.
+    ///
+    /// @param index The index of the record. Not bounds checked.
+    record_type& operator[](const std::size_t index) const noexcept {
+        return *std::launder(reinterpret_cast<record_type*>(base_ + header_size + index * stride));
+    }
+
+    /// Load every record. Each record is loaded atomically, but records may change while the others are loaded.
+    ///
+    /// @param output Receives the records. Must be at least size() records long.
+    void snapshot(const std::span<TLayout> output,
+                  const std::memory_order order = std::memory_order_acquire) const noexcept {
+        for (std::size_t i = 0; i < size_; ++i) {
+            output[i] = (*this)[i].load(order);
+        }
+    }
+
+private:
+    static constexpr std::uint64_t magic = 0x4246'5354'4154'5553u;
+
+    struct header {
+        std::atomic<std::uint64_t> magic{0};
+        std::uint64_t layout_hash{0};
+        std::uint64_t record_count{0};
+        std::uint64_t record_stride{0};
+    };
+
+    static constexpr std::size_t header_size = (sizeof(header) + stride - 1) / stride * stride;
+
+    /// Returns true if a block of memory has room for a number of records.
+    static constexpr bool fits(const std::span<std::byte> memory, const std::uint64_t records) noexcept {
+        return memory.size() >= header_size && records <= (memory.size() - header_size) / stride;
+    }
+
+    status_board(std::byte* const base, const std::size_t size) noexcept
+        : base_(base), size_(size) {
+    }
+
+    std::byte* base_;
+    std::size_t size_;
+};
+
+#if BIT_FIELD_HAS_POSIX_SHARED_MEMORY
+/// A named POSIX shared memory object (shm_open) mapped into this process (mmap), for holding a status_board. The
+/// mapping is removed when this is destroyed, but the object itself lasts until unlink is called.
+class shared_memory {
+public:
+    /// Create a shared memory object, or open it if it already exists, and make it at least a given size.
+    ///
+    /// @param name  The name, such as "/workers". See shm_open.
+    /// @param bytes The size.
+    ///
+    /// @returns The mapping, or an empty optional if any system call failed.
+    static std::optional<shared_memory> create(const char* const name, const std::size_t bytes) noexcept {
+        const int descriptor = ::shm_open(name, O_CREAT | O_RDWR, 0600);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        struct stat status{};
+        const bool grow = ::fstat(descriptor, &status) == 0 && static_cast<std::size_t>(status.st_size) < bytes;
+        if ((grow && ::ftruncate(descriptor, static_cast<off_t>(bytes)) != 0) || (!grow && status.st_size <= 0)) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        return map(descriptor, bytes);
+    }
+
+    /// Open an existing shared memory object, mapping all of it.
+    ///
+    /// @param name The name.
+    ///
+    /// @returns The mapping, or an empty optional if the object does not exist or any system call failed.
+    static std::optional<shared_memory> open(const char* const name) noexcept {
+        const int descriptor = ::shm_open(name, O_RDWR, 0600);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        struct stat status{};
+        if (::fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        return map(descriptor, static_cast<std::size_t>(status.st_size));
+    }
+
+    /// Remove a shared memory object's name. Existing mappings stay valid.
+    ///
+    /// @returns True on success.
+    static bool unlink(const char* const name) noexcept {
+        return ::shm_unlink(name) == 0;
+    }
+
+    shared_memory(shared_memory&& other) noexcept
+        : memory_(std::exchange(other.memory_, {})) {
+    }
+
+    shared_memory& operator=(shared_memory&& other) noexcept {
+        std::swap(memory_, other.memory_);
+        return *this;
+    }
+
+    ~shared_memory() {
+        if (!memory_.empty()) {
+            ::munmap(memory_.data(), memory_.size());
+        }
+    }
+
+    /// The mapped memory.
+    std::span<std::byte> bytes() const noexcept {
+        return memory_;
+    }
+
+private:
+    explicit shared_memory(const std::span<std::byte> memory) noexcept
+        : memory_(memory) {
+    }
+
+    static std::optional<shared_memory> map(const int descriptor, const std::size_t bytes) noexcept {
+        void* const address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (address == MAP_FAILED) {
+            return std::nullopt;
+        }
+        return shared_memory{ std::span<std::byte>{ static_cast<std::byte*>(address), bytes } };
+    }
+
+    std::span<std::byte> memory_;
+};
+#endif
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // STATUS_BOARD_HPP
+/// Binary event tracing into per-thread ring buffers, with event headers described by bit field layouts.
+#ifndef TRACE_BUFFER_HPP
+#define TRACE_BUFFER_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A layout usable as the header of trace events. It names three of its fields with member aliases: delta_field, the
+/// time since the previous event, type_field, the event type, and length_field, the number of payload bytes following
+/// the header.
+template <typename T>
+concept trace_header_layout = bit_field_layout<T> && std::unsigned_integral<typename T::value_type> && requires {
+    typename T::delta_field;
+    typename T::type_field;
+    typename T::length_field;
+};
+
+/// One decoded trace event.
+struct trace_event {
+    /// The absolute time of the event, in whatever unit the timestamps given to trace_buffer::record were.
+    std::uint64_t timestamp;
+
+    /// The event type.
+    unsigned type;
+
+    /// The payload bytes. Points into the decoded dump.
+    std::span<const std::byte> payload;
+};
+
+namespace detail {
+
+/// Properties of trace events shared by the buffer and the decoder.
+template <trace_header_layout THeader>
+struct trace_format {
+    using value_type = typename THeader::value_type;
+    using delta_field = typename THeader::delta_field;
+    using type_field = typename THeader::type_field;
+    using length_field = typename THeader::length_field;
+
+    static constexpr std::size_t header_size = sizeof(value_type);
+
+    static constexpr std::uint64_t max_delta = (std::uint64_t{1} << delta_field::bits) - 1;
+    static constexpr std::size_t max_payload = (std::size_t{1} << length_field::bits) - 1;
+
+    /// The largest event type, which is reserved for rebase events. A rebase event's payload is the absolute timestamp
+    /// as eight little-endian bytes, and later deltas are relative to it.
+    static constexpr unsigned rebase_type = (1u << type_field::bits) - 1;
+
+    static_assert(delta_field::bits < 64 && type_field::bits < 32, "Trace header fields are too wide.");
+    static_assert(max_payload >= 8, "The length field must hold the eight byte payload of a rebase event.");
+
+    static constexpr auto get_config = bit_field_config<std::uint64_t>{};
+    static constexpr auto set_config = bit_field_config{ .strategy = bit_field_assignment_strategy::unchecked };
+
+    /// Build an event header. The fields are combined in a register, so writing the header is a single store.
+    static constexpr THeader make_header(const std::uint64_t delta, const unsigned type,
+                                         const std::size_t length) noexcept {
+        THeader header{};
+        delta_field::template set<set_config>(header.raw_value, static_cast<value_type>(delta));
+        type_field::template set<set_config>(header.raw_value, static_cast<value_type>(type));
+        length_field::template set<set_config>(header.raw_value, static_cast<value_type>(length));
+        return header;
+    }
+};
+
+} // End namespace detail.
+
+/// A ring buffer of binary trace events, written by one thread and drained by one other thread at a time, such as a
+/// thread_local buffer per traced thread and a collector which periodically writes the drained bytes to a file.
+///
+/// Each event is a THeader layout stored little-endian, followed by its payload bytes. The header is built in a
+/// register and written with one store, so recording an event costs a few instructions instead of formatting text.
+/// The delta field holds the time since the previous event; when a delta does not fit, or the first time, or after
+/// events were dropped, a rebase event holding the full timestamp is recorded first. When the buffer is full, events
+/// are dropped and counted rather than overwriting events the collector has not drained.
+///
+/// @tparam THeader   The header layout. See trace_header_layout.
+/// @tparam NCapacity The size of the ring in bytes. Must be a power of two.
+template <trace_header_layout THeader, std::size_t NCapacity = 65536>
+class trace_buffer {
+    using format = detail::trace_format<THeader>;
+
+public:
+    static constexpr std::size_t capacity = NCapacity;
+    static constexpr std::size_t header_size = format::header_size;
+    static constexpr std::size_t max_payload = format::max_payload;
+    static constexpr unsigned rebase_type = format::rebase_type;
+
+    static_assert(std::has_single_bit(capacity), "The capacity must be a power of two.");
+    static_assert(capacity >= 2 * (header_size + max_payload), "The capacity must hold at least two events.");
+
+    /// Record an event.
+    ///
+    /// @param timestamp The time of the event. Should not decrease from one event to the next; if it does, a rebase
+    ///                  event is recorded.
+    /// @param type      The event type. Must be less than rebase_type.
+    /// @param payload   The payload. Must be at most max_payload bytes.
+    ///
+    /// @returns True if the event was recorded, or false if the buffer was full and it was dropped, or if the type or
+    ///          the payload size does not fit the header, in which case nothing is recorded and nothing is counted.
+    bool record(const std::uint64_t timestamp, const unsigned type,
+                const std::span<const std::byte> payload = {}) noexcept {
+        // The header is built with the unchecked strategy, and write stages an event of at most max_payload bytes.
+        if (type >= rebase_type || payload.size() > max_payload) {
+            return false;
+        }
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        std::uint64_t delta = timestamp - last_timestamp_;
+        const bool rebase = rebase_needed_ || delta > format::max_delta;
+        const std::size_t size = header_size + payload.size() + (rebase ? header_size + 8 : 0);
+        if (head + size - cached_tail_ > capacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head + size - cached_tail_ > capacity) {
+                ++dropped_;
+                rebase_needed_ = true;
+                return false;
+            }
+        }
+
+        std::uint64_t position = head;
+        if (rebase) {
+            std::byte timestamp_bytes[8];
+            store_bytes<std::endian::little>(timestamp_bytes, timestamp);
+            position = write(position, format::make_header(0, rebase_type, 8), timestamp_bytes);
+            rebase_needed_ = false;
+            delta = 0;
+        }
+        last_timestamp_ = timestamp;
+        position = write(position, format::make_header(delta, type, payload.size()), payload);
+        head_.store(position, std::memory_order_release);
+        return true;
+    }
+
+    /// Copy recorded events out of the buffer, oldest first, freeing their space. Only whole events are copied.
+    ///
+    /// @param output Receives the events, in the format trace_decoder reads.
+    ///
+    /// @returns The number of bytes copied.
+    std::size_t drain(const std::span<std::byte> output) noexcept {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t end = tail;
+        if (head - tail <= output.size()) {
+            end = head;
+        } else {
+            // Stop at the last event boundary which fits.
+            while (end != head) {
+                std::byte bytes[header_size];
+                read(end, bytes);
+                const std::uint64_t size = header_size + format::length_field::template get<format::get_config>(
+                    load_layout<THeader, std::endian::little>(bytes).raw_value);
+                if (end + size - tail > output.size()) {
+                    break;
+                }
+                end += size;
+            }
+        }
+        read(tail, output.first(static_cast<std::size_t>(end - tail)));
+        tail_.store(end, std::memory_order_release);
+        return static_cast<std::size_t>(end - tail);
+    }
+
+    /// The number of bytes recorded but not drained yet.
+    std::size_t size() const noexcept {
+        return static_cast<std::size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+    }
+
+    /// The number of events dropped because the buffer was full. Only the recording thread may call this.
+    std::uint64_t dropped() const noexcept {
+        return dropped_;
+    }
+
+private:
+    static constexpr std::size_t index_mask = capacity - 1;
+
+    /// Write a header and a payload at a position, wrapping around the end of the ring.
+    ///
+    /// @returns The position after the event.
+    std::uint64_t write(const std::uint64_t position, const THeader header,
+                        const std::span<const std::byte> payload) noexcept {
+        const std::size_t index = static_cast<std::size_t>(position) & index_mask;
+        const std::size_t size = header_size + payload.size();
+        if (index + size <= capacity) {
+            store_layout<std::endian::little>(ring_ + index, header);
+            if (!payload.empty()) {
+                std::memcpy(ring_ + index + header_size, payload.data(), payload.size());
+            }
+        } else {
+            std::byte event[header_size + max_payload];
+            store_layout<std::endian::little>(event, header);
+            if (!payload.empty()) {
+                std::memcpy(event + header_size, payload.data(), payload.size());
+            }
+            const std::size_t first = capacity - index;
+            std::memcpy(ring_ + index, event, first);
+            std::memcpy(ring_, event + first, size - first);
+        }
+        return position + size;
+    }
+
+    /// Copy bytes out of the ring from a position, wrapping around the end of the ring.
+    void read(const std::uint64_t position, const std::span<std::byte> output) const noexcept {
+        const std::size_t index = static_cast<std::size_t>(position) & index_mask;
+        const std::size_t first = std::min(output.size(), capacity - index);
+        std::memcpy(output.data(), ring_ + index, first);
+        std::memcpy(output.data() + first, ring_, output.size() - first);
+    }
+
+    // Written by the recording thread.
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t cached_tail_{0};
+    std::uint64_t last_timestamp_{0};
+    std::uint64_t dropped_{0};
+    bool rebase_needed_{true};
+
+    // Written by the draining thread.
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail_{0};
+
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::byte ring_[capacity];
+};
+
+/// Decodes the bytes drained from a trace_buffer, using the same header layout. Dumps drained one after another from
+/// the same buffer must be decoded in order by the same decoder, since deltas continue from one dump to the next.
+///
+/// @tparam THeader The header layout the events were recorded with.
+template <trace_header_layout THeader>
+class trace_decoder {
+    using format = detail::trace_format<THeader>;
+
+public:
+    /// Decode events.
+    ///
+    /// @param dump The bytes drained from a trace_buffer.
+    /// @param fn   Called with each trace_event, in order. Rebase events are consumed and not passed on.
+    ///
+    /// @returns The number of bytes decoded. Less than the size of the dump if it ends with a partial event.
+    constexpr std::size_t decode(const std::span<const std::byte> dump, auto&& fn) {
+        std::size_t position = 0;
+        while (dump.size() - position >= format::header_size) {
+            const THeader header = load_layout<THeader, std::endian::little>(dump.data() + position);
+            const auto raw = header.raw_value;
+            const auto length = static_cast<std::size_t>(
+                format::length_field::template get<format::get_config>(raw));
+            if (dump.size() - position - format::header_size < length) {
+                break;
+            }
+            const std::span<const std::byte> payload = dump.subspan(position + format::header_size, length);
+            const auto type = static_cast<unsigned>(format::type_field::template get<format::get_config>(raw));
+            position += format::header_size + length;
+            if (type == format::rebase_type && length == 8) {
+                timestamp_ = load_bytes<std::uint64_t, std::endian::little>(payload.data());
+                continue;
+            }
+            timestamp_ += format::delta_field::template get<format::get_config>(raw);
+            fn(trace_event{ .timestamp = timestamp_, .type = type, .payload = payload });
+        }
+        return position;
+    }
+
+    /// The timestamp of the last decoded event.
+    constexpr std::uint64_t timestamp() const noexcept {
+        return timestamp_;
+    }
+
+private:
+    std::uint64_t timestamp_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // TRACE_BUFFER_HPP
+/// A columnar file format for archives of layout records, storing each field in its own bit-packed pages.
+#ifndef COLUMN_ARCHIVE_HPP
+#define COLUMN_ARCHIVE_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Options for write_column_archive.
+struct column_archive_options {
+    /// The number of records in each page. Each page of a column is decoded as a unit by column_archive::scan.
+    std::size_t page_records = 4096;
+
+    /// Compress pages with frame of reference coding: store the smallest value of the page once, and the difference of
+    /// every value from it with just enough bits for the largest difference. A page is only compressed when that is
+    /// narrower than the field, and a page where every value is the same takes no bits per value at all.
+    bool compress = true;
+};
+
+namespace detail {
+
+inline constexpr std::uint64_t column_archive_magic = 0x5643'4F4C'4246'4C44u;
+inline constexpr std::uint64_t column_archive_version = 1;
+
+/// The number of 64-bit words in the footer before the page entries.
+inline constexpr std::size_t column_footer_words = 5;
+
+/// The number of 64-bit words in the page entry of each page of each column: its offset, its width, and its base.
+inline constexpr std::size_t column_entry_words = 3;
+
+/// The number of bytes of a page of values packed at a width. One extra word lets every value be read with two loads.
+constexpr std::size_t column_page_bytes(const std::size_t values, const unsigned width) noexcept {
+    return ((values * width + 63) / 64 + 1) * 8;
+}
+
+/// Read the value at an index from a page of values packed at a width.
+constexpr std::uint64_t unpack_column_value(const std::byte* const page, const unsigned width,
+                                            const std::uint64_t base, const std::size_t index) noexcept {
+    if (width == 0) {
+        return base;
+    }
+    const std::size_t bit = index * width;
+    const std::byte* const word = page + bit / 64 * 8;
+    const std::uint64_t low = load_bytes<std::uint64_t, std::endian::little>(word);
+    const std::uint64_t high = load_bytes<std::uint64_t, std::endian::little>(word + 8);
+    const std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    return base + (funnel_shift_right(low, high, static_cast<unsigned>(bit % 64)) & mask);
+}
+
+/// Read the value packed at a bit position known at compile time, with one load if it lies within one word.
+template <unsigned NWidth, unsigned NBit>
+constexpr std::uint64_t unpack_column_bits(const std::byte* const group) noexcept {
+    constexpr std::uint64_t mask = NWidth == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << NWidth) - 1;
+    const std::uint64_t low = load_bytes<std::uint64_t, std::endian::little>(group + NBit / 64 * 8);
+    if constexpr (NBit % 64 + NWidth <= 64) {
+        return (low >> (NBit % 64)) & mask;
+    } else {
+        const std::uint64_t high = load_bytes<std::uint64_t, std::endian::little>(group + NBit / 64 * 8 + 8);
+        return funnel_shift_right(low, high, NBit % 64) & mask;
+    }
+}
+
+/// Read the values of a page of values packed at a width known at compile time. Groups of 64 values take exactly
+/// NWidth words, so within a group every load and shift is a constant, and the compiler can vectorize the group.
+template <unsigned NWidth>
+constexpr void unpack_column_page(const std::byte* const page, const std::uint64_t base,
+                                  const std::span<std::uint64_t> output) noexcept {
+    std::size_t i = 0;
+    if constexpr (NWidth == 0) {
+        for (; i < output.size(); ++i) {
+            output[i] = base;
+        }
+    } else {
+        for (; i + 64 <= output.size(); i += 64) {
+            const std::byte* const group = page + i / 64 * NWidth * 8;
+            std::uint64_t* const values = output.data() + i;
+            [&]<unsigned... NIndices>(std::integer_sequence<unsigned, NIndices...>) constexpr {
+                ((values[NIndices] = base + unpack_column_bits<NWidth, NIndices * NWidth>(group)), ...);
+            }(std::make_integer_sequence<unsigned, 64>{});
+        }
+        for (; i < output.size(); ++i) {
+            output[i] = unpack_column_value(page, NWidth, base, i);
+        }
+    }
+}
+
+/// Read the values of a page of values packed at any width.
+constexpr void unpack_column_page(const std::byte* const page, const unsigned width, const std::uint64_t base,
+                                  const std::span<std::uint64_t> output) noexcept {
+    using unpack_function = void (*)(const std::byte*, std::uint64_t, std::span<std::uint64_t>) noexcept;
+    constexpr auto functions = []<unsigned... NWidths>(std::integer_sequence<unsigned, NWidths...>) constexpr {
+        return std::array<unpack_function, sizeof...(NWidths)>{ &unpack_column_page<NWidths>... };
+    }(std::make_integer_sequence<unsigned, 65>{});
+    functions[width](page, base, output);
+}
+
+constexpr void append_column_word(std::vector<std::byte>& output, const std::uint64_t word) {
+    std::byte bytes[8]{};
+    store_bytes<std::endian::little>(bytes, word);
+    output.insert(output.end(), bytes, bytes + 8);
+}
+
+} // End namespace detail.
+
+/// Write records as a column archive. Each field of the layout, as found by layout_fields, becomes a column, stored as
+/// pages of page_records values packed at the field's width, one column after another. A footer at the end indexes
+/// every page, and records the layout_hash of the layout, so that only a reader with the same layout will open it. All
+/// numbers are little-endian, so the archive may be written to a file and mapped into memory on any host.
+///
+/// @param records The records.
+/// @param options How to write the pages.
+///
+/// @returns The bytes of the archive.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+constexpr std::vector<std::byte> write_column_archive(const std::span<const TLayout> records,
+                                                      const column_archive_options options = {}) {
+    using fields = layout_fields<TLayout>;
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+
+    const std::size_t page_records = std::max<std::size_t>(options.page_records, 1);
+    const std::size_t page_count = (records.size() + page_records - 1) / page_records;
+
+    std::vector<std::byte> output;
+    std::vector<std::uint64_t> entries;
+    std::vector<std::uint64_t> values;
+    entries.reserve(fields::count * page_count * detail::column_entry_words);
+    values.reserve(page_records);
+    for (std::size_t field = 0; field < fields::count; ++field) {
+        const unsigned offset = fields::offsets[field];
+        const unsigned declared = fields::width_of(field);
+        const std::uint64_t mask = declared == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << declared) - 1;
+        for (std::size_t first = 0; first < records.size(); first += page_records) {
+            const std::size_t count = std::min(page_records, records.size() - first);
+            values.clear();
+            for (const TLayout& record : records.subspan(first, count)) {
+                values.push_back((static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> offset) &
+                                 mask);
+            }
+
+            std::uint64_t base = 0;
+            unsigned width = declared;
+            if (options.compress) {
+                const auto [low, high] = std::minmax_element(values.begin(), values.end());
+                const auto reduced = static_cast<unsigned>(std::bit_width(*high - *low));
+                if (reduced < declared) {
+                    base = *low;
+                    width = reduced;
+                }
+            }
+
+            entries.push_back(output.size());
+            entries.push_back(width);
+            entries.push_back(base);
+            std::uint64_t word = 0;
+            unsigned used = 0;
+            for (const std::uint64_t value : values) {
+                const std::uint64_t delta = value - base;
+                word |= delta << used;
+                used += width;
+                if (used >= 64) {
+                    detail::append_column_word(output, word);
+                    used -= 64;
+                    word = used == 0 ? 0 : delta >> (width - used);
+                }
+            }
+            if (used > 0) {
+                detail::append_column_word(output, word);
+            }
+            detail::append_column_word(output, 0);
+        }
+    }
+
+    const std::uint64_t footer_offset = output.size();
+    detail::append_column_word(output, detail::column_archive_version);
+    detail::append_column_word(output, layout_hash<TLayout>);
+    detail::append_column_word(output, records.size());
+    detail::append_column_word(output, page_records);
+    detail::append_column_word(output, fields::count);
+    for (const std::uint64_t entry : entries) {
+        detail::append_column_word(output, entry);
+    }
+    detail::append_column_word(output, footer_offset);
+    detail::append_column_word(output, detail::column_archive_magic);
+    return output;
+}
+
+/// Write records as a column archive. See above.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+constexpr std::vector<std::byte> write_column_archive(const std::span<TLayout> records,
+                                                      const column_archive_options options = {}) {
+    return write_column_archive(std::span<const TLayout>{ records }, options);
+}
+
+/// A reader of a column archive written by write_column_archive, such as a file mapped into memory with mmap. The
+/// reader decodes values in place, so a query touching one field reads only the pages of that field's column.
+///
+/// Values are returned as the raw bits of each field, zero-extended to 64 bits. Whole records are rebuilt from every
+/// column, after which their fields can be read as usual.
+///
+/// @tparam TLayout The layout the archive was written with.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class column_archive {
+    using fields = layout_fields<TLayout>;
+
+public:
+    /// Open an archive, checking that it was written with this layout and that every page lies within it.
+    ///
+    /// @param archive The bytes of the archive. Must outlive the reader.
+    ///
+    /// @returns The reader, or an empty optional if the archive is not valid.
+    static constexpr std::optional<column_archive> open(const std::span<const std::byte> archive) noexcept {
+        constexpr std::size_t trailer_bytes = 16;
+        constexpr std::size_t fixed_bytes = detail::column_footer_words * 8 + trailer_bytes;
+        if (archive.size() < fixed_bytes ||
+            load_bytes<std::uint64_t, std::endian::little>(archive.data() + archive.size() - 8) !=
+                detail::column_archive_magic) {
+            return std::nullopt;
+        }
+        const std::uint64_t footer_offset =
+            load_bytes<std::uint64_t, std::endian::little>(archive.data() + archive.size() - trailer_bytes);
+        if (footer_offset > archive.size() - fixed_bytes) {
+            return std::nullopt;
+        }
+
+        column_archive reader{ archive, static_cast<std::size_t>(footer_offset) };
+        if (reader.footer(0) != detail::column_archive_version || reader.footer(1) != layout_hash<TLayout> ||
+            reader.footer(3) == 0 || reader.footer(4) != fields::count) {
+            return std::nullopt;
+        }
+        reader.page_records_ = static_cast<std::size_t>(reader.footer(3));
+        const std::uint64_t records = reader.footer(2);
+        const std::uint64_t pages = records / reader.page_records_ + (records % reader.page_records_ != 0 ? 1 : 0);
+        const std::size_t entry_bytes = archive.size() - fixed_bytes - reader.footer_offset_;
+        if (fields::count != 0 && pages != entry_bytes / 8 / detail::column_entry_words / fields::count) {
+            return std::nullopt;
+        }
+        if (entry_bytes != pages * fields::count * detail::column_entry_words * 8) {
+            return std::nullopt;
+        }
+        reader.size_ = static_cast<std::size_t>(records);
+        reader.page_count_ = static_cast<std::size_t>(pages);
+
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            for (std::size_t page = 0; page < reader.page_count_; ++page) {
+                const std::uint64_t offset = reader.footer(reader.entry(field, page));
+                const std::uint64_t width = reader.footer(reader.entry(field, page) + 1);
+                if (width > fields::width_of(field) || offset > reader.footer_offset_ ||
+                    reader.footer_offset_ - offset <
+                        detail::column_page_bytes(reader.page_size(page), static_cast<unsigned>(width))) {
+                    return std::nullopt;
+                }
+                // Every value of the page, the base plus up to 2^width - 1, must fit the field.
+                const std::uint64_t base = reader.footer(reader.entry(field, page) + 2);
+                if (base > low_mask(fields::width_of(field)) - low_mask(static_cast<unsigned>(width))) {
+                    return std::nullopt;
+                }
+            }
+        }
+        return reader;
+    }
+
+    /// The number of records.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// The number of records in each page, except perhaps the last.
+    constexpr std::size_t page_records() const noexcept {
+        return page_records_;
+    }
+
+    /// The number of pages in each column.
+    constexpr std::size_t page_count() const noexcept {
+        return page_count_;
+    }
+
+    /// The number of records in a page.
+    constexpr std::size_t page_size(const std::size_t page) const noexcept {
+        return std::min(page_records_, size_ - page * page_records_);
+    }
+
+    /// The number of bytes of a column's pages, which is all that is read to scan the column.
+    template <typename TField>
+    constexpr std::size_t column_bytes() const noexcept {
+        std::size_t result = 0;
+        for (std::size_t page = 0; page < page_count_; ++page) {
+            result += detail::column_page_bytes(page_size(page), page_width(fields::template index_of<TField>, page));
+        }
+        return result;
+    }
+
+    /// Decode the values of a field in one page.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param page   The page index.
+    /// @param output Receives the values. Must be at least page_size(page) long.
+    ///
+    /// @returns The number of values decoded.
+    template <typename TField>
+    constexpr std::size_t read_page(const std::size_t page, const std::span<std::uint64_t> output) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const std::size_t count = page_size(page);
+        detail::unpack_column_page(page_data(field, page), page_width(field, page), page_base(field, page),
+                                   output.first(count));
+        return count;
+    }
+
+    /// Decode a whole column, one page at a time, reading no other column.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param fn Called for each page with the index of its first record and a span of its decoded values.
+    template <typename TField>
+    constexpr void scan(auto&& fn) const {
+        std::vector<std::uint64_t> values(std::min(page_records_, size_));
+        for (std::size_t page = 0; page < page_count_; ++page) {
+            const std::size_t count = read_page<TField>(page, values);
+            fn(page * page_records_, std::span<const std::uint64_t>{ values.data(), count });
+        }
+    }
+
+    /// Decode the value of a field in one record.
+    ///
+    /// @param index The index of the record. Must be less than size().
+    template <typename TField>
+    constexpr std::uint64_t value(const std::size_t index) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const std::size_t page = index / page_records_;
+        return detail::unpack_column_value(page_data(field, page), page_width(field, page), page_base(field, page),
+                                           index % page_records_);
+    }
+
+    /// Rebuild one record from every column.
+    ///
+    /// @param index The index of the record. Must be less than size().
+    constexpr TLayout record(const std::size_t index) const noexcept {
+        TLayout result{};
+        read_records(index, std::span<TLayout>{ &result, 1 });
+        return result;
+    }
+
+    /// Rebuild a range of records from every column.
+    ///
+    /// @param first  The index of the first record.
+    /// @param output Receives the records. first + output.size() must not exceed size().
+    constexpr void read_records(const std::size_t first, const std::span<TLayout> output) const noexcept {
+        for (TLayout& record : output) {
+            record.raw_value = 0;
+        }
+        for (std::size_t done = 0; done < output.size();) {
+            const std::size_t page = (first + done) / page_records_;
+            const std::size_t start = (first + done) % page_records_;
+            const std::size_t count = std::min(page_size(page) - start, output.size() - done);
+            for (std::size_t field = 0; field < fields::count; ++field) {
+                const std::byte* const data = page_data(field, page);
+                const unsigned width = page_width(field, page);
+                const std::uint64_t base = page_base(field, page);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const std::uint64_t bits_value = detail::unpack_column_value(data, width, base, start + i);
+                    TLayout& record = output[done + i];
+                    record.raw_value = static_cast<value_type>(
+                        static_cast<unsigned_type>(record.raw_value) |
+                        static_cast<unsigned_type>(bits_value << fields::offsets[field]));
+                }
+            }
+            done += count;
+        }
+    }
+
+private:
+    using value_type = typename TLayout::value_type;
+    using unsigned_type = detail::uint_least_t<bits<value_type>>;
+
+    constexpr column_archive(const std::span<const std::byte> archive, const std::size_t footer_offset) noexcept
+        : archive_(archive), footer_offset_(footer_offset) {
+    }
+
+    /// Read a word of the footer.
+    constexpr std::uint64_t footer(const std::size_t index) const noexcept {
+        return load_bytes<std::uint64_t, std::endian::little>(archive_.data() + footer_offset_ + index * 8);
+    }
+
+    /// The index in the footer of the entry of a page of a column.
+    constexpr std::size_t entry(const std::size_t field, const std::size_t page) const noexcept {
+        return detail::column_footer_words + (field * page_count_ + page) * detail::column_entry_words;
+    }
+
+    constexpr const std::byte* page_data(const std::size_t field, const std::size_t page) const noexcept {
+        return archive_.data() + footer(entry(field, page));
+    }
+
+    constexpr unsigned page_width(const std::size_t field, const std::size_t page) const noexcept {
+        return static_cast<unsigned>(footer(entry(field, page) + 1));
+    }
+
+    constexpr std::uint64_t page_base(const std::size_t field, const std::size_t page) const noexcept {
+        return footer(entry(field, page) + 2);
+    }
+
+    /// The largest value of a number of bits.
+    static constexpr std::uint64_t low_mask(const unsigned width) noexcept {
+        return width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    }
+
+    std::span<const std::byte> archive_;
+    std::size_t footer_offset_;
+    std::size_t size_{0};
+    std::size_t page_records_{1};
+    std::size_t page_count_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // COLUMN_ARCHIVE_HPP
+/// Per-block field statistics over arrays of layout records, for skipping blocks which cannot match a scan.
+#ifndef ZONE_MAP_HPP
+#define ZONE_MAP_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A zone map over an array of layout records: for every block of NBlock records, the smallest and largest value of
+/// each field, and for fields of 8 bits or fewer, the set of values present, which for a 2-bit field is just 4 bits.
+/// Scans consult the map first and skip every block whose statistics rule out a match, so a search for a rare value
+/// only reads the few blocks which might hold it.
+///
+/// Field values are the raw bits of each field, zero-extended to 64 bits and compared as unsigned numbers. The records
+/// themselves are not stored; the map must be given the same records it was built from.
+///
+/// @tparam TLayout The layout of the records.
+/// @tparam NBlock  The number of records in each block.
+template <bit_field_layout TLayout, std::size_t NBlock = 4096>
+    requires (bits<typename TLayout::value_type> <= 64 && NBlock > 0)
+class zone_map {
+    using fields = layout_fields<TLayout>;
+
+public:
+    static constexpr std::size_t block_size = NBlock;
+
+    /// The widest field whose present values are recorded.
+    static constexpr unsigned max_presence_width = 8;
+
+    constexpr zone_map() = default;
+
+    /// Build a map of records.
+    ///
+    /// @param records The records.
+    constexpr explicit zone_map(const std::span<const TLayout> records) {
+        append(records);
+    }
+
+    /// Add records to the end of the map, as they are appended to the array it describes.
+    ///
+    /// @param records The new records.
+    constexpr void append(std::span<const TLayout> records) {
+        while (!records.empty()) {
+            if (size_ % NBlock == 0) {
+                zones_.push_back(empty_zone());
+            }
+            const std::size_t count = std::min(records.size(), NBlock - size_ % NBlock);
+            add_block(zones_.back(), records.first(count), std::make_index_sequence<fields::count>{});
+            records = records.subspan(count);
+            size_ += count;
+        }
+    }
+
+    /// Add one record to the end of the map.
+    constexpr void append(const TLayout& record) {
+        append(std::span<const TLayout>{ &record, 1 });
+    }
+
+    /// The number of records described.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// The number of blocks.
+    constexpr std::size_t block_count() const noexcept {
+        return zones_.size();
+    }
+
+    /// The smallest value of a field in a block.
+    template <typename TField>
+    constexpr std::uint64_t min(const std::size_t block) const noexcept {
+        return zones_[block].min[fields::template index_of<TField>];
+    }
+
+    /// The largest value of a field in a block.
+    template <typename TField>
+    constexpr std::uint64_t max(const std::size_t block) const noexcept {
+        return zones_[block].max[fields::template index_of<TField>];
+    }
+
+    /// Returns false if no record in a block can have a field in a range of values.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param block The block index.
+    /// @param low   The smallest value of the range.
+    /// @param high  The largest value of the range.
+    template <typename TField>
+    constexpr bool may_contain(const std::size_t block, const std::uint64_t low,
+                               const std::uint64_t high) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const zone& statistics = zones_[block];
+        if (low > high || high < statistics.min[field] || low > statistics.max[field]) {
+            return false;
+        }
+        if constexpr (fields::width_of(field) <= max_presence_width) {
+            // Look for any present value in the range, one word of the presence set at a time.
+            constexpr std::size_t first_word = presence_offsets[field];
+            const std::uint64_t from = std::max(low, statistics.min[field]);
+            const std::uint64_t to = std::min(high, statistics.max[field]);
+            for (std::uint64_t word = from / 64; word <= to / 64; ++word) {
+                const std::uint64_t above = ~std::uint64_t{0} << (word == from / 64 ? from % 64 : 0);
+                const std::uint64_t below = ~std::uint64_t{0} >> (word == to / 64 ? 63 - to % 64 : 0);
+                if ((statistics.presence[first_word + word] & above & below) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        } else {
+            return true;
+        }
+    }
+
+    /// Returns false if no record in a block can have a field equal to a value.
+    template <typename TField>
+    constexpr bool may_contain(const std::size_t block, const std::uint64_t value) const noexcept {
+        return may_contain<TField>(block, value, value);
+    }
+
+    /// Find the records whose field lies in a range of values, skipping blocks which cannot hold any.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param records The records the map describes.
+    /// @param low     The smallest value of the range.
+    /// @param high    The largest value of the range.
+    /// @param fn      Called with the index of each matching record, in order.
+    ///
+    /// @returns The number of matching records.
+    template <typename TField>
+    constexpr std::size_t find(const std::span<const TLayout> records, const std::uint64_t low,
+                               const std::uint64_t high, auto&& fn) const {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        std::size_t matches = 0;
+        for (std::size_t block = 0; block < zones_.size(); ++block) {
+            if (!may_contain<TField>(block, low, high)) {
+                continue;
+            }
+            const std::size_t first = block * NBlock;
+            const std::size_t last = std::min(first + NBlock, records.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint64_t value = field_value<field>(records[i]);
+                if (value >= low && value <= high) {
+                    fn(i);
+                    ++matches;
+                }
+            }
+        }
+        return matches;
+    }
+
+    /// Find the records whose field equals a value, skipping blocks which cannot hold any.
+    template <typename TField>
+    constexpr std::size_t find(const std::span<const TLayout> records, const std::uint64_t value, auto&& fn) const {
+        return find<TField>(records, value, value, fn);
+    }
+
+    /// Count the records whose field lies in a range of values, skipping blocks which cannot hold any.
+    template <typename TField>
+    constexpr std::size_t count_matches(const std::span<const TLayout> records, const std::uint64_t low,
+                                        const std::uint64_t high) const {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        std::size_t matches = 0;
+        for (std::size_t block = 0; block < zones_.size(); ++block) {
+            if (!may_contain<TField>(block, low, high)) {
+                continue;
+            }
+            const std::size_t first = block * NBlock;
+            const std::size_t last = std::min(first + NBlock, records.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint64_t value = field_value<field>(records[i]);
+                matches += (value >= low && value <= high) ? 1 : 0;
+            }
+        }
+        return matches;
+    }
+
+private:
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+
+    /// The index of the first word of each narrow field's presence set, and the number of words in all of them.
+    static constexpr std::array<std::size_t, fields::count + 1> presence_offsets = []() constexpr {
+        std::array<std::size_t, fields::count + 1> result{};
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            const unsigned width = fields::width_of(field);
+            const std::size_t words = width <= max_presence_width ? ((std::size_t{1} << width) + 63) / 64 : 0;
+            result[field + 1] = result[field] + words;
+        }
+        return result;
+    }();
+
+    struct zone {
+        std::array<std::uint64_t, fields::count> min;
+        std::array<std::uint64_t, fields::count> max;
+        std::array<std::uint64_t, presence_offsets[fields::count]> presence;
+    };
+
+    static constexpr zone empty_zone() noexcept {
+        zone result{};
+        result.min.fill(~std::uint64_t{0});
+        return result;
+    }
+
+    template <std::size_t NField>
+    static constexpr std::uint64_t field_value(const TLayout& record) noexcept {
+        constexpr unsigned width = fields::width_of(NField);
+        constexpr std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+        return (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> fields::offsets[NField]) &
+               mask;
+    }
+
+    /// Fold a run of records from one block into its statistics. Each field is a separate loop of independent
+    /// reductions over the block, which is small enough to stay in cache, so the records are read from memory once and
+    /// each loop vectorizes.
+    template <std::size_t... NFields>
+    static constexpr void add_block(zone& statistics, const std::span<const TLayout> records,
+                                    std::index_sequence<NFields...>) noexcept {
+        (add_field<NFields>(statistics, records), ...);
+    }
+
+    template <std::size_t NField>
+    static constexpr void add_field(zone& statistics, const std::span<const TLayout> records) noexcept {
+        constexpr unsigned width = fields::width_of(NField);
+        constexpr std::size_t first_word = presence_offsets[NField];
+        if constexpr (width <= 6) {
+            // The smallest and largest values are the lowest and highest bits of the presence set.
+            using set_type = std::conditional_t<width <= 5, std::uint32_t, std::uint64_t>;
+            set_type present{0};
+            for (const TLayout& record : records) {
+                present |= static_cast<set_type>(set_type{1} << field_value<NField>(record));
+            }
+            statistics.presence[first_word] |= present;
+            statistics.min[NField] = static_cast<std::uint64_t>(std::countr_zero(statistics.presence[first_word]));
+            statistics.max[NField] = static_cast<std::uint64_t>(63 - std::countl_zero(statistics.presence[first_word]));
+        } else if constexpr (width <= max_presence_width) {
+            std::uint64_t* const present = statistics.presence.data() + first_word;
+            for (const TLayout& record : records) {
+                const std::uint64_t value = field_value<NField>(record);
+                present[value / 64] |= std::uint64_t{1} << (value % 64);
+            }
+            constexpr std::size_t words = presence_offsets[NField + 1] - first_word;
+            std::size_t low = 0;
+            std::size_t high = words - 1;
+            while (present[low] == 0) {
+                ++low;
+            }
+            while (present[high] == 0) {
+                --high;
+            }
+            statistics.min[NField] = low * 64 + static_cast<std::uint64_t>(std::countr_zero(present[low]));
+            statistics.max[NField] = high * 64 + static_cast<std::uint64_t>(63 - std::countl_zero(present[high]));
+        } else {
+            // Reduce in the narrowest type holding the field, which vectorizes best.
+            using value_type = detail::uint_least_t<width>;
+            auto low = static_cast<value_type>(statistics.min[NField]);
+            auto high = static_cast<value_type>(statistics.max[NField]);
+            for (const TLayout& record : records) {
+                const auto value = static_cast<value_type>(field_value<NField>(record));
+                low = std::min(low, value);
+                high = std::max(high, value);
+            }
+            statistics.min[NField] = low;
+            statistics.max[NField] = high;
+        }
+    }
+
+    std::vector<zone> zones_;
+    std::size_t size_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ZONE_MAP_HPP
+/// Scanning files of layout records with reads running ahead of the computation.
+#ifndef READ_AHEAD_HPP
+#define READ_AHEAD_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/types.h>
+#  include <unistd.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Options for scan_records.
+struct read_ahead_options {
+    /// The number of bytes read at once, and handed to the scan function at once. Rounded up to a multiple of the
+    /// alignment.
+    std::size_t chunk_size = std::size_t{1} << 20;
+
+    /// The number of chunk buffers. While the scan function works on one, the rest are being filled.
+    std::size_t depth = 3;
+
+    /// The number of threads reading chunks. More than one keeps several reads in flight at once, which helps devices
+    /// such as NVMe drives which serve requests in parallel.
+    std::size_t readers = 1;
+
+    /// The alignment of the buffers, of the chunk size, and of every read offset, as required by O_DIRECT. Must be a
+    /// power of two.
+    std::size_t alignment = 4096;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+/// A source for scan_records reading from a file descriptor with pread, which may be opened with O_DIRECT.
+struct pread_source {
+    int descriptor;
+
+    /// The offset in the file of the first record.
+    std::uint64_t base{0};
+
+    std::ptrdiff_t operator()(const std::span<std::byte> buffer, const std::uint64_t offset) const noexcept {
+        return ::pread(descriptor, buffer.data(), buffer.size(), static_cast<off_t>(base + offset));
+    }
+};
+#endif
+
+/// Scan a file of records, such as one written by copying an array of layouts, reading ahead of the scan. Reader
+/// threads fill a ring of aligned chunk buffers while the calling thread hands each filled chunk to a bulk operation,
+/// so reading and computing overlap instead of taking turns as with a loop of read calls.
+///
+/// @tparam TLayout The layout of the records, which are stored as their raw values in native byte order.
+///
+/// @param source  Reads the bytes of the file. Called as source(buffer, offset) with a std::span<std::byte> and a
+///                std::uint64_t byte offset, possibly from several reader threads at once, and returns the number of
+///                bytes read, zero at the end of the file, or a negative number on error, like pread. See pread_source.
+/// @param fn      Called on the calling thread with a std::span<const TLayout> of each chunk's records, in order. If
+///                it returns bool, returning false stops the scan.
+/// @param options The chunk size, read-ahead depth, and number of readers.
+///
+/// If fn throws, the readers are stopped and joined before the exception propagates.
+///
+/// @returns The number of records scanned, or an empty optional if the source returned an error or the alignment is
+///          not a power of two. Bytes after the last whole record are ignored.
+template <bit_field_layout TLayout>
+std::optional<std::uint64_t> scan_records(auto&& source, auto&& fn, const read_ahead_options options = {}) {
+    static_assert(sizeof(TLayout) == sizeof(typename TLayout::value_type) && std::is_trivially_copyable_v<TLayout>,
+                  "Records must be stored as their raw values.");
+
+    const std::size_t alignment = std::max<std::size_t>(options.alignment, alignof(TLayout));
+    if (!std::has_single_bit(alignment)) {
+        return std::nullopt;
+    }
+    const std::size_t chunk_size =
+        std::max<std::size_t>((options.chunk_size + alignment - 1) / alignment * alignment, alignment);
+    const std::size_t depth = std::max<std::size_t>(options.depth, 1);
+    const std::size_t readers = std::clamp<std::size_t>(options.readers, 1, depth);
+
+    struct buffer_deleter {
+        std::align_val_t alignment;
+        void operator()(std::byte* const buffer) const noexcept {
+            ::operator delete[](buffer, alignment);
+        }
+    };
+    const std::unique_ptr<std::byte[], buffer_deleter> buffers{
+        static_cast<std::byte*>(::operator new[](chunk_size * depth, std::align_val_t{ alignment })),
+        buffer_deleter{ std::align_val_t{ alignment } }
+    };
+
+    // Chunk i goes in slot i % depth on lap i / depth. A slot's state is 2 * lap while it waits to be filled on that
+    // lap, and 2 * lap + 1 once filled. The scan sets every state to closed to release the readers when it stops.
+    constexpr std::uint64_t closed = ~std::uint64_t{0};
+    constexpr std::size_t failed = ~std::size_t{0};
+    struct slot {
+        alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> state{0};
+        std::size_t size{0};
+    };
+    std::vector<slot> slots(depth);
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<bool> finished{false};
+
+    const auto wait_for = [&](std::atomic<std::uint64_t>& state, const std::uint64_t target) {
+        for (std::uint64_t value = state.load(std::memory_order_acquire); value != target;
+             value = state.load(std::memory_order_acquire)) {
+            if (value == closed) {
+                return false;
+            }
+            state.wait(value, std::memory_order_acquire);
+        }
+        return true;
+    };
+
+    const auto read_chunks = [&] {
+        while (!finished.load(std::memory_order_relaxed)) {
+            const std::uint64_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            slot& target = slots[chunk % depth];
+            if (!wait_for(target.state, 2 * (chunk / depth))) {
+                return;
+            }
+            const std::span<std::byte> buffer{ buffers.get() + chunk % depth * chunk_size, chunk_size };
+            std::size_t filled = 0;
+            while (filled < chunk_size) {
+                const std::ptrdiff_t result = source(buffer.subspan(filled), chunk * chunk_size + filled);
+                if (result <= 0) {
+                    filled = result < 0 ? failed : filled;
+                    break;
+                }
+                filled += static_cast<std::size_t>(result);
+            }
+            if (filled != chunk_size) {
+                // Nothing after a short chunk needs reading.
+                finished.store(true, std::memory_order_relaxed);
+            }
+            target.size = filled;
+            // Publish the chunk, unless the scan has stopped and closed the slot in the meantime.
+            std::uint64_t expected = 2 * (chunk / depth);
+            target.state.compare_exchange_strong(expected, expected + 1, std::memory_order_release,
+                                                 std::memory_order_relaxed);
+            target.state.notify_all();
+        }
+    };
+
+    // However the scan ends, including by an exception from fn or from starting a thread, release the readers and
+    // join them, since destroying a std::thread which is still joinable terminates the program.
+    std::vector<std::thread> threads;
+    struct stop_readers {
+        std::atomic<bool>& finished;
+        std::vector<slot>& slots;
+        std::vector<std::thread>& threads;
+
+        ~stop_readers() {
+            finished.store(true, std::memory_order_relaxed);
+            for (slot& each : slots) {
+                each.state.store(closed, std::memory_order_release);
+                each.state.notify_all();
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+    } const stop{ finished, slots, threads };
+    threads.reserve(readers);
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads.emplace_back(read_chunks);
+    }
+
+    std::optional<std::uint64_t> scanned{ 0 };
+    for (std::uint64_t chunk = 0;; ++chunk) {
+        slot& current = slots[chunk % depth];
+        wait_for(current.state, 2 * (chunk / depth) + 1);
+        const std::size_t size = current.size;
+        if (size == failed) {
+            scanned.reset();
+            break;
+        }
+        const std::span<const TLayout> records{
+            std::launder(reinterpret_cast<const TLayout*>(buffers.get() + chunk % depth * chunk_size)),
+            size / sizeof(TLayout)
+        };
+        *scanned += records.size();
+        bool proceed = size == chunk_size;
+        if constexpr (std::is_same_v<decltype(fn(records)), bool>) {
+            proceed = fn(records) && proceed;
+        } else {
+            fn(records);
+        }
+        if (!proceed) {
+            break;
+        }
+        current.state.store(2 * (chunk / depth + 1), std::memory_order_release);
+        current.state.notify_all();
+    }
+    return scanned;
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // READ_AHEAD_HPP
+/// Blocks of layouts at fixed byte offsets, such as device register blocks and fixed-format protocol messages.
+#ifndef LAYOUT_BLOCK_HPP
+#define LAYOUT_BLOCK_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// How a member of a layout_block is read and written.
+enum class block_access {
+    /// As ordinary memory. The compiler may merge, split, or remove accesses, and copies of whole blocks use memcpy.
+    memory,
+
+    /// With a single volatile load or store of exactly the layout's width, as device registers require. Every access
+    /// is performed, in program order, and copies of whole blocks go member by member. The member must be aligned.
+    exact,
+};
+
+/// A member of a layout_block: a layout stored at a fixed byte offset.
+///
+/// @tparam NOffset The byte offset of the layout from the start of the block.
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TOrder  The byte order of the layout in the block.
+/// @tparam NAccess How the layout is read and written.
+template <std::size_t NOffset, bit_field_layout TLayout, std::endian TOrder = std::endian::native,
+          block_access NAccess = block_access::memory>
+    requires (bits<typename TLayout::value_type> <= 64)
+struct block_member {
+    using layout_type = TLayout;
+
+    static constexpr std::size_t offset = NOffset;
+    static constexpr std::size_t size = sizeof(typename TLayout::value_type);
+    static constexpr std::endian byte_order = TOrder;
+    static constexpr block_access access = NAccess;
+
+    static_assert(NAccess != block_access::exact || NOffset % size == 0,
+                  "Members with exact access must be aligned to their size.");
+};
+
+/// A compile-time description of a block of layouts at fixed byte offsets, such as the registers of a device or the
+/// words of a fixed-format message, which is overlaid on memory with a block_view.
+///
+/// @tparam TMembers The members, each a block_member. They may be listed in any order, but must not overlap.
+template <typename... TMembers>
+    requires (sizeof...(TMembers) > 0)
+struct layout_block {
+    using members = std::tuple<TMembers...>;
+
+    /// A copy of every member's layout, as loaded by block_view::load_all.
+    using values_type = std::tuple<typename TMembers::layout_type...>;
+
+    static constexpr std::size_t member_count = sizeof...(TMembers);
+
+    /// The type of the member at an index.
+    template <std::size_t NIndex>
+    using member_type = std::tuple_element_t<NIndex, members>;
+
+    /// The index of the member with a given layout type. Exactly one member must have that layout type.
+    template <typename TLayout>
+        requires ((std::is_same_v<typename TMembers::layout_type, TLayout> + ...) == 1)
+    static constexpr std::size_t index_of = []() constexpr {
+        constexpr std::array<bool, member_count> matches{ std::is_same_v<typename TMembers::layout_type, TLayout>... };
+        return static_cast<std::size_t>(std::find(matches.begin(), matches.end(), true) - matches.begin());
+    }();
+
+    /// The number of bytes the block spans, up to the end of its last member.
+    static constexpr std::size_t size = std::max({ (TMembers::offset + TMembers::size)... });
+
+    /// The alignment the base of the block needs for its exact-access members.
+    static constexpr std::size_t alignment =
+        std::max({ (TMembers::access == block_access::exact ? TMembers::size : std::size_t{1})... });
+
+    /// Returns true if every member can be copied with memcpy.
+    static constexpr bool plain_memory = ((TMembers::access == block_access::memory) && ...);
+
+    static_assert([]() constexpr {
+        constexpr std::array<std::size_t, member_count> offsets{ TMembers::offset... };
+        constexpr std::array<std::size_t, member_count> sizes{ TMembers::size... };
+        for (std::size_t i = 0; i < member_count; ++i) {
+            for (std::size_t j = i + 1; j < member_count; ++j) {
+                if (offsets[i] < offsets[j] + sizes[j] && offsets[j] < offsets[i] + sizes[i]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(), "Members of a layout_block must not overlap.");
+};
+
+/// A typed, zero-copy view of a layout_block overlaid on a byte buffer or on a device's register base address. Each
+/// member is loaded and stored at its compile-time offset, in its own byte order and with its own access policy, so no
+/// pointer arithmetic or casting is needed.
+///
+/// @tparam TBlock The layout_block.
+/// @tparam TByte  std::byte for a mutable view, or const std::byte for a read-only view.
+template <typename TBlock, typename TByte = std::byte>
+    requires std::is_same_v<std::remove_const_t<TByte>, std::byte>
+class block_view {
+public:
+    using block_type = TBlock;
+    using values_type = typename TBlock::values_type;
+
+    /// Construct a view of a buffer.
+    ///
+    /// @param buffer The buffer, at least TBlock::size bytes long, which is not checked. Must outlive the view. Must be
+    ///               aligned to TBlock::alignment if the block has exact-access members.
+    constexpr explicit block_view(const std::span<TByte> buffer) noexcept
+        : base_(buffer.data()) {
+    }
+
+    /// Construct a view of memory at an address, such as a memory-mapped register block.
+    ///
+    /// @param base The address of the block.
+    constexpr explicit block_view(TByte* const base) noexcept
+        : base_(base) {
+    }
+
+    /// Load the member at an index.
+    template <std::size_t NIndex>
+    constexpr auto load() const noexcept {
+        using member = typename TBlock::template member_type<NIndex>;
+        using layout = typename member::layout_type;
+        if constexpr (member::access == block_access::exact) {
+            using word = detail::uint_least_t<bits<typename layout::value_type>>;
+            word value = *reinterpret_cast<const volatile word*>(base_ + member::offset);
+            if constexpr (member::byte_order != std::endian::native) {
+                value = detail::byte_swap(value);
+            }
+            layout result{};
+            result.raw_value = static_cast<typename layout::value_type>(value);
+            return result;
+        } else {
+            return load_layout<layout, member::byte_order>(base_ + member::offset);
+        }
+    }
+
+    /// Load the member with a layout type.
+    template <bit_field_layout TLayout>
+    constexpr TLayout load() const noexcept {
+        return load<TBlock::template index_of<TLayout>>();
+    }
+
+    /// Store the member at an index.
+    template <std::size_t NIndex>
+    constexpr void store(const typename TBlock::template member_type<NIndex>::layout_type& layout) const noexcept
+        requires (!std::is_const_v<TByte>) {
+        using member = typename TBlock::template member_type<NIndex>;
+        using layout_type = typename member::layout_type;
+        if constexpr (member::access == block_access::exact) {
+            using word = detail::uint_least_t<bits<typename layout_type::value_type>>;
+            auto value = static_cast<word>(layout.raw_value);
+            if constexpr (member::byte_order != std::endian::native) {
+                value = detail::byte_swap(value);
+            }
+            *reinterpret_cast<volatile word*>(base_ + member::offset) = value;
+        } else {
+            store_layout<member::byte_order>(base_ + member::offset, layout);
+        }
+    }
+
+    /// Store the member with a layout type.
+    template <bit_field_layout TLayout>
+    constexpr void store(const TLayout& layout) const noexcept requires (!std::is_const_v<TByte>) {
+        store<TBlock::template index_of<TLayout>>(layout);
+    }
+
+    /// Load a member, let a function modify it, and store it back. For a register, this is one read and one write.
+    template <std::size_t NIndex>
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        auto layout = load<NIndex>();
+        fn(layout);
+        store<NIndex>(layout);
+    }
+
+    /// Load a member with a layout type, let a function modify it, and store it back.
+    template <bit_field_layout TLayout>
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        modify<TBlock::template index_of<TLayout>>(fn);
+    }
+
+    /// Load every member.
+    constexpr values_type load_all() const noexcept {
+        return [this]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return values_type{ load<NIndices>()... };
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Store every member, in the order they are listed in the block.
+    constexpr void store_all(const values_type& values) const noexcept requires (!std::is_const_v<TByte>) {
+        [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            (store<NIndices>(std::get<NIndices>(values)), ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Copy every member from another view of the same block, such as a register block into a buffer or back. Bytes
+    /// between members are not copied. Blocks of plain memory members are copied with a memcpy of each member's bytes,
+    /// which the compiler merges where members are adjacent; otherwise each member is loaded and stored in turn.
+    ///
+    /// @param source The view to copy from.
+    template <typename TSourceByte>
+    constexpr void copy_from(const block_view<TBlock, TSourceByte> source) const noexcept
+        requires (!std::is_const_v<TByte>) {
+        if constexpr (TBlock::plain_memory) {
+            if (!std::is_constant_evaluated()) {
+                [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) {
+                    (std::memcpy(base_ + TBlock::template member_type<NIndices>::offset,
+                                 source.data() + TBlock::template member_type<NIndices>::offset,
+                                 TBlock::template member_type<NIndices>::size), ...);
+                }(std::make_index_sequence<TBlock::member_count>{});
+                return;
+            }
+        }
+        [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            (store<NIndices>(source.template load<NIndices>()), ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Compare every member with another view of the same block. Bytes between members are not compared.
+    ///
+    /// @param other The view to compare with.
+    ///
+    /// @returns True if every member has the same raw value.
+    template <typename TOtherByte>
+    constexpr bool equals(const block_view<TBlock, TOtherByte> other) const noexcept {
+        return [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return ((load<NIndices>().raw_value == other.template load<NIndices>().raw_value) && ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// The address of the block.
+    constexpr TByte* data() const noexcept {
+        return base_;
+    }
+
+private:
+    TByte* base_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_BLOCK_HPP
+/// Predefined layouts of common network protocol headers: Ethernet, 802.1Q VLAN tags, IPv4, IPv6, TCP, and UDP.
+#ifndef NETWORK_HEADERS_HPP
+#define NETWORK_HEADERS_HPP
+
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Layouts of network protocol headers. Every header is big-endian on the wire, and is described as a layout_block of
+/// 16- and 32-bit big-endian words, viewed in place in a packet buffer with a block_view.
+///
+/// The RFCs draw each word with its most significant bit first, on the left. Once a word is loaded big-endian, its
+/// first bit on the wire is its most significant bit, so each layout below lists its fields in the reverse of the RFC
+/// diagram, starting from the least significant bit at the right of the diagram.
+namespace net {
+
+/// EtherType values.
+enum class ether_type : std::uint16_t {
+    ipv4 = 0x0800,
+    arp = 0x0806,
+    vlan = 0x8100,
+    ipv6 = 0x86DD,
+    qinq = 0x88A8,
+};
+
+/// IP protocol numbers, as found in ipv4_word2::protocol and ipv6_word1::next_header.
+enum class ip_protocol : std::uint8_t {
+    icmp = 1,
+    tcp = 6,
+    udp = 17,
+    icmpv6 = 58,
+};
+
+/// The type or length field of an Ethernet frame, or of a VLAN tag.
+struct ethernet_type : bit_field_builder<ethernet_type, std::uint16_t> {
+    BIT_FIELD(type, 16, bit_field_config<ether_type>{});
+};
+
+/// An Ethernet II header: destination and source MAC addresses, then the EtherType. The addresses are 48 bits; read
+/// them with load_mac.
+using ethernet_header = layout_block<block_member<12, ethernet_type, std::endian::big>>;
+
+inline constexpr std::size_t ethernet_header_size = 14;
+
+/// Load a 48-bit MAC address, such as the destination at offset 0 or the source at offset 6 of an Ethernet header.
+///
+/// @param data Points at the first of six bytes.
+///
+/// @returns The address, with its first byte in bits 40 to 47.
+constexpr std::uint64_t load_mac(const std::byte* const data) noexcept {
+    return (std::uint64_t{ load_bytes<std::uint32_t, std::endian::big>(data) } << 16) |
+           load_bytes<std::uint16_t, std::endian::big>(data + 4);
+}
+
+/// The tag control information of an 802.1Q VLAN tag.
+struct vlan_tci : bit_field_builder<vlan_tci, std::uint16_t> {
+    BIT_FIELD(vid, 12);                             ///< VLAN identifier.
+    BIT_FIELD(dei, 1, bit_field_config<bool>{});    ///< Drop eligible indicator.
+    BIT_FIELD(pcp, 3);                              ///< Priority code point.
+};
+
+/// An 802.1Q VLAN tag following an EtherType of ether_type::vlan: the tag control information, then the EtherType of
+/// the encapsulated frame.
+using vlan_tag = layout_block<
+    block_member<0, vlan_tci, std::endian::big>,
+    block_member<2, ethernet_type, std::endian::big>>;
+
+inline constexpr std::size_t vlan_tag_size = 4;
+
+/// The first word of an IPv4 header.
+struct ipv4_word0 : bit_field_builder<ipv4_word0, std::uint32_t> {
+    BIT_FIELD(total_length, 16);
+    BIT_FIELD(ecn,           2);
+    BIT_FIELD(dscp,          6);
+    BIT_FIELD(ihl,           4);                    ///< The header length in 32-bit words.
+    BIT_FIELD(version,       4);
+};
+
+/// The second word of an IPv4 header.
+struct ipv4_word1 : bit_field_builder<ipv4_word1, std::uint32_t> {
+    BIT_FIELD(fragment_offset, 13);                 ///< In units of 8 bytes.
+    BIT_FIELD(more_fragments,   1, bit_field_config<bool>{});
+    BIT_FIELD(dont_fragment,    1, bit_field_config<bool>{});
+    BIT_FIELD(reserved,         1);
+    BIT_FIELD(identification,  16);
+};
+
+/// The third word of an IPv4 header.
+struct ipv4_word2 : bit_field_builder<ipv4_word2, std::uint32_t> {
+    BIT_FIELD(checksum, 16);
+    BIT_FIELD(protocol,  8, bit_field_config<ip_protocol>{});
+    BIT_FIELD(ttl,       8);
+};
+
+/// The source address of an IPv4 header.
+struct ipv4_source : bit_field_builder<ipv4_source, std::uint32_t> {
+    BIT_FIELD(address, 32);
+};
+
+/// The destination address of an IPv4 header.
+struct ipv4_destination : bit_field_builder<ipv4_destination, std::uint32_t> {
+    BIT_FIELD(address, 32);
+};
+
+/// The fixed 20 bytes of an IPv4 header. Options, if ipv4_word0::ihl is more than 5, follow.
+using ipv4_header = layout_block<
+    block_member<0, ipv4_word0, std::endian::big>,
+    block_member<4, ipv4_word1, std::endian::big>,
+    block_member<8, ipv4_word2, std::endian::big>,
+    block_member<12, ipv4_source, std::endian::big>,
+    block_member<16, ipv4_destination, std::endian::big>>;
+
+/// An IPv4 header with its options, for walking a packet with a layout_cursor.
+using ipv4_segment = segment<std::endian::big, length_from<0, ipv4_word0::ihl, 4>, ipv4_word0, ipv4_word1, ipv4_word2,
+                             ipv4_source, ipv4_destination>;
+
+/// The first word of an IPv6 header.
+struct ipv6_word0 : bit_field_builder<ipv6_word0, std::uint32_t> {
+    BIT_FIELD(flow_label, 20);
+    BIT_FIELD(ecn,         2);
+    BIT_FIELD(dscp,        6);
+    BIT_FIELD(version,     4);
+};
+
+/// The second word of an IPv6 header.
+struct ipv6_word1 : bit_field_builder<ipv6_word1, std::uint32_t> {
+    BIT_FIELD(hop_limit,       8);
+    BIT_FIELD(next_header,     8, bit_field_config<ip_protocol>{});
+    BIT_FIELD(payload_length, 16);
+};
+
+/// The fixed 40 bytes of an IPv6 header. The 128-bit addresses are read with ipv6_source and ipv6_destination.
+using ipv6_header = layout_block<
+    block_member<0, ipv6_word0, std::endian::big>,
+    block_member<4, ipv6_word1, std::endian::big>>;
+
+inline constexpr std::size_t ipv6_header_size = 40;
+
+/// The source address of an IPv6 header, in network byte order.
+///
+/// @param header The header, at least ipv6_header_size bytes.
+constexpr std::span<const std::byte, 16> ipv6_source(const std::span<const std::byte> header) noexcept {
+    return header.subspan<8, 16>();
+}
+
+/// The destination address of an IPv6 header, in network byte order.
+///
+/// @param header The header, at least ipv6_header_size bytes.
+constexpr std::span<const std::byte, 16> ipv6_destination(const std::span<const std::byte> header) noexcept {
+    return header.subspan<24, 16>();
+}
+
+/// The source and destination ports of a TCP or UDP header.
+struct transport_ports : bit_field_builder<transport_ports, std::uint32_t> {
+    BIT_FIELD(destination_port, 16);
+    BIT_FIELD(source_port,      16);
+};
+
+/// The sequence number of a TCP header.
+struct tcp_sequence : bit_field_builder<tcp_sequence, std::uint32_t> {
+    BIT_FIELD(number, 32);
+};
+
+/// The acknowledgment number of a TCP header.
+struct tcp_acknowledgment : bit_field_builder<tcp_acknowledgment, std::uint32_t> {
+    BIT_FIELD(number, 32);
+};
+
+/// The data offset, flags, and window of a TCP header.
+struct tcp_control : bit_field_builder<tcp_control, std::uint32_t> {
+    BIT_FIELD(window,      16);
+    BIT_FIELD(fin,          1, bit_field_config<bool>{});
+    BIT_FIELD(syn,          1, bit_field_config<bool>{});
+    BIT_FIELD(rst,          1, bit_field_config<bool>{});
+    BIT_FIELD(psh,          1, bit_field_config<bool>{});
+    BIT_FIELD(ack,          1, bit_field_config<bool>{});
+    BIT_FIELD(urg,          1, bit_field_config<bool>{});
+    BIT_FIELD(ece,          1, bit_field_config<bool>{});
+    BIT_FIELD(cwr,          1, bit_field_config<bool>{});
+    BIT_FIELD(ns,           1, bit_field_config<bool>{});
+    BIT_FIELD(reserved,     3);
+    BIT_FIELD(data_offset,  4);                     ///< The header length in 32-bit words.
+};
+
+/// The checksum and urgent pointer of a TCP header.
+struct tcp_checksum : bit_field_builder<tcp_checksum, std::uint32_t> {
+    BIT_FIELD(urgent_pointer, 16);
+    BIT_FIELD(checksum,       16);
+};
+
+/// The fixed 20 bytes of a TCP header. Options, if tcp_control::data_offset is more than 5, follow.
+using tcp_header = layout_block<
+    block_member<0, transport_ports, std::endian::big>,
+    block_member<4, tcp_sequence, std::endian::big>,
+    block_member<8, tcp_acknowledgment, std::endian::big>,
+    block_member<12, tcp_control, std::endian::big>,
+    block_member<16, tcp_checksum, std::endian::big>>;
+
+/// A TCP header with its options, for walking a packet with a layout_cursor.
+using tcp_segment = segment<std::endian::big, length_from<3, tcp_control::data_offset, 4>, transport_ports,
+                            tcp_sequence, tcp_acknowledgment, tcp_control, tcp_checksum>;
+
+/// The length and checksum of a UDP header.
+struct udp_length : bit_field_builder<udp_length, std::uint32_t> {
+    BIT_FIELD(checksum, 16);
+    BIT_FIELD(length,   16);                        ///< The length of the header and payload in bytes.
+};
+
+/// A UDP header.
+using udp_header = layout_block<
+    block_member<0, transport_ports, std::endian::big>,
+    block_member<4, udp_length, std::endian::big>>;
+
+} // End namespace net.
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // NETWORK_HEADERS_HPP
+/// Encoding and decoding IO-Link M-sequences: the master and device messages exchanged in every communication cycle.
+#ifndef IO_LINK_HPP
+#define IO_LINK_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Layouts and codecs for IO-Link M-sequences, following annex A of the IO-Link interface specification:
+/// https://io-link.com/share/Downloads/Package-2020/IOL-Interface-Spec_10002_V113_Jun19.pdf
+///
+/// A master message is the M-sequence control octet (MC), the checksum/M-sequence type octet (CKT), the output
+/// process data, and, when writing, the on-request data. The device replies with the on-request data, when reading,
+/// the input process data, and the checksum/status octet (CKS).
+namespace io_link {
+
+enum class communication_channel : std::uint8_t {
+    process   = 0,
+    page      = 1,
+    diagnosis = 2,
+    isdu      = 3
+};
+
+enum class transmission_direction : std::uint8_t {
+    write = 0,
+    read  = 1
+};
+
+enum class m_sequence_type : std::uint8_t {
+    type_0 = 0,
+    type_1 = 1,
+    type_2 = 2,
+};
+
+/// The M-sequence control octet, the first octet of a master message. See section A.1.2.
+struct m_sequence_control : bit_field_builder<m_sequence_control, std::uint8_t> {
+    BIT_FIELD(address,   5, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(channel,   2, bit_field_config<communication_channel>{});
+    BIT_FIELD(direction, 1, bit_field_config<transmission_direction>{});
+};
+
+/// The checksum/M-sequence type octet, the second octet of a master message. See section A.1.3.
+struct checksum_type : bit_field_builder<checksum_type, std::uint8_t> {
+    BIT_FIELD(checksum, 6, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(type,     2, bit_field_config<m_sequence_type>{});
+};
+
+/// The checksum/status octet, the last octet of a device message. See section A.1.5.
+struct checksum_status : bit_field_builder<checksum_status, std::uint8_t> {
+    BIT_FIELD(checksum,             6, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(process_data_invalid, 1, bit_field_config<bool>{});
+    BIT_FIELD(event,                1, bit_field_config<bool>{});
+};
+
+/// The shape of a port's M-sequences: the M-sequence type sent in CKT, and the number of octets of each part, as
+/// agreed with the device from its M-sequence capability.
+struct m_sequence_format {
+    m_sequence_type type;
+    std::uint8_t process_data_out;
+    std::uint8_t process_data_in;
+    std::uint8_t on_request_data;
+
+    /// The size of the master message of a cycle in a direction.
+    constexpr std::size_t master_size(const transmission_direction direction) const noexcept {
+        return 2u + process_data_out + (direction == transmission_direction::write ? on_request_data : 0u);
+    }
+
+    /// The size of the device message of a cycle in a direction.
+    constexpr std::size_t device_size(const transmission_direction direction) const noexcept {
+        return 1u + process_data_in + (direction == transmission_direction::read ? on_request_data : 0u);
+    }
+
+    constexpr bool operator==(const m_sequence_format&) const noexcept = default;
+};
+
+/// TYPE_0: one octet of on-request data, no process data. Used during startup and preoperate.
+inline constexpr m_sequence_format type_0{ m_sequence_type::type_0, 0, 0, 1 };
+
+/// TYPE_1_2: two octets of on-request data, no process data.
+inline constexpr m_sequence_format type_1_2{ m_sequence_type::type_1, 0, 0, 2 };
+
+/// TYPE_1_V: 8 or 32 octets of on-request data, no process data.
+constexpr m_sequence_format type_1_v(const std::uint8_t on_request_data) noexcept {
+    return { m_sequence_type::type_1, 0, 0, on_request_data };
+}
+
+/// TYPE_2_1 to TYPE_2_5: one octet of on-request data with one or two octets of process data.
+inline constexpr m_sequence_format type_2_1{ m_sequence_type::type_2, 0, 1, 1 };
+inline constexpr m_sequence_format type_2_2{ m_sequence_type::type_2, 0, 2, 1 };
+inline constexpr m_sequence_format type_2_3{ m_sequence_type::type_2, 1, 0, 1 };
+inline constexpr m_sequence_format type_2_4{ m_sequence_type::type_2, 2, 0, 1 };
+inline constexpr m_sequence_format type_2_5{ m_sequence_type::type_2, 1, 1, 1 };
+
+/// TYPE_2_V: up to 32 octets of process data in each direction, with 1, 2, 8, or 32 octets of on-request data.
+constexpr m_sequence_format type_2_v(const std::uint8_t process_data_out, const std::uint8_t process_data_in,
+                                     const std::uint8_t on_request_data) noexcept {
+    return { m_sequence_type::type_2, process_data_out, process_data_in, on_request_data };
+}
+
+/// The parts of a master message. The spans view the frame it was decoded from, or the data to encode.
+struct master_message {
+    m_sequence_control control;
+    std::span<const std::byte> process_data;
+    std::span<const std::byte> on_request_data;
+};
+
+/// The parts of a device message. The spans view the frame it was decoded from, or the data to encode.
+struct device_message {
+    std::span<const std::byte> on_request_data;
+    std::span<const std::byte> process_data;
+    bool event{false};
+    bool process_data_invalid{false};
+};
+
+namespace detail {
+
+/// The seed every message's checksum starts from. See section A.1.6.
+inline constexpr std::uint8_t checksum_seed = 0x52;
+
+/// The 6-bit checksum of every 8-bit XOR of a message's octets, seed included, which compresses pairs of bits of the
+/// 8-bit value as in figure A.3 of the specification.
+inline constexpr std::array<std::uint8_t, 256> checksum_table = []() constexpr {
+    std::array<std::uint8_t, 256> result{};
+    for (unsigned value = 0; value < 256; ++value) {
+        const auto bit = [value](const unsigned index) { return (value >> index) & 1u; };
+        const unsigned compressed = (bit(7) ^ bit(5) ^ bit(3) ^ bit(1)) << 5 |
+                                    (bit(6) ^ bit(4) ^ bit(2) ^ bit(0)) << 4 |
+                                    (bit(7) ^ bit(6)) << 3 |
+                                    (bit(5) ^ bit(4)) << 2 |
+                                    (bit(3) ^ bit(2)) << 1 |
+                                    (bit(1) ^ bit(0));
+        result[value] = static_cast<std::uint8_t>(compressed);
+    }
+    return result;
+}();
+
+/// The XOR of a run of octets. At run time, eight octets are folded at once.
+constexpr std::uint8_t fold_octets(std::span<const std::byte> octets) noexcept {
+    std::uint64_t folded = 0;
+    if (!std::is_constant_evaluated()) {
+        for (; octets.size() >= 8; octets = octets.subspan(8)) {
+            std::uint64_t word;
+            std::memcpy(&word, octets.data(), 8);
+            folded ^= word;
+        }
+        if (octets.size() >= 4) {
+            std::uint32_t word;
+            std::memcpy(&word, octets.data(), 4);
+            folded ^= word;
+            octets = octets.subspan(4);
+        }
+        folded ^= folded >> 32;
+        folded ^= folded >> 16;
+        folded ^= folded >> 8;
+    }
+    for (const std::byte octet : octets) {
+        folded ^= static_cast<std::uint8_t>(octet);
+    }
+    return static_cast<std::uint8_t>(folded);
+}
+
+/// The checksum of a received message, computed as if the checksum bits of its octet at an index were zero.
+constexpr std::uint8_t received_checksum(const std::span<const std::byte> message, const std::size_t index) noexcept {
+    const unsigned embedded = static_cast<std::uint8_t>(message[index]) & 0x3Fu;
+    const auto folded = static_cast<std::uint8_t>(fold_octets(message) ^ embedded);
+    return checksum_table[folded ^ checksum_seed];
+}
+
+} // End namespace detail.
+
+/// Compute the 6-bit checksum of a message. A table maps the XOR of the message's octets to the checksum, so the cost
+/// is one XOR per octet and one load.
+///
+/// @param message The whole master or device message, with the checksum bits of its CKT or CKS octet cleared.
+///
+/// @returns The checksum, which belongs in the low six bits of the CKT or CKS octet.
+constexpr std::uint8_t checksum(const std::span<const std::byte> message) noexcept {
+    return detail::checksum_table[detail::fold_octets(message) ^ detail::checksum_seed];
+}
+
+/// Encode a master message.
+///
+/// @param format  The port's M-sequence format.
+/// @param message The control octet and data. The process data must be format.process_data_out octets, and the
+///                on-request data format.on_request_data octets when writing, or empty when reading.
+/// @param frame   Receives the message.
+///
+/// @returns The size of the message, or zero if the data does not match the format or the frame is too small.
+constexpr std::size_t encode_master(const m_sequence_format& format, const master_message& message,
+                                    const std::span<std::byte> frame) noexcept {
+    const transmission_direction direction = message.control.get_direction();
+    const std::size_t size = format.master_size(direction);
+    const std::size_t on_request_data = direction == transmission_direction::write ? format.on_request_data : 0;
+    if (message.process_data.size() != format.process_data_out ||
+        message.on_request_data.size() != on_request_data || frame.size() < size) {
+        return 0;
+    }
+    checksum_type type{};
+    type.set_type(format.type);
+    frame[0] = static_cast<std::byte>(message.control.raw_value);
+    frame[1] = static_cast<std::byte>(type.raw_value);
+    std::copy(message.process_data.begin(), message.process_data.end(), frame.begin() + 2);
+    std::copy(message.on_request_data.begin(), message.on_request_data.end(),
+              frame.begin() + 2 + static_cast<std::ptrdiff_t>(format.process_data_out));
+    type.set_checksum(checksum(frame.first(size)));
+    frame[1] = static_cast<std::byte>(type.raw_value);
+    return size;
+}
+
+/// Decode and check a master message, as a device does.
+///
+/// @param format The port's M-sequence format.
+/// @param frame  The message.
+///
+/// @returns The message, viewing the frame, or an empty optional if the frame's size, M-sequence type, or checksum
+///          is wrong.
+constexpr std::optional<master_message> decode_master(const m_sequence_format& format,
+                                                      const std::span<const std::byte> frame) noexcept {
+    if (frame.size() < 2) {
+        return std::nullopt;
+    }
+    const m_sequence_control control{ static_cast<std::uint8_t>(frame[0]) };
+    const checksum_type type{ static_cast<std::uint8_t>(frame[1]) };
+    if (frame.size() != format.master_size(control.get_direction()) || type.get_type() != format.type ||
+        detail::received_checksum(frame, 1) != type.get_checksum()) {
+        return std::nullopt;
+    }
+    return master_message{
+        control,
+        frame.subspan(2, format.process_data_out),
+        frame.subspan(2u + format.process_data_out),
+    };
+}
+
+/// Encode a device message, as a device replies to a master message.
+///
+/// @param format  The port's M-sequence format.
+/// @param control The control octet of the master message being answered.
+/// @param message The data and status. The process data must be format.process_data_in octets, and the on-request
+///                data format.on_request_data octets when reading, or empty when writing.
+/// @param frame   Receives the message.
+///
+/// @returns The size of the message, or zero if the data does not match the format or the frame is too small.
+constexpr std::size_t encode_device(const m_sequence_format& format, const m_sequence_control control,
+                                    const device_message& message, const std::span<std::byte> frame) noexcept {
+    const transmission_direction direction = control.get_direction();
+    const std::size_t size = format.device_size(direction);
+    const std::size_t on_request_data = direction == transmission_direction::read ? format.on_request_data : 0;
+    if (message.process_data.size() != format.process_data_in ||
+        message.on_request_data.size() != on_request_data || frame.size() < size) {
+        return 0;
+    }
+    checksum_status status{};
+    status.set_event(message.event);
+    status.set_process_data_invalid(message.process_data_invalid);
+    std::copy(message.on_request_data.begin(), message.on_request_data.end(), frame.begin());
+    std::copy(message.process_data.begin(), message.process_data.end(),
+              frame.begin() + static_cast<std::ptrdiff_t>(on_request_data));
+    frame[size - 1] = static_cast<std::byte>(status.raw_value);
+    status.set_checksum(checksum(frame.first(size)));
+    frame[size - 1] = static_cast<std::byte>(status.raw_value);
+    return size;
+}
+
+/// Decode and check a device message, as the master does.
+///
+/// @param format  The port's M-sequence format.
+/// @param control The control octet of the master message the device answered.
+/// @param frame   The message.
+///
+/// @returns The message, viewing the frame, or an empty optional if the frame's size or checksum is wrong.
+constexpr std::optional<device_message> decode_device(const m_sequence_format& format,
+                                                      const m_sequence_control control,
+                                                      const std::span<const std::byte> frame) noexcept {
+    const transmission_direction direction = control.get_direction();
+    if (frame.size() != format.device_size(direction)) {
+        return std::nullopt;
+    }
+    const checksum_status status{ static_cast<std::uint8_t>(frame.back()) };
+    if (detail::received_checksum(frame, frame.size() - 1) != status.get_checksum()) {
+        return std::nullopt;
+    }
+    const std::size_t on_request_data = direction == transmission_direction::read ? format.on_request_data : 0;
+    return device_message{
+        frame.first(on_request_data),
+        frame.subspan(on_request_data, format.process_data_in),
+        status.get_event(),
+        status.get_process_data_invalid(),
+    };
+}
+
+/// Encode the master messages of many ports at once, as a gateway does once per cycle. The messages are written one
+/// after another, each format.master_size bytes long.
+///
+/// @param formats  Each port's M-sequence format.
+/// @param messages Each port's message, as for encode_master.
+/// @param frames   Receives the messages.
+///
+/// @returns The total size of the messages, or zero if any message does not match its format or the frames are too
+///          small.
+constexpr std::size_t encode_master_messages(const std::span<const m_sequence_format> formats,
+                                             const std::span<const master_message> messages,
+                                             const std::span<std::byte> frames) noexcept {
+    if (formats.size() != messages.size()) {
+        return 0;
+    }
+    std::size_t offset = 0;
+    for (std::size_t port = 0; port < messages.size(); ++port) {
+        const std::size_t size = encode_master(formats[port], messages[port], frames.subspan(offset));
+        if (size == 0) {
+            return 0;
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+/// Decode the device messages of many ports at once, as a gateway does once per cycle. The messages are read one after
+/// another, each format.device_size bytes long for the direction of its port's control octet.
+///
+/// @param formats  Each port's M-sequence format.
+/// @param controls The control octet each port's device answered.
+/// @param frames   The messages.
+/// @param messages Receives each port's message, or an empty optional if its checksum is wrong.
+///
+/// @returns The number of messages with a correct checksum, or zero if the spans' sizes disagree.
+constexpr std::size_t decode_device_messages(const std::span<const m_sequence_format> formats,
+                                             const std::span<const m_sequence_control> controls,
+                                             const std::span<const std::byte> frames,
+                                             const std::span<std::optional<device_message>> messages) noexcept {
+    if (formats.size() != controls.size() || formats.size() != messages.size()) {
+        return 0;
+    }
+    std::size_t offset = 0;
+    std::size_t valid = 0;
+    for (std::size_t port = 0; port < formats.size(); ++port) {
+        const std::size_t size = formats[port].device_size(controls[port].get_direction());
+        if (size > frames.size() - offset) {
+            return 0;
+        }
+        messages[port] = decode_device(formats[port], controls[port], frames.subspan(offset, size));
+        valid += messages[port].has_value() ? 1u : 0u;
+        offset += size;
+    }
+    return valid;
+}
+
+} // End namespace io_link.
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // IO_LINK_HPP
+/// Classifying layout records against many rules at once, each matching a value or range of several fields.
+#ifndef LAYOUT_CLASSIFIER_HPP
+#define LAYOUT_CLASSIFIER_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A rule for layout_classifier: a range of accepted values for each field, all of which must hold. Fields the rule
+/// does not mention accept any value. Values are the raw bits of each field, compared as unsigned numbers.
+///
+/// @tparam TLayout The layout of the records.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class classifier_rule {
+    using fields = layout_fields<TLayout>;
+
+public:
+    constexpr classifier_rule() noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            high_[field] = field_mask(field);
+        }
+    }
+
+    /// Require a field to lie in a range of values. Requiring a field twice accepts only values in both ranges.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param low  The smallest accepted value.
+    /// @param high The largest accepted value.
+    template <typename TField>
+    constexpr classifier_rule& where(const std::uint64_t low, const std::uint64_t high) noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        low_[field] = std::max(low_[field], low);
+        high_[field] = std::min(high_[field], high);
+        return *this;
+    }
+
+    /// Require a field to equal a value.
+    template <typename TField>
+    constexpr classifier_rule& where(const std::uint64_t value) noexcept {
+        return where<TField>(value, value);
+    }
+
+    /// The smallest value of a field the rule accepts.
+    constexpr std::uint64_t low(const std::size_t field) const noexcept {
+        return low_[field];
+    }
+
+    /// The largest value of a field the rule accepts.
+    constexpr std::uint64_t high(const std::size_t field) const noexcept {
+        return high_[field];
+    }
+
+    /// Returns true if the rule restricts a field.
+    constexpr bool restricts(const std::size_t field) const noexcept {
+        return low_[field] != 0 || high_[field] != field_mask(field);
+    }
+
+    /// Returns true if some record can match the rule.
+    constexpr bool satisfiable() const noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            if (low_[field] > high_[field]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Test a record against the rule directly, one field at a time.
+    constexpr bool matches(const TLayout& record) const noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            const std::uint64_t value = field_value(record, field);
+            if (value < low_[field] || value > high_[field]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// The value of a field of a record.
+    static constexpr std::uint64_t field_value(const TLayout& record, const std::size_t field) noexcept {
+        using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+        return (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> fields::offsets[field]) &
+               field_mask(field);
+    }
+
+    /// The largest value of a field.
+    static constexpr std::uint64_t field_mask(const std::size_t field) noexcept {
+        const unsigned width = fields::width_of(field);
+        return width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    }
+
+private:
+    std::array<std::uint64_t, fields::count> low_{};
+    std::array<std::uint64_t, fields::count> high_{};
+};
+
+/// A classifier compiled from a list of rules, which finds the first rule a record matches without testing the rules
+/// one by one.
+///
+/// Each field some rule restricts is split into intervals at the ends of every rule's range, so all values in an
+/// interval match the same rules. For each interval, the classifier stores the set of rules it allows, one bit per
+/// rule. Classifying a record looks up the interval of each restricted field, directly in a table for fields of up to
+/// 12 bits or by binary search otherwise, and intersects their rule sets a word at a time. The first bit left is the
+/// first matching rule. The cost grows with the number of restricted fields and with the number of rules / 64, rather
+/// than with the number of rules.
+///
+/// @tparam TLayout The layout of the records.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class layout_classifier {
+    using fields = layout_fields<TLayout>;
+    using rule_type = classifier_rule<TLayout>;
+
+public:
+    /// The result of classifying a record which matches no rule.
+    static constexpr std::size_t no_match = ~std::size_t{0};
+
+    /// The widest field looked up in a table rather than by binary search.
+    static constexpr unsigned max_table_width = 12;
+
+    constexpr layout_classifier() = default;
+
+    /// Compile a classifier from rules. Earlier rules take priority over later ones.
+    ///
+    /// @param rules The rules.
+    constexpr explicit layout_classifier(const std::span<const rule_type> rules)
+        : rule_count_(rules.size()),
+          words_((rules.size() + 63) / 64),
+          allowed_(words_, 0) {
+        for (std::size_t rule = 0; rule < rules.size(); ++rule) {
+            if (rules[rule].satisfiable()) {
+                allowed_[rule / 64] |= std::uint64_t{1} << (rule % 64);
+            }
+        }
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            if (std::any_of(rules.begin(), rules.end(), [field](const rule_type& rule) {
+                    return rule.restricts(field);
+                })) {
+                dimensions_.push_back(make_dimension(rules, field));
+            }
+        }
+    }
+
+    /// The number of rules.
+    constexpr std::size_t rule_count() const noexcept {
+        return rule_count_;
+    }
+
+    /// The number of 64-bit words in a set of rules.
+    constexpr std::size_t word_count() const noexcept {
+        return words_;
+    }
+
+    /// The number of fields some rule restricts, each of which is looked up when classifying.
+    constexpr std::size_t dimension_count() const noexcept {
+        return dimensions_.size();
+    }
+
+    /// Find the first rule a record matches.
+    ///
+    /// @returns The index of the rule, or no_match.
+    constexpr std::size_t classify(const TLayout& record) const noexcept {
+        std::array<const std::uint64_t*, fields::count> rows{};
+        for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+            rows[i] = row_of(dimensions_[i], record);
+        }
+        return first_match(rows);
+    }
+
+    /// Find the first rule each of several records matches. The records are taken in groups whose lookups are made
+    /// together before any of their rule sets are intersected, so the lookups' loads overlap.
+    ///
+    /// @param records The records.
+    /// @param results Receives the index of each record's first matching rule, or no_match. Must be at least as long
+    ///                as records.
+    constexpr void classify(const std::span<const TLayout> records,
+                            const std::span<std::size_t> results) const noexcept {
+        constexpr std::size_t group = 8;
+        std::array<std::array<const std::uint64_t*, fields::count>, group> rows{};
+        for (std::size_t first = 0; first < records.size(); first += group) {
+            const std::size_t size = std::min(group, records.size() - first);
+            for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+                for (std::size_t j = 0; j < size; ++j) {
+                    rows[j][i] = row_of(dimensions_[i], records[first + j]);
+                }
+            }
+            for (std::size_t j = 0; j < size; ++j) {
+                results[first + j] = first_match(rows[j]);
+            }
+        }
+    }
+
+    /// Find every rule a record matches.
+    ///
+    /// @param record  The record.
+    /// @param matches Receives the set of matching rules, one bit per rule, rule i being bit i % 64 of word i / 64.
+    ///                Must be word_count() words long.
+    constexpr void match_all(const TLayout& record, const std::span<std::uint64_t> matches) const noexcept {
+        std::copy(allowed_.begin(), allowed_.end(), matches.begin());
+        for (const dimension& each : dimensions_) {
+            const std::uint64_t* const row = row_of(each, record);
+            for (std::size_t word = 0; word < words_; ++word) {
+                matches[word] &= row[word];
+            }
+        }
+    }
+
+private:
+    /// A restricted field: the starts of its intervals, and the set of rules each interval allows.
+    struct dimension {
+        unsigned offset;
+        std::uint64_t mask;
+        std::vector<std::uint64_t> starts;
+        std::vector<std::uint32_t> table;
+        std::vector<std::uint64_t> rows;
+    };
+
+    constexpr dimension make_dimension(const std::span<const rule_type> rules, const std::size_t field) const {
+        dimension result{ fields::offsets[field], rule_type::field_mask(field), { 0 }, {}, {} };
+        for (const rule_type& rule : rules) {
+            if (rule.restricts(field) && rule.satisfiable()) {
+                result.starts.push_back(rule.low(field));
+                if (rule.high(field) != result.mask) {
+                    result.starts.push_back(rule.high(field) + 1);
+                }
+            }
+        }
+        std::sort(result.starts.begin(), result.starts.end());
+        result.starts.erase(std::unique(result.starts.begin(), result.starts.end()), result.starts.end());
+
+        const std::size_t intervals = result.starts.size();
+        result.rows.assign(intervals * words_, 0);
+        for (std::size_t rule = 0; rule < rules.size(); ++rule) {
+            if (!rules[rule].satisfiable()) {
+                continue;
+            }
+            const std::size_t from = interval_of(result.starts, rules[rule].low(field));
+            const std::size_t to = interval_of(result.starts, rules[rule].high(field));
+            for (std::size_t interval = from; interval <= to; ++interval) {
+                result.rows[interval * words_ + rule / 64] |= std::uint64_t{1} << (rule % 64);
+            }
+        }
+
+        if (fields::width_of(field) <= max_table_width) {
+            result.table.resize(result.mask + 1);
+            std::size_t interval = 0;
+            for (std::uint64_t value = 0; value <= result.mask; ++value) {
+                while (interval + 1 < intervals && result.starts[interval + 1] <= value) {
+                    ++interval;
+                }
+                result.table[value] = static_cast<std::uint32_t>(interval * words_);
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::size_t interval_of(const std::vector<std::uint64_t>& starts, const std::uint64_t value) {
+        return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), value) - starts.begin()) - 1;
+    }
+
+    constexpr const std::uint64_t* row_of(const dimension& each, const TLayout& record) const noexcept {
+        using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+        const std::uint64_t value =
+            (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> each.offset) & each.mask;
+        if (!each.table.empty()) {
+            return each.rows.data() + each.table[value];
+        }
+        // A branchless binary search, since the interval of each record is unpredictable. The first start is zero, so
+        // the search always ends on the last start at or below the value.
+        const std::uint64_t* first = each.starts.data();
+        for (std::size_t size = each.starts.size(); size > 1;) {
+            const std::size_t half = size / 2;
+            first = first[half] <= value ? first + half : first;
+            size -= half;
+        }
+        return each.rows.data() + static_cast<std::size_t>(first - each.starts.data()) * words_;
+    }
+
+    /// Intersect the rule sets of a record's intervals a word at a time, and return the first rule left. The inner loop
+    /// has no early exit, so it compiles to a straight run of loads and ANDs.
+    constexpr std::size_t first_match(const std::array<const std::uint64_t*, fields::count>& rows) const noexcept {
+        for (std::size_t word = 0; word < words_; ++word) {
+            std::uint64_t candidates = allowed_[word];
+            for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+                candidates &= rows[i][word];
+            }
+            if (candidates != 0) {
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(candidates));
+            }
+        }
+        return no_match;
+    }
+
+    std::size_t rule_count_{0};
+    std::size_t words_{0};
+    std::vector<std::uint64_t> allowed_;
+    std::vector<dimension> dimensions_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_CLASSIFIER_HPP
+/// Tables of every possible value of a narrow layout, decoded ahead of time.
+#ifndef DECODE_TABLE_HPP
+#define DECODE_TABLE_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The size of the chunks a decode_table is decoded in. Each chunk is a separate constant evaluation, which keeps a
+/// 65536-entry table within the compiler's limit on the work done by any one evaluation.
+inline constexpr std::size_t decode_table_chunk_size = 4096;
+
+/// One chunk of a decode_table: the decoded values of NSize consecutive raw values, starting at NFirst.
+template <typename TLayout, auto FDecode, typename TDecoded, std::size_t NFirst, std::size_t NSize>
+inline constexpr std::array<TDecoded, NSize> decode_table_chunk = []() constexpr {
+    std::array<TDecoded, NSize> result{};
+    for (std::size_t i = 0; i < NSize; ++i) {
+        TLayout layout{};
+        layout.raw_value = static_cast<typename TLayout::value_type>(NFirst + i);
+        result[i] = std::invoke(FDecode, std::as_const(layout));
+    }
+    return result;
+}();
+
+} // End namespace detail.
+
+/// A table of a narrow layout decoded in full: every possible raw value is passed through a decode function once, at
+/// compile time, and the result stored. Decoding is then a single table load, however many fields the layout has and
+/// however much work each field needs, such as converting to enums, sign extension, or scaling.
+///
+/// The table has one entry per combination of the layout's allocated bits, so 256 entries for a complete 8-bit layout
+/// and 65536 for a complete 16-bit layout, each the size of the decoded type. It is a static constexpr member, so it
+/// is constant-initialized in read-only storage and costs nothing at startup. Whether it beats decoding each field with
+/// shifts and masks depends on whether the entries in use stay in cache: see bench/decode_table_bench.cpp.
+///
+/// @tparam TLayout The layout, at most 16 bits wide.
+/// @tparam FDecode A function object or function pointer, callable at compile time with a const TLayout&, which returns
+///                 the decoded value. The decoded type must be default constructible and copy assignable.
+template <bit_field_layout TLayout, auto FDecode>
+    requires (bits<typename TLayout::value_type> <= 16 && std::is_invocable_v<decltype(FDecode), const TLayout&>)
+struct decode_table {
+    using layout_type = TLayout;
+    using decoded_type = std::remove_cvref_t<std::invoke_result_t<decltype(FDecode), const TLayout&>>;
+
+    /// The number of entries, one per combination of the allocated bits.
+    static constexpr std::size_t size = std::size_t{1} << TLayout::allocated_bits();
+
+    /// The decoded value of every raw value, indexed by raw value.
+    static constexpr std::array<decoded_type, size> entries = []() constexpr {
+        std::array<decoded_type, size> result{};
+        constexpr std::size_t chunk_size = std::min(size, detail::decode_table_chunk_size);
+        [&result]<std::size_t... NChunks>(std::index_sequence<NChunks...>) constexpr {
+            (std::copy_n(detail::decode_table_chunk<TLayout, FDecode, decoded_type, NChunks * chunk_size, chunk_size>
+                             .begin(),
+                         chunk_size, result.begin() + NChunks * chunk_size),
+             ...);
+        }(std::make_index_sequence<size / chunk_size>{});
+        return result;
+    }();
+
+    /// Decode a raw value. Bits above the allocated bits are ignored.
+    ///
+    /// @param raw The raw value.
+    ///
+    /// @returns The decoded value, a reference into the table.
+    static constexpr const decoded_type& decode(const typename TLayout::value_type raw) noexcept {
+        return entries[static_cast<std::size_t>(static_cast<unsigned_type>(raw)) & (size - 1)];
+    }
+
+    /// Decode a layout.
+    static constexpr const decoded_type& decode(const TLayout& layout) noexcept {
+        return decode(layout.raw_value);
+    }
+
+    /// Decode several layouts.
+    ///
+    /// @param layouts The layouts.
+    /// @param decoded Receives the decoded values. Must be at least as long as layouts.
+    static constexpr void decode(const std::span<const TLayout> layouts,
+                                 const std::span<decoded_type> decoded) noexcept {
+        for (std::size_t i = 0; i < layouts.size(); ++i) {
+            decoded[i] = decode(layouts[i].raw_value);
+        }
+    }
+
+private:
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // DECODE_TABLE_HPP
+/// An approximate membership filter with deletion, storing bit-packed fingerprints in buckets described by a layout.
+#ifndef CUCKOO_FILTER_HPP
+#define CUCKOO_FILTER_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The finalizer of MurmurHash3, which spreads every bit of a key over the whole result.
+constexpr std::uint64_t cuckoo_mix(std::uint64_t key) noexcept {
+    key ^= key >> 33;
+    key *= 0xFF51'AFD7'ED55'8CCDu;
+    key ^= key >> 33;
+    key *= 0xC4CE'B9FE'1A85'EC53u;
+    key ^= key >> 33;
+    return key;
+}
+
+/// Returns true if every field of a layout has the same width and there are at most 64 bits of them.
+template <typename TLayout>
+constexpr bool has_equal_slots() noexcept {
+    using fields = layout_fields<TLayout>;
+    for (std::size_t field = 0; field < fields::count; ++field) {
+        if (fields::width_of(field) != fields::width_of(0) || fields::offsets[field] != field * fields::width_of(0)) {
+            return false;
+        }
+    }
+    return fields::count * fields::width_of(0) <= 64;
+}
+
+} // End namespace detail.
+
+/// A cuckoo filter: a set of keys which answers whether a key may be present, with a small rate of false positives and
+/// no false negatives, and which, unlike a Bloom filter, supports removing keys.
+///
+/// The filter stores a short fingerprint of each key in one of two buckets chosen by the key's hash. A bucket is a
+/// layout whose fields are all slots of the same width, such as five 12-bit slots in a std::uint64_t. A fingerprint of
+/// zero marks an empty slot. A lookup compares the fingerprint against every slot of both buckets, each bucket at once
+/// with a SIMD-within-a-register compare, so the slots need not be byte aligned. An insertion into two full buckets
+/// moves fingerprints to their other buckets until one fits, or gives up and moves them back.
+///
+/// With buckets of b slots of f bits filled to 95%, the false positive rate is about 2b / 2^f, and each key takes
+/// about f / 0.95 bits: for example 13.5 bits per key at 0.24% with five 12-bit slots, where a Bloom filter
+/// takes 12.5 bits, and 16.8 bits per key at 0.012% with four 16-bit slots, where a Bloom filter takes 18.8 bits.
+///
+/// @tparam TBucket The layout of a bucket. Every field is a slot. Fields must all be the same width, from 4 to 16 bits.
+template <bit_field_layout TBucket>
+    requires (bits<typename TBucket::value_type> <= 64 && detail::has_equal_slots<TBucket>() &&
+              layout_fields<TBucket>::width_of(0) >= 4 && layout_fields<TBucket>::width_of(0) <= 16)
+class cuckoo_filter {
+    using fields = layout_fields<TBucket>;
+    using unsigned_type = detail::uint_least_t<bits<typename TBucket::value_type>>;
+
+public:
+    /// The number of slots in a bucket.
+    static constexpr std::size_t slots_per_bucket = fields::count;
+
+    /// The number of bits in a fingerprint.
+    static constexpr unsigned fingerprint_bits = fields::width_of(0);
+
+    /// The number of times an insertion moves a fingerprint to its other bucket before giving up.
+    static constexpr std::size_t max_kicks = 500;
+
+    constexpr cuckoo_filter() = default;
+
+    /// Create an empty filter with room for a number of keys at a load of 95%, which buckets of four or more slots
+    /// reach.
+    ///
+    /// @param capacity The number of keys.
+    constexpr explicit cuckoo_filter(const std::size_t capacity)
+        : buckets_(std::bit_ceil(std::max<std::size_t>(2, ((capacity * 20 + 18) / 19 + slots_per_bucket - 1) /
+                                                              slots_per_bucket))),
+          mask_(buckets_.size() - 1) {}
+
+    /// Add a key. Adding a key twice stores it twice, so it must be removed twice.
+    ///
+    /// @param key The key, such as a hash of the item. It is mixed again before use, so it need not be well spread.
+    ///
+    /// @returns False if no room was found for the key, in which case the filter is left as it was.
+    constexpr bool insert(const std::uint64_t key) noexcept {
+        if (buckets_.empty()) {
+            return false;
+        }
+        const std::uint64_t hash = detail::cuckoo_mix(key);
+        std::uint64_t fingerprint = fingerprint_of(hash);
+        std::size_t index = static_cast<std::size_t>(hash) & mask_;
+        if (place(index, fingerprint) || place(alternate(index, fingerprint), fingerprint)) {
+            ++size_;
+            return true;
+        }
+        // Swap the fingerprint with a random slot of its bucket, and try to place the evicted one in its other bucket,
+        // remembering each slot swapped so that the swaps can be undone if no room is found.
+        std::array<std::size_t, max_kicks> path{};
+        for (std::size_t kick = 0; kick < max_kicks; ++kick) {
+            state_ = state_ * 6'364'136'223'846'793'005u + 1'442'695'040'888'963'407u;
+            const unsigned slot = static_cast<unsigned>((state_ >> 33) % slots_per_bucket);
+            path[kick] = index * slots_per_bucket + slot;
+            const std::uint64_t evicted = get_slot(buckets_[index], slot);
+            set_slot(buckets_[index], slot, fingerprint);
+            fingerprint = evicted;
+            index = alternate(index, fingerprint);
+            if (place(index, fingerprint)) {
+                ++size_;
+                return true;
+            }
+        }
+        for (std::size_t kick = max_kicks; kick-- > 0;) {
+            TBucket& bucket = buckets_[path[kick] / slots_per_bucket];
+            const unsigned slot = static_cast<unsigned>(path[kick] % slots_per_bucket);
+            const std::uint64_t placed = get_slot(bucket, slot);
+            set_slot(bucket, slot, fingerprint);
+            fingerprint = placed;
+        }
+        return false;
+    }
+
+    /// Returns true if a key may have been added, and false if it certainly was not.
+    constexpr bool contains(const std::uint64_t key) const noexcept {
+        if (buckets_.empty()) {
+            return false;
+        }
+        const std::uint64_t hash = detail::cuckoo_mix(key);
+        const std::uint64_t fingerprint = fingerprint_of(hash);
+        const std::size_t first = static_cast<std::size_t>(hash) & mask_;
+        const std::size_t second = alternate(first, fingerprint);
+        return (find(buckets_[first], fingerprint) | find(buckets_[second], fingerprint)) != 0;
+    }
+
+    /// Remove a key. Only keys which were added may be removed: removing any other key may remove a different key
+    /// with the same fingerprint and buckets.
+    ///
+    /// @returns False if the key was not found.
+    constexpr bool erase(const std::uint64_t key) noexcept {
+        if (buckets_.empty()) {
+            return false;
+        }
+        const std::uint64_t hash = detail::cuckoo_mix(key);
+        const std::uint64_t fingerprint = fingerprint_of(hash);
+        const std::size_t first = static_cast<std::size_t>(hash) & mask_;
+        const std::size_t second = alternate(first, fingerprint);
+        if (!remove(first, fingerprint) && !remove(second, fingerprint)) {
+            return false;
+        }
+        --size_;
+        return true;
+    }
+
+    /// The number of keys added and not removed.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// The number of buckets.
+    constexpr std::size_t bucket_count() const noexcept {
+        return buckets_.size();
+    }
+
+    /// The number of slots, the most keys the filter can hold.
+    constexpr std::size_t slot_count() const noexcept {
+        return buckets_.size() * slots_per_bucket;
+    }
+
+    /// The size of the buckets in bytes.
+    constexpr std::size_t memory_size() const noexcept {
+        return buckets_.size() * sizeof(TBucket);
+    }
+
+    /// The buckets, such as for writing the filter to a file.
+    constexpr std::span<const TBucket> buckets() const noexcept {
+        return buckets_;
+    }
+
+private:
+    static constexpr std::uint64_t slot_mask = (std::uint64_t{1} << fingerprint_bits) - 1;
+
+    /// The lowest bit of every slot.
+    static constexpr std::uint64_t low_bits = []() constexpr {
+        std::uint64_t result = 0;
+        for (std::size_t slot = 0; slot < slots_per_bucket; ++slot) {
+            result |= std::uint64_t{1} << (slot * fingerprint_bits);
+        }
+        return result;
+    }();
+
+    /// The highest bit of every slot.
+    static constexpr std::uint64_t high_bits = low_bits << (fingerprint_bits - 1);
+
+    /// The fingerprint of a hash, taken from bits the bucket index does not use. Zero marks an empty slot, so a
+    /// fingerprint of zero becomes one.
+    static constexpr std::uint64_t fingerprint_of(const std::uint64_t hash) noexcept {
+        const std::uint64_t fingerprint = (hash >> 32) & slot_mask;
+        return fingerprint == 0 ? 1 : fingerprint;
+    }
+
+    /// The other bucket of a fingerprint. Applying it twice returns to the first bucket. The offset is taken from the
+    /// high half of a Fibonacci hash of the fingerprint, since the low bits of a product only depend on the low bits
+    /// of the fingerprint, which would keep fingerprints alike in their low bits moving among the same few buckets.
+    constexpr std::size_t alternate(const std::size_t index, const std::uint64_t fingerprint) const noexcept {
+        return (index ^ static_cast<std::size_t>((fingerprint * 0x9E37'79B9'7F4A'7C15u) >> 32)) & mask_;
+    }
+
+    static constexpr std::uint64_t raw_of(const TBucket& bucket) noexcept {
+        return static_cast<std::uint64_t>(static_cast<unsigned_type>(bucket.raw_value));
+    }
+
+    /// Find a fingerprint in every slot of a bucket at once. XOR zeroes the slots holding the fingerprint, and the
+    /// classic test for a zero byte, widened to slots, finds them: subtracting one from each slot borrows out of its
+    /// high bit only if the slot was zero. Borrows carried into the next slot can only flag slots above a real match,
+    /// so the result is nonzero exactly when some slot matches, and its lowest set bit is in the first matching slot.
+    ///
+    /// @returns The high bit of the first matching slot, and perhaps others above it, or zero if no slot matches.
+    static constexpr std::uint64_t find(const TBucket& bucket, const std::uint64_t fingerprint) noexcept {
+        const std::uint64_t difference = raw_of(bucket) ^ (fingerprint * low_bits);
+        return (difference - low_bits) & ~difference & high_bits;
+    }
+
+    static constexpr std::uint64_t get_slot(const TBucket& bucket, const unsigned slot) noexcept {
+        return (raw_of(bucket) >> (slot * fingerprint_bits)) & slot_mask;
+    }
+
+    static constexpr void set_slot(TBucket& bucket, const unsigned slot, const std::uint64_t fingerprint) noexcept {
+        const unsigned offset = slot * fingerprint_bits;
+        const std::uint64_t raw = (raw_of(bucket) & ~(slot_mask << offset)) | (fingerprint << offset);
+        bucket.raw_value = static_cast<typename TBucket::value_type>(static_cast<unsigned_type>(raw));
+    }
+
+    /// Put a fingerprint in the first empty slot of a bucket.
+    ///
+    /// @returns False if the bucket is full.
+    constexpr bool place(const std::size_t index, const std::uint64_t fingerprint) noexcept {
+        const std::uint64_t empty = find(buckets_[index], 0);
+        if (empty == 0) {
+            return false;
+        }
+        set_slot(buckets_[index], static_cast<unsigned>(std::countr_zero(empty)) / fingerprint_bits, fingerprint);
+        return true;
+    }
+
+    /// Clear the first slot of a bucket holding a fingerprint.
+    ///
+    /// @returns False if no slot holds it.
+    constexpr bool remove(const std::size_t index, const std::uint64_t fingerprint) noexcept {
+        const std::uint64_t found = find(buckets_[index], fingerprint);
+        if (found == 0) {
+            return false;
+        }
+        set_slot(buckets_[index], static_cast<unsigned>(std::countr_zero(found)) / fingerprint_bits, 0);
+        return true;
+    }
+
+    std::vector<TBucket> buckets_;
+    std::size_t mask_{0};
+    std::size_t size_{0};
+    std::uint64_t state_{0x9E37'79B9'7F4A'7C15u};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CUCKOO_FILTER_HPP
+/// Compressed non-decreasing sequences of integers with random access, using the Elias-Fano encoding.
+#ifndef ELIAS_FANO_HPP
+#define ELIAS_FANO_HPP
+
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#if defined(__BMI2__) || defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The position of the rank-th set bit of a word, counting from zero. With BMI2, pdep deposits a single bit at the
+/// position of the rank-th set bit of the word.
+///
+/// @param word The word, which must have more than rank bits set.
+/// @param rank The number of set bits to skip.
+constexpr unsigned select_in_word(std::uint64_t word, const unsigned rank) noexcept {
+#if defined(__BMI2__)
+    if (!std::is_constant_evaluated()) {
+        return static_cast<unsigned>(std::countr_zero(_pdep_u64(std::uint64_t{1} << rank, word)));
+    }
+#endif
+    for (unsigned i = 0; i < rank; ++i) {
+        word &= word - 1;
+    }
+    return static_cast<unsigned>(std::countr_zero(word));
+}
+
+} // End namespace detail.
+
+/// A non-decreasing sequence of unsigned integers in Elias-Fano encoding, such as a sorted posting list or a list of
+/// timestamps. Each value is split into low bits, of a width chosen from the ratio of the largest value to the number
+/// of values, and high bits. The low bits are packed one after another into an array of words. The high bits are
+/// stored in unary as a bitvector: value i sets bit (high bits of value i) + i. A sequence of n values up to u takes
+/// about n * (2 + log2(u / n)) bits, within a fraction of a bit per value of the least possible.
+///
+/// Finding the i-th set bit or the i-th clear bit of the bitvector (select) gives random access and the search for the
+/// first value at or above a target (next_geq). The position of every 256th set bit and every 256th clear bit is
+/// sampled, so a select scans at most a few words from a sample and finishes within a word, with pdep when BMI2 is
+/// available. Decoding a run of values finds the high bits of a block of values a word of the bitvector at a time,
+/// then adds their low bits, four values at a time with AVX2.
+class elias_fano {
+public:
+    /// The number of set bits, and of clear bits, between samples of their positions.
+    static constexpr std::size_t sample_interval = 256;
+
+    constexpr elias_fano() = default;
+
+    /// Encode a sequence.
+    ///
+    /// @param values The values, in non-decreasing order.
+    constexpr explicit elias_fano(const std::span<const std::uint64_t> values)
+        : size_(values.size()), last_(values.empty() ? 0 : values.back()) {
+        if (values.empty()) {
+            return;
+        }
+        const std::uint64_t ratio = last_ / size_;
+        low_bits_ = ratio == 0 ? 0 : static_cast<unsigned>(std::bit_width(ratio)) - 1;
+        low_mask_ = low_bits_ == 0 ? 0 : ~std::uint64_t{0} >> (64 - low_bits_);
+
+        // One word of padding after each array lets a read of any position load the next word too.
+        const std::size_t high_length = size_ + static_cast<std::size_t>(last_ >> low_bits_) + 1;
+        high_.assign(high_length / 64 + 2, 0);
+        low_.assign(size_ * low_bits_ / 64 + 2, 0);
+        for (std::size_t i = 0; i < size_; ++i) {
+            const std::size_t position = static_cast<std::size_t>(values[i] >> low_bits_) + i;
+            high_[position / 64] |= std::uint64_t{1} << (position % 64);
+            if (low_bits_ != 0) {
+                const std::size_t bit = i * low_bits_;
+                const unsigned offset = static_cast<unsigned>(bit % 64);
+                const std::uint64_t low = values[i] & low_mask_;
+                low_[bit / 64] |= low << offset;
+                if (offset + low_bits_ > 64) {
+                    low_[bit / 64 + 1] |= low >> (64 - offset);
+                }
+            }
+        }
+
+        std::size_t ones = 0;
+        std::size_t zeros = 0;
+        for (std::size_t position = 0; position < high_length; ++position) {
+            if (((high_[position / 64] >> (position % 64)) & 1) != 0) {
+                if (ones++ % sample_interval == 0) {
+                    one_samples_.push_back(position);
+                }
+            } else if (zeros++ % sample_interval == 0) {
+                zero_samples_.push_back(position);
+            }
+        }
+    }
+
+    /// The number of values.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Returns true if there are no values.
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// The number of low bits of each value stored in the packed array.
+    constexpr unsigned low_bits() const noexcept {
+        return low_bits_;
+    }
+
+    /// The size of the encoding in bytes, including the samples.
+    constexpr std::size_t memory_size() const noexcept {
+        return (high_.size() + low_.size() + one_samples_.size() + zero_samples_.size()) * sizeof(std::uint64_t);
+    }
+
+    /// Access a value.
+    ///
+    /// @param index The index of the value. Not bounds checked.
+    constexpr std::uint64_t operator[](const std::size_t index) const noexcept {
+        return (static_cast<std::uint64_t>(select(one_samples_, false, index) - index) << low_bits_) | low(index);
+    }
+
+    /// Find the first value at or above a target. Values with the target's high bits start right after the clear bit
+    /// ending the previous high bits, so one select of a clear bit skips every smaller high part, and the search ends
+    /// within the values sharing the target's high bits.
+    ///
+    /// @param target The target.
+    ///
+    /// @returns The index of the first value at or above the target, or size() if every value is below it.
+    constexpr std::size_t next_geq(const std::uint64_t target) const noexcept {
+        if (size_ == 0 || target > last_) {
+            return size_;
+        }
+        const std::size_t high = static_cast<std::size_t>(target >> low_bits_);
+        const std::size_t position = high == 0 ? 0 : select(zero_samples_, true, high - 1) + 1;
+        std::size_t index = position - high;
+        std::size_t word = position / 64;
+        std::uint64_t bits = high_[word] & (~std::uint64_t{0} << (position % 64));
+        for (;; ++index) {
+            while (bits == 0) {
+                bits = high_[++word];
+            }
+            const std::size_t one = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            if (((static_cast<std::uint64_t>(one - index) << low_bits_) | low(index)) >= target) {
+                return index;
+            }
+            bits &= bits - 1;
+        }
+    }
+
+    /// Decode a run of consecutive values.
+    ///
+    /// @param first  The index of the first value.
+    /// @param output Receives the values. first + output.size() must not exceed size().
+    constexpr void decode(const std::size_t first, const std::span<std::uint64_t> output) const noexcept {
+        if (output.empty()) {
+            return;
+        }
+        const std::size_t start = select(one_samples_, false, first);
+        // Members are copied to locals, since the compiler cannot tell that stores to the output do not change them.
+        const std::uint64_t* const high = high_.data();
+        const std::uint64_t* const low = low_.data();
+        const unsigned low_bits = low_bits_;
+        const std::uint64_t low_mask = low_mask_;
+        std::size_t word = start / 64;
+        std::uint64_t bits = high[word] & (~std::uint64_t{0} << (start % 64));
+        std::size_t index = first;
+        for (std::size_t block = 0; block < output.size(); block += decode_block) {
+            const std::size_t count = std::min(decode_block, output.size() - block);
+            std::uint64_t* const out = output.data() + block;
+            // The high bits: the position of each set bit, less the index of its value.
+            for (std::size_t j = 0; j < count; ++j) {
+                while (bits == 0) {
+                    bits = high[++word];
+                }
+                out[j] = word * 64 + static_cast<std::size_t>(std::countr_zero(bits)) - (index + j);
+                bits &= bits - 1;
+            }
+            // The low bits, read in order with no dependence between values, combined with the high bits.
+            std::size_t j = 0;
+#if defined(__AVX2__)
+            if (!std::is_constant_evaluated() && low_bits <= 56) {
+                // Four values at a time: gather the eight bytes starting at the byte holding each value's first low
+                // bit, which hold all of its low bits, and shift each lane by the value's offset within that byte.
+                const auto base = static_cast<long long>(index * low_bits);
+                const auto width = static_cast<long long>(low_bits);
+                const __m256i step = _mm256_set1_epi64x(4 * width);
+                const __m256i seven = _mm256_set1_epi64x(7);
+                const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(low_mask));
+                const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(low_bits));
+                const auto* const bytes = reinterpret_cast<const long long*>(low);
+                __m256i bit = _mm256_setr_epi64x(base, base + width, base + 2 * width, base + 3 * width);
+                for (; j + 4 <= count; j += 4) {
+                    const __m256i loaded = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(bit, 3), 1);
+                    const __m256i value =
+                        _mm256_and_si256(_mm256_srlv_epi64(loaded, _mm256_and_si256(bit, seven)), mask);
+                    __m256i* const target = reinterpret_cast<__m256i*>(out + j);
+                    const __m256i high_part = _mm256_sll_epi64(_mm256_loadu_si256(target), shift);
+                    _mm256_storeu_si256(target, _mm256_or_si256(high_part, value));
+                    bit = _mm256_add_epi64(bit, step);
+                }
+            }
+#endif
+            for (; j < count; ++j) {
+                const std::size_t bit = (index + j) * low_bits;
+                const std::uint64_t value =
+                    detail::funnel_shift_right(low[bit / 64], low[bit / 64 + 1], static_cast<unsigned>(bit % 64));
+                out[j] = (out[j] << low_bits) | (value & low_mask);
+            }
+            index += count;
+        }
+    }
+
+private:
+    static constexpr std::size_t decode_block = 64;
+
+    /// The low bits of a value.
+    constexpr std::uint64_t low(const std::size_t index) const noexcept {
+        const std::size_t bit = index * low_bits_;
+        return detail::funnel_shift_right(low_[bit / 64], low_[bit / 64 + 1], static_cast<unsigned>(bit % 64)) &
+               low_mask_;
+    }
+
+    /// The position of the rank-th set bit, or of the rank-th clear bit, of the high bits.
+    constexpr std::size_t select(const std::vector<std::uint64_t>& samples, const bool zeros,
+                                 const std::size_t rank) const noexcept {
+        const std::size_t sample = samples[rank / sample_interval];
+        std::size_t remaining = rank % sample_interval;
+        std::size_t word = sample / 64;
+        const std::uint64_t flip = zeros ? ~std::uint64_t{0} : 0;
+        std::uint64_t bits = (high_[word] ^ flip) & (~std::uint64_t{0} << (sample % 64));
+        for (std::size_t count = static_cast<std::size_t>(std::popcount(bits)); count <= remaining;
+             count = static_cast<std::size_t>(std::popcount(bits))) {
+            remaining -= count;
+            bits = high_[++word] ^ flip;
+        }
+        return word * 64 + detail::select_in_word(bits, static_cast<unsigned>(remaining));
+    }
+
+    std::size_t size_{0};
+    std::uint64_t last_{0};
+    unsigned low_bits_{0};
+    std::uint64_t low_mask_{0};
+    std::vector<std::uint64_t> high_;
+    std::vector<std::uint64_t> low_;
+    std::vector<std::uint64_t> one_samples_;
+    std::vector<std::uint64_t> zero_samples_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ELIAS_FANO_HPP
@@ -0,0 +1,672 @@
+/// Atomic storage for bit field layouts, including 128-bit layouts updated with a double-width compare-and-swap.
+#ifndef ATOMIC_LAYOUT_HPP
+#define ATOMIC_LAYOUT_HPP
+
+#include "config.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__) && defined(__AVX__)
+#  include <immintrin.h>
+#endif
+
+#include "bit_field.hpp"
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// An atomic integer of up to 64 bits. A thin wrapper around std::atomic with the interface used by atomic_layout.
+template <typename T>
+class atomic_word {
+public:
+    static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+    constexpr atomic_word() noexcept = default;
+
+    constexpr explicit atomic_word(const T value) noexcept
+        : value_(value) {
+    }
+
+    T load(const std::memory_order order) const noexcept {
+        return value_.load(order);
+    }
+
+    void store(const T value, const std::memory_order order) noexcept {
+        value_.store(value, order);
+    }
+
+    bool compare_exchange_weak(T& expected, const T desired, const std::memory_order success,
+                               const std::memory_order failure) noexcept {
+        return value_.compare_exchange_weak(expected, desired, success, failure);
+    }
+
+    bool compare_exchange_strong(T& expected, const T desired, const std::memory_order success,
+                                 const std::memory_order failure) noexcept {
+        return value_.compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    T fetch_or(const T value, const std::memory_order order) noexcept {
+        return value_.fetch_or(value, order);
+    }
+
+    T fetch_and(const T value, const std::memory_order order) noexcept {
+        return value_.fetch_and(value, order);
+    }
+
+    void wait(const T old, const std::memory_order order) const noexcept {
+        value_.wait(old, order);
+    }
+
+    void notify_one() noexcept {
+        value_.notify_one();
+    }
+
+    void notify_all() noexcept {
+        value_.notify_all();
+    }
+
+private:
+    std::atomic<T> value_{0};
+};
+
+#if defined(__SIZEOF_INT128__)
+/// A 128-bit atomic integer. Compare-and-swap is a single cmpxchg16b on x86-64 built with -mcx16 (or any -march which
+/// implies it), and casp or an ldxp/stxp loop on AArch64. Elsewhere the compiler's 16-byte atomic builtins are used,
+/// which may require linking libatomic. All operations are sequentially consistent regardless of the requested order.
+///
+/// Loads use a single 16-byte vmovdqa on x86-64 processors with AVX, which Intel and AMD guarantee to be atomic for
+/// aligned addresses. Otherwise a load is a compare-and-swap which does not change the value.
+template <>
+class atomic_word<uint128_t> {
+public:
+#  if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+    static constexpr bool is_always_lock_free = true;
+#  else
+    static constexpr bool is_always_lock_free = false;
+#  endif
+
+    constexpr atomic_word() noexcept = default;
+
+    constexpr explicit atomic_word(const uint128_t value) noexcept
+        : value_(value) {
+    }
+
+    uint128_t load(const std::memory_order) const noexcept {
+#  if defined(__x86_64__) && defined(__AVX__)
+        __m128i result;
+        asm volatile("vmovdqa %1, %0" : "=x"(result) : "m"(value_) : "memory");
+        return std::bit_cast<uint128_t>(result);
+#  else
+        uint128_t expected = 0;
+        cas(expected, 0);
+        return expected;
+#  endif
+    }
+
+    void store(const uint128_t value, const std::memory_order) noexcept {
+        // A failed compare-and-swap loads the current value into expected, so the guess needs no racy plain read.
+        uint128_t expected = 0;
+        while (!cas(expected, value)) {
+        }
+    }
+
+    bool compare_exchange_weak(uint128_t& expected, const uint128_t desired, const std::memory_order,
+                               const std::memory_order) noexcept {
+        return cas(expected, desired);
+    }
+
+    bool compare_exchange_strong(uint128_t& expected, const uint128_t desired, const std::memory_order,
+                                 const std::memory_order) noexcept {
+        return cas(expected, desired);
+    }
+
+private:
+    bool cas(uint128_t& expected, const uint128_t desired) const noexcept {
+#  if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+        const uint128_t previous = __sync_val_compare_and_swap(&value_, expected, desired);
+        const bool success = previous == expected;
+        expected = previous;
+        return success;
+#  else
+        return __atomic_compare_exchange_n(&value_, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#  endif
+    }
+
+    // Mutable so that a load can be implemented as a compare-and-swap which leaves the value unchanged.
+    alignas(16) mutable uint128_t value_{0};
+};
+#endif
+
+/// Tell the processor that the calling thread is spinning, to save power and yield to another hardware thread.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // End namespace detail.
+
+/// Satisfied by layouts which designate a version field with BIT_FIELD_VERSION.
+///
+/// @tparam T The type to check.
+template <typename T>
+concept versioned_layout = bit_field_layout<T> && requires { typename T::version_field; };
+
+/// Atomic storage for a bit_field_builder layout. Layouts of up to 64 bits are stored in a std::atomic. 128-bit layouts
+/// (using uint128_t storage) are updated with a double-width compare-and-swap, so that, for example, a 64-bit pointer,
+/// a 48-bit version, and 16 bits of flags can all change together.
+///
+/// Updates are compare-and-swap loops. For set, the masks of all of the fields being written and the bits of their new
+/// values are computed before the loop, so each retry is just an and, an or, and the compare-and-swap.
+///
+/// If the layout designates a version field (see BIT_FIELD_VERSION), every update through this class increments the
+/// version in the same compare-and-swap, wrapping around within the field, so that a word which changes from A to B
+/// and back to A is still seen to have changed. When the version is the most significant field, the increment is a
+/// single add folded into the desired value; otherwise the carry is masked off so it cannot spill into the next field.
+/// Whatever a modify function or a compare_exchange caller puts in the version field is replaced.
+///
+/// If the layout has a lock field (see BIT_FIELD_LOCK and BIT_FIELD_SHARED_LOCK), the atomic_layout is also a mutex,
+/// usable with std::lock_guard, std::unique_lock, and (for a shared lock) std::shared_lock. The lock lives in the same
+/// word as the data it protects, so there is no separate mutex object and no extra cache line to fetch. Acquiring the
+/// lock spins briefly, then sets a waiters bit and parks the thread with std::atomic::wait (a futex on Linux.)
+/// Unlocking only notifies when the waiters bit is set. Holding the lock does not stop other threads reading any field,
+/// so the other fields can still be read optimistically (with get, load, or read_begin and validate) while the lock is
+/// held. Nor does it stop other threads updating the other fields, but no update can change the lock field: store,
+/// compare_exchange, and modify keep the lock field of the word they replace, whatever the new value holds there, and
+/// set refuses to set it. Only locking and unlocking change it.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+template <bit_field_layout TLayout>
+class atomic_layout {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// Whether every operation is lock free on this platform.
+    static constexpr bool is_always_lock_free = detail::atomic_word<value_type>::is_always_lock_free;
+
+    /// Whether updates increment a version field.
+    static constexpr bool is_versioned = versioned_layout<TLayout>;
+
+    /// Whether the layout has an exclusive lock field.
+    static constexpr bool has_lock = requires { typename TLayout::lock_field; };
+
+    /// Whether the layout has a reader-writer lock field.
+    static constexpr bool has_shared_lock = requires { typename TLayout::shared_lock_field; };
+
+    static_assert(!(has_lock && has_shared_lock), "A layout may have an exclusive lock or a shared lock, not both.");
+    static_assert(!(has_lock || has_shared_lock) || bits<value_type> <= 64,
+                  "Lock fields require a layout of at most 64 bits, which can be waited on.");
+
+    /// Construct with every bit zero.
+    constexpr atomic_layout() noexcept = default;
+
+    /// Construct with an initial value.
+    ///
+    /// @param layout The initial value.
+    constexpr explicit atomic_layout(const TLayout& layout) noexcept
+        : word_(layout.raw_value) {
+    }
+
+    atomic_layout(const atomic_layout&) = delete;
+    atomic_layout& operator=(const atomic_layout&) = delete;
+
+    /// Atomically load the whole layout.
+    ///
+    /// @param order The memory order of the load.
+    ///
+    /// @returns A snapshot of every field.
+    TLayout load(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return make_layout(word_.load(order));
+    }
+
+    /// Atomically replace the whole layout, but for the version and lock fields, which are kept as described above.
+    ///
+    /// @param layout The new value.
+    /// @param order  The memory order of the store.
+    void store(const TLayout& layout, const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        if constexpr (preserved_mask != 0) {
+            value_type expected = word_.load(std::memory_order_relaxed);
+            while (!word_.compare_exchange_weak(expected, next_value(layout.raw_value, expected), order,
+                                                std::memory_order_relaxed)) {
+            }
+        } else {
+            word_.store(layout.raw_value, order);
+        }
+    }
+
+    /// Atomically replace the layout if it is equal to an expected value. Weak, so it may fail spuriously. For a
+    /// versioned layout, the version of desired is ignored, and the stored version is that of expected plus one. For a
+    /// layout with a lock field, the lock field of desired is ignored, and that of expected is stored.
+    ///
+    /// @param expected The expected value. Updated with the current value on failure.
+    /// @param desired  The new value.
+    /// @param success  The memory order on success.
+    /// @param failure  The memory order on failure.
+    ///
+    /// @returns True if the layout was replaced.
+    bool compare_exchange_weak(TLayout& expected, const TLayout& desired,
+                               const std::memory_order success = std::memory_order_seq_cst,
+                               const std::memory_order failure = std::memory_order_seq_cst) noexcept {
+        return word_.compare_exchange_weak(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                           success, failure);
+    }
+
+    /// Same as compare_exchange_weak, but never fails spuriously.
+    bool compare_exchange_strong(TLayout& expected, const TLayout& desired,
+                                 const std::memory_order success = std::memory_order_seq_cst,
+                                 const std::memory_order failure = std::memory_order_seq_cst) noexcept {
+        return word_.compare_exchange_strong(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                             success, failure);
+    }
+
+    /// Atomically load a single field.
+    ///
+    /// @tparam TField  The field, such as "layout::name" for a field defined with BIT_FIELD.
+    /// @tparam TConfig The field configuration to use for the result. See bit_field::get.
+    ///
+    /// @param order The memory order of the load.
+    ///
+    /// @returns The value of the field.
+    template <typename TField, auto TConfig = bit_field_config{}>
+    auto get(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return TField::template get<TConfig>(word_.load(order));
+    }
+
+    /// Atomically set one or more fields, leaving the others unchanged. Values are masked to the width of their field.
+    ///
+    /// @tparam TFields The fields to set, such as "layout::name" for fields defined with BIT_FIELD.
+    ///
+    /// @param values The new value of each field, in the same order as TFields.
+    ///
+    /// @returns The layout as it was immediately before the update.
+    template <typename... TFields>
+        requires (sizeof...(TFields) > 0)
+    TLayout set(const auto... values) noexcept requires (sizeof...(values) == sizeof...(TFields)) {
+        constexpr value_type mask = (bit_mask<value_type, TFields::offset, TFields::bits> | ...);
+        static_assert((mask & version_mask) == 0, "The version field is updated automatically and cannot be set.");
+        static_assert((mask & lock_mask) == 0, "The lock field is only changed by locking and unlocking.");
+        value_type bits{0};
+        (TFields::template set<set_config>(bits, values), ...);
+
+        // The fields being set do not overlap the version or the lock, so the desired value already carries the
+        // expected version and lock, and only needs the increment.
+        value_type expected = word_.load(std::memory_order_relaxed);
+        while (!word_.compare_exchange_weak(expected,
+                                            increment_version(static_cast<value_type>((expected & ~mask) | bits)),
+                                            std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        }
+        return make_layout(expected);
+    }
+
+    /// Atomically apply an arbitrary update. The function is called with a copy of the current layout, which it
+    /// modifies in place, and is called again with a fresh copy whenever another thread wins the race. It should
+    /// therefore have no side effects.
+    ///
+    /// If the function returns bool, returning false abandons the update.
+    ///
+    /// @param fn The update, called with a TLayout&.
+    ///
+    /// @returns The layout as it was immediately before the update, or before it was abandoned.
+    TLayout modify(auto&& fn) noexcept(noexcept(fn(std::declval<TLayout&>()))) {
+        TLayout expected = make_layout(word_.load(std::memory_order_relaxed));
+        while (true) {
+            TLayout desired = expected;
+            if constexpr (std::is_same_v<decltype(fn(desired)), bool>) {
+                if (!fn(desired)) {
+                    return expected;
+                }
+            } else {
+                fn(desired);
+            }
+            if (word_.compare_exchange_weak(expected.raw_value, next_value(desired.raw_value, expected.raw_value),
+                                            std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return expected;
+            }
+        }
+    }
+
+    /// Atomically increment the version without changing any other field, so that every optimistic read which began
+    /// before it fails validation.
+    ///
+    /// @returns The layout as it was immediately before the update.
+    TLayout bump_version() noexcept requires is_versioned {
+        value_type expected = word_.load(std::memory_order_relaxed);
+        while (!word_.compare_exchange_weak(expected, increment_version(expected), std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+        }
+        return make_layout(expected);
+    }
+
+    /// Acquire the lock exclusively: the lock bit for BIT_FIELD_LOCK, or the writer bit for BIT_FIELD_SHARED_LOCK.
+    /// For a shared lock, the writer bit is taken first, which stops new readers, and then the readers already holding
+    /// the lock are waited for.
+    void lock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            if ((word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) != 0) {
+                lock_slow();
+            }
+        } else {
+            value_type value = word_.load(std::memory_order_relaxed);
+            if ((value & (writer_bit | reader_mask)) != 0 ||
+                !word_.compare_exchange_strong(value, value | writer_bit, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                lock_slow();
+            }
+        }
+    }
+
+    /// Try to acquire the lock exclusively without waiting.
+    ///
+    /// @returns True if the lock was acquired.
+    bool try_lock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            return (word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) == 0;
+        } else {
+            value_type value = word_.load(std::memory_order_relaxed);
+            return (value & (writer_bit | reader_mask)) == 0 &&
+                   word_.compare_exchange_strong(value, value | writer_bit, std::memory_order_acquire,
+                                                 std::memory_order_relaxed);
+        }
+    }
+
+    /// Release the exclusive lock, waking waiting threads if there are any.
+    void unlock() noexcept requires (has_lock || has_shared_lock) {
+        if constexpr (has_lock) {
+            if ((word_.fetch_and(static_cast<value_type>(~(lock_bit | waiters_bit)), std::memory_order_release) &
+                 waiters_bit) != 0) {
+                word_.notify_one();
+            }
+        } else {
+            if ((word_.fetch_and(static_cast<value_type>(~(writer_bit | waiters_bit)), std::memory_order_release) &
+                 waiters_bit) != 0) {
+                word_.notify_all();
+            }
+        }
+    }
+
+    /// Acquire the lock shared, as one of any number of readers. Waits while a writer holds or is waiting for the
+    /// lock, so a steady stream of readers cannot starve writers.
+    void lock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        for (unsigned spin = 0;; ++spin) {
+            if ((value & writer_bit) == 0 && (value & reader_mask) != reader_mask) {
+                if (word_.compare_exchange_weak(value, static_cast<value_type>(value + reader_one),
+                                                std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+            } else {
+                value = pause(value, spin);
+            }
+        }
+    }
+
+    /// Try to acquire the lock shared without waiting.
+    ///
+    /// @returns True if the lock was acquired.
+    bool try_lock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        while ((value & writer_bit) == 0 && (value & reader_mask) != reader_mask) {
+            if (word_.compare_exchange_weak(value, static_cast<value_type>(value + reader_one),
+                                            std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Release a shared lock. The last reader out wakes waiting threads if there are any.
+    void unlock_shared() noexcept requires has_shared_lock {
+        value_type value = word_.load(std::memory_order_relaxed);
+        value_type desired{};
+        do {
+            desired = static_cast<value_type>(value - reader_one);
+            if ((desired & reader_mask) == 0) {
+                desired = static_cast<value_type>(desired & ~waiters_bit);
+            }
+        } while (!word_.compare_exchange_weak(value, desired, std::memory_order_release, std::memory_order_relaxed));
+        if ((desired & reader_mask) == 0 && (value & waiters_bit) != 0) {
+            word_.notify_all();
+        }
+    }
+
+    /// Returns true if the lock is held exclusively, or for a shared lock, if a writer holds or is waiting for it.
+    bool is_locked(const std::memory_order order = std::memory_order_seq_cst) const noexcept
+            requires (has_lock || has_shared_lock) {
+        return (word_.load(order) & lock_bit) != 0;
+    }
+
+    /// Begin an optimistic read. Read the word, and anything reached through it, then call validate with the returned
+    /// version. If validate returns false, an update happened in between and the read should be retried:
+    ///
+    ///     do {
+    ///         version = word.read_begin();
+    ///         ... read fields, follow pointers held in the word, and so on ...
+    ///     } while (!word.validate(version));
+    ///
+    /// A single load always gives a consistent snapshot of the word itself. The version extends that to several loads
+    /// of the word, and to memory reached through pointers held in it, provided that memory never changes once it is
+    /// published and is not freed while a reader may still follow the pointer. Memory which writers change in place is
+    /// not covered: nothing orders those writes against the version, so a read torn by one can still validate, and the
+    /// reads race with the writes. Such data needs the lock.
+    ///
+    /// @returns The current version.
+    auto read_begin() const noexcept requires is_versioned {
+        return TLayout::version_field::template get<bit_field_config{}>(word_.load(std::memory_order_acquire));
+    }
+
+    /// Finish an optimistic read.
+    ///
+    /// @param version The version returned by read_begin.
+    ///
+    /// @returns True if the word has not been updated since read_begin returned version. Since the version wraps, this
+    ///          is only certain if fewer than 2^bits updates could have happened in between.
+    bool validate(const auto version) const noexcept requires is_versioned {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return TLayout::version_field::template get<bit_field_config{}>(word_.load(std::memory_order_relaxed)) ==
+               version;
+    }
+
+private:
+    static constexpr auto set_config = bit_field_config{ .strategy = bit_field_assignment_strategy::mask };
+
+    /// The number of times to check a held lock before parking the thread.
+    static constexpr unsigned spin_limit = 100;
+
+    /// The bits of the lock field. BIT_FIELD_LOCK is a lock bit and a waiters bit. BIT_FIELD_SHARED_LOCK is a writer
+    /// bit, a waiters bit, and a count of readers in the remaining bits.
+    static constexpr unsigned lock_offset = []() constexpr {
+        if constexpr (has_lock) {
+            return TLayout::lock_field::offset;
+        } else if constexpr (has_shared_lock) {
+            return TLayout::shared_lock_field::offset;
+        } else {
+            return 0u;
+        }
+    }();
+    static constexpr value_type lock_bit = static_cast<value_type>(value_type{1} << lock_offset);
+    static constexpr value_type writer_bit = lock_bit;
+    static constexpr value_type waiters_bit = static_cast<value_type>(value_type{1} << (lock_offset + 1));
+    static constexpr value_type reader_one = static_cast<value_type>(value_type{1} << (lock_offset + 2));
+    static constexpr value_type reader_mask = []() constexpr {
+        if constexpr (has_shared_lock) {
+            return bit_mask<value_type, lock_offset + 2, TLayout::shared_lock_field::bits - 2>;
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// Every bit of the lock field, if there is one.
+    static constexpr value_type lock_mask = []() constexpr {
+        if constexpr (has_lock) {
+            return static_cast<value_type>(lock_bit | waiters_bit);
+        } else if constexpr (has_shared_lock) {
+            return static_cast<value_type>(writer_bit | waiters_bit | reader_mask);
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// Wait for a value of the word to change, spinning at first and then parking the thread. The waiters bit is set
+    /// before parking, so that whoever changes the lock knows to wake this thread.
+    ///
+    /// @param value The value last seen.
+    /// @param spin  The number of times this has already been called for the same wait.
+    ///
+    /// @returns A fresh value of the word.
+    value_type pause(value_type value, const unsigned spin) noexcept {
+        if (spin < spin_limit) {
+            detail::cpu_relax();
+            return word_.load(std::memory_order_relaxed);
+        }
+        if ((value & waiters_bit) == 0) {
+            if (!word_.compare_exchange_weak(value, static_cast<value_type>(value | waiters_bit),
+                                             std::memory_order_relaxed, std::memory_order_relaxed)) {
+                return value;
+            }
+            value = static_cast<value_type>(value | waiters_bit);
+        }
+        word_.wait(value, std::memory_order_relaxed);
+        return word_.load(std::memory_order_relaxed);
+    }
+
+    void lock_slow() noexcept {
+        if constexpr (has_lock) {
+            for (unsigned spin = 0; spin < spin_limit; ++spin) {
+                detail::cpu_relax();
+                if ((word_.load(std::memory_order_relaxed) & lock_bit) == 0 &&
+                    (word_.fetch_or(lock_bit, std::memory_order_acquire) & lock_bit) == 0) {
+                    return;
+                }
+            }
+            // Whoever takes the lock from here on sets the waiters bit, since it cannot know if it was the last waiter.
+            while (true) {
+                const value_type previous = word_.fetch_or(lock_bit | waiters_bit, std::memory_order_acquire);
+                if ((previous & lock_bit) == 0) {
+                    return;
+                }
+                word_.wait(static_cast<value_type>(previous | waiters_bit), std::memory_order_relaxed);
+            }
+        } else {
+            // Take the writer bit, which stops new readers.
+            value_type value = word_.load(std::memory_order_relaxed);
+            for (unsigned spin = 0;; ++spin) {
+                if ((value & writer_bit) == 0) {
+                    if (word_.compare_exchange_weak(value, static_cast<value_type>(value | writer_bit),
+                                                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else {
+                    value = pause(value, spin);
+                }
+            }
+            // Wait for the readers already holding the lock to leave.
+            value = word_.load(std::memory_order_acquire);
+            for (unsigned spin = 0; (value & reader_mask) != 0; ++spin) {
+                value = pause(value, spin);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+    }
+
+    static constexpr value_type version_mask = []() constexpr {
+        if constexpr (is_versioned) {
+            return bit_mask<value_type, TLayout::version_field::offset, TLayout::version_field::bits>;
+        } else {
+            return value_type{0};
+        }
+    }();
+
+    /// The bits which an update keeps from the value it replaces, rather than taking from the new value.
+    static constexpr value_type preserved_mask = static_cast<value_type>(version_mask | lock_mask);
+
+    static_assert(!is_versioned || static_cast<value_type>(-1) > value_type{0},
+                  "A versioned layout must use unsigned storage so that the version can wrap around.");
+
+    /// Increment the version field of a value, wrapping around within the field.
+    static constexpr value_type increment_version(const value_type value) noexcept {
+        if constexpr (!is_versioned) {
+            return value;
+        } else {
+            using version = typename TLayout::version_field;
+            constexpr value_type one = static_cast<value_type>(value_type{1} << version::offset);
+            if constexpr (version::offset + version::bits == bits<value_type>) {
+                // The carry out of the top field falls off the end of the word.
+                return static_cast<value_type>(value + one);
+            } else {
+                return static_cast<value_type>((value & ~version_mask) | ((value + one) & version_mask));
+            }
+        }
+    }
+
+    /// The value to store in place of expected: desired, with the lock field of expected and the version of expected
+    /// plus one.
+    static constexpr value_type next_value(const value_type desired, const value_type expected) noexcept {
+        if constexpr (preserved_mask == 0) {
+            return desired;
+        } else {
+            return increment_version(
+                static_cast<value_type>((desired & ~preserved_mask) | (expected & preserved_mask)));
+        }
+    }
+
+    static constexpr TLayout make_layout(const value_type value) noexcept {
+        TLayout layout{};
+        layout.raw_value = value;
+        return layout;
+    }
+
+    detail::atomic_word<value_type> word_{};
+};
+
+/// Define a new field and designate it as the version of the layout. atomic_layout increments the version on every
+/// update. A layout may have at most one version field. The parameters and the symbols created are the same as for
+/// BIT_FIELD_DEP, and in addition:
+///     version_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_VERSION_DEP(self, name, num_bits, ...)                                                               \
+    BIT_FIELD_DEP(self, name, num_bits, __VA_ARGS__);                                                                  \
+    using version_field = name
+
+/// Same as BIT_FIELD_VERSION_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_VERSION(name, num_bits, ...) \
+    BIT_FIELD_VERSION_DEP(, name, num_bits, __VA_ARGS__)
+
+/// Define a two bit exclusive lock field: a lock bit, and above it a bit set when threads are parked waiting for the
+/// lock. An atomic_layout of the layout can then be locked and unlocked like a mutex. A layout may have at most one
+/// lock field. The parameters and the symbols created are the same as for BIT_FIELD_DEP (with num_bits fixed at 2), and
+/// in addition:
+///     lock_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_LOCK_DEP(self, name)                                                                                 \
+    BIT_FIELD_DEP(self, name, 2);                                                                                      \
+    using lock_field = name
+
+/// Same as BIT_FIELD_LOCK_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_LOCK(name) \
+    BIT_FIELD_LOCK_DEP(, name)
+
+/// Define a reader-writer lock field of num_bits bits: a writer bit, a waiters bit, and a count of readers in the
+/// remaining num_bits - 2 bits, which limits the number of simultaneous readers. An atomic_layout of the layout can
+/// then be locked like a std::shared_mutex. A layout may have at most one lock field. The parameters and the symbols
+/// created are the same as for BIT_FIELD_DEP, and in addition:
+///     shared_lock_field -- A type alias for the field, used by atomic_layout to find it.
+#define BIT_FIELD_SHARED_LOCK_DEP(self, name, num_bits)                                                                \
+    static_assert(num_bits >= 3, "A shared lock needs a writer bit, a waiters bit, and at least one reader bit.");     \
+    BIT_FIELD_DEP(self, name, num_bits);                                                                               \
+    using shared_lock_field = name
+
+/// Same as BIT_FIELD_SHARED_LOCK_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_SHARED_LOCK(name, num_bits) \
+    BIT_FIELD_SHARED_LOCK_DEP(, name, num_bits)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ATOMIC_LAYOUT_HPP
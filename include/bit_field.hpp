@@ -3,9 +3,12 @@
 
 #include "config.hpp"
 
+#include <bit>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <limits>
+#include <type_traits>
 #if BIT_FIELD_EXCEPTIONS_ENABLED
 #  include <stdexcept>
 #endif
@@ -39,6 +42,25 @@ enum class bit_field_assignment_strategy {
     no_override
 };
 
+/// Enum allowing the width of the memory access made by "set" to be selected at compile-time. Like the assignment
+/// strategy, it is set first as a class-wide default, which can be overridden per field and on individual "set" calls.
+enum class bit_field_store_width {
+    /// Read the whole storage value, modify it, and write the whole value back. This is the default behavior.
+    full,
+
+    /// If the field is exactly 8, 16, or 32 bits wide and its offset is a multiple of its width, it occupies whole,
+    /// naturally aligned bytes of the storage. Such fields are written with a single store of just those bytes, which
+    /// avoids the load of the surrounding value and the store-forwarding stall of reading it back soon after a store
+    /// of another field. This is not a concurrency guarantee: the storage is still an ordinary object, and setting
+    /// two of its fields from different threads without synchronization is a data race. Other fields, storage which
+    /// is volatile, and constant evaluation all fall back to the full width behavior.
+    narrow,
+
+    /// This is not an actual store width that can be employed. It is a sentinel value indicating that the default
+    /// value for the current context should be used.
+    no_override
+};
+
 /// A sentinel value that can be used in a bit_field_config type to indicate that the default offset should be used.
 /// The default chosen is context-sensitive. There's a global default and a field-level default. If using the
 /// bit_field_builder class there's also a class-level default.
@@ -70,6 +92,9 @@ struct bit_field_config {
 
     /// Strategy to use when setting fields.
     bit_field_assignment_strategy strategy{bit_field_assignment_strategy::no_override};
+
+    /// Width of the memory access to use when setting fields.
+    bit_field_store_width store_width{bit_field_store_width::no_override};
 };
 
 /// A type representing a single field within the bit field.
@@ -124,6 +149,27 @@ public:
         }
     }();
 
+    /// Determines the actual store width to use based on the passed in bit_field_config.
+    template <auto TConfig>
+    static constexpr bit_field_store_width effective_store_width = []() constexpr {
+        if constexpr (TConfig.store_width == bit_field_store_width::no_override) {
+            if constexpr (default_config.store_width == bit_field_store_width::no_override) {
+                return bit_field_store_width::BIT_FIELD_DEFAULT_STORE_WIDTH;
+            } else {
+                return default_config.store_width;
+            }
+        } else {
+            return TConfig.store_width;
+        }
+    }();
+
+    /// True if setting the field in a TStorage with the passed in bit_field_config writes only the bytes of the field.
+    template <auto TConfig, typename TStorage>
+    static constexpr bool uses_narrow_store =
+        effective_store_width<TConfig> == bit_field_store_width::narrow && detail::integral<TStorage> &&
+        (NBits == 8 || NBits == 16 || NBits == 32) && NBits < 8 * sizeof(TStorage) && NOffset % NBits == 0 &&
+        (std::endian::native == std::endian::little || std::endian::native == std::endian::big);
+
     /// Determines the actual result type to use based on the passed in bit_field_config.
     template <auto TConfig, typename TStorage>
     using effective_storage =
@@ -146,6 +192,8 @@ public:
     static constexpr auto get(const auto value) noexcept {
         static_assert(TConfig.strategy == bit_field_assignment_strategy::no_override,
                       "Overriding the strategy in TConfig does nothing.");
+        static_assert(TConfig.store_width == bit_field_store_width::no_override,
+                      "Overriding the store width in TConfig does nothing.");
         using TStorage = std::remove_const_t<decltype(value)>;
         return extract_bits<bits, offset, TStorage, effective_storage<TConfig, TStorage>, effective_offset<TConfig>>(
             value);
@@ -202,8 +250,21 @@ private:
         // the compiler is smart enough to inline it since it's a single statement, and it's only used locally. In the
         // default case we skip masking the value inside extract_bits because we've either already done that in the case
         // of the return_bool and exception strategies, or we're not doing it at all in the case of the unchecked
-        // strategy. The only strategy that does do masking is the mask strategy itself.
+        // strategy. The only strategy that does do masking is the mask strategy itself. Narrow stores copy just the
+        // field's bytes into place through a byte pointer, which is always allowed to alias the storage.
         auto set_helper = [&]<bool skip_mask = true>() {
+            if constexpr (uses_narrow_store<TConfig, TStorage> &&
+                          !std::is_volatile_v<std::remove_reference_t<decltype(into)>>) {
+                if (!std::is_constant_evaluated()) {
+                    constexpr std::size_t byte_offset = std::endian::native == std::endian::little
+                                                      ? offset / 8 : sizeof(TStorage) - offset / 8 - bits / 8;
+                    using TBytes = detail::uint_least_t<bits>;
+                    const auto field_bytes =
+                        extract_bits<bits, effective_offset<TConfig>, TValue, TBytes, 0, skip_mask>(value);
+                    std::memcpy(reinterpret_cast<unsigned char*>(&into) + byte_offset, &field_bytes, sizeof(TBytes));
+                    return;
+                }
+            }
             into = static_cast<TStorage>(into & ~bit_mask<TStorage, offset, bits>) |
                    extract_bits<bits, effective_offset<TConfig>, TValue, TStorage, offset, skip_mask>(value);
         };
@@ -27,10 +27,14 @@ static constexpr auto make_config = []() constexpr {
         constexpr bit_field_assignment_strategy effective_strategy =
             given_config.strategy != bit_field_assignment_strategy::no_override
             ? given_config.strategy : TDefaultConfig.strategy;
+        constexpr bit_field_store_width effective_store_width =
+            given_config.store_width != bit_field_store_width::no_override
+            ? given_config.store_width : TDefaultConfig.store_width;
         using effective_type = std::conditional_t<std::is_void_v<typename decltype(given_config)::type>,
                                                   typename decltype(TDefaultConfig)::type,
                                                   typename decltype(given_config)::type>;
-        return bit_field_config<effective_type>{ .offset = effective_offset, .strategy = effective_strategy };
+        return bit_field_config<effective_type>{
+            .offset = effective_offset, .strategy = effective_strategy, .store_width = effective_store_width };
     }
 }();
 
@@ -43,10 +47,11 @@ static constexpr auto make_config = []() constexpr {
 ///
 /// @tparam TDerived       Place the class deriving from bit_field here. This is basically only used as a tag to make
 ///                        the bit_field type unique so it can internally use multiple compile-time counters.
-/// @tparam T              The underlying storage type of the bit field. Must be integral or std::byte.
+/// @tparam T              The underlying storage type of the bit field. Must be integral (including the 128-bit
+///                        extension integers) or std::byte.
 /// @tparam TDefaultConfig The default configuration for any field that does not override settings.
 template <typename TDerived, typename T, bit_field_config TDefaultConfig = bit_field_config{}>
-    requires (std::integral<T> || std::is_same_v<T, std::byte>)
+    requires (detail::integral<T> || std::is_same_v<T, std::byte>)
 struct bit_field_builder {
     using value_type = T;
 
@@ -61,12 +66,26 @@ struct bit_field_builder {
         return COUNTER_VALUE(TDerived::count, max_field) == max_field;
     }
 
+    /// Returns the number of bits allocated so far by fields and padding. Once the derived class is complete, this is
+    /// the number of bits the layout occupies, starting from the least significant bit.
+    static constexpr unsigned allocated_bits() {
+        return COUNTER_VALUE(TDerived::count, max_field);
+    }
+
     // Compile-time counter to count the number of bits allocated so far.
     COUNTER_INITIALIZE(count, 0);
 
     T raw_value{0};
 };
 
+/// Satisfied by layout types defined by deriving from bit_field_builder.
+///
+/// @tparam T The type to check.
+template <typename T>
+concept bit_field_layout =
+    requires { typename T::value_type; T::default_config; } &&
+    std::is_base_of_v<bit_field_builder<T, typename T::value_type, T::default_config>, T>;
+
 /// Increment the bit counter by num_bits without adding a new field. Used to represent padding bits.
 ///
 /// @param self     The "self" type derived from bit_field_builder. This parameter is only needed when the derived class
@@ -0,0 +1,238 @@
+/// Views of bit field layouts stored at arbitrary bit offsets within byte buffers.
+#ifndef BIT_VIEW_HPP
+#define BIT_VIEW_HPP
+
+#include "config.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "bit_field_builder.hpp"
+#include "byte_order.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Shift the 128-bit value high:low right by shift bits, keeping the low 64 bits. Compiles to shrd on x86-64 and extr
+/// on AArch64.
+///
+/// @param low   The low half.
+/// @param high  The high half.
+/// @param shift The shift amount, from 0 to 63.
+constexpr std::uint64_t funnel_shift_right(const std::uint64_t low, const std::uint64_t high,
+                                           const unsigned shift) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ using uint128 = unsigned __int128;
+    return static_cast<std::uint64_t>(((static_cast<uint128>(high) << 64) | low) >> (shift & 63));
+#else
+    return (low >> shift) | ((high << 1) << (63 - shift));
+#endif
+}
+
+} // End namespace detail.
+
+/// A view of a bit_field_builder layout stored at any bit position in a byte buffer, as found in packed streams where
+/// structures are concatenated without byte alignment. Bits are numbered from the least significant bit of the first
+/// byte, so the layout's least significant bit is bit (bit_offset % 8) of byte (bit_offset / 8), and the layout
+/// occupies exactly TLayout::allocated_bits() bits.
+///
+/// Loading does one unaligned 64-bit load and a shift, plus one more byte and a funnel shift for layouts wider than 57
+/// bits, after which the layout's fields are extracted with their usual compile-time masks and shifts. Storing writes
+/// back only the bytes the layout overlaps, and preserves the bits of those bytes outside the layout. Near the end of
+/// the buffer, where a 64-bit load would run past it, the bytes are accessed one at a time instead.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TByte   std::byte for a mutable view, or const std::byte for a read-only view.
+template <bit_field_layout TLayout, typename TByte = std::byte>
+    requires (std::is_same_v<std::remove_const_t<TByte>, std::byte> && bits<typename TLayout::value_type> <= 64)
+class bit_view {
+public:
+    /// The number of bits the layout occupies in the buffer.
+    static constexpr std::size_t width = TLayout::allocated_bits();
+
+    static_assert(width > 0, "The layout must allocate at least one bit.");
+
+    /// Check whether a layout fits in a buffer at a bit offset.
+    ///
+    /// @param buffer     The buffer.
+    /// @param bit_offset The bit offset of the layout.
+    ///
+    /// @returns True if every bit of the layout lies within the buffer.
+    static constexpr bool fits(const std::span<const std::byte> buffer, const std::size_t bit_offset) noexcept {
+        return bit_offset <= buffer.size() * 8 && width <= buffer.size() * 8 - bit_offset;
+    }
+
+    /// Construct a view. The layout must fit in the buffer at the given offset (see fits), which is not checked.
+    ///
+    /// @param buffer     The buffer holding the layout. Must outlive the view.
+    /// @param bit_offset The bit offset of the least significant bit of the layout.
+    constexpr bit_view(const std::span<TByte> buffer, const std::size_t bit_offset) noexcept
+        : buffer_(buffer), byte_(bit_offset / 8), shift_(static_cast<unsigned>(bit_offset % 8)) {
+    }
+
+    /// Load the layout.
+    ///
+    /// @returns A copy of the layout. Bits above width are zero.
+    constexpr TLayout load() const noexcept {
+        std::uint64_t word = 0;
+        if (!std::is_constant_evaluated() && byte_ + load_bytes_count <= buffer_.size()) {
+            word = load_bytes<std::uint64_t, std::endian::little>(buffer_.data() + byte_);
+            if constexpr (wide) {
+                const auto high = static_cast<std::uint64_t>(buffer_[byte_ + 8]);
+                word = detail::funnel_shift_right(word, high, shift_);
+            } else {
+                word >>= shift_;
+            }
+        } else {
+            word = load_slow();
+        }
+
+        TLayout layout{};
+        layout.raw_value = static_cast<value_type>(word & value_mask);
+        return layout;
+    }
+
+    /// Store the layout, writing only the bytes it overlaps. Bits of the layout above width are ignored.
+    ///
+    /// @param layout The layout to store.
+    constexpr void store(const TLayout& layout) const noexcept requires (!std::is_const_v<TByte>) {
+        const auto value = static_cast<std::uint64_t>(static_cast<unsigned_type>(layout.raw_value)) & value_mask;
+        if (!std::is_constant_evaluated() && byte_ + load_bytes_count <= buffer_.size()) {
+            std::byte* const data = buffer_.data() + byte_;
+            const std::uint64_t word = load_bytes<std::uint64_t, std::endian::little>(data);
+            const std::uint64_t updated = (word & ~(value_mask << shift_)) | (value << shift_);
+            if constexpr (wide) {
+                const auto high = static_cast<std::uint64_t>(data[8]);
+                const std::uint64_t high_mask = (value_mask >> 1) >> (63 - shift_);
+                const std::uint64_t high_bits = (value >> 1) >> (63 - shift_);
+                store_bytes<std::endian::little>(data, updated);
+                if (shift_ + width > 64) {
+                    data[8] = static_cast<std::byte>((high & ~high_mask) | high_bits);
+                }
+            } else if (min_bytes == 8 || shift_ + width <= min_bytes * 8) {
+                store_low_bytes<min_bytes>(data, updated);
+            } else {
+                store_low_bytes<(min_bytes < 8 ? min_bytes + 1 : 8)>(data, updated);
+            }
+        } else {
+            store_slow(value);
+        }
+    }
+
+    /// Load the layout, let a function modify it, and store it back.
+    ///
+    /// @param fn Called with a reference to the loaded layout.
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        TLayout layout = load();
+        fn(layout);
+        store(layout);
+    }
+
+    /// The bit offset of the bit immediately after the layout, where a following layout would start.
+    constexpr std::size_t end_bit_offset() const noexcept {
+        return byte_ * 8 + shift_ + width;
+    }
+
+private:
+    using value_type = typename TLayout::value_type;
+    using unsigned_type = detail::uint_least_t<bits<value_type>>;
+
+    /// Layouts whose bits can extend past the first eight bytes need a ninth byte and a funnel shift.
+    static constexpr bool wide = width + 7 > 64;
+
+    /// The number of bytes which must be present for the fast path, which always loads a whole word.
+    static constexpr std::size_t load_bytes_count = wide ? 9 : 8;
+
+    /// The fewest bytes the layout can overlap, when it starts on a byte boundary.
+    static constexpr std::size_t min_bytes = (width + 7) / 8;
+
+    static constexpr std::uint64_t value_mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+
+    /// Store the low NBytes bytes of a little-endian word, using as few stores as the size allows.
+    template <std::size_t NBytes>
+    static constexpr void store_low_bytes(std::byte* const data, const std::uint64_t word) noexcept {
+        if constexpr (NBytes == 8) {
+            store_bytes<std::endian::little>(data, word);
+        } else if constexpr (NBytes >= 4) {
+            store_bytes<std::endian::little>(data, static_cast<std::uint32_t>(word));
+            store_low_bytes<NBytes - 4>(data + 4, word >> 32);
+        } else if constexpr (NBytes >= 2) {
+            store_bytes<std::endian::little>(data, static_cast<std::uint16_t>(word));
+            store_low_bytes<NBytes - 2>(data + 2, word >> 16);
+        } else if constexpr (NBytes == 1) {
+            data[0] = static_cast<std::byte>(word);
+        }
+    }
+
+    /// The number of bytes the layout actually overlaps.
+    constexpr std::size_t overlapped_bytes() const noexcept {
+        return (shift_ + width + 7) / 8;
+    }
+
+    constexpr std::uint64_t load_slow() const noexcept {
+        std::uint64_t low = 0;
+        std::uint64_t high = 0;
+        const std::size_t count = overlapped_bytes();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto byte = static_cast<std::uint64_t>(buffer_[byte_ + i]);
+            if (i < 8) {
+                low |= byte << (8 * i);
+            } else {
+                high = byte;
+            }
+        }
+        return detail::funnel_shift_right(low, high, shift_);
+    }
+
+    constexpr void store_slow(const std::uint64_t value) const noexcept {
+        // The value and its mask shifted into place, as a 64-bit low part and the byte above it.
+        const std::uint64_t low_value = value << shift_;
+        const std::uint64_t low_mask = value_mask << shift_;
+        const std::uint64_t high_value = (value >> 1) >> (63 - shift_);
+        const std::uint64_t high_mask = (value_mask >> 1) >> (63 - shift_);
+
+        const std::size_t count = overlapped_bytes();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto bits_value = static_cast<std::uint8_t>(i < 8 ? low_value >> (8 * i) : high_value);
+            const auto bits_mask = static_cast<std::uint8_t>(i < 8 ? low_mask >> (8 * i) : high_mask);
+            const auto old = static_cast<std::uint8_t>(buffer_[byte_ + i]);
+            buffer_[byte_ + i] = static_cast<std::byte>((old & ~bits_mask) | bits_value);
+        }
+    }
+
+    std::span<TByte> buffer_;
+    std::size_t byte_;
+    unsigned shift_;
+};
+
+/// Load a layout stored at a bit offset in a buffer. See bit_view.
+///
+/// @tparam TLayout The layout type.
+///
+/// @param buffer     The buffer. The layout must fit at the given offset.
+/// @param bit_offset The bit offset of the least significant bit of the layout.
+///
+/// @returns The loaded layout.
+template <bit_field_layout TLayout>
+constexpr TLayout load_layout_at_bit(const std::span<const std::byte> buffer, const std::size_t bit_offset) noexcept {
+    return bit_view<TLayout, const std::byte>{ buffer, bit_offset }.load();
+}
+
+/// Store a layout at a bit offset in a buffer, touching only the bytes it overlaps. See bit_view.
+///
+/// @param buffer     The buffer. The layout must fit at the given offset.
+/// @param bit_offset The bit offset of the least significant bit of the layout.
+/// @param layout     The layout to store.
+template <bit_field_layout TLayout>
+constexpr void store_layout_at_bit(const std::span<std::byte> buffer, const std::size_t bit_offset,
+                                   const TLayout& layout) noexcept {
+    bit_view<TLayout>{ buffer, bit_offset }.store(layout);
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // BIT_VIEW_HPP
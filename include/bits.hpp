@@ -7,6 +7,8 @@
 #include <climits>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace BIT_FIELD_NAMESPACE {
 
@@ -16,6 +18,34 @@ namespace BIT_FIELD_NAMESPACE {
 template <typename T>
 constexpr std::size_t bits = sizeof(T) * CHAR_BIT;
 
+#if defined(__SIZEOF_INT128__)
+/// The 128-bit unsigned integer provided by GCC and Clang as an extension. It can be used as bit field storage.
+__extension__ using uint128_t = unsigned __int128;
+
+/// The 128-bit signed integer provided by GCC and Clang as an extension.
+__extension__ using int128_t = __int128;
+#endif
+
+namespace detail {
+
+/// Satisfied by integral types, including the 128-bit extension integers, which the standard library does not consider
+/// integral in strict conformance modes.
+template <typename T>
+concept integral = std::integral<T>
+#if defined(__SIZEOF_INT128__)
+    || std::is_same_v<std::remove_cv_t<T>, uint128_t> || std::is_same_v<std::remove_cv_t<T>, int128_t>
+#endif
+    ;
+
+/// The smallest unsigned integer type capable of holding NBits bits.
+template <std::size_t NBits>
+using uint_least_t = std::conditional_t<(NBits <= 8),  std::uint8_t,
+                     std::conditional_t<(NBits <= 16), std::uint16_t,
+                     std::conditional_t<(NBits <= 32), std::uint32_t,
+                                                       std::uint64_t>>>;
+
+} // End namespace detail.
+
 /// Construct a bit mask of type T with NCount consecutive set bits starting at NStart (from LSB).
 ///
 /// @tparam T      The result type of the bit mask. Must be integral or std::byte.
@@ -24,11 +54,11 @@ constexpr std::size_t bits = sizeof(T) * CHAR_BIT;
 ///
 /// @returns A value of the requested type T representing the desired bit mask.
 template <typename T, unsigned NStart, unsigned NCount>
-    requires ((std::integral<T> || std::is_same_v<T, std::byte>) && NCount > 0 && NStart + NCount <= bits<T>)
+    requires ((detail::integral<T> || std::is_same_v<T, std::byte>) && NCount > 0 && NStart + NCount <= bits<T>)
 constexpr T bit_mask = []() constexpr {
     T value{0};
     for (unsigned i = NStart; i < NStart + NCount; ++i) {
-        value |= static_cast<T>(1 << i);
+        value |= static_cast<T>(T{1} << i);
     }
     return value;
 }();
@@ -59,8 +89,8 @@ template <std::size_t NBits,
           std::size_t NDestinationOffset = 0,
           bool        BSkipMask = false>
     requires (
-        (std::integral<TSource> || std::is_enum_v<TSource> || std::is_same_v<TSource, std::byte>) &&
-        (std::integral<TDestination> || std::is_enum_v<TDestination> || std::is_same_v<TDestination, std::byte>) &&
+        (detail::integral<TSource> || std::is_enum_v<TSource> || std::is_same_v<TSource, std::byte>) &&
+        (detail::integral<TDestination> || std::is_enum_v<TDestination> || std::is_same_v<TDestination, std::byte>) &&
         (NBits > 0) &&
         (bits<TSource> >= NBits + NSourceOffset) &&
         (bits<TDestination> >= NBits + NDestinationOffset)
@@ -0,0 +1,135 @@
+/// Loading and storing integers and bit field layouts from byte buffers in a chosen byte order.
+#ifndef BYTE_ORDER_HPP
+#define BYTE_ORDER_HPP
+
+#include "config.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Reverse the bytes of an unsigned integer, including uint128_t.
+template <integral T>
+constexpr T byte_swap(const T value) noexcept {
+#if defined(__GNUC__)
+    if constexpr (sizeof(T) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(T) == 4) {
+        return __builtin_bswap32(value);
+    } else if constexpr (sizeof(T) == 8) {
+        return __builtin_bswap64(value);
+    } else if constexpr (sizeof(T) == 16) {
+        return static_cast<T>((static_cast<T>(__builtin_bswap64(static_cast<std::uint64_t>(value))) << 64) |
+                              __builtin_bswap64(static_cast<std::uint64_t>(value >> 64)));
+    }
+#endif
+    T result{0};
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        result = static_cast<T>(result | (((value >> (8 * i)) & T{0xFF}) << (8 * (sizeof(T) - 1 - i))));
+    }
+    return result;
+}
+
+/// The unsigned integer which load_bytes and store_bytes move the bytes of a T through, as wide as T.
+template <typename T>
+#if defined(__SIZEOF_INT128__)
+using byte_order_word = std::conditional_t<(bits<T> > 64), uint128_t, uint_least_t<bits<T>>>;
+#else
+using byte_order_word = uint_least_t<bits<T>>;
+#endif
+
+} // End namespace detail.
+
+/// Load an integer from a byte buffer. At run time this is a single unaligned load, followed by a byte swap if TOrder
+/// is not the native order. In constant evaluation the bytes are combined one at a time.
+///
+/// @tparam T      The integral type (or std::byte) to load, including the 128-bit integers.
+/// @tparam TOrder The byte order of the buffer.
+///
+/// @param data Points at the first of sizeof(T) bytes to load.
+///
+/// @returns The loaded value.
+template <typename T, std::endian TOrder = std::endian::native>
+    requires (detail::integral<std::remove_cv_t<T>> || std::is_same_v<std::remove_cv_t<T>, std::byte>)
+constexpr std::remove_cv_t<T> load_bytes(const std::byte* const data) noexcept {
+    using TUnsigned = detail::byte_order_word<T>;
+    TUnsigned value{0};
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            const std::size_t shift = 8 * (TOrder == std::endian::big ? sizeof(T) - 1 - i : i);
+            value = static_cast<TUnsigned>(value | (static_cast<TUnsigned>(data[i]) << shift));
+        }
+    } else {
+        std::memcpy(&value, data, sizeof(T));
+        if constexpr (TOrder != std::endian::native) {
+            value = detail::byte_swap(value);
+        }
+    }
+    return static_cast<std::remove_cv_t<T>>(value);
+}
+
+/// Store an integer into a byte buffer. The counterpart of load_bytes.
+///
+/// @tparam TOrder The byte order of the buffer.
+/// @tparam T      The integral type (or std::byte) to store, including the 128-bit integers.
+///
+/// @param data  Points at the first of sizeof(T) bytes to store.
+/// @param value The value to store.
+template <std::endian TOrder = std::endian::native, typename T>
+    requires (detail::integral<T> || std::is_same_v<T, std::byte>)
+constexpr void store_bytes(std::byte* const data, const T value) noexcept {
+    using TUnsigned = detail::byte_order_word<T>;
+    auto bytes = static_cast<TUnsigned>(value);
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            const std::size_t shift = 8 * (TOrder == std::endian::big ? sizeof(T) - 1 - i : i);
+            data[i] = static_cast<std::byte>(bytes >> shift);
+        }
+    } else {
+        if constexpr (TOrder != std::endian::native) {
+            bytes = detail::byte_swap(bytes);
+        }
+        std::memcpy(data, &bytes, sizeof(T));
+    }
+}
+
+/// Load a bit field layout from a byte buffer.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TOrder  The byte order of the buffer.
+///
+/// @param data Points at the first of sizeof(TLayout::value_type) bytes to load.
+///
+/// @returns The loaded layout.
+template <bit_field_layout TLayout, std::endian TOrder = std::endian::native>
+constexpr TLayout load_layout(const std::byte* const data) noexcept {
+    TLayout layout{};
+    layout.raw_value = load_bytes<typename TLayout::value_type, TOrder>(data);
+    return layout;
+}
+
+/// Store a bit field layout into a byte buffer.
+///
+/// @tparam TOrder  The byte order of the buffer.
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+///
+/// @param data   Points at the first of sizeof(TLayout::value_type) bytes to store.
+/// @param layout The layout to store.
+template <std::endian TOrder = std::endian::native, bit_field_layout TLayout>
+constexpr void store_layout(std::byte* const data, const TLayout& layout) noexcept {
+    store_bytes<TOrder>(data, static_cast<std::remove_cv_t<typename TLayout::value_type>>(layout.raw_value));
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // BYTE_ORDER_HPP
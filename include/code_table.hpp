@@ -0,0 +1,174 @@
+/// Codecs mapping small codes to values through a lookup table.
+#ifndef CODE_TABLE_HPP
+#define CODE_TABLE_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#if defined(__SSSE3__)
+#  include <immintrin.h>
+#endif
+
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A codec for non-linearly encoded fields, such as logarithmic or companded sensor values. Each of the 2^NBits codes
+/// indexes a constant table of values. Decoding is a single masked table load. Encoding finds the code whose value is
+/// nearest to the requested value (preferring the smaller value on ties) by binary searching a compile-time sorted copy
+/// of the table, so the table itself does not need to be monotonic.
+///
+/// The table is a template parameter object, so it has static storage and is constant-initialized.
+///
+/// A code_table satisfies the field_codec concept, so it can be stored in a bit_field_builder with BIT_FIELD_CODEC.
+///
+/// @tparam NBits  The number of bits in a code.
+/// @tparam TTable A std::array of exactly 2^NBits arithmetic values, indexed by code.
+template <std::size_t NBits, auto TTable>
+    requires (NBits > 0 && NBits <= 16 && TTable.size() == (std::size_t{1} << NBits) &&
+              std::is_arithmetic_v<typename decltype(TTable)::value_type>)
+struct code_table {
+    using value_type = typename decltype(TTable)::value_type;
+    using raw_type = detail::uint_least_t<NBits>;
+
+    static constexpr std::size_t bits = NBits;
+
+    /// The values indexed by code.
+    static constexpr const auto& table = TTable;
+
+    /// Decode a single code. Bits of raw above the code width are ignored.
+    ///
+    /// @param raw The code.
+    ///
+    /// @returns The value the code maps to.
+    static constexpr value_type decode(const raw_type raw) noexcept {
+        return table[raw & code_mask];
+    }
+
+    /// Encode a value as the code whose table value is nearest to it.
+    ///
+    /// @param value The value to encode.
+    ///
+    /// @returns The nearest code.
+    static constexpr raw_type encode(const value_type value) noexcept {
+        // Binary search for the first sorted entry which is not less than the value.
+        std::size_t low = 0;
+        std::size_t high = sorted.size();
+        while (low < high) {
+            const std::size_t middle = low + (high - low) / 2;
+            if (table[sorted[middle]] < value) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low == sorted.size()) {
+            return sorted[low - 1];
+        } else if (low == 0) {
+            return sorted[0];
+        }
+
+        using difference = std::conditional_t<std::is_floating_point_v<value_type>, value_type, std::int64_t>;
+        const difference below = static_cast<difference>(value) - static_cast<difference>(table[sorted[low - 1]]);
+        const difference above = static_cast<difference>(table[sorted[low]]) - static_cast<difference>(value);
+        return above < below ? sorted[low] : sorted[low - 1];
+    }
+
+    /// Decode a run of codes, one code per raw_type. The output must be at least as large as the input.
+    ///
+    /// When SSSE3 is available, tables of at most sixteen one or two byte values are decoded sixteen codes at a time
+    /// with pshufb, treating the table as a register-resident shuffle control.
+    ///
+    /// @param input  The codes.
+    /// @param output Receives the decoded values.
+    static void decode(const std::span<const raw_type> input, const std::span<value_type> output) noexcept {
+        std::size_t i = 0;
+#if defined(__SSSE3__)
+        if constexpr (NBits <= 4 && std::is_integral_v<value_type> && sizeof(value_type) <= 2) {
+            const __m128i mask = _mm_set1_epi8(static_cast<char>(code_mask));
+            const __m128i low_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_tables[0].data()));
+            const __m128i high_bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle_tables[1].data()));
+            for (const std::size_t end = input.size() & ~std::size_t{15}; i < end; i += 16) {
+                const __m128i codes =
+                    _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i)), mask);
+                const __m128i low = _mm_shuffle_epi8(low_bytes, codes);
+                if constexpr (sizeof(value_type) == 1) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), low);
+                } else {
+                    const __m128i high = _mm_shuffle_epi8(high_bytes, codes);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), _mm_unpacklo_epi8(low, high));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i + 8), _mm_unpackhi_epi8(low, high));
+                }
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = decode(input[i]);
+        }
+    }
+
+private:
+    static constexpr raw_type code_mask = static_cast<raw_type>((std::size_t{1} << NBits) - 1);
+
+    /// Every code, ordered by the value it maps to.
+    static constexpr auto sorted = []() constexpr {
+        std::array<raw_type, TTable.size()> codes{};
+        for (std::size_t i = 0; i < codes.size(); ++i) {
+            codes[i] = static_cast<raw_type>(i);
+        }
+        // Insertion sort is fine at compile time for tables this small, and it is stable so equal values keep the
+        // lowest code first.
+        for (std::size_t i = 1; i < codes.size(); ++i) {
+            const raw_type code = codes[i];
+            std::size_t j = i;
+            for (; j > 0 && TTable[code] < TTable[codes[j - 1]]; --j) {
+                codes[j] = codes[j - 1];
+            }
+            codes[j] = code;
+        }
+        return codes;
+    }();
+
+    /// The low and high bytes of each table value, padded to sixteen entries, for use as pshufb tables.
+    static constexpr auto shuffle_tables = []() constexpr {
+        std::array<std::array<std::uint8_t, 16>, 2> bytes{};
+        if constexpr (NBits <= 4 && std::is_integral_v<value_type> && sizeof(value_type) <= 2) {
+            for (std::size_t i = 0; i < TTable.size(); ++i) {
+                const auto value = static_cast<std::uint16_t>(TTable[i]);
+                bytes[0][i] = static_cast<std::uint8_t>(value);
+                bytes[1][i] = static_cast<std::uint8_t>(value >> 8);
+            }
+        }
+        return bytes;
+    }();
+};
+
+/// The ITU-T G.711 A-law expansion table, mapping each 8-bit A-law code to a 16-bit linear sample.
+constexpr auto alaw_table = []() constexpr {
+    std::array<std::int16_t, 256> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        const unsigned code = static_cast<unsigned>(i) ^ 0x55u;
+        const unsigned segment = (code & 0x70u) >> 4;
+        unsigned magnitude = (code & 0x0Fu) << 4;
+        if (segment == 0) {
+            magnitude += 8;
+        } else {
+            magnitude = (magnitude + 0x108u) << (segment - 1);
+        }
+        const int sample = static_cast<int>(magnitude);
+        table[i] = static_cast<std::int16_t>((code & 0x80u) ? sample : -sample);
+    }
+    return table;
+}();
+
+/// A codec for ITU-T G.711 A-law samples.
+using alaw = code_table<8, alaw_table>;
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CODE_TABLE_HPP
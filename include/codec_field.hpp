@@ -0,0 +1,104 @@
+/// Fields whose raw bits are converted to and from some other value type by a codec.
+#ifndef CODEC_FIELD_HPP
+#define CODEC_FIELD_HPP
+
+#include "config.hpp"
+
+#include <concepts>
+#include <cstddef>
+
+#include "bit_field.hpp"
+#include "bit_field_builder.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A codec describes how the raw bits of a field map to a value of some other type. It must expose:
+///
+///   bits       -- The number of bits in an encoded value.
+///   raw_type   -- An unsigned integral type which holds an encoded value in its low "bits" bits.
+///   value_type -- The decoded type.
+///   decode     -- A static function converting a raw_type to a value_type.
+///   encode     -- A static function converting a value_type to a raw_type. Must not set bits above "bits".
+///
+/// @tparam T The codec type.
+template <typename T>
+concept field_codec = requires (const typename T::raw_type raw, const typename T::value_type value) {
+    { T::bits } -> std::convertible_to<std::size_t>;
+    { T::decode(raw) } -> std::same_as<typename T::value_type>;
+    { T::encode(value) } -> std::same_as<typename T::raw_type>;
+} && std::unsigned_integral<typename T::raw_type>;
+
+/// A field whose raw bits are described by a bit_field, and whose value is converted by a codec.
+///
+/// @tparam TField The bit_field describing where the raw bits are stored. Must be exactly as wide as the codec.
+/// @tparam TCodec The codec converting between the raw bits and the value type.
+template <typename TField, field_codec TCodec>
+    requires (TField::bits == TCodec::bits)
+struct codec_field {
+    using field = TField;
+    using codec = TCodec;
+    using value_type = typename TCodec::value_type;
+
+    static constexpr std::size_t offset = TField::offset;
+    static constexpr std::size_t bits = TField::bits;
+
+    /// Extract the raw bits from a value and decode them.
+    ///
+    /// @param value The value from which the raw bits will be extracted.
+    ///
+    /// @returns The decoded value.
+    static constexpr value_type get(const auto value) noexcept {
+        return TCodec::decode(TField::template get<get_config>(value));
+    }
+
+    /// Encode a value and insert the raw bits into some storage.
+    ///
+    /// @param into  The storage to update.
+    /// @param value The value to encode.
+    static constexpr void set(auto& into, const value_type value) noexcept {
+        TField::template set<set_config>(into, TCodec::encode(value));
+    }
+
+private:
+    /// Raw bits are always exchanged with the codec at offset zero. The codec guarantees that no extraneous bits are
+    /// set, so no checking is required on insertion.
+    static constexpr auto get_config = bit_field_config<typename TCodec::raw_type>{ .offset = 0 };
+    static constexpr auto set_config =
+        bit_field_config{ .offset = 0, .strategy = bit_field_assignment_strategy::unchecked };
+};
+
+/// Define a new codec field. The number of bits consumed is dictated by the codec.
+///
+/// @param self  The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param name  The name of the field. Used to generate the below symbol names.
+/// @param ...   The codec type, which must satisfy field_codec. Variadic so that template arguments containing commas
+///              do not need extra parentheses.
+///
+/// This creates the following symbols at the current scope (replacing "name" with the given name of the field):
+///     name     -- A codec_field type definition.
+///     get_name -- Member function accessor for the field returning the decoded value.
+///     set_name -- Member function mutator for the field taking the value to encode.
+#define BIT_FIELD_CODEC_DEP(self, name, ...)                                                                           \
+    static_assert(COUNTER_VALUE(self count, self max_field) + __VA_ARGS__::bits <= self max_field);                    \
+                                                                                                                       \
+    using name = ::BIT_FIELD_NAMESPACE::codec_field<                                                                   \
+        ::BIT_FIELD_NAMESPACE::bit_field<__VA_ARGS__::bits, COUNTER_VALUE(self count, self max_field)>,                \
+        __VA_ARGS__>;                                                                                                  \
+                                                                                                                       \
+    constexpr typename name::value_type get_##name() const noexcept {                                                  \
+        return name::get(self raw_value);                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    constexpr void set_##name(const typename name::value_type value) noexcept {                                        \
+        name::set(self raw_value, value);                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    BIT_FIELD_PAD_DEP(self, name::bits)
+
+/// Same as BIT_FIELD_CODEC_DEP, but for use in contexts where dependent name lookups are not required (most cases.)
+#define BIT_FIELD_CODEC(name, ...) \
+    BIT_FIELD_CODEC_DEP(, name, __VA_ARGS__)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CODEC_FIELD_HPP
@@ -0,0 +1,433 @@
+/// A columnar file format for archives of layout records, storing each field in its own bit-packed pages.
+#ifndef COLUMN_ARCHIVE_HPP
+#define COLUMN_ARCHIVE_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "bit_view.hpp"
+#include "byte_order.hpp"
+#include "layout_diff.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Options for write_column_archive.
+struct column_archive_options {
+    /// The number of records in each page. Each page of a column is decoded as a unit by column_archive::scan.
+    std::size_t page_records = 4096;
+
+    /// Compress pages with frame of reference coding: store the smallest value of the page once, and the difference of
+    /// every value from it with just enough bits for the largest difference. A page is only compressed when that is
+    /// narrower than the field, and a page where every value is the same takes no bits per value at all.
+    bool compress = true;
+};
+
+namespace detail {
+
+inline constexpr std::uint64_t column_archive_magic = 0x5643'4F4C'4246'4C44u;
+inline constexpr std::uint64_t column_archive_version = 1;
+
+/// The number of 64-bit words in the footer before the page entries.
+inline constexpr std::size_t column_footer_words = 5;
+
+/// The number of 64-bit words in the page entry of each page of each column: its offset, its width, and its base.
+inline constexpr std::size_t column_entry_words = 3;
+
+/// The number of bytes of a page of values packed at a width. One extra word lets every value be read with two loads.
+constexpr std::size_t column_page_bytes(const std::size_t values, const unsigned width) noexcept {
+    return ((values * width + 63) / 64 + 1) * 8;
+}
+
+/// Read the value at an index from a page of values packed at a width.
+constexpr std::uint64_t unpack_column_value(const std::byte* const page, const unsigned width,
+                                            const std::uint64_t base, const std::size_t index) noexcept {
+    if (width == 0) {
+        return base;
+    }
+    const std::size_t bit = index * width;
+    const std::byte* const word = page + bit / 64 * 8;
+    const std::uint64_t low = load_bytes<std::uint64_t, std::endian::little>(word);
+    const std::uint64_t high = load_bytes<std::uint64_t, std::endian::little>(word + 8);
+    const std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    return base + (funnel_shift_right(low, high, static_cast<unsigned>(bit % 64)) & mask);
+}
+
+/// Read the value packed at a bit position known at compile time, with one load if it lies within one word.
+template <unsigned NWidth, unsigned NBit>
+constexpr std::uint64_t unpack_column_bits(const std::byte* const group) noexcept {
+    constexpr std::uint64_t mask = NWidth == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << NWidth) - 1;
+    const std::uint64_t low = load_bytes<std::uint64_t, std::endian::little>(group + NBit / 64 * 8);
+    if constexpr (NBit % 64 + NWidth <= 64) {
+        return (low >> (NBit % 64)) & mask;
+    } else {
+        const std::uint64_t high = load_bytes<std::uint64_t, std::endian::little>(group + NBit / 64 * 8 + 8);
+        return funnel_shift_right(low, high, NBit % 64) & mask;
+    }
+}
+
+/// Read the values of a page of values packed at a width known at compile time. Groups of 64 values take exactly
+/// NWidth words, so within a group every load and shift is a constant, and the compiler can vectorize the group.
+template <unsigned NWidth>
+constexpr void unpack_column_page(const std::byte* const page, const std::uint64_t base,
+                                  const std::span<std::uint64_t> output) noexcept {
+    std::size_t i = 0;
+    if constexpr (NWidth == 0) {
+        for (; i < output.size(); ++i) {
+            output[i] = base;
+        }
+    } else {
+        for (; i + 64 <= output.size(); i += 64) {
+            const std::byte* const group = page + i / 64 * NWidth * 8;
+            std::uint64_t* const values = output.data() + i;
+            [&]<unsigned... NIndices>(std::integer_sequence<unsigned, NIndices...>) constexpr {
+                ((values[NIndices] = base + unpack_column_bits<NWidth, NIndices * NWidth>(group)), ...);
+            }(std::make_integer_sequence<unsigned, 64>{});
+        }
+        for (; i < output.size(); ++i) {
+            output[i] = unpack_column_value(page, NWidth, base, i);
+        }
+    }
+}
+
+/// Read the values of a page of values packed at any width.
+constexpr void unpack_column_page(const std::byte* const page, const unsigned width, const std::uint64_t base,
+                                  const std::span<std::uint64_t> output) noexcept {
+    using unpack_function = void (*)(const std::byte*, std::uint64_t, std::span<std::uint64_t>) noexcept;
+    constexpr auto functions = []<unsigned... NWidths>(std::integer_sequence<unsigned, NWidths...>) constexpr {
+        return std::array<unpack_function, sizeof...(NWidths)>{ &unpack_column_page<NWidths>... };
+    }(std::make_integer_sequence<unsigned, 65>{});
+    functions[width](page, base, output);
+}
+
+constexpr void append_column_word(std::vector<std::byte>& output, const std::uint64_t word) {
+    std::byte bytes[8]{};
+    store_bytes<std::endian::little>(bytes, word);
+    output.insert(output.end(), bytes, bytes + 8);
+}
+
+} // End namespace detail.
+
+/// Write records as a column archive. Each field of the layout, as found by layout_fields, becomes a column, stored as
+/// pages of page_records values packed at the field's width, one column after another. A footer at the end indexes
+/// every page, and records the layout_hash of the layout, so that only a reader with the same layout will open it. All
+/// numbers are little-endian, so the archive may be written to a file and mapped into memory on any host.
+///
+/// @param records The records.
+/// @param options How to write the pages.
+///
+/// @returns The bytes of the archive.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+constexpr std::vector<std::byte> write_column_archive(const std::span<const TLayout> records,
+                                                      const column_archive_options options = {}) {
+    using fields = layout_fields<TLayout>;
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+
+    const std::size_t page_records = std::max<std::size_t>(options.page_records, 1);
+    const std::size_t page_count = (records.size() + page_records - 1) / page_records;
+
+    std::vector<std::byte> output;
+    std::vector<std::uint64_t> entries;
+    std::vector<std::uint64_t> values;
+    entries.reserve(fields::count * page_count * detail::column_entry_words);
+    values.reserve(page_records);
+    for (std::size_t field = 0; field < fields::count; ++field) {
+        const unsigned offset = fields::offsets[field];
+        const unsigned declared = fields::width_of(field);
+        const std::uint64_t mask = declared == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << declared) - 1;
+        for (std::size_t first = 0; first < records.size(); first += page_records) {
+            const std::size_t count = std::min(page_records, records.size() - first);
+            values.clear();
+            for (const TLayout& record : records.subspan(first, count)) {
+                values.push_back((static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> offset) &
+                                 mask);
+            }
+
+            std::uint64_t base = 0;
+            unsigned width = declared;
+            if (options.compress) {
+                const auto [low, high] = std::minmax_element(values.begin(), values.end());
+                const auto reduced = static_cast<unsigned>(std::bit_width(*high - *low));
+                if (reduced < declared) {
+                    base = *low;
+                    width = reduced;
+                }
+            }
+
+            entries.push_back(output.size());
+            entries.push_back(width);
+            entries.push_back(base);
+            std::uint64_t word = 0;
+            unsigned used = 0;
+            for (const std::uint64_t value : values) {
+                const std::uint64_t delta = value - base;
+                word |= delta << used;
+                used += width;
+                if (used >= 64) {
+                    detail::append_column_word(output, word);
+                    used -= 64;
+                    word = used == 0 ? 0 : delta >> (width - used);
+                }
+            }
+            if (used > 0) {
+                detail::append_column_word(output, word);
+            }
+            detail::append_column_word(output, 0);
+        }
+    }
+
+    const std::uint64_t footer_offset = output.size();
+    detail::append_column_word(output, detail::column_archive_version);
+    detail::append_column_word(output, layout_hash<TLayout>);
+    detail::append_column_word(output, records.size());
+    detail::append_column_word(output, page_records);
+    detail::append_column_word(output, fields::count);
+    for (const std::uint64_t entry : entries) {
+        detail::append_column_word(output, entry);
+    }
+    detail::append_column_word(output, footer_offset);
+    detail::append_column_word(output, detail::column_archive_magic);
+    return output;
+}
+
+/// Write records as a column archive. See above.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+constexpr std::vector<std::byte> write_column_archive(const std::span<TLayout> records,
+                                                      const column_archive_options options = {}) {
+    return write_column_archive(std::span<const TLayout>{ records }, options);
+}
+
+/// A reader of a column archive written by write_column_archive, such as a file mapped into memory with mmap. The
+/// reader decodes values in place, so a query touching one field reads only the pages of that field's column.
+///
+/// Values are returned as the raw bits of each field, zero-extended to 64 bits. Whole records are rebuilt from every
+/// column, after which their fields can be read as usual.
+///
+/// @tparam TLayout The layout the archive was written with.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class column_archive {
+    using fields = layout_fields<TLayout>;
+
+public:
+    /// Open an archive, checking that it was written with this layout and that every page lies within it.
+    ///
+    /// @param archive The bytes of the archive. Must outlive the reader.
+    ///
+    /// @returns The reader, or an empty optional if the archive is not valid.
+    static constexpr std::optional<column_archive> open(const std::span<const std::byte> archive) noexcept {
+        constexpr std::size_t trailer_bytes = 16;
+        constexpr std::size_t fixed_bytes = detail::column_footer_words * 8 + trailer_bytes;
+        if (archive.size() < fixed_bytes ||
+            load_bytes<std::uint64_t, std::endian::little>(archive.data() + archive.size() - 8) !=
+                detail::column_archive_magic) {
+            return std::nullopt;
+        }
+        const std::uint64_t footer_offset =
+            load_bytes<std::uint64_t, std::endian::little>(archive.data() + archive.size() - trailer_bytes);
+        if (footer_offset > archive.size() - fixed_bytes) {
+            return std::nullopt;
+        }
+
+        column_archive reader{ archive, static_cast<std::size_t>(footer_offset) };
+        if (reader.footer(0) != detail::column_archive_version || reader.footer(1) != layout_hash<TLayout> ||
+            reader.footer(3) == 0 || reader.footer(4) != fields::count) {
+            return std::nullopt;
+        }
+        reader.page_records_ = static_cast<std::size_t>(reader.footer(3));
+        const std::uint64_t records = reader.footer(2);
+        const std::uint64_t pages = records / reader.page_records_ + (records % reader.page_records_ != 0 ? 1 : 0);
+        const std::size_t entry_bytes = archive.size() - fixed_bytes - reader.footer_offset_;
+        if (fields::count != 0 && pages != entry_bytes / 8 / detail::column_entry_words / fields::count) {
+            return std::nullopt;
+        }
+        if (entry_bytes != pages * fields::count * detail::column_entry_words * 8) {
+            return std::nullopt;
+        }
+        reader.size_ = static_cast<std::size_t>(records);
+        reader.page_count_ = static_cast<std::size_t>(pages);
+
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            for (std::size_t page = 0; page < reader.page_count_; ++page) {
+                const std::uint64_t offset = reader.footer(reader.entry(field, page));
+                const std::uint64_t width = reader.footer(reader.entry(field, page) + 1);
+                if (width > fields::width_of(field) || offset > reader.footer_offset_ ||
+                    reader.footer_offset_ - offset <
+                        detail::column_page_bytes(reader.page_size(page), static_cast<unsigned>(width))) {
+                    return std::nullopt;
+                }
+                // Every value of the page, the base plus up to 2^width - 1, must fit the field.
+                const std::uint64_t base = reader.footer(reader.entry(field, page) + 2);
+                if (base > low_mask(fields::width_of(field)) - low_mask(static_cast<unsigned>(width))) {
+                    return std::nullopt;
+                }
+            }
+        }
+        return reader;
+    }
+
+    /// The number of records.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// The number of records in each page, except perhaps the last.
+    constexpr std::size_t page_records() const noexcept {
+        return page_records_;
+    }
+
+    /// The number of pages in each column.
+    constexpr std::size_t page_count() const noexcept {
+        return page_count_;
+    }
+
+    /// The number of records in a page.
+    constexpr std::size_t page_size(const std::size_t page) const noexcept {
+        return std::min(page_records_, size_ - page * page_records_);
+    }
+
+    /// The number of bytes of a column's pages, which is all that is read to scan the column.
+    template <typename TField>
+    constexpr std::size_t column_bytes() const noexcept {
+        std::size_t result = 0;
+        for (std::size_t page = 0; page < page_count_; ++page) {
+            result += detail::column_page_bytes(page_size(page), page_width(fields::template index_of<TField>, page));
+        }
+        return result;
+    }
+
+    /// Decode the values of a field in one page.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param page   The page index.
+    /// @param output Receives the values. Must be at least page_size(page) long.
+    ///
+    /// @returns The number of values decoded.
+    template <typename TField>
+    constexpr std::size_t read_page(const std::size_t page, const std::span<std::uint64_t> output) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const std::size_t count = page_size(page);
+        detail::unpack_column_page(page_data(field, page), page_width(field, page), page_base(field, page),
+                                   output.first(count));
+        return count;
+    }
+
+    /// Decode a whole column, one page at a time, reading no other column.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param fn Called for each page with the index of its first record and a span of its decoded values.
+    template <typename TField>
+    constexpr void scan(auto&& fn) const {
+        std::vector<std::uint64_t> values(std::min(page_records_, size_));
+        for (std::size_t page = 0; page < page_count_; ++page) {
+            const std::size_t count = read_page<TField>(page, values);
+            fn(page * page_records_, std::span<const std::uint64_t>{ values.data(), count });
+        }
+    }
+
+    /// Decode the value of a field in one record.
+    ///
+    /// @param index The index of the record. Must be less than size().
+    template <typename TField>
+    constexpr std::uint64_t value(const std::size_t index) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const std::size_t page = index / page_records_;
+        return detail::unpack_column_value(page_data(field, page), page_width(field, page), page_base(field, page),
+                                           index % page_records_);
+    }
+
+    /// Rebuild one record from every column.
+    ///
+    /// @param index The index of the record. Must be less than size().
+    constexpr TLayout record(const std::size_t index) const noexcept {
+        TLayout result{};
+        read_records(index, std::span<TLayout>{ &result, 1 });
+        return result;
+    }
+
+    /// Rebuild a range of records from every column.
+    ///
+    /// @param first  The index of the first record.
+    /// @param output Receives the records. first + output.size() must not exceed size().
+    constexpr void read_records(const std::size_t first, const std::span<TLayout> output) const noexcept {
+        for (TLayout& record : output) {
+            record.raw_value = 0;
+        }
+        for (std::size_t done = 0; done < output.size();) {
+            const std::size_t page = (first + done) / page_records_;
+            const std::size_t start = (first + done) % page_records_;
+            const std::size_t count = std::min(page_size(page) - start, output.size() - done);
+            for (std::size_t field = 0; field < fields::count; ++field) {
+                const std::byte* const data = page_data(field, page);
+                const unsigned width = page_width(field, page);
+                const std::uint64_t base = page_base(field, page);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const std::uint64_t bits_value = detail::unpack_column_value(data, width, base, start + i);
+                    TLayout& record = output[done + i];
+                    record.raw_value = static_cast<value_type>(
+                        static_cast<unsigned_type>(record.raw_value) |
+                        static_cast<unsigned_type>(bits_value << fields::offsets[field]));
+                }
+            }
+            done += count;
+        }
+    }
+
+private:
+    using value_type = typename TLayout::value_type;
+    using unsigned_type = detail::uint_least_t<bits<value_type>>;
+
+    constexpr column_archive(const std::span<const std::byte> archive, const std::size_t footer_offset) noexcept
+        : archive_(archive), footer_offset_(footer_offset) {
+    }
+
+    /// Read a word of the footer.
+    constexpr std::uint64_t footer(const std::size_t index) const noexcept {
+        return load_bytes<std::uint64_t, std::endian::little>(archive_.data() + footer_offset_ + index * 8);
+    }
+
+    /// The index in the footer of the entry of a page of a column.
+    constexpr std::size_t entry(const std::size_t field, const std::size_t page) const noexcept {
+        return detail::column_footer_words + (field * page_count_ + page) * detail::column_entry_words;
+    }
+
+    constexpr const std::byte* page_data(const std::size_t field, const std::size_t page) const noexcept {
+        return archive_.data() + footer(entry(field, page));
+    }
+
+    constexpr unsigned page_width(const std::size_t field, const std::size_t page) const noexcept {
+        return static_cast<unsigned>(footer(entry(field, page) + 1));
+    }
+
+    constexpr std::uint64_t page_base(const std::size_t field, const std::size_t page) const noexcept {
+        return footer(entry(field, page) + 2);
+    }
+
+    /// The largest value of a number of bits.
+    static constexpr std::uint64_t low_mask(const unsigned width) noexcept {
+        return width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    }
+
+    std::span<const std::byte> archive_;
+    std::size_t footer_offset_;
+    std::size_t size_{0};
+    std::size_t page_records_{1};
+    std::size_t page_count_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // COLUMN_ARCHIVE_HPP
@@ -0,0 +1,212 @@
+/// Arrays of small integer elements packed into atomic words, with atomic updates of individual elements.
+#ifndef CONCURRENT_PACKED_ARRAY_HPP
+#define CONCURRENT_PACKED_ARRAY_HPP
+
+#include "config.hpp"
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// An array of NBits-bit unsigned elements packed into atomic words, which many threads may update at once, such as
+/// the visited states of a parallel breadth-first search or per-object reference tags. Elements never span two words:
+/// each word holds bits<TWord> / NBits whole elements, and any bits left over are unused.
+///
+/// Every update of an element is atomic and leaves the other elements of its word untouched. fetch_or and fetch_and
+/// are single atomic instructions on the word (lock or / lock and on x86-64), and test_and_set of a 1-bit element is a
+/// lock bts. Everything else is a compare-and-swap loop on the containing word, which only retries when another
+/// thread changed some element of the same word in between.
+///
+/// @tparam NBits The number of bits in an element.
+/// @tparam TWord The unsigned integer type of the words the elements are packed into.
+template <std::size_t NBits, std::unsigned_integral TWord = std::uint64_t>
+    requires (NBits > 0 && NBits <= bits<TWord>)
+class concurrent_packed_array {
+public:
+    using value_type = detail::uint_least_t<NBits>;
+    using word_type = TWord;
+
+    /// The number of bits in an element.
+    static constexpr std::size_t element_bits = NBits;
+
+    /// The number of elements in each word.
+    static constexpr std::size_t elements_per_word = bits<TWord> / NBits;
+
+    /// The largest value an element can hold.
+    static constexpr value_type max_value = static_cast<value_type>(bit_mask<TWord, 0, NBits>);
+
+    /// Returns the number of words needed to hold a number of elements.
+    static constexpr std::size_t words_for(const std::size_t size) noexcept {
+        return (size + elements_per_word - 1) / elements_per_word;
+    }
+
+    /// Construct an array with every element zero.
+    ///
+    /// @param size The number of elements.
+    explicit concurrent_packed_array(const std::size_t size)
+        : words_(std::make_unique<std::atomic<TWord>[]>(words_for(size))), size_(size) {
+    }
+
+    concurrent_packed_array(const concurrent_packed_array&) = delete;
+    concurrent_packed_array& operator=(const concurrent_packed_array&) = delete;
+
+    /// The number of elements.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Atomically load an element.
+    ///
+    /// @param index The index of the element. Not bounds checked.
+    /// @param order The memory order of the load.
+    value_type load(const std::size_t index, const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return extract(words_[word_index(index)].load(order), shift(index));
+    }
+
+    /// Atomically replace an element. Bits of the value above NBits are ignored.
+    ///
+    /// @param index The index of the element.
+    /// @param value The new value.
+    /// @param order The memory order of the update.
+    void store(const std::size_t index, const value_type value,
+               const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        exchange(index, value, order);
+    }
+
+    /// Atomically replace an element. Bits of the value above NBits are ignored.
+    ///
+    /// @returns The previous value of the element.
+    value_type exchange(const std::size_t index, const value_type value,
+                        const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](value_type) { return value; });
+    }
+
+    /// Atomically add to an element, wrapping around within its NBits bits.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_add(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](const value_type old) { return static_cast<value_type>(old + value); });
+    }
+
+    /// Atomically subtract from an element, wrapping around within its NBits bits.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_sub(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return update(index, order, [value](const value_type old) { return static_cast<value_type>(old - value); });
+    }
+
+    /// Atomically OR bits into an element with a single atomic OR of the word.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_or(const std::size_t index, const value_type value,
+                        const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        return extract(words_[word_index(index)].fetch_or(place(value, offset), order), offset);
+    }
+
+    /// Atomically AND bits into an element with a single atomic AND of the word.
+    ///
+    /// @returns The previous value of the element.
+    value_type fetch_and(const std::size_t index, const value_type value,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        const auto keep = static_cast<TWord>(~place(static_cast<value_type>(~value), offset));
+        return extract(words_[word_index(index)].fetch_and(keep, order), offset);
+    }
+
+    /// Atomically set a 1-bit element, as when marking a vertex visited.
+    ///
+    /// @returns True if the element was already set.
+    bool test_and_set(const std::size_t index, const std::memory_order order = std::memory_order_seq_cst) noexcept
+            requires (NBits == 1) {
+        const TWord bit = static_cast<TWord>(TWord{1} << shift(index));
+        return (words_[word_index(index)].fetch_or(bit, order) & bit) != 0;
+    }
+
+    /// Atomically replace an element if it holds an expected value.
+    ///
+    /// @param index    The index of the element.
+    /// @param expected The expected value. Updated with the current value on failure.
+    /// @param desired  The new value. Bits above NBits are ignored.
+    /// @param order    The memory order on success.
+    ///
+    /// @returns True if the element was replaced. Never fails because a different element of the word changed.
+    bool compare_exchange(const std::size_t index, value_type& expected, const value_type desired,
+                          const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        const unsigned offset = shift(index);
+        std::atomic<TWord>& word = words_[word_index(index)];
+        TWord current = word.load(std::memory_order_relaxed);
+        while (extract(current, offset) == static_cast<value_type>(expected & max_value)) {
+            const auto replaced = static_cast<TWord>((current & ~place(max_value, offset)) | place(desired, offset));
+            if (word.compare_exchange_weak(current, replaced, order, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        expected = extract(current, offset);
+        return false;
+    }
+
+    /// Atomically apply an arbitrary function to an element.
+    ///
+    /// @param index The index of the element.
+    /// @param fn    Called with the current value, returning the new value. Called again whenever another thread
+    ///              changes the word first, so it should have no side effects.
+    /// @param order The memory order of the update.
+    ///
+    /// @returns The previous value of the element.
+    value_type update(const std::size_t index, const std::memory_order order, auto&& fn) noexcept(noexcept(fn(0))) {
+        const unsigned offset = shift(index);
+        std::atomic<TWord>& word = words_[word_index(index)];
+        TWord current = word.load(std::memory_order_relaxed);
+        while (true) {
+            const value_type old = extract(current, offset);
+            const auto value = static_cast<value_type>(fn(old));
+            const auto replaced = static_cast<TWord>((current & ~place(max_value, offset)) | place(value, offset));
+            if (word.compare_exchange_weak(current, replaced, order, std::memory_order_relaxed)) {
+                return old;
+            }
+        }
+    }
+
+    /// The words holding the elements, for bulk scans such as counting the set elements of a bitmap.
+    std::span<std::atomic<TWord>> words() noexcept {
+        return { words_.get(), words_for(size_) };
+    }
+
+    std::span<const std::atomic<TWord>> words() const noexcept {
+        return { words_.get(), words_for(size_) };
+    }
+
+private:
+    static constexpr std::size_t word_index(const std::size_t index) noexcept {
+        return index / elements_per_word;
+    }
+
+    static constexpr unsigned shift(const std::size_t index) noexcept {
+        return static_cast<unsigned>(index % elements_per_word * NBits);
+    }
+
+    static constexpr value_type extract(const TWord word, const unsigned offset) noexcept {
+        return static_cast<value_type>((word >> offset) & bit_mask<TWord, 0, NBits>);
+    }
+
+    static constexpr TWord place(const value_type value, const unsigned offset) noexcept {
+        return static_cast<TWord>((static_cast<TWord>(value) & bit_mask<TWord, 0, NBits>) << offset);
+    }
+
+    std::unique_ptr<std::atomic<TWord>[]> words_;
+    std::size_t size_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // CONCURRENT_PACKED_ARRAY_HPP
@@ -19,6 +19,17 @@
 #  define BIT_FIELD_DEFAULT_STRATEGY mask
 #endif
 
+// Allow the user to define the default store width used when setting fields before they include the header file.
+#ifndef BIT_FIELD_DEFAULT_STORE_WIDTH
+#  define BIT_FIELD_DEFAULT_STORE_WIDTH full
+#endif
+
+// Allow the user to define the cache line size used to keep concurrently written words apart before they include the
+// header file. 64 bytes suits most x86-64 and AArch64 processors; 128 also covers adjacent-line prefetching.
+#ifndef BIT_FIELD_CACHE_LINE_SIZE
+#  define BIT_FIELD_CACHE_LINE_SIZE 64
+#endif
+
 // Allow the user to define what namespace everything goes into.
 #ifndef BIT_FIELD_NAMESPACE
 #  define BIT_FIELD_NAMESPACE bf
@@ -0,0 +1,105 @@
+/// Tables of every possible value of a narrow layout, decoded ahead of time.
+#ifndef DECODE_TABLE_HPP
+#define DECODE_TABLE_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The size of the chunks a decode_table is decoded in. Each chunk is a separate constant evaluation, which keeps a
+/// 65536-entry table within the compiler's limit on the work done by any one evaluation.
+inline constexpr std::size_t decode_table_chunk_size = 4096;
+
+/// One chunk of a decode_table: the decoded values of NSize consecutive raw values, starting at NFirst.
+template <typename TLayout, auto FDecode, typename TDecoded, std::size_t NFirst, std::size_t NSize>
+inline constexpr std::array<TDecoded, NSize> decode_table_chunk = []() constexpr {
+    std::array<TDecoded, NSize> result{};
+    for (std::size_t i = 0; i < NSize; ++i) {
+        TLayout layout{};
+        layout.raw_value = static_cast<typename TLayout::value_type>(NFirst + i);
+        result[i] = std::invoke(FDecode, std::as_const(layout));
+    }
+    return result;
+}();
+
+} // End namespace detail.
+
+/// A table of a narrow layout decoded in full: every possible raw value is passed through a decode function once, at
+/// compile time, and the result stored. Decoding is then a single table load, however many fields the layout has and
+/// however much work each field needs, such as converting to enums, sign extension, or scaling.
+///
+/// The table has one entry per combination of the layout's allocated bits, so 256 entries for a complete 8-bit layout
+/// and 65536 for a complete 16-bit layout, each the size of the decoded type. It is a static constexpr member, so it
+/// is constant-initialized in read-only storage and costs nothing at startup. Whether it beats decoding each field with
+/// shifts and masks depends on whether the entries in use stay in cache: see bench/decode_table_bench.cpp.
+///
+/// @tparam TLayout The layout, at most 16 bits wide.
+/// @tparam FDecode A function object or function pointer, callable at compile time with a const TLayout&, which returns
+///                 the decoded value. The decoded type must be default constructible and copy assignable.
+template <bit_field_layout TLayout, auto FDecode>
+    requires (bits<typename TLayout::value_type> <= 16 && std::is_invocable_v<decltype(FDecode), const TLayout&>)
+struct decode_table {
+    using layout_type = TLayout;
+    using decoded_type = std::remove_cvref_t<std::invoke_result_t<decltype(FDecode), const TLayout&>>;
+
+    /// The number of entries, one per combination of the allocated bits.
+    static constexpr std::size_t size = std::size_t{1} << TLayout::allocated_bits();
+
+    /// The decoded value of every raw value, indexed by raw value.
+    static constexpr std::array<decoded_type, size> entries = []() constexpr {
+        std::array<decoded_type, size> result{};
+        constexpr std::size_t chunk_size = std::min(size, detail::decode_table_chunk_size);
+        [&result]<std::size_t... NChunks>(std::index_sequence<NChunks...>) constexpr {
+            (std::copy_n(detail::decode_table_chunk<TLayout, FDecode, decoded_type, NChunks * chunk_size, chunk_size>
+                             .begin(),
+                         chunk_size, result.begin() + NChunks * chunk_size),
+             ...);
+        }(std::make_index_sequence<size / chunk_size>{});
+        return result;
+    }();
+
+    /// Decode a raw value. Bits above the allocated bits are ignored.
+    ///
+    /// @param raw The raw value.
+    ///
+    /// @returns The decoded value, a reference into the table.
+    static constexpr const decoded_type& decode(const typename TLayout::value_type raw) noexcept {
+        return entries[static_cast<std::size_t>(static_cast<unsigned_type>(raw)) & (size - 1)];
+    }
+
+    /// Decode a layout.
+    static constexpr const decoded_type& decode(const TLayout& layout) noexcept {
+        return decode(layout.raw_value);
+    }
+
+    /// Decode several layouts.
+    ///
+    /// @param layouts The layouts.
+    /// @param decoded Receives the decoded values. Must be at least as long as layouts.
+    static constexpr void decode(const std::span<const TLayout> layouts,
+                                 const std::span<decoded_type> decoded) noexcept {
+        for (std::size_t i = 0; i < layouts.size(); ++i) {
+            decoded[i] = decode(layouts[i].raw_value);
+        }
+    }
+
+private:
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // DECODE_TABLE_HPP
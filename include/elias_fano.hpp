@@ -0,0 +1,260 @@
+/// Compressed non-decreasing sequences of integers with random access, using the Elias-Fano encoding.
+#ifndef ELIAS_FANO_HPP
+#define ELIAS_FANO_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+#if defined(__BMI2__) || defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
+#include "bit_view.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The position of the rank-th set bit of a word, counting from zero. With BMI2, pdep deposits a single bit at the
+/// position of the rank-th set bit of the word.
+///
+/// @param word The word, which must have more than rank bits set.
+/// @param rank The number of set bits to skip.
+constexpr unsigned select_in_word(std::uint64_t word, const unsigned rank) noexcept {
+#if defined(__BMI2__)
+    if (!std::is_constant_evaluated()) {
+        return static_cast<unsigned>(std::countr_zero(_pdep_u64(std::uint64_t{1} << rank, word)));
+    }
+#endif
+    for (unsigned i = 0; i < rank; ++i) {
+        word &= word - 1;
+    }
+    return static_cast<unsigned>(std::countr_zero(word));
+}
+
+} // End namespace detail.
+
+/// A non-decreasing sequence of unsigned integers in Elias-Fano encoding, such as a sorted posting list or a list of
+/// timestamps. Each value is split into low bits, of a width chosen from the ratio of the largest value to the number
+/// of values, and high bits. The low bits are packed one after another into an array of words. The high bits are
+/// stored in unary as a bitvector: value i sets bit (high bits of value i) + i. A sequence of n values up to u takes
+/// about n * (2 + log2(u / n)) bits, within a fraction of a bit per value of the least possible.
+///
+/// Finding the i-th set bit or the i-th clear bit of the bitvector (select) gives random access and the search for the
+/// first value at or above a target (next_geq). The position of every 256th set bit and every 256th clear bit is
+/// sampled, so a select scans at most a few words from a sample and finishes within a word, with pdep when BMI2 is
+/// available. Decoding a run of values finds the high bits of a block of values a word of the bitvector at a time,
+/// then adds their low bits, four values at a time with AVX2.
+class elias_fano {
+public:
+    /// The number of set bits, and of clear bits, between samples of their positions.
+    static constexpr std::size_t sample_interval = 256;
+
+    constexpr elias_fano() = default;
+
+    /// Encode a sequence.
+    ///
+    /// @param values The values, in non-decreasing order.
+    constexpr explicit elias_fano(const std::span<const std::uint64_t> values)
+        : size_(values.size()), last_(values.empty() ? 0 : values.back()) {
+        if (values.empty()) {
+            return;
+        }
+        const std::uint64_t ratio = last_ / size_;
+        low_bits_ = ratio == 0 ? 0 : static_cast<unsigned>(std::bit_width(ratio)) - 1;
+        low_mask_ = low_bits_ == 0 ? 0 : ~std::uint64_t{0} >> (64 - low_bits_);
+
+        // One word of padding after each array lets a read of any position load the next word too.
+        const std::size_t high_length = size_ + static_cast<std::size_t>(last_ >> low_bits_) + 1;
+        high_.assign(high_length / 64 + 2, 0);
+        low_.assign(size_ * low_bits_ / 64 + 2, 0);
+        for (std::size_t i = 0; i < size_; ++i) {
+            const std::size_t position = static_cast<std::size_t>(values[i] >> low_bits_) + i;
+            high_[position / 64] |= std::uint64_t{1} << (position % 64);
+            if (low_bits_ != 0) {
+                const std::size_t bit = i * low_bits_;
+                const unsigned offset = static_cast<unsigned>(bit % 64);
+                const std::uint64_t low = values[i] & low_mask_;
+                low_[bit / 64] |= low << offset;
+                if (offset + low_bits_ > 64) {
+                    low_[bit / 64 + 1] |= low >> (64 - offset);
+                }
+            }
+        }
+
+        std::size_t ones = 0;
+        std::size_t zeros = 0;
+        for (std::size_t position = 0; position < high_length; ++position) {
+            if (((high_[position / 64] >> (position % 64)) & 1) != 0) {
+                if (ones++ % sample_interval == 0) {
+                    one_samples_.push_back(position);
+                }
+            } else if (zeros++ % sample_interval == 0) {
+                zero_samples_.push_back(position);
+            }
+        }
+    }
+
+    /// The number of values.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Returns true if there are no values.
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// The number of low bits of each value stored in the packed array.
+    constexpr unsigned low_bits() const noexcept {
+        return low_bits_;
+    }
+
+    /// The size of the encoding in bytes, including the samples.
+    constexpr std::size_t memory_size() const noexcept {
+        return (high_.size() + low_.size() + one_samples_.size() + zero_samples_.size()) * sizeof(std::uint64_t);
+    }
+
+    /// Access a value.
+    ///
+    /// @param index The index of the value. Not bounds checked.
+    constexpr std::uint64_t operator[](const std::size_t index) const noexcept {
+        return (static_cast<std::uint64_t>(select(one_samples_, false, index) - index) << low_bits_) | low(index);
+    }
+
+    /// Find the first value at or above a target. Values with the target's high bits start right after the clear bit
+    /// ending the previous high bits, so one select of a clear bit skips every smaller high part, and the search ends
+    /// within the values sharing the target's high bits.
+    ///
+    /// @param target The target.
+    ///
+    /// @returns The index of the first value at or above the target, or size() if every value is below it.
+    constexpr std::size_t next_geq(const std::uint64_t target) const noexcept {
+        if (size_ == 0 || target > last_) {
+            return size_;
+        }
+        const std::size_t high = static_cast<std::size_t>(target >> low_bits_);
+        const std::size_t position = high == 0 ? 0 : select(zero_samples_, true, high - 1) + 1;
+        std::size_t index = position - high;
+        std::size_t word = position / 64;
+        std::uint64_t bits = high_[word] & (~std::uint64_t{0} << (position % 64));
+        for (;; ++index) {
+            while (bits == 0) {
+                bits = high_[++word];
+            }
+            const std::size_t one = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            if (((static_cast<std::uint64_t>(one - index) << low_bits_) | low(index)) >= target) {
+                return index;
+            }
+            bits &= bits - 1;
+        }
+    }
+
+    /// Decode a run of consecutive values.
+    ///
+    /// @param first  The index of the first value.
+    /// @param output Receives the values. first + output.size() must not exceed size().
+    constexpr void decode(const std::size_t first, const std::span<std::uint64_t> output) const noexcept {
+        if (output.empty()) {
+            return;
+        }
+        const std::size_t start = select(one_samples_, false, first);
+        // Members are copied to locals, since the compiler cannot tell that stores to the output do not change them.
+        const std::uint64_t* const high = high_.data();
+        const std::uint64_t* const low = low_.data();
+        const unsigned low_bits = low_bits_;
+        const std::uint64_t low_mask = low_mask_;
+        std::size_t word = start / 64;
+        std::uint64_t bits = high[word] & (~std::uint64_t{0} << (start % 64));
+        std::size_t index = first;
+        for (std::size_t block = 0; block < output.size(); block += decode_block) {
+            const std::size_t count = std::min(decode_block, output.size() - block);
+            std::uint64_t* const out = output.data() + block;
+            // The high bits: the position of each set bit, less the index of its value.
+            for (std::size_t j = 0; j < count; ++j) {
+                while (bits == 0) {
+                    bits = high[++word];
+                }
+                out[j] = word * 64 + static_cast<std::size_t>(std::countr_zero(bits)) - (index + j);
+                bits &= bits - 1;
+            }
+            // The low bits, read in order with no dependence between values, combined with the high bits.
+            std::size_t j = 0;
+#if defined(__AVX2__)
+            if (!std::is_constant_evaluated() && low_bits <= 56) {
+                // Four values at a time: gather the eight bytes starting at the byte holding each value's first low
+                // bit, which hold all of its low bits, and shift each lane by the value's offset within that byte.
+                const auto base = static_cast<long long>(index * low_bits);
+                const auto width = static_cast<long long>(low_bits);
+                const __m256i step = _mm256_set1_epi64x(4 * width);
+                const __m256i seven = _mm256_set1_epi64x(7);
+                const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(low_mask));
+                const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(low_bits));
+                const auto* const bytes = reinterpret_cast<const long long*>(low);
+                __m256i bit = _mm256_setr_epi64x(base, base + width, base + 2 * width, base + 3 * width);
+                for (; j + 4 <= count; j += 4) {
+                    const __m256i loaded = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(bit, 3), 1);
+                    const __m256i value =
+                        _mm256_and_si256(_mm256_srlv_epi64(loaded, _mm256_and_si256(bit, seven)), mask);
+                    __m256i* const target = reinterpret_cast<__m256i*>(out + j);
+                    const __m256i high_part = _mm256_sll_epi64(_mm256_loadu_si256(target), shift);
+                    _mm256_storeu_si256(target, _mm256_or_si256(high_part, value));
+                    bit = _mm256_add_epi64(bit, step);
+                }
+            }
+#endif
+            for (; j < count; ++j) {
+                const std::size_t bit = (index + j) * low_bits;
+                const std::uint64_t value =
+                    detail::funnel_shift_right(low[bit / 64], low[bit / 64 + 1], static_cast<unsigned>(bit % 64));
+                out[j] = (out[j] << low_bits) | (value & low_mask);
+            }
+            index += count;
+        }
+    }
+
+private:
+    static constexpr std::size_t decode_block = 64;
+
+    /// The low bits of a value.
+    constexpr std::uint64_t low(const std::size_t index) const noexcept {
+        const std::size_t bit = index * low_bits_;
+        return detail::funnel_shift_right(low_[bit / 64], low_[bit / 64 + 1], static_cast<unsigned>(bit % 64)) &
+               low_mask_;
+    }
+
+    /// The position of the rank-th set bit, or of the rank-th clear bit, of the high bits.
+    constexpr std::size_t select(const std::vector<std::uint64_t>& samples, const bool zeros,
+                                 const std::size_t rank) const noexcept {
+        const std::size_t sample = samples[rank / sample_interval];
+        std::size_t remaining = rank % sample_interval;
+        std::size_t word = sample / 64;
+        const std::uint64_t flip = zeros ? ~std::uint64_t{0} : 0;
+        std::uint64_t bits = (high_[word] ^ flip) & (~std::uint64_t{0} << (sample % 64));
+        for (std::size_t count = static_cast<std::size_t>(std::popcount(bits)); count <= remaining;
+             count = static_cast<std::size_t>(std::popcount(bits))) {
+            remaining -= count;
+            bits = high_[++word] ^ flip;
+        }
+        return word * 64 + detail::select_in_word(bits, static_cast<unsigned>(remaining));
+    }
+
+    std::size_t size_{0};
+    std::uint64_t last_{0};
+    unsigned low_bits_{0};
+    std::uint64_t low_mask_{0};
+    std::vector<std::uint64_t> high_;
+    std::vector<std::uint64_t> low_;
+    std::vector<std::uint64_t> one_samples_;
+    std::vector<std::uint64_t> zero_samples_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ELIAS_FANO_HPP
@@ -0,0 +1,363 @@
+/// Encoding and decoding IO-Link M-sequences: the master and device messages exchanged in every communication cycle.
+#ifndef IO_LINK_HPP
+#define IO_LINK_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "bit_field_builder.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Layouts and codecs for IO-Link M-sequences, following annex A of the IO-Link interface specification:
+/// https://io-link.com/share/Downloads/Package-2020/IOL-Interface-Spec_10002_V113_Jun19.pdf
+///
+/// A master message is the M-sequence control octet (MC), the checksum/M-sequence type octet (CKT), the output
+/// process data, and, when writing, the on-request data. The device replies with the on-request data, when reading,
+/// the input process data, and the checksum/status octet (CKS).
+namespace io_link {
+
+enum class communication_channel : std::uint8_t {
+    process   = 0,
+    page      = 1,
+    diagnosis = 2,
+    isdu      = 3
+};
+
+enum class transmission_direction : std::uint8_t {
+    write = 0,
+    read  = 1
+};
+
+enum class m_sequence_type : std::uint8_t {
+    type_0 = 0,
+    type_1 = 1,
+    type_2 = 2,
+};
+
+/// The M-sequence control octet, the first octet of a master message. See section A.1.2.
+struct m_sequence_control : bit_field_builder<m_sequence_control, std::uint8_t> {
+    BIT_FIELD(address,   5, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(channel,   2, bit_field_config<communication_channel>{});
+    BIT_FIELD(direction, 1, bit_field_config<transmission_direction>{});
+};
+
+/// The checksum/M-sequence type octet, the second octet of a master message. See section A.1.3.
+struct checksum_type : bit_field_builder<checksum_type, std::uint8_t> {
+    BIT_FIELD(checksum, 6, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(type,     2, bit_field_config<m_sequence_type>{});
+};
+
+/// The checksum/status octet, the last octet of a device message. See section A.1.5.
+struct checksum_status : bit_field_builder<checksum_status, std::uint8_t> {
+    BIT_FIELD(checksum,             6, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(process_data_invalid, 1, bit_field_config<bool>{});
+    BIT_FIELD(event,                1, bit_field_config<bool>{});
+};
+
+/// The shape of a port's M-sequences: the M-sequence type sent in CKT, and the number of octets of each part, as
+/// agreed with the device from its M-sequence capability.
+struct m_sequence_format {
+    m_sequence_type type;
+    std::uint8_t process_data_out;
+    std::uint8_t process_data_in;
+    std::uint8_t on_request_data;
+
+    /// The size of the master message of a cycle in a direction.
+    constexpr std::size_t master_size(const transmission_direction direction) const noexcept {
+        return 2u + process_data_out + (direction == transmission_direction::write ? on_request_data : 0u);
+    }
+
+    /// The size of the device message of a cycle in a direction.
+    constexpr std::size_t device_size(const transmission_direction direction) const noexcept {
+        return 1u + process_data_in + (direction == transmission_direction::read ? on_request_data : 0u);
+    }
+
+    constexpr bool operator==(const m_sequence_format&) const noexcept = default;
+};
+
+/// TYPE_0: one octet of on-request data, no process data. Used during startup and preoperate.
+inline constexpr m_sequence_format type_0{ m_sequence_type::type_0, 0, 0, 1 };
+
+/// TYPE_1_2: two octets of on-request data, no process data.
+inline constexpr m_sequence_format type_1_2{ m_sequence_type::type_1, 0, 0, 2 };
+
+/// TYPE_1_V: 8 or 32 octets of on-request data, no process data.
+constexpr m_sequence_format type_1_v(const std::uint8_t on_request_data) noexcept {
+    return { m_sequence_type::type_1, 0, 0, on_request_data };
+}
+
+/// TYPE_2_1 to TYPE_2_5: one octet of on-request data with one or two octets of process data.
+inline constexpr m_sequence_format type_2_1{ m_sequence_type::type_2, 0, 1, 1 };
+inline constexpr m_sequence_format type_2_2{ m_sequence_type::type_2, 0, 2, 1 };
+inline constexpr m_sequence_format type_2_3{ m_sequence_type::type_2, 1, 0, 1 };
+inline constexpr m_sequence_format type_2_4{ m_sequence_type::type_2, 2, 0, 1 };
+inline constexpr m_sequence_format type_2_5{ m_sequence_type::type_2, 1, 1, 1 };
+
+/// TYPE_2_V: up to 32 octets of process data in each direction, with 1, 2, 8, or 32 octets of on-request data.
+constexpr m_sequence_format type_2_v(const std::uint8_t process_data_out, const std::uint8_t process_data_in,
+                                     const std::uint8_t on_request_data) noexcept {
+    return { m_sequence_type::type_2, process_data_out, process_data_in, on_request_data };
+}
+
+/// The parts of a master message. The spans view the frame it was decoded from, or the data to encode.
+struct master_message {
+    m_sequence_control control;
+    std::span<const std::byte> process_data;
+    std::span<const std::byte> on_request_data;
+};
+
+/// The parts of a device message. The spans view the frame it was decoded from, or the data to encode.
+struct device_message {
+    std::span<const std::byte> on_request_data;
+    std::span<const std::byte> process_data;
+    bool event{false};
+    bool process_data_invalid{false};
+};
+
+namespace detail {
+
+/// The seed every message's checksum starts from. See section A.1.6.
+inline constexpr std::uint8_t checksum_seed = 0x52;
+
+/// The 6-bit checksum of every 8-bit XOR of a message's octets, seed included, which compresses pairs of bits of the
+/// 8-bit value as in figure A.3 of the specification.
+inline constexpr std::array<std::uint8_t, 256> checksum_table = []() constexpr {
+    std::array<std::uint8_t, 256> result{};
+    for (unsigned value = 0; value < 256; ++value) {
+        const auto bit = [value](const unsigned index) { return (value >> index) & 1u; };
+        const unsigned compressed = (bit(7) ^ bit(5) ^ bit(3) ^ bit(1)) << 5 |
+                                    (bit(6) ^ bit(4) ^ bit(2) ^ bit(0)) << 4 |
+                                    (bit(7) ^ bit(6)) << 3 |
+                                    (bit(5) ^ bit(4)) << 2 |
+                                    (bit(3) ^ bit(2)) << 1 |
+                                    (bit(1) ^ bit(0));
+        result[value] = static_cast<std::uint8_t>(compressed);
+    }
+    return result;
+}();
+
+/// The XOR of a run of octets. At run time, eight octets are folded at once.
+constexpr std::uint8_t fold_octets(std::span<const std::byte> octets) noexcept {
+    std::uint64_t folded = 0;
+    if (!std::is_constant_evaluated()) {
+        for (; octets.size() >= 8; octets = octets.subspan(8)) {
+            std::uint64_t word;
+            std::memcpy(&word, octets.data(), 8);
+            folded ^= word;
+        }
+        if (octets.size() >= 4) {
+            std::uint32_t word;
+            std::memcpy(&word, octets.data(), 4);
+            folded ^= word;
+            octets = octets.subspan(4);
+        }
+        folded ^= folded >> 32;
+        folded ^= folded >> 16;
+        folded ^= folded >> 8;
+    }
+    for (const std::byte octet : octets) {
+        folded ^= static_cast<std::uint8_t>(octet);
+    }
+    return static_cast<std::uint8_t>(folded);
+}
+
+/// The checksum of a received message, computed as if the checksum bits of its octet at an index were zero.
+constexpr std::uint8_t received_checksum(const std::span<const std::byte> message, const std::size_t index) noexcept {
+    const unsigned embedded = static_cast<std::uint8_t>(message[index]) & 0x3Fu;
+    const auto folded = static_cast<std::uint8_t>(fold_octets(message) ^ embedded);
+    return checksum_table[folded ^ checksum_seed];
+}
+
+} // End namespace detail.
+
+/// Compute the 6-bit checksum of a message. A table maps the XOR of the message's octets to the checksum, so the cost
+/// is one XOR per octet and one load.
+///
+/// @param message The whole master or device message, with the checksum bits of its CKT or CKS octet cleared.
+///
+/// @returns The checksum, which belongs in the low six bits of the CKT or CKS octet.
+constexpr std::uint8_t checksum(const std::span<const std::byte> message) noexcept {
+    return detail::checksum_table[detail::fold_octets(message) ^ detail::checksum_seed];
+}
+
+/// Encode a master message.
+///
+/// @param format  The port's M-sequence format.
+/// @param message The control octet and data. The process data must be format.process_data_out octets, and the
+///                on-request data format.on_request_data octets when writing, or empty when reading.
+/// @param frame   Receives the message.
+///
+/// @returns The size of the message, or zero if the data does not match the format or the frame is too small.
+constexpr std::size_t encode_master(const m_sequence_format& format, const master_message& message,
+                                    const std::span<std::byte> frame) noexcept {
+    const transmission_direction direction = message.control.get_direction();
+    const std::size_t size = format.master_size(direction);
+    const std::size_t on_request_data = direction == transmission_direction::write ? format.on_request_data : 0;
+    if (message.process_data.size() != format.process_data_out ||
+        message.on_request_data.size() != on_request_data || frame.size() < size) {
+        return 0;
+    }
+    checksum_type type{};
+    type.set_type(format.type);
+    frame[0] = static_cast<std::byte>(message.control.raw_value);
+    frame[1] = static_cast<std::byte>(type.raw_value);
+    std::copy(message.process_data.begin(), message.process_data.end(), frame.begin() + 2);
+    std::copy(message.on_request_data.begin(), message.on_request_data.end(),
+              frame.begin() + 2 + static_cast<std::ptrdiff_t>(format.process_data_out));
+    type.set_checksum(checksum(frame.first(size)));
+    frame[1] = static_cast<std::byte>(type.raw_value);
+    return size;
+}
+
+/// Decode and check a master message, as a device does.
+///
+/// @param format The port's M-sequence format.
+/// @param frame  The message.
+///
+/// @returns The message, viewing the frame, or an empty optional if the frame's size, M-sequence type, or checksum
+///          is wrong.
+constexpr std::optional<master_message> decode_master(const m_sequence_format& format,
+                                                      const std::span<const std::byte> frame) noexcept {
+    if (frame.size() < 2) {
+        return std::nullopt;
+    }
+    const m_sequence_control control{ static_cast<std::uint8_t>(frame[0]) };
+    const checksum_type type{ static_cast<std::uint8_t>(frame[1]) };
+    if (frame.size() != format.master_size(control.get_direction()) || type.get_type() != format.type ||
+        detail::received_checksum(frame, 1) != type.get_checksum()) {
+        return std::nullopt;
+    }
+    return master_message{
+        control,
+        frame.subspan(2, format.process_data_out),
+        frame.subspan(2u + format.process_data_out),
+    };
+}
+
+/// Encode a device message, as a device replies to a master message.
+///
+/// @param format  The port's M-sequence format.
+/// @param control The control octet of the master message being answered.
+/// @param message The data and status. The process data must be format.process_data_in octets, and the on-request
+///                data format.on_request_data octets when reading, or empty when writing.
+/// @param frame   Receives the message.
+///
+/// @returns The size of the message, or zero if the data does not match the format or the frame is too small.
+constexpr std::size_t encode_device(const m_sequence_format& format, const m_sequence_control control,
+                                    const device_message& message, const std::span<std::byte> frame) noexcept {
+    const transmission_direction direction = control.get_direction();
+    const std::size_t size = format.device_size(direction);
+    const std::size_t on_request_data = direction == transmission_direction::read ? format.on_request_data : 0;
+    if (message.process_data.size() != format.process_data_in ||
+        message.on_request_data.size() != on_request_data || frame.size() < size) {
+        return 0;
+    }
+    checksum_status status{};
+    status.set_event(message.event);
+    status.set_process_data_invalid(message.process_data_invalid);
+    std::copy(message.on_request_data.begin(), message.on_request_data.end(), frame.begin());
+    std::copy(message.process_data.begin(), message.process_data.end(),
+              frame.begin() + static_cast<std::ptrdiff_t>(on_request_data));
+    frame[size - 1] = static_cast<std::byte>(status.raw_value);
+    status.set_checksum(checksum(frame.first(size)));
+    frame[size - 1] = static_cast<std::byte>(status.raw_value);
+    return size;
+}
+
+/// Decode and check a device message, as the master does.
+///
+/// @param format  The port's M-sequence format.
+/// @param control The control octet of the master message the device answered.
+/// @param frame   The message.
+///
+/// @returns The message, viewing the frame, or an empty optional if the frame's size or checksum is wrong.
+constexpr std::optional<device_message> decode_device(const m_sequence_format& format,
+                                                      const m_sequence_control control,
+                                                      const std::span<const std::byte> frame) noexcept {
+    const transmission_direction direction = control.get_direction();
+    if (frame.size() != format.device_size(direction)) {
+        return std::nullopt;
+    }
+    const checksum_status status{ static_cast<std::uint8_t>(frame.back()) };
+    if (detail::received_checksum(frame, frame.size() - 1) != status.get_checksum()) {
+        return std::nullopt;
+    }
+    const std::size_t on_request_data = direction == transmission_direction::read ? format.on_request_data : 0;
+    return device_message{
+        frame.first(on_request_data),
+        frame.subspan(on_request_data, format.process_data_in),
+        status.get_event(),
+        status.get_process_data_invalid(),
+    };
+}
+
+/// Encode the master messages of many ports at once, as a gateway does once per cycle. The messages are written one
+/// after another, each format.master_size bytes long.
+///
+/// @param formats  Each port's M-sequence format.
+/// @param messages Each port's message, as for encode_master.
+/// @param frames   Receives the messages.
+///
+/// @returns The total size of the messages, or zero if any message does not match its format or the frames are too
+///          small.
+constexpr std::size_t encode_master_messages(const std::span<const m_sequence_format> formats,
+                                             const std::span<const master_message> messages,
+                                             const std::span<std::byte> frames) noexcept {
+    if (formats.size() != messages.size()) {
+        return 0;
+    }
+    std::size_t offset = 0;
+    for (std::size_t port = 0; port < messages.size(); ++port) {
+        const std::size_t size = encode_master(formats[port], messages[port], frames.subspan(offset));
+        if (size == 0) {
+            return 0;
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+/// Decode the device messages of many ports at once, as a gateway does once per cycle. The messages are read one after
+/// another, each format.device_size bytes long for the direction of its port's control octet.
+///
+/// @param formats  Each port's M-sequence format.
+/// @param controls The control octet each port's device answered.
+/// @param frames   The messages.
+/// @param messages Receives each port's message, or an empty optional if its checksum is wrong.
+///
+/// @returns The number of messages with a correct checksum, or zero if the spans' sizes disagree.
+constexpr std::size_t decode_device_messages(const std::span<const m_sequence_format> formats,
+                                             const std::span<const m_sequence_control> controls,
+                                             const std::span<const std::byte> frames,
+                                             const std::span<std::optional<device_message>> messages) noexcept {
+    if (formats.size() != controls.size() || formats.size() != messages.size()) {
+        return 0;
+    }
+    std::size_t offset = 0;
+    std::size_t valid = 0;
+    for (std::size_t port = 0; port < formats.size(); ++port) {
+        const std::size_t size = formats[port].device_size(controls[port].get_direction());
+        if (size > frames.size() - offset) {
+            return 0;
+        }
+        messages[port] = decode_device(formats[port], controls[port], frames.subspan(offset, size));
+        valid += messages[port].has_value() ? 1u : 0u;
+        offset += size;
+    }
+    return valid;
+}
+
+} // End namespace io_link.
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // IO_LINK_HPP
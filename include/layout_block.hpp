@@ -0,0 +1,254 @@
+/// Blocks of layouts at fixed byte offsets, such as device register blocks and fixed-format protocol messages.
+#ifndef LAYOUT_BLOCK_HPP
+#define LAYOUT_BLOCK_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "bit_field_builder.hpp"
+#include "byte_order.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// How a member of a layout_block is read and written.
+enum class block_access {
+    /// As ordinary memory. The compiler may merge, split, or remove accesses, and copies of whole blocks use memcpy.
+    memory,
+
+    /// With a single volatile load or store of exactly the layout's width, as device registers require. Every access
+    /// is performed, in program order, and copies of whole blocks go member by member. The member must be aligned.
+    exact,
+};
+
+/// A member of a layout_block: a layout stored at a fixed byte offset.
+///
+/// @tparam NOffset The byte offset of the layout from the start of the block.
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+/// @tparam TOrder  The byte order of the layout in the block.
+/// @tparam NAccess How the layout is read and written.
+template <std::size_t NOffset, bit_field_layout TLayout, std::endian TOrder = std::endian::native,
+          block_access NAccess = block_access::memory>
+    requires (bits<typename TLayout::value_type> <= 64)
+struct block_member {
+    using layout_type = TLayout;
+
+    static constexpr std::size_t offset = NOffset;
+    static constexpr std::size_t size = sizeof(typename TLayout::value_type);
+    static constexpr std::endian byte_order = TOrder;
+    static constexpr block_access access = NAccess;
+
+    static_assert(NAccess != block_access::exact || NOffset % size == 0,
+                  "Members with exact access must be aligned to their size.");
+};
+
+/// A compile-time description of a block of layouts at fixed byte offsets, such as the registers of a device or the
+/// words of a fixed-format message, which is overlaid on memory with a block_view.
+///
+/// @tparam TMembers The members, each a block_member. They may be listed in any order, but must not overlap.
+template <typename... TMembers>
+    requires (sizeof...(TMembers) > 0)
+struct layout_block {
+    using members = std::tuple<TMembers...>;
+
+    /// A copy of every member's layout, as loaded by block_view::load_all.
+    using values_type = std::tuple<typename TMembers::layout_type...>;
+
+    static constexpr std::size_t member_count = sizeof...(TMembers);
+
+    /// The type of the member at an index.
+    template <std::size_t NIndex>
+    using member_type = std::tuple_element_t<NIndex, members>;
+
+    /// The index of the member with a given layout type. Exactly one member must have that layout type.
+    template <typename TLayout>
+        requires ((std::is_same_v<typename TMembers::layout_type, TLayout> + ...) == 1)
+    static constexpr std::size_t index_of = []() constexpr {
+        constexpr std::array<bool, member_count> matches{ std::is_same_v<typename TMembers::layout_type, TLayout>... };
+        return static_cast<std::size_t>(std::find(matches.begin(), matches.end(), true) - matches.begin());
+    }();
+
+    /// The number of bytes the block spans, up to the end of its last member.
+    static constexpr std::size_t size = std::max({ (TMembers::offset + TMembers::size)... });
+
+    /// The alignment the base of the block needs for its exact-access members.
+    static constexpr std::size_t alignment =
+        std::max({ (TMembers::access == block_access::exact ? TMembers::size : std::size_t{1})... });
+
+    /// Returns true if every member can be copied with memcpy.
+    static constexpr bool plain_memory = ((TMembers::access == block_access::memory) && ...);
+
+    static_assert([]() constexpr {
+        constexpr std::array<std::size_t, member_count> offsets{ TMembers::offset... };
+        constexpr std::array<std::size_t, member_count> sizes{ TMembers::size... };
+        for (std::size_t i = 0; i < member_count; ++i) {
+            for (std::size_t j = i + 1; j < member_count; ++j) {
+                if (offsets[i] < offsets[j] + sizes[j] && offsets[j] < offsets[i] + sizes[i]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(), "Members of a layout_block must not overlap.");
+};
+
+/// A typed, zero-copy view of a layout_block overlaid on a byte buffer or on a device's register base address. Each
+/// member is loaded and stored at its compile-time offset, in its own byte order and with its own access policy, so no
+/// pointer arithmetic or casting is needed.
+///
+/// @tparam TBlock The layout_block.
+/// @tparam TByte  std::byte for a mutable view, or const std::byte for a read-only view.
+template <typename TBlock, typename TByte = std::byte>
+    requires std::is_same_v<std::remove_const_t<TByte>, std::byte>
+class block_view {
+public:
+    using block_type = TBlock;
+    using values_type = typename TBlock::values_type;
+
+    /// Construct a view of a buffer.
+    ///
+    /// @param buffer The buffer, at least TBlock::size bytes long, which is not checked. Must outlive the view. Must be
+    ///               aligned to TBlock::alignment if the block has exact-access members.
+    constexpr explicit block_view(const std::span<TByte> buffer) noexcept
+        : base_(buffer.data()) {
+    }
+
+    /// Construct a view of memory at an address, such as a memory-mapped register block.
+    ///
+    /// @param base The address of the block.
+    constexpr explicit block_view(TByte* const base) noexcept
+        : base_(base) {
+    }
+
+    /// Load the member at an index.
+    template <std::size_t NIndex>
+    constexpr auto load() const noexcept {
+        using member = typename TBlock::template member_type<NIndex>;
+        using layout = typename member::layout_type;
+        if constexpr (member::access == block_access::exact) {
+            using word = detail::uint_least_t<bits<typename layout::value_type>>;
+            word value = *reinterpret_cast<const volatile word*>(base_ + member::offset);
+            if constexpr (member::byte_order != std::endian::native) {
+                value = detail::byte_swap(value);
+            }
+            layout result{};
+            result.raw_value = static_cast<typename layout::value_type>(value);
+            return result;
+        } else {
+            return load_layout<layout, member::byte_order>(base_ + member::offset);
+        }
+    }
+
+    /// Load the member with a layout type.
+    template <bit_field_layout TLayout>
+    constexpr TLayout load() const noexcept {
+        return load<TBlock::template index_of<TLayout>>();
+    }
+
+    /// Store the member at an index.
+    template <std::size_t NIndex>
+    constexpr void store(const typename TBlock::template member_type<NIndex>::layout_type& layout) const noexcept
+        requires (!std::is_const_v<TByte>) {
+        using member = typename TBlock::template member_type<NIndex>;
+        using layout_type = typename member::layout_type;
+        if constexpr (member::access == block_access::exact) {
+            using word = detail::uint_least_t<bits<typename layout_type::value_type>>;
+            auto value = static_cast<word>(layout.raw_value);
+            if constexpr (member::byte_order != std::endian::native) {
+                value = detail::byte_swap(value);
+            }
+            *reinterpret_cast<volatile word*>(base_ + member::offset) = value;
+        } else {
+            store_layout<member::byte_order>(base_ + member::offset, layout);
+        }
+    }
+
+    /// Store the member with a layout type.
+    template <bit_field_layout TLayout>
+    constexpr void store(const TLayout& layout) const noexcept requires (!std::is_const_v<TByte>) {
+        store<TBlock::template index_of<TLayout>>(layout);
+    }
+
+    /// Load a member, let a function modify it, and store it back. For a register, this is one read and one write.
+    template <std::size_t NIndex>
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        auto layout = load<NIndex>();
+        fn(layout);
+        store<NIndex>(layout);
+    }
+
+    /// Load a member with a layout type, let a function modify it, and store it back.
+    template <bit_field_layout TLayout>
+    constexpr void modify(auto&& fn) const requires (!std::is_const_v<TByte>) {
+        modify<TBlock::template index_of<TLayout>>(fn);
+    }
+
+    /// Load every member.
+    constexpr values_type load_all() const noexcept {
+        return [this]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return values_type{ load<NIndices>()... };
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Store every member, in the order they are listed in the block.
+    constexpr void store_all(const values_type& values) const noexcept requires (!std::is_const_v<TByte>) {
+        [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            (store<NIndices>(std::get<NIndices>(values)), ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Copy every member from another view of the same block, such as a register block into a buffer or back. Bytes
+    /// between members are not copied. Blocks of plain memory members are copied with a memcpy of each member's bytes,
+    /// which the compiler merges where members are adjacent; otherwise each member is loaded and stored in turn.
+    ///
+    /// @param source The view to copy from.
+    template <typename TSourceByte>
+    constexpr void copy_from(const block_view<TBlock, TSourceByte> source) const noexcept
+        requires (!std::is_const_v<TByte>) {
+        if constexpr (TBlock::plain_memory) {
+            if (!std::is_constant_evaluated()) {
+                [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) {
+                    (std::memcpy(base_ + TBlock::template member_type<NIndices>::offset,
+                                 source.data() + TBlock::template member_type<NIndices>::offset,
+                                 TBlock::template member_type<NIndices>::size), ...);
+                }(std::make_index_sequence<TBlock::member_count>{});
+                return;
+            }
+        }
+        [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            (store<NIndices>(source.template load<NIndices>()), ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// Compare every member with another view of the same block. Bytes between members are not compared.
+    ///
+    /// @param other The view to compare with.
+    ///
+    /// @returns True if every member has the same raw value.
+    template <typename TOtherByte>
+    constexpr bool equals(const block_view<TBlock, TOtherByte> other) const noexcept {
+        return [&]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return ((load<NIndices>().raw_value == other.template load<NIndices>().raw_value) && ...);
+        }(std::make_index_sequence<TBlock::member_count>{});
+    }
+
+    /// The address of the block.
+    constexpr TByte* data() const noexcept {
+        return base_;
+    }
+
+private:
+    TByte* base_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_BLOCK_HPP
@@ -0,0 +1,315 @@
+/// Classifying layout records against many rules at once, each matching a value or range of several fields.
+#ifndef LAYOUT_CLASSIFIER_HPP
+#define LAYOUT_CLASSIFIER_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "layout_diff.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A rule for layout_classifier: a range of accepted values for each field, all of which must hold. Fields the rule
+/// does not mention accept any value. Values are the raw bits of each field, compared as unsigned numbers.
+///
+/// @tparam TLayout The layout of the records.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class classifier_rule {
+    using fields = layout_fields<TLayout>;
+
+public:
+    constexpr classifier_rule() noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            high_[field] = field_mask(field);
+        }
+    }
+
+    /// Require a field to lie in a range of values. Requiring a field twice accepts only values in both ranges.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param low  The smallest accepted value.
+    /// @param high The largest accepted value.
+    template <typename TField>
+    constexpr classifier_rule& where(const std::uint64_t low, const std::uint64_t high) noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        low_[field] = std::max(low_[field], low);
+        high_[field] = std::min(high_[field], high);
+        return *this;
+    }
+
+    /// Require a field to equal a value.
+    template <typename TField>
+    constexpr classifier_rule& where(const std::uint64_t value) noexcept {
+        return where<TField>(value, value);
+    }
+
+    /// The smallest value of a field the rule accepts.
+    constexpr std::uint64_t low(const std::size_t field) const noexcept {
+        return low_[field];
+    }
+
+    /// The largest value of a field the rule accepts.
+    constexpr std::uint64_t high(const std::size_t field) const noexcept {
+        return high_[field];
+    }
+
+    /// Returns true if the rule restricts a field.
+    constexpr bool restricts(const std::size_t field) const noexcept {
+        return low_[field] != 0 || high_[field] != field_mask(field);
+    }
+
+    /// Returns true if some record can match the rule.
+    constexpr bool satisfiable() const noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            if (low_[field] > high_[field]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Test a record against the rule directly, one field at a time.
+    constexpr bool matches(const TLayout& record) const noexcept {
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            const std::uint64_t value = field_value(record, field);
+            if (value < low_[field] || value > high_[field]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// The value of a field of a record.
+    static constexpr std::uint64_t field_value(const TLayout& record, const std::size_t field) noexcept {
+        using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+        return (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> fields::offsets[field]) &
+               field_mask(field);
+    }
+
+    /// The largest value of a field.
+    static constexpr std::uint64_t field_mask(const std::size_t field) noexcept {
+        const unsigned width = fields::width_of(field);
+        return width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    }
+
+private:
+    std::array<std::uint64_t, fields::count> low_{};
+    std::array<std::uint64_t, fields::count> high_{};
+};
+
+/// A classifier compiled from a list of rules, which finds the first rule a record matches without testing the rules
+/// one by one.
+///
+/// Each field some rule restricts is split into intervals at the ends of every rule's range, so all values in an
+/// interval match the same rules. For each interval, the classifier stores the set of rules it allows, one bit per
+/// rule. Classifying a record looks up the interval of each restricted field, directly in a table for fields of up to
+/// 12 bits or by binary search otherwise, and intersects their rule sets a word at a time. The first bit left is the
+/// first matching rule. The cost grows with the number of restricted fields and with the number of rules / 64, rather
+/// than with the number of rules.
+///
+/// @tparam TLayout The layout of the records.
+template <bit_field_layout TLayout>
+    requires (bits<typename TLayout::value_type> <= 64)
+class layout_classifier {
+    using fields = layout_fields<TLayout>;
+    using rule_type = classifier_rule<TLayout>;
+
+public:
+    /// The result of classifying a record which matches no rule.
+    static constexpr std::size_t no_match = ~std::size_t{0};
+
+    /// The widest field looked up in a table rather than by binary search.
+    static constexpr unsigned max_table_width = 12;
+
+    constexpr layout_classifier() = default;
+
+    /// Compile a classifier from rules. Earlier rules take priority over later ones.
+    ///
+    /// @param rules The rules.
+    constexpr explicit layout_classifier(const std::span<const rule_type> rules)
+        : rule_count_(rules.size()),
+          words_((rules.size() + 63) / 64),
+          allowed_(words_, 0) {
+        for (std::size_t rule = 0; rule < rules.size(); ++rule) {
+            if (rules[rule].satisfiable()) {
+                allowed_[rule / 64] |= std::uint64_t{1} << (rule % 64);
+            }
+        }
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            if (std::any_of(rules.begin(), rules.end(), [field](const rule_type& rule) {
+                    return rule.restricts(field);
+                })) {
+                dimensions_.push_back(make_dimension(rules, field));
+            }
+        }
+    }
+
+    /// The number of rules.
+    constexpr std::size_t rule_count() const noexcept {
+        return rule_count_;
+    }
+
+    /// The number of 64-bit words in a set of rules.
+    constexpr std::size_t word_count() const noexcept {
+        return words_;
+    }
+
+    /// The number of fields some rule restricts, each of which is looked up when classifying.
+    constexpr std::size_t dimension_count() const noexcept {
+        return dimensions_.size();
+    }
+
+    /// Find the first rule a record matches.
+    ///
+    /// @returns The index of the rule, or no_match.
+    constexpr std::size_t classify(const TLayout& record) const noexcept {
+        std::array<const std::uint64_t*, fields::count> rows{};
+        for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+            rows[i] = row_of(dimensions_[i], record);
+        }
+        return first_match(rows);
+    }
+
+    /// Find the first rule each of several records matches. The records are taken in groups whose lookups are made
+    /// together before any of their rule sets are intersected, so the lookups' loads overlap.
+    ///
+    /// @param records The records.
+    /// @param results Receives the index of each record's first matching rule, or no_match. Must be at least as long
+    ///                as records.
+    constexpr void classify(const std::span<const TLayout> records,
+                            const std::span<std::size_t> results) const noexcept {
+        constexpr std::size_t group = 8;
+        std::array<std::array<const std::uint64_t*, fields::count>, group> rows{};
+        for (std::size_t first = 0; first < records.size(); first += group) {
+            const std::size_t size = std::min(group, records.size() - first);
+            for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+                for (std::size_t j = 0; j < size; ++j) {
+                    rows[j][i] = row_of(dimensions_[i], records[first + j]);
+                }
+            }
+            for (std::size_t j = 0; j < size; ++j) {
+                results[first + j] = first_match(rows[j]);
+            }
+        }
+    }
+
+    /// Find every rule a record matches.
+    ///
+    /// @param record  The record.
+    /// @param matches Receives the set of matching rules, one bit per rule, rule i being bit i % 64 of word i / 64.
+    ///                Must be word_count() words long.
+    constexpr void match_all(const TLayout& record, const std::span<std::uint64_t> matches) const noexcept {
+        std::copy(allowed_.begin(), allowed_.end(), matches.begin());
+        for (const dimension& each : dimensions_) {
+            const std::uint64_t* const row = row_of(each, record);
+            for (std::size_t word = 0; word < words_; ++word) {
+                matches[word] &= row[word];
+            }
+        }
+    }
+
+private:
+    /// A restricted field: the starts of its intervals, and the set of rules each interval allows.
+    struct dimension {
+        unsigned offset;
+        std::uint64_t mask;
+        std::vector<std::uint64_t> starts;
+        std::vector<std::uint32_t> table;
+        std::vector<std::uint64_t> rows;
+    };
+
+    constexpr dimension make_dimension(const std::span<const rule_type> rules, const std::size_t field) const {
+        dimension result{ fields::offsets[field], rule_type::field_mask(field), { 0 }, {}, {} };
+        for (const rule_type& rule : rules) {
+            if (rule.restricts(field) && rule.satisfiable()) {
+                result.starts.push_back(rule.low(field));
+                if (rule.high(field) != result.mask) {
+                    result.starts.push_back(rule.high(field) + 1);
+                }
+            }
+        }
+        std::sort(result.starts.begin(), result.starts.end());
+        result.starts.erase(std::unique(result.starts.begin(), result.starts.end()), result.starts.end());
+
+        const std::size_t intervals = result.starts.size();
+        result.rows.assign(intervals * words_, 0);
+        for (std::size_t rule = 0; rule < rules.size(); ++rule) {
+            if (!rules[rule].satisfiable()) {
+                continue;
+            }
+            const std::size_t from = interval_of(result.starts, rules[rule].low(field));
+            const std::size_t to = interval_of(result.starts, rules[rule].high(field));
+            for (std::size_t interval = from; interval <= to; ++interval) {
+                result.rows[interval * words_ + rule / 64] |= std::uint64_t{1} << (rule % 64);
+            }
+        }
+
+        if (fields::width_of(field) <= max_table_width) {
+            result.table.resize(result.mask + 1);
+            std::size_t interval = 0;
+            for (std::uint64_t value = 0; value <= result.mask; ++value) {
+                while (interval + 1 < intervals && result.starts[interval + 1] <= value) {
+                    ++interval;
+                }
+                result.table[value] = static_cast<std::uint32_t>(interval * words_);
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::size_t interval_of(const std::vector<std::uint64_t>& starts, const std::uint64_t value) {
+        return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), value) - starts.begin()) - 1;
+    }
+
+    constexpr const std::uint64_t* row_of(const dimension& each, const TLayout& record) const noexcept {
+        using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+        const std::uint64_t value =
+            (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> each.offset) & each.mask;
+        if (!each.table.empty()) {
+            return each.rows.data() + each.table[value];
+        }
+        // A branchless binary search, since the interval of each record is unpredictable. The first start is zero, so
+        // the search always ends on the last start at or below the value.
+        const std::uint64_t* first = each.starts.data();
+        for (std::size_t size = each.starts.size(); size > 1;) {
+            const std::size_t half = size / 2;
+            first = first[half] <= value ? first + half : first;
+            size -= half;
+        }
+        return each.rows.data() + static_cast<std::size_t>(first - each.starts.data()) * words_;
+    }
+
+    /// Intersect the rule sets of a record's intervals a word at a time, and return the first rule left. The inner loop
+    /// has no early exit, so it compiles to a straight run of loads and ANDs.
+    constexpr std::size_t first_match(const std::array<const std::uint64_t*, fields::count>& rows) const noexcept {
+        for (std::size_t word = 0; word < words_; ++word) {
+            std::uint64_t candidates = allowed_[word];
+            for (std::size_t i = 0; i < dimensions_.size(); ++i) {
+                candidates &= rows[i][word];
+            }
+            if (candidates != 0) {
+                return word * 64 + static_cast<std::size_t>(std::countr_zero(candidates));
+            }
+        }
+        return no_match;
+    }
+
+    std::size_t rule_count_{0};
+    std::size_t words_{0};
+    std::vector<std::uint64_t> allowed_;
+    std::vector<dimension> dimensions_;
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_CLASSIFIER_HPP
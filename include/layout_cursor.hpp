@@ -0,0 +1,305 @@
+/// Decoding chains of variable-length segments, such as protocol headers whose length is given by one of their fields.
+#ifndef LAYOUT_CURSOR_HPP
+#define LAYOUT_CURSOR_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "bit_field_builder.hpp"
+#include "byte_order.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A length rule computing the total length of a segment in bytes from a field of its fixed prefix, as
+/// field * NScale + NBias. For example, the IPv4 header length is the IHL field times four, and a TLV record with a
+/// two byte type and a two byte length counting only the value is length_from<0, length, 1, 4>.
+///
+/// @tparam NLayoutIndex The index of the prefix layout containing the length field.
+/// @tparam TField       The field holding the length, typically "layout::name" for a field defined with BIT_FIELD.
+/// @tparam NScale       The number of bytes per unit of the length field.
+/// @tparam NBias        A constant number of bytes added to the scaled length field.
+template <std::size_t NLayoutIndex, typename TField, std::size_t NScale = 1, std::size_t NBias = 0>
+struct length_from {
+    static constexpr std::size_t layout_index = NLayoutIndex;
+
+    /// Compute the length of a segment.
+    ///
+    /// @param prefix The tuple of decoded prefix layouts.
+    ///
+    /// @returns The total length of the segment in bytes, including the prefix.
+    static constexpr std::size_t length(const auto& prefix) noexcept {
+        const auto value = TField::template get<length_config>(std::get<NLayoutIndex>(prefix).raw_value);
+        return static_cast<std::size_t>(value) * NScale + NBias;
+    }
+
+private:
+    static constexpr auto length_config = bit_field_config<std::size_t>{};
+};
+
+/// A segment is a fixed prefix, made of one or more layouts stored back to back in the given byte order, followed by a
+/// variable number of bytes whose extent is given by a length rule. The fixed prefix keeps all of the compile-time
+/// masks and shifts of its layouts; only the position of the next segment is computed at run time.
+///
+/// @tparam TOrder    The byte order of the layouts in the prefix.
+/// @tparam TLength   The length rule. Must provide a static length function taking the prefix tuple, such as
+///                   length_from.
+/// @tparam TLayouts  The layouts making up the fixed prefix, in order.
+template <std::endian TOrder, typename TLength, bit_field_layout... TLayouts>
+    requires (sizeof...(TLayouts) > 0)
+struct segment {
+    /// The decoded fixed prefix.
+    using prefix_type = std::tuple<TLayouts...>;
+
+    static constexpr std::endian byte_order = TOrder;
+
+    /// The number of bytes in the fixed prefix, and therefore the smallest valid segment length.
+    static constexpr std::size_t prefix_size = (sizeof(typename TLayouts::value_type) + ...);
+
+    /// Decode the fixed prefix. No bounds checking is done.
+    ///
+    /// @param data Points at the first of prefix_size bytes.
+    ///
+    /// @returns The decoded prefix layouts.
+    static constexpr prefix_type decode(const std::byte* const data) noexcept {
+        return decode_impl(data, std::index_sequence_for<TLayouts...>{});
+    }
+
+    /// Encode the fixed prefix. No bounds checking is done.
+    ///
+    /// @param data   Points at the first of prefix_size bytes.
+    /// @param prefix The prefix layouts to encode.
+    static constexpr void encode(std::byte* const data, const prefix_type& prefix) noexcept {
+        encode_impl(data, prefix, std::index_sequence_for<TLayouts...>{});
+    }
+
+    /// Compute the total length of the segment, including the prefix, from its decoded prefix.
+    ///
+    /// @param prefix The decoded prefix.
+    ///
+    /// @returns The length of the segment in bytes.
+    static constexpr std::size_t length(const prefix_type& prefix) noexcept {
+        return TLength::length(prefix);
+    }
+
+private:
+    /// The byte offset of each prefix layout.
+    static constexpr std::array<std::size_t, sizeof...(TLayouts)> offsets = []() constexpr {
+        std::array<std::size_t, sizeof...(TLayouts)> result{};
+        std::size_t offset = 0;
+        std::size_t i = 0;
+        ((result[i++] = offset, offset += sizeof(typename TLayouts::value_type)), ...);
+        return result;
+    }();
+
+    template <std::size_t... NIndices>
+    static constexpr prefix_type decode_impl(const std::byte* const data, std::index_sequence<NIndices...>) noexcept {
+        return prefix_type{ load_layout<TLayouts, TOrder>(data + offsets[NIndices])... };
+    }
+
+    template <std::size_t... NIndices>
+    static constexpr void encode_impl(std::byte* const data, const prefix_type& prefix,
+                                      std::index_sequence<NIndices...>) noexcept {
+        (store_layout<TOrder>(data + offsets[NIndices], std::get<NIndices>(prefix)), ...);
+    }
+};
+
+/// A decoded segment: its prefix layouts, and all of its bytes.
+///
+/// @tparam TSegment The segment type.
+template <typename TSegment>
+struct segment_view {
+    typename TSegment::prefix_type prefix{};
+
+    /// Every byte of the segment, including the prefix. Empty if the segment is not valid.
+    std::span<const std::byte> bytes{};
+
+    /// Get one of the prefix layouts.
+    ///
+    /// @tparam NIndex The index of the layout in the prefix.
+    template <std::size_t NIndex>
+    constexpr const auto& get() const noexcept {
+        return std::get<NIndex>(prefix);
+    }
+
+    /// The bytes after the fixed prefix, such as IPv4 options or a TLV value.
+    constexpr std::span<const std::byte> body() const noexcept {
+        return bytes.empty() ? bytes : bytes.subspan(TSegment::prefix_size);
+    }
+
+    /// Returns true if the segment was decoded successfully.
+    constexpr bool valid() const noexcept {
+        return !bytes.empty();
+    }
+};
+
+/// Walks a byte buffer, decoding segments one after another. Each segment is bounds checked once for its whole fixed
+/// prefix, and once for its computed length, rather than once per field.
+class layout_cursor {
+public:
+    /// Construct a cursor at the beginning of a buffer.
+    ///
+    /// @param buffer The bytes to decode. Must outlive the cursor and any segment_view it returns.
+    constexpr explicit layout_cursor(const std::span<const std::byte> buffer) noexcept
+        : remaining_(buffer) {
+    }
+
+    /// Decode the segment at the cursor and advance past it.
+    ///
+    /// @tparam TSegment The segment type expected at the cursor.
+    ///
+    /// @returns The decoded segment, or an empty optional if the buffer is too short for the prefix, or the length rule
+    ///          produces a length shorter than the prefix or longer than the rest of the buffer. In that case the
+    ///          cursor does not move.
+    template <typename TSegment>
+    constexpr std::optional<segment_view<TSegment>> next() noexcept {
+        segment_view<TSegment> view = peek<TSegment>();
+        if (!view.valid()) {
+            return std::nullopt;
+        }
+        remaining_ = remaining_.subspan(view.bytes.size());
+        consumed_ += view.bytes.size();
+        return view;
+    }
+
+    /// Decode the segment at the cursor without advancing.
+    ///
+    /// @tparam TSegment The segment type expected at the cursor.
+    ///
+    /// @returns The decoded segment. It is not valid under the same conditions that next would fail.
+    template <typename TSegment>
+    constexpr segment_view<TSegment> peek() const noexcept {
+        return decode_segment<TSegment>(remaining_);
+    }
+
+    /// Decode a single layout at the cursor and advance past it.
+    ///
+    /// @tparam TLayout The layout type.
+    /// @tparam TOrder  The byte order of the layout in the buffer.
+    ///
+    /// @returns The layout, or an empty optional if the buffer is too short, in which case the cursor does not move.
+    template <bit_field_layout TLayout, std::endian TOrder = std::endian::native>
+    constexpr std::optional<TLayout> read() noexcept {
+        constexpr std::size_t size = sizeof(typename TLayout::value_type);
+        if (remaining_.size() < size) {
+            return std::nullopt;
+        }
+        const TLayout layout = load_layout<TLayout, TOrder>(remaining_.data());
+        remaining_ = remaining_.subspan(size);
+        consumed_ += size;
+        return layout;
+    }
+
+    /// Advance the cursor by a number of bytes.
+    ///
+    /// @param count The number of bytes to skip.
+    ///
+    /// @returns True if the bytes were skipped, or false if fewer bytes remain, in which case the cursor does not move.
+    constexpr bool skip(const std::size_t count) noexcept {
+        if (remaining_.size() < count) {
+            return false;
+        }
+        remaining_ = remaining_.subspan(count);
+        consumed_ += count;
+        return true;
+    }
+
+    /// The bytes which have not been decoded yet.
+    constexpr std::span<const std::byte> remaining() const noexcept {
+        return remaining_;
+    }
+
+    /// The number of bytes decoded so far.
+    constexpr std::size_t position() const noexcept {
+        return consumed_;
+    }
+
+    /// Returns true if every byte has been decoded.
+    constexpr bool empty() const noexcept {
+        return remaining_.empty();
+    }
+
+    /// Decode the segment at the start of a buffer.
+    ///
+    /// @tparam TSegment The segment type.
+    ///
+    /// @param buffer The bytes to decode.
+    ///
+    /// @returns The decoded segment, which is not valid if it does not fit in the buffer.
+    template <typename TSegment>
+    static constexpr segment_view<TSegment> decode_segment(const std::span<const std::byte> buffer) noexcept {
+        if (buffer.size() < TSegment::prefix_size) {
+            return {};
+        }
+        segment_view<TSegment> view{ .prefix = TSegment::decode(buffer.data()) };
+        const std::size_t length = TSegment::length(view.prefix);
+        if (length < TSegment::prefix_size || length > buffer.size()) {
+            return {};
+        }
+        view.bytes = buffer.first(length);
+        return view;
+    }
+
+private:
+    std::span<const std::byte> remaining_;
+    std::size_t consumed_{0};
+};
+
+/// Decode a run of back-to-back segments of the same type, such as a sequence of TLV records, calling a function for
+/// each one.
+///
+/// @tparam TSegment The segment type.
+///
+/// @param buffer The bytes to decode.
+/// @param fn     Called with each segment_view, in order. If it returns bool, returning false stops the walk.
+///
+/// @returns The number of bytes consumed. Equal to the buffer size if every byte formed a valid segment.
+template <typename TSegment>
+constexpr std::size_t for_each_segment(const std::span<const std::byte> buffer, auto&& fn) {
+    layout_cursor cursor{ buffer };
+    while (!cursor.empty()) {
+        const std::optional<segment_view<TSegment>> view = cursor.next<TSegment>();
+        if (!view) {
+            break;
+        }
+        if constexpr (std::is_same_v<decltype(fn(*view)), bool>) {
+            if (!fn(*view)) {
+                break;
+            }
+        } else {
+            fn(*view);
+        }
+    }
+    return cursor.position();
+}
+
+/// Decode the leading segment of many independent frames, such as the IP header of each captured packet.
+///
+/// @tparam TSegment The segment type at the start of every frame.
+///
+/// @param frames The frames to decode.
+/// @param output Receives the decoded segment of each frame. Must be at least as large as frames. Frames which are too
+///               short for their segment produce a segment_view which is not valid.
+///
+/// @returns The number of valid segments.
+template <typename TSegment>
+constexpr std::size_t decode_segments(const std::span<const std::span<const std::byte>> frames,
+                                      const std::span<segment_view<TSegment>> output) noexcept {
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        output[i] = layout_cursor::decode_segment<TSegment>(frames[i]);
+        valid += output[i].valid() ? std::size_t{1} : std::size_t{0};
+    }
+    return valid;
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_CURSOR_HPP
@@ -0,0 +1,273 @@
+/// Finding which fields differ between two values of a layout, and copying just those fields.
+#ifndef LAYOUT_DIFF_HPP
+#define LAYOUT_DIFF_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#if defined(__BMI2__)
+#  include <immintrin.h>
+#endif
+
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+#include "counter.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// The fields of a bit_field_builder layout, recovered at compile time from the layout's bit counter. Every BIT_FIELD
+/// (and every other macro which allocates bits) leaves a mark where it ends, so the boundaries between fields can be
+/// found without naming the fields. Padding counts as a field here: it has an index, and changes to it are reported.
+///
+/// @tparam TLayout The layout type, derived from bit_field_builder.
+template <bit_field_layout TLayout>
+struct layout_fields {
+    using value_type = typename TLayout::value_type;
+
+private:
+    static constexpr unsigned width = TLayout::allocated_bits();
+
+    /// Returns true if a field ends at bit NEnd.
+    template <unsigned NEnd>
+    static constexpr bool ends_at() noexcept {
+        if constexpr (requires { TLayout::count(counter<NEnd>{}); }) {
+            return decltype(TLayout::count(counter<NEnd>{}))::value == NEnd;
+        } else {
+            return false;
+        }
+    }
+
+    template <unsigned... NEnds>
+    static constexpr std::size_t count_ends(std::integer_sequence<unsigned, NEnds...>) noexcept {
+        return (std::size_t{0} + ... + (ends_at<NEnds + 1>() ? 1 : 0));
+    }
+
+public:
+    /// The number of fields, including padding.
+    static constexpr std::size_t count = count_ends(std::make_integer_sequence<unsigned, width>{});
+
+    static_assert(count <= 64, "Layouts with more than 64 fields are not supported.");
+
+    /// A bitmask with one bit per field, where bit i stands for the field at index i.
+    using mask_type = detail::uint_least_t<(count > 0 ? count : 1)>;
+
+    /// The offset of each field, in increasing order. The field at index i occupies bits offsets[i] up to, but not
+    /// including, offsets[i + 1], or the end of the allocated bits for the last field.
+    static constexpr std::array<unsigned, count> offsets = []() constexpr {
+        std::array<unsigned, count> result{};
+        std::size_t i = 0;
+        unsigned start = 0;
+        [&]<unsigned... NEnds>(std::integer_sequence<unsigned, NEnds...>) constexpr {
+            ((ends_at<NEnds + 1>() ? (result[i++] = start, start = NEnds + 1, 0) : 0), ...);
+        }(std::make_integer_sequence<unsigned, width>{});
+        return result;
+    }();
+
+    /// The width of the field at an index.
+    static constexpr unsigned width_of(const std::size_t index) noexcept {
+        return (index + 1 < count ? offsets[index + 1] : width) - offsets[index];
+    }
+
+    /// The index of a field, given its type, such as "layout::name" for a field defined with BIT_FIELD.
+    template <typename TField>
+    static constexpr std::size_t index_of = []() constexpr {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (offsets[i] == TField::offset) {
+                return i;
+            }
+        }
+        return count;
+    }();
+
+    /// The bit standing for a field in a mask_type.
+    template <typename TField>
+        requires (index_of<TField> < count)
+    static constexpr mask_type bit = static_cast<mask_type>(mask_type{1} << index_of<TField>);
+
+    /// The lowest bit of every field.
+    static constexpr value_type low_bits = []() constexpr {
+        value_type result{0};
+        for (std::size_t i = 0; i < count; ++i) {
+            result = static_cast<value_type>(result | static_cast<value_type>(value_type{1} << offsets[i]));
+        }
+        return result;
+    }();
+
+    /// The highest bit of every field.
+    static constexpr value_type high_bits = []() constexpr {
+        value_type result{0};
+        for (std::size_t i = 0; i < count; ++i) {
+            const unsigned top = offsets[i] + width_of(i) - 1;
+            result = static_cast<value_type>(result | static_cast<value_type>(value_type{1} << top));
+        }
+        return result;
+    }();
+
+    /// Every allocated bit.
+    static constexpr value_type allocated = bit_mask<value_type, 0, width>;
+};
+
+/// A hash identifying the shape of a layout: its storage size and the offset of every field (see layout_fields.) Two
+/// programs built with different versions of a layout get different hashes, unless the change only renamed fields or
+/// changed their configured types.
+///
+/// @tparam TLayout The layout type.
+/// @tparam NTag    A value mixed into the hash, such as a schema version, to tell apart layouts of the same shape.
+template <bit_field_layout TLayout, std::uint64_t NTag = 0>
+constexpr std::uint64_t layout_hash = []() constexpr {
+    // 64-bit FNV-1a over the words describing the layout.
+    std::uint64_t hash = 0xCBF2'9CE4'8422'2325u;
+    const auto mix = [&hash](const std::uint64_t value) constexpr {
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 0x0000'0100'0000'01B3u;
+        }
+    };
+    mix(NTag);
+    mix(sizeof(typename TLayout::value_type));
+    mix(TLayout::allocated_bits());
+    for (const unsigned offset : layout_fields<TLayout>::offsets) {
+        mix(offset);
+    }
+    return hash;
+}();
+
+namespace detail {
+
+/// Gather the bits of value selected by a compile-time mask into the low bits of the result, like pext.
+template <typename T, typename TResult, T TMask>
+constexpr TResult gather_bits(const T value) noexcept {
+#if defined(__BMI2__)
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        if (!std::is_constant_evaluated()) {
+            return static_cast<TResult>(
+                _pext_u64(static_cast<std::uint64_t>(value), static_cast<std::uint64_t>(TMask)));
+        }
+    }
+#endif
+    TResult result{0};
+    T mask = TMask;
+    for (unsigned i = 0; mask != 0; ++i) {
+        const T lowest = static_cast<T>(mask & (~mask + 1));
+        if ((value & lowest) != 0) {
+            result = static_cast<TResult>(result | static_cast<TResult>(TResult{1} << i));
+        }
+        mask = static_cast<T>(mask & ~lowest);
+    }
+    return result;
+}
+
+/// Scatter the low bits of value to the positions of the bits set in a compile-time mask, like pdep.
+template <typename T, T TMask>
+constexpr T scatter_bits(const auto value) noexcept {
+#if defined(__BMI2__)
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        if (!std::is_constant_evaluated()) {
+            return static_cast<T>(_pdep_u64(static_cast<std::uint64_t>(value), static_cast<std::uint64_t>(TMask)));
+        }
+    }
+#endif
+    T result{0};
+    T mask = TMask;
+    for (unsigned i = 0; mask != 0; ++i) {
+        const T lowest = static_cast<T>(mask & (~mask + 1));
+        if (((value >> i) & 1) != 0) {
+            result = static_cast<T>(result | lowest);
+        }
+        mask = static_cast<T>(mask & ~lowest);
+    }
+    return result;
+}
+
+} // End namespace detail.
+
+/// Find which fields differ between two raw values of a layout. The values are compared with one XOR. Then each field
+/// of the difference is reduced to its highest bit in parallel: adding all ones below the highest bit of each field
+/// carries into that bit exactly when some lower bit is set, and never carries out of the field. Finally the highest
+/// bits are gathered into the mask with one pext on processors with BMI2, or a loop over the fields otherwise.
+///
+/// @tparam TLayout The layout type.
+///
+/// @param old_value The raw value before.
+/// @param new_value The raw value after.
+///
+/// @returns A mask with bit i set if the field at index i differs. See layout_fields.
+template <bit_field_layout TLayout>
+constexpr typename layout_fields<TLayout>::mask_type changed_fields(const typename TLayout::value_type old_value,
+                                                                    const typename TLayout::value_type new_value) {
+    using fields = layout_fields<TLayout>;
+    using value_type = typename fields::value_type;
+    constexpr value_type below_high = static_cast<value_type>(fields::allocated & ~fields::high_bits);
+
+    const auto difference = static_cast<value_type>(old_value ^ new_value);
+    const auto reduced = static_cast<value_type>(
+        static_cast<value_type>(static_cast<value_type>(difference & below_high) + below_high) | difference);
+    return detail::gather_bits<value_type, typename fields::mask_type, fields::high_bits>(reduced);
+}
+
+/// Find which fields differ between two values of a layout. See the overload taking raw values.
+template <bit_field_layout TLayout>
+constexpr typename layout_fields<TLayout>::mask_type changed_fields(const TLayout& old_value,
+                                                                    const TLayout& new_value) {
+    return changed_fields<TLayout>(old_value.raw_value, new_value.raw_value);
+}
+
+/// Find which fields differ in each pair of records of two equally sized arrays, such as two snapshots of a table.
+///
+/// @param old_values The records before.
+/// @param new_values The records after. Must be the same size as old_values.
+/// @param changes    Receives the mask of changed fields of each record. Must be at least as large as old_values.
+///
+/// @returns The number of records with at least one changed field.
+template <bit_field_layout TLayout>
+constexpr std::size_t changed_fields(const std::span<const TLayout> old_values,
+                                     const std::span<const TLayout> new_values,
+                                     const std::span<typename layout_fields<TLayout>::mask_type> changes) {
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < old_values.size(); ++i) {
+        changes[i] = changed_fields<TLayout>(old_values[i].raw_value, new_values[i].raw_value);
+        changed += changes[i] != 0 ? std::size_t{1} : std::size_t{0};
+    }
+    return changed;
+}
+
+/// Copy the selected fields of one value of a layout into another. The mask is expanded to cover whole fields by
+/// placing its bits at the lowest and highest bits of their fields (one pdep each with BMI2) and subtracting.
+///
+/// @param target  The value to update.
+/// @param source  The value to copy the fields from, such as the new value given to changed_fields.
+/// @param changes A mask with bit i set for each field index i to copy, such as the result of changed_fields.
+template <bit_field_layout TLayout>
+constexpr void apply_patch(TLayout& target, const TLayout& source,
+                           const typename layout_fields<TLayout>::mask_type changes) {
+    using fields = layout_fields<TLayout>;
+    using value_type = typename fields::value_type;
+
+    const value_type low = detail::scatter_bits<value_type, fields::low_bits>(changes);
+    const value_type high = detail::scatter_bits<value_type, fields::high_bits>(changes);
+    const auto mask = static_cast<value_type>(static_cast<value_type>(high - low) | high);
+    target.raw_value = static_cast<value_type>((target.raw_value & ~mask) | (source.raw_value & mask));
+}
+
+/// Copy the selected fields of each record of one array into the matching record of another.
+///
+/// @param targets The records to update.
+/// @param sources The records to copy fields from. Must be the same size as targets.
+/// @param changes The mask of fields to copy for each record. Must be the same size as targets.
+template <bit_field_layout TLayout>
+constexpr void apply_patch(const std::span<TLayout> targets, const std::span<const TLayout> sources,
+                           const std::span<const typename layout_fields<TLayout>::mask_type> changes) {
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (changes[i] != 0) {
+            apply_patch(targets[i], sources[i], changes[i]);
+        }
+    }
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // LAYOUT_DIFF_HPP
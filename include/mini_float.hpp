@@ -0,0 +1,243 @@
+/// Low-precision floating point formats which can be stored in bit fields.
+#ifndef MINI_FLOAT_HPP
+#define MINI_FLOAT_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#if defined(__F16C__)
+#  include <immintrin.h>
+#endif
+
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Portable conversion between float and a mini_float encoding using integer manipulation of the float representation.
+/// See mini_float for a description of the template parameters.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned>
+struct mini_float_impl {
+    static constexpr std::size_t bits = (BSigned ? 1 : 0) + NExponent + NMantissa;
+    static constexpr int bias = (1 << (NExponent - 1)) - 1;
+    static constexpr std::uint32_t raw_mask = static_cast<std::uint32_t>((std::uint64_t{1} << bits) - 1);
+    static constexpr std::uint32_t exponent_max = (1u << NExponent) - 1;
+    static constexpr std::uint32_t mantissa_mask = (1u << NMantissa) - 1;
+    static constexpr unsigned mantissa_shift = 23 - NMantissa;
+    static constexpr std::uint32_t infinity = exponent_max << NMantissa;
+
+    static constexpr float decode(const std::uint32_t raw) noexcept {
+        const std::uint32_t value = raw & raw_mask;
+        const std::uint32_t sign = BSigned ? (value >> (NExponent + NMantissa)) << 31 : 0;
+        const std::uint32_t exponent = (value >> NMantissa) & exponent_max;
+        const std::uint32_t mantissa = value & mantissa_mask;
+
+        if (exponent == 0) {
+            // Zero or subnormal: the mantissa times 2^(1 - bias - NMantissa). With eight exponent bits the scale is
+            // below the smallest normal float, so it is built as a float subnormal. It is never below the smallest
+            // float subnormal, 2^-149, and the product is a multiple of the scale with fewer than 24 significant
+            // bits, so the product is exact.
+            constexpr int scale_exponent = 1 - bias - static_cast<int>(NMantissa);
+            constexpr float scale = scale_exponent < -126
+                                        ? std::bit_cast<float>(1u << (scale_exponent + 149))
+                                        : std::bit_cast<float>(static_cast<std::uint32_t>(scale_exponent + 127) << 23);
+            const float magnitude = static_cast<float>(mantissa) * scale;
+            return std::bit_cast<float>(std::bit_cast<std::uint32_t>(magnitude) | sign);
+        } else if (exponent == exponent_max) {
+            // Infinity or NaN, keeping the NaN payload.
+            return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << mantissa_shift));
+        } else {
+            return std::bit_cast<float>(sign | ((exponent + 127 - bias) << 23) | (mantissa << mantissa_shift));
+        }
+    }
+
+    /// Shift right, rounding to nearest with ties to even.
+    static constexpr std::uint32_t round_shift(const std::uint32_t value, const unsigned shift) noexcept {
+        if (shift == 0) {
+            return value;
+        }
+        const std::uint32_t half_minus_one = (1u << (shift - 1)) - 1;
+        return (value + half_minus_one + ((value >> shift) & 1u)) >> shift;
+    }
+
+    static constexpr std::uint32_t encode(const float value) noexcept {
+        const std::uint32_t float_bits = std::bit_cast<std::uint32_t>(value);
+        const std::uint32_t magnitude = float_bits & 0x7FFFFFFFu;
+        const std::uint32_t sign = BSigned ? (float_bits >> 31) << (NExponent + NMantissa) : 0;
+
+        if (magnitude > 0x7F800000u) {
+            // NaN. Produce a quiet NaN of the same sign.
+            return sign | infinity | (1u << (NMantissa - 1));
+        }
+        if constexpr (!BSigned) {
+            if (float_bits >> 31) {
+                return 0;
+            }
+        }
+
+        const int float_exponent = static_cast<int>(magnitude >> 23);
+        const int exponent = float_exponent - 127 + bias;
+
+        if (exponent >= static_cast<int>(exponent_max)) {
+            return sign | infinity;
+        } else if (exponent > 0) {
+            // Normal in the target format. Rounding may carry into the exponent, which correctly produces the next
+            // binade, or infinity.
+            const std::uint32_t combined = (static_cast<std::uint32_t>(exponent) << 23) | (magnitude & 0x7FFFFFu);
+            return sign | round_shift(combined, mantissa_shift);
+        } else {
+            // Subnormal or zero in the target format. Rounding may carry into the smallest normal, which is also
+            // encoded correctly.
+            const std::uint32_t mantissa = float_exponent == 0 ? magnitude : (magnitude & 0x7FFFFFu) | 0x800000u;
+            const int shift = float_exponent == 0 ? 150 - bias - static_cast<int>(NMantissa)
+                                                  : 1 - exponent + static_cast<int>(mantissa_shift);
+            return sign | (shift > 24 ? 0 : round_shift(mantissa, static_cast<unsigned>(shift)));
+        }
+    }
+};
+
+/// Every decoded value of a format of at most eight bits, indexed by the encoded value.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned>
+constexpr auto mini_float_table = []() constexpr {
+    using impl = mini_float_impl<NExponent, NMantissa, BSigned>;
+    std::array<float, (std::size_t{1} << impl::bits)> table{};
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        table[i] = impl::decode(static_cast<std::uint32_t>(i));
+    }
+    return table;
+}();
+
+} // End namespace detail.
+
+/// An IEEE 754-like binary floating point format with a configurable number of exponent and mantissa bits, optionally
+/// without a sign bit. The format has subnormals, and the all-ones exponent encodes infinity and NaN, exactly like the
+/// IEEE interchange formats. With five exponent bits and ten mantissa bits the format is exactly IEEE binary16.
+///
+/// Values are converted to and from float. Every value of every supported format is exactly representable as a float,
+/// so decoding is exact. Encoding rounds to nearest, ties to even, and overflows to infinity. Unsigned formats clamp
+/// negative values to zero.
+///
+/// Formats with at most eight bits decode through a constexpr table of every possible value. IEEE binary16 decodes and
+/// encodes with the F16C instructions when they are available and the call is not constant-evaluated.
+///
+/// A mini_float satisfies the field_codec concept, so it can be stored in a bit_field_builder with BIT_FIELD_CODEC.
+///
+/// @tparam NExponent The number of exponent bits, from 2 to 8.
+/// @tparam NMantissa The number of explicit mantissa bits, from 1 to 22.
+/// @tparam BSigned   Whether the format has a sign bit in its most significant position.
+template <unsigned NExponent, unsigned NMantissa, bool BSigned = true>
+    requires (NExponent >= 2 && NExponent <= 8 && NMantissa >= 1 && NMantissa <= 22)
+struct mini_float {
+    using value_type = float;
+
+    static constexpr unsigned exponent_bits = NExponent;
+    static constexpr unsigned mantissa_bits = NMantissa;
+    static constexpr bool is_signed = BSigned;
+
+    /// The total number of bits in an encoded value.
+    static constexpr std::size_t bits = (BSigned ? 1 : 0) + NExponent + NMantissa;
+
+    /// The type used to hold an encoded value. Only the low "bits" bits are used.
+    using raw_type = detail::uint_least_t<bits>;
+
+    /// The exponent bias of the format.
+    static constexpr int bias = (1 << (NExponent - 1)) - 1;
+
+    /// Whether the format is exactly IEEE binary16, which some hardware converts natively.
+    static constexpr bool is_ieee_half = NExponent == 5 && NMantissa == 10 && BSigned;
+
+    /// Decode a single value. Bits of raw above the format width are ignored.
+    ///
+    /// @param raw The encoded value.
+    ///
+    /// @returns The exact float representation of the encoded value.
+    static constexpr float decode(const raw_type raw) noexcept {
+        if constexpr (bits <= 8) {
+            return detail::mini_float_table<NExponent, NMantissa, BSigned>[raw & impl::raw_mask];
+        } else {
+#if defined(__F16C__)
+            if constexpr (is_ieee_half) {
+                if (!std::is_constant_evaluated()) {
+                    return _cvtsh_ss(raw);
+                }
+            }
+#endif
+            return impl::decode(raw);
+        }
+    }
+
+    /// Encode a single value, rounding to nearest with ties to even.
+    ///
+    /// @param value The value to encode.
+    ///
+    /// @returns The encoded value in the low "bits" bits.
+    static constexpr raw_type encode(const float value) noexcept {
+#if defined(__F16C__)
+        if constexpr (is_ieee_half) {
+            if (!std::is_constant_evaluated()) {
+                return static_cast<raw_type>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+            }
+        }
+#endif
+        return static_cast<raw_type>(impl::encode(value));
+    }
+
+    /// Decode a run of values. The output must be at least as large as the input. IEEE binary16 converts eight values
+    /// per instruction when F16C and AVX are available. Other formats use the single value path, which the compiler is
+    /// free to vectorize.
+    ///
+    /// @param input  The encoded values.
+    /// @param output Receives the decoded values.
+    static void decode(const std::span<const raw_type> input, const std::span<float> output) noexcept {
+        std::size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+        if constexpr (is_ieee_half) {
+            for (const std::size_t end = input.size() & ~std::size_t{7}; i < end; i += 8) {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+                _mm256_storeu_ps(output.data() + i, _mm256_cvtph_ps(packed));
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = decode(input[i]);
+        }
+    }
+
+    /// Encode a run of values. The output must be at least as large as the input.
+    ///
+    /// @param input  The values to encode.
+    /// @param output Receives the encoded values.
+    static void encode(const std::span<const float> input, const std::span<raw_type> output) noexcept {
+        std::size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+        if constexpr (is_ieee_half) {
+            for (const std::size_t end = input.size() & ~std::size_t{7}; i < end; i += 8) {
+                const __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(input.data() + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), packed);
+            }
+        }
+#endif
+        for (; i < input.size(); ++i) {
+            output[i] = encode(input[i]);
+        }
+    }
+
+private:
+    using impl = detail::mini_float_impl<NExponent, NMantissa, BSigned>;
+};
+
+/// IEEE 754 binary16.
+using half_float = mini_float<5, 10>;
+
+/// The bfloat16 format, the upper half of an IEEE binary32.
+using brain_float = mini_float<8, 7>;
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // MINI_FLOAT_HPP
@@ -0,0 +1,289 @@
+/// Packing of several bounded values into a shared run of bits using mixed-radix arithmetic.
+#ifndef MIXED_RADIX_HPP
+#define MIXED_RADIX_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "bit_field.hpp"
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// The product of a list of radices, or zero if the product does not fit in 64 bits.
+template <std::size_t... NRadices>
+constexpr std::uint64_t radix_product = []() constexpr {
+    std::uint64_t product = 1;
+    for (const std::uint64_t radix : std::array<std::uint64_t, sizeof...(NRadices)>{ NRadices... }) {
+        if (product > std::numeric_limits<std::uint64_t>::max() / radix) {
+            return std::uint64_t{0};
+        }
+        product *= radix;
+    }
+    return product;
+}();
+
+/// Divide by a constant using a multiplication and a shift which are exact for every dividend up to NMax. Compilers
+/// already do this for scalar code, but spelling it out in 32-bit arithmetic lets narrow bulk loops vectorize, since
+/// vector units generally lack integer division and 8-bit multiplication.
+///
+/// @tparam NDivisor The divisor.
+/// @tparam NMax     The largest dividend which must divide exactly.
+template <std::uint64_t NDivisor, std::uint64_t NMax>
+struct constant_divisor {
+    /// Find the smallest shift whose rounded-up reciprocal has an error small enough for every dividend up to NMax.
+    static constexpr unsigned shift = []() constexpr {
+        for (unsigned candidate = 0; candidate < 32; ++candidate) {
+            const std::uint64_t power = std::uint64_t{1} << candidate;
+            const std::uint64_t multiplier = (power + NDivisor - 1) / NDivisor;
+            if ((multiplier * NDivisor - power) * NMax < power) {
+                return candidate;
+            }
+        }
+        return 32u;
+    }();
+
+    static constexpr std::uint64_t multiplier = ((std::uint64_t{1} << shift) + NDivisor - 1) / NDivisor;
+
+    /// Whether the product of any dividend and the multiplier fits in 32 bits.
+    static constexpr bool is_narrow = shift < 32 && NMax * multiplier <= std::numeric_limits<std::uint32_t>::max();
+
+    template <typename T>
+    static constexpr T divide(const T dividend) noexcept {
+        if constexpr (is_narrow) {
+            const auto wide = static_cast<std::uint32_t>(dividend);
+            return static_cast<T>((wide * static_cast<std::uint32_t>(multiplier)) >> shift);
+        } else {
+            return static_cast<T>(dividend / NDivisor);
+        }
+    }
+};
+
+} // End namespace detail.
+
+/// Several bounded values ("digits") packed into one integer as a mixed-radix number. Digit zero is the least
+/// significant, so three digits with radices A, B, and C are packed as d0 + A * (d1 + B * d2). This wastes less than
+/// one bit in total, where giving each digit its own run of bits wastes up to one bit per digit. For example, three
+/// digits with five states each need 7 bits rather than 9.
+///
+/// All divisors are compile-time constants, so digit extraction compiles to multiplications and shifts. For groups of
+/// up to 16 bits these are done in 32-bit arithmetic so that bulk extraction vectorizes.
+///
+/// @tparam NRadices The number of states of each digit, least significant first. Each must be at least two.
+template <std::size_t... NRadices>
+    requires (sizeof...(NRadices) > 0 && ((NRadices >= 2) && ...) && detail::radix_product<NRadices...> != 0)
+struct mixed_radix {
+    /// The number of digits.
+    static constexpr std::size_t count = sizeof...(NRadices);
+
+    /// The number of states of each digit.
+    static constexpr std::array<std::uint64_t, count> radices{ NRadices... };
+
+    /// The number of distinct packed values.
+    static constexpr std::uint64_t states = detail::radix_product<NRadices...>;
+
+    /// The number of bits required to store a packed value.
+    static constexpr std::size_t bits = static_cast<std::size_t>(std::bit_width(states - 1));
+
+    /// The type holding a packed value.
+    using raw_type = detail::uint_least_t<bits>;
+
+    /// The place value of each digit.
+    template <std::size_t NIndex>
+        requires (NIndex < count)
+    static constexpr raw_type weight = []() constexpr {
+        std::uint64_t product = 1;
+        for (std::size_t i = 0; i < NIndex; ++i) {
+            product *= radices[i];
+        }
+        return static_cast<raw_type>(product);
+    }();
+
+    /// Extract a digit from a packed value.
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    ///
+    /// @returns The digit, less than its radix.
+    template <std::size_t NIndex>
+    static constexpr raw_type get(const raw_type packed) noexcept {
+        using quotient = detail::constant_divisor<weight<NIndex>, states - 1>;
+        if constexpr (NIndex == count - 1) {
+            return quotient::divide(packed);
+        } else {
+            using remainder = detail::constant_divisor<radices[NIndex], (states - 1) / weight<NIndex>>;
+            const raw_type shifted = quotient::divide(packed);
+            return static_cast<raw_type>(shifted - remainder::divide(shifted) * static_cast<raw_type>(radices[NIndex]));
+        }
+    }
+
+    /// Replace a digit in a packed value. The digit is reduced modulo its radix, mirroring the mask assignment strategy
+    /// of ordinary bit fields.
+    ///
+    /// @tparam NIndex The index of the digit to replace.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    /// @param digit  The new digit.
+    ///
+    /// @returns The updated packed value.
+    template <std::size_t NIndex>
+    static constexpr raw_type set(const raw_type packed, const std::uint64_t digit) noexcept {
+        const auto reduced = static_cast<raw_type>(digit % radices[NIndex]);
+        return static_cast<raw_type>(packed - get<NIndex>(packed) * weight<NIndex> + reduced * weight<NIndex>);
+    }
+
+    /// Pack every digit at once.
+    ///
+    /// @param digits The digits, least significant first. Each is reduced modulo its radix.
+    ///
+    /// @returns The packed value.
+    static constexpr raw_type pack(const std::array<std::uint64_t, count>& digits) noexcept {
+        std::uint64_t packed = 0;
+        for (std::size_t i = count; i-- > 0;) {
+            packed = packed * radices[i] + digits[i] % radices[i];
+        }
+        return static_cast<raw_type>(packed);
+    }
+
+    /// Unpack every digit at once.
+    ///
+    /// @param packed The packed value. Must be less than "states".
+    ///
+    /// @returns The digits, least significant first.
+    static constexpr std::array<raw_type, count> unpack(const raw_type packed) noexcept {
+        return [packed]<std::size_t... NIndices>(std::index_sequence<NIndices...>) constexpr {
+            return std::array<raw_type, count>{ get<NIndices>(packed)... };
+        }(std::make_index_sequence<count>{});
+    }
+};
+
+/// A field which stores a mixed-radix group in a run of bits described by a bit_field.
+///
+/// @tparam TField The bit_field describing where the packed value is stored. Must be exactly as wide as the group.
+/// @tparam TRadix The mixed_radix describing the digits.
+template <typename TField, typename TRadix>
+    requires (TField::bits == TRadix::bits)
+struct mixed_radix_field {
+    using field = TField;
+    using radix = TRadix;
+    using raw_type = typename TRadix::raw_type;
+
+    static constexpr std::size_t offset = TField::offset;
+    static constexpr std::size_t bits = TField::bits;
+
+    /// Extract a digit from the group stored in a value.
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param value The value containing the group.
+    ///
+    /// @returns The digit.
+    template <std::size_t NIndex>
+    static constexpr raw_type get(const auto value) noexcept {
+        return TRadix::template get<NIndex>(TField::template get<get_config>(value));
+    }
+
+    /// Replace a digit of the group stored in a value.
+    ///
+    /// @tparam NIndex The index of the digit to replace.
+    ///
+    /// @param into  The value containing the group.
+    /// @param digit The new digit, reduced modulo its radix.
+    template <std::size_t NIndex>
+    static constexpr void set(auto& into, const std::uint64_t digit) noexcept {
+        TField::template set<set_config>(
+            into, TRadix::template set<NIndex>(TField::template get<get_config>(into), digit));
+    }
+
+    /// Extract one digit from the group in each of a run of values. The loop has no dependencies between iterations
+    /// and divides by constants using 32-bit multiplications, so compilers vectorize it (GCC does so at -O3).
+    ///
+    /// @tparam NIndex The index of the digit to extract.
+    ///
+    /// @param input  The values containing the group.
+    /// @param output Receives the digits. Must be at least as large as the input.
+    template <std::size_t NIndex, typename TStorage>
+    static void get(const std::span<const TStorage> input, const std::span<raw_type> output) noexcept {
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            output[i] = get<NIndex>(input[i]);
+        }
+    }
+
+private:
+    static constexpr auto get_config = bit_field_config<raw_type>{ .offset = 0 };
+    /// Packed values are only valid below TRadix::states, so a packed value can never exceed the field width unless the
+    /// stored group was already invalid. Masking anyway keeps an invalid group from corrupting neighboring fields.
+    static constexpr auto set_config = bit_field_config{ .offset = 0, .strategy = bit_field_assignment_strategy::mask };
+};
+
+/// Define a mixed-radix group consuming as many bits as the product of its radices requires.
+///
+/// @param self The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param name The name of the group. Used to generate the below symbol names.
+/// @param ...  The radix of each digit, least significant first.
+///
+/// This creates the following symbols at the current scope (replacing "name" with the given name of the group):
+///     name     -- A mixed_radix_field type definition.
+///     get_name -- Member function template taking a digit index and returning the digit.
+///     set_name -- Member function template taking a digit index and the new digit.
+#define BIT_FIELD_MIXED_RADIX_DEP(self, name, ...)                                                                     \
+    using name = ::BIT_FIELD_NAMESPACE::mixed_radix_field<                                                             \
+        ::BIT_FIELD_NAMESPACE::bit_field<::BIT_FIELD_NAMESPACE::mixed_radix<__VA_ARGS__>::bits,                        \
+                                         COUNTER_VALUE(self count, self max_field)>,                                   \
+        ::BIT_FIELD_NAMESPACE::mixed_radix<__VA_ARGS__>>;                                                              \
+                                                                                                                       \
+    static_assert(COUNTER_VALUE(self count, self max_field) + name::bits <= self max_field);                           \
+                                                                                                                       \
+    template <std::size_t NIndex>                                                                                      \
+    constexpr typename name::raw_type get_##name() const noexcept {                                                    \
+        return name::template get<NIndex>(self raw_value);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    template <std::size_t NIndex>                                                                                      \
+    constexpr void set_##name(const std::uint64_t digit) noexcept {                                                    \
+        name::template set<NIndex>(self raw_value, digit);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    BIT_FIELD_PAD_DEP(self, name::bits)
+
+/// Same as BIT_FIELD_MIXED_RADIX_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_MIXED_RADIX(name, ...) \
+    BIT_FIELD_MIXED_RADIX_DEP(, name, __VA_ARGS__)
+
+/// Give a digit of a mixed-radix group its own accessors. Consumes no bits.
+///
+/// @param self  The "self" type derived from bit_field_builder. See BIT_FIELD_DEP.
+/// @param group The name of a group defined with BIT_FIELD_MIXED_RADIX.
+/// @param name  The name of the digit.
+/// @param index The index of the digit within the group.
+///
+/// This creates get_name and set_name member functions at the current scope.
+#define BIT_FIELD_RADIX_DIGIT_DEP(self, group, name, index)                                                            \
+    constexpr typename group::raw_type get_##name() const noexcept {                                                   \
+        return group::template get<index>(self raw_value);                                                             \
+    }                                                                                                                  \
+                                                                                                                       \
+    constexpr void set_##name(const std::uint64_t digit) noexcept {                                                    \
+        group::template set<index>(self raw_value, digit);                                                             \
+    }
+
+/// Same as BIT_FIELD_RADIX_DIGIT_DEP, but for use in contexts where dependent name lookups are not required (most
+/// cases.)
+#define BIT_FIELD_RADIX_DIGIT(group, name, index) \
+    BIT_FIELD_RADIX_DIGIT_DEP(, group, name, index)
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // MIXED_RADIX_HPP
@@ -0,0 +1,228 @@
+/// Predefined layouts of common network protocol headers: Ethernet, 802.1Q VLAN tags, IPv4, IPv6, TCP, and UDP.
+#ifndef NETWORK_HEADERS_HPP
+#define NETWORK_HEADERS_HPP
+
+#include "config.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "bit_field_builder.hpp"
+#include "byte_order.hpp"
+#include "layout_block.hpp"
+#include "layout_cursor.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Layouts of network protocol headers. Every header is big-endian on the wire, and is described as a layout_block of
+/// 16- and 32-bit big-endian words, viewed in place in a packet buffer with a block_view.
+///
+/// The RFCs draw each word with its most significant bit first, on the left. Once a word is loaded big-endian, its
+/// first bit on the wire is its most significant bit, so each layout below lists its fields in the reverse of the RFC
+/// diagram, starting from the least significant bit at the right of the diagram.
+namespace net {
+
+/// EtherType values.
+enum class ether_type : std::uint16_t {
+    ipv4 = 0x0800,
+    arp = 0x0806,
+    vlan = 0x8100,
+    ipv6 = 0x86DD,
+    qinq = 0x88A8,
+};
+
+/// IP protocol numbers, as found in ipv4_word2::protocol and ipv6_word1::next_header.
+enum class ip_protocol : std::uint8_t {
+    icmp = 1,
+    tcp = 6,
+    udp = 17,
+    icmpv6 = 58,
+};
+
+/// The type or length field of an Ethernet frame, or of a VLAN tag.
+struct ethernet_type : bit_field_builder<ethernet_type, std::uint16_t> {
+    BIT_FIELD(type, 16, bit_field_config<ether_type>{});
+};
+
+/// An Ethernet II header: destination and source MAC addresses, then the EtherType. The addresses are 48 bits; read
+/// them with load_mac.
+using ethernet_header = layout_block<block_member<12, ethernet_type, std::endian::big>>;
+
+inline constexpr std::size_t ethernet_header_size = 14;
+
+/// Load a 48-bit MAC address, such as the destination at offset 0 or the source at offset 6 of an Ethernet header.
+///
+/// @param data Points at the first of six bytes.
+///
+/// @returns The address, with its first byte in bits 40 to 47.
+constexpr std::uint64_t load_mac(const std::byte* const data) noexcept {
+    return (std::uint64_t{ load_bytes<std::uint32_t, std::endian::big>(data) } << 16) |
+           load_bytes<std::uint16_t, std::endian::big>(data + 4);
+}
+
+/// The tag control information of an 802.1Q VLAN tag.
+struct vlan_tci : bit_field_builder<vlan_tci, std::uint16_t> {
+    BIT_FIELD(vid, 12);                             ///< VLAN identifier.
+    BIT_FIELD(dei, 1, bit_field_config<bool>{});    ///< Drop eligible indicator.
+    BIT_FIELD(pcp, 3);                              ///< Priority code point.
+};
+
+/// An 802.1Q VLAN tag following an EtherType of ether_type::vlan: the tag control information, then the EtherType of
+/// the encapsulated frame.
+using vlan_tag = layout_block<
+    block_member<0, vlan_tci, std::endian::big>,
+    block_member<2, ethernet_type, std::endian::big>>;
+
+inline constexpr std::size_t vlan_tag_size = 4;
+
+/// The first word of an IPv4 header.
+struct ipv4_word0 : bit_field_builder<ipv4_word0, std::uint32_t> {
+    BIT_FIELD(total_length, 16);
+    BIT_FIELD(ecn,           2);
+    BIT_FIELD(dscp,          6);
+    BIT_FIELD(ihl,           4);                    ///< The header length in 32-bit words.
+    BIT_FIELD(version,       4);
+};
+
+/// The second word of an IPv4 header.
+struct ipv4_word1 : bit_field_builder<ipv4_word1, std::uint32_t> {
+    BIT_FIELD(fragment_offset, 13);                 ///< In units of 8 bytes.
+    BIT_FIELD(more_fragments,   1, bit_field_config<bool>{});
+    BIT_FIELD(dont_fragment,    1, bit_field_config<bool>{});
+    BIT_FIELD(reserved,         1);
+    BIT_FIELD(identification,  16);
+};
+
+/// The third word of an IPv4 header.
+struct ipv4_word2 : bit_field_builder<ipv4_word2, std::uint32_t> {
+    BIT_FIELD(checksum, 16);
+    BIT_FIELD(protocol,  8, bit_field_config<ip_protocol>{});
+    BIT_FIELD(ttl,       8);
+};
+
+/// The source address of an IPv4 header.
+struct ipv4_source : bit_field_builder<ipv4_source, std::uint32_t> {
+    BIT_FIELD(address, 32);
+};
+
+/// The destination address of an IPv4 header.
+struct ipv4_destination : bit_field_builder<ipv4_destination, std::uint32_t> {
+    BIT_FIELD(address, 32);
+};
+
+/// The fixed 20 bytes of an IPv4 header. Options, if ipv4_word0::ihl is more than 5, follow.
+using ipv4_header = layout_block<
+    block_member<0, ipv4_word0, std::endian::big>,
+    block_member<4, ipv4_word1, std::endian::big>,
+    block_member<8, ipv4_word2, std::endian::big>,
+    block_member<12, ipv4_source, std::endian::big>,
+    block_member<16, ipv4_destination, std::endian::big>>;
+
+/// An IPv4 header with its options, for walking a packet with a layout_cursor.
+using ipv4_segment = segment<std::endian::big, length_from<0, ipv4_word0::ihl, 4>, ipv4_word0, ipv4_word1, ipv4_word2,
+                             ipv4_source, ipv4_destination>;
+
+/// The first word of an IPv6 header.
+struct ipv6_word0 : bit_field_builder<ipv6_word0, std::uint32_t> {
+    BIT_FIELD(flow_label, 20);
+    BIT_FIELD(ecn,         2);
+    BIT_FIELD(dscp,        6);
+    BIT_FIELD(version,     4);
+};
+
+/// The second word of an IPv6 header.
+struct ipv6_word1 : bit_field_builder<ipv6_word1, std::uint32_t> {
+    BIT_FIELD(hop_limit,       8);
+    BIT_FIELD(next_header,     8, bit_field_config<ip_protocol>{});
+    BIT_FIELD(payload_length, 16);
+};
+
+/// The fixed 40 bytes of an IPv6 header. The 128-bit addresses are read with ipv6_source and ipv6_destination.
+using ipv6_header = layout_block<
+    block_member<0, ipv6_word0, std::endian::big>,
+    block_member<4, ipv6_word1, std::endian::big>>;
+
+inline constexpr std::size_t ipv6_header_size = 40;
+
+/// The source address of an IPv6 header, in network byte order.
+///
+/// @param header The header, at least ipv6_header_size bytes.
+constexpr std::span<const std::byte, 16> ipv6_source(const std::span<const std::byte> header) noexcept {
+    return header.subspan<8, 16>();
+}
+
+/// The destination address of an IPv6 header, in network byte order.
+///
+/// @param header The header, at least ipv6_header_size bytes.
+constexpr std::span<const std::byte, 16> ipv6_destination(const std::span<const std::byte> header) noexcept {
+    return header.subspan<24, 16>();
+}
+
+/// The source and destination ports of a TCP or UDP header.
+struct transport_ports : bit_field_builder<transport_ports, std::uint32_t> {
+    BIT_FIELD(destination_port, 16);
+    BIT_FIELD(source_port,      16);
+};
+
+/// The sequence number of a TCP header.
+struct tcp_sequence : bit_field_builder<tcp_sequence, std::uint32_t> {
+    BIT_FIELD(number, 32);
+};
+
+/// The acknowledgment number of a TCP header.
+struct tcp_acknowledgment : bit_field_builder<tcp_acknowledgment, std::uint32_t> {
+    BIT_FIELD(number, 32);
+};
+
+/// The data offset, flags, and window of a TCP header.
+struct tcp_control : bit_field_builder<tcp_control, std::uint32_t> {
+    BIT_FIELD(window,      16);
+    BIT_FIELD(fin,          1, bit_field_config<bool>{});
+    BIT_FIELD(syn,          1, bit_field_config<bool>{});
+    BIT_FIELD(rst,          1, bit_field_config<bool>{});
+    BIT_FIELD(psh,          1, bit_field_config<bool>{});
+    BIT_FIELD(ack,          1, bit_field_config<bool>{});
+    BIT_FIELD(urg,          1, bit_field_config<bool>{});
+    BIT_FIELD(ece,          1, bit_field_config<bool>{});
+    BIT_FIELD(cwr,          1, bit_field_config<bool>{});
+    BIT_FIELD(ns,           1, bit_field_config<bool>{});
+    BIT_FIELD(reserved,     3);
+    BIT_FIELD(data_offset,  4);                     ///< The header length in 32-bit words.
+};
+
+/// The checksum and urgent pointer of a TCP header.
+struct tcp_checksum : bit_field_builder<tcp_checksum, std::uint32_t> {
+    BIT_FIELD(urgent_pointer, 16);
+    BIT_FIELD(checksum,       16);
+};
+
+/// The fixed 20 bytes of a TCP header. Options, if tcp_control::data_offset is more than 5, follow.
+using tcp_header = layout_block<
+    block_member<0, transport_ports, std::endian::big>,
+    block_member<4, tcp_sequence, std::endian::big>,
+    block_member<8, tcp_acknowledgment, std::endian::big>,
+    block_member<12, tcp_control, std::endian::big>,
+    block_member<16, tcp_checksum, std::endian::big>>;
+
+/// A TCP header with its options, for walking a packet with a layout_cursor.
+using tcp_segment = segment<std::endian::big, length_from<3, tcp_control::data_offset, 4>, transport_ports,
+                            tcp_sequence, tcp_acknowledgment, tcp_control, tcp_checksum>;
+
+/// The length and checksum of a UDP header.
+struct udp_length : bit_field_builder<udp_length, std::uint32_t> {
+    BIT_FIELD(checksum, 16);
+    BIT_FIELD(length,   16);                        ///< The length of the header and payload in bytes.
+};
+
+/// A UDP header.
+using udp_header = layout_block<
+    block_member<0, transport_ports, std::endian::big>,
+    block_member<4, udp_length, std::endian::big>>;
+
+} // End namespace net.
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // NETWORK_HEADERS_HPP
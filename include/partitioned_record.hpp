@@ -0,0 +1,205 @@
+/// Records whose fields are split by writer across cache lines, to avoid false sharing between concurrent writers.
+#ifndef PARTITIONED_RECORD_HPP
+#define PARTITIONED_RECORD_HPP
+
+#include "config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// The fields of a partitioned_record written by one thread, or one group of threads.
+///
+/// @tparam TFields The fields, such as "layout::name" for fields defined with BIT_FIELD.
+template <typename... TFields>
+struct domain {
+    /// True if the field belongs to this domain.
+    template <typename TField>
+    static constexpr bool contains = (std::is_same_v<TField, TFields> || ...);
+
+    /// The bits of every field of this domain within a value of type T.
+    template <typename T>
+    static constexpr T mask = (T{0} | ... | bit_mask<T, TFields::offset, TFields::bits>);
+};
+
+namespace detail {
+
+template <typename T>
+constexpr bool is_domain = false;
+
+template <typename... TFields>
+constexpr bool is_domain<domain<TFields...>> = true;
+
+} // End namespace detail.
+
+/// A record with one logical layout whose fields are divided among writer domains. Each domain's fields are stored in
+/// their own atomic_layout<TLayout>, at their usual offsets, on their own cache line, so that writers in different
+/// domains never contend for the same line. Fields are read and written by name, as with atomic_layout, and each
+/// access goes to the word of the domain owning the field:
+///
+///     bf::partitioned_record<queue_state, bf::domain<queue_state::head, queue_state::closed>,
+///                            bf::domain<queue_state::tail, queue_state::waiting>> queue;
+///     queue.set<queue_state::head>(head);
+///
+/// snapshot reassembles a TLayout from the fields of every domain. Fields which belong to no domain read as zero.
+///
+/// If the layout has a version field (see BIT_FIELD_VERSION), it belongs to no domain: each domain's word keeps its
+/// own version, incremented by every update of that word, and snapshot uses them to tell when a domain changed and
+/// changed back. The version field of a snapshot is zero. Lock fields are not supported, since there is no single
+/// word for them to lock.
+///
+/// @tparam TLayout  The logical layout, derived from bit_field_builder.
+/// @tparam TDomains The writer domains, each a domain<...> of fields of TLayout. A field may belong to one domain.
+template <bit_field_layout TLayout, typename... TDomains>
+    requires (sizeof...(TDomains) > 0 && (detail::is_domain<TDomains> && ...))
+class partitioned_record {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// The number of writer domains.
+    static constexpr std::size_t domain_count = sizeof...(TDomains);
+
+    /// The bits of the fields of each domain.
+    static constexpr std::array<value_type, domain_count> domain_masks{ TDomains::template mask<value_type>... };
+
+    /// The index of the domain owning a field. The field must belong to exactly one domain.
+    template <typename TField>
+        requires ((TDomains::template contains<TField> + ...) == 1)
+    static constexpr std::size_t domain_index = []() constexpr {
+        std::size_t index = 0;
+        std::size_t i = 0;
+        ((TDomains::template contains<TField> ? (index = i, ++i) : ++i), ...);
+        return index;
+    }();
+
+    /// Whether every operation is lock free on this platform.
+    static constexpr bool is_always_lock_free = atomic_layout<TLayout>::is_always_lock_free;
+
+    static_assert(!atomic_layout<TLayout>::has_lock && !atomic_layout<TLayout>::has_shared_lock,
+                  "A partitioned record has no single word for a lock field to lock.");
+    static_assert([]() constexpr {
+        for (std::size_t i = 0; i < domain_count; ++i) {
+            for (std::size_t j = i + 1; j < domain_count; ++j) {
+                if ((domain_masks[i] & domain_masks[j]) != 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(), "Each field may belong to only one domain.");
+    static_assert([]() constexpr {
+        if constexpr (versioned_layout<TLayout>) {
+            return !(TDomains::template contains<typename TLayout::version_field> || ...);
+        } else {
+            return true;
+        }
+    }(), "The version field is kept separately in every domain's word and cannot belong to a domain.");
+
+    /// Construct with every field zero.
+    constexpr partitioned_record() noexcept = default;
+
+    partitioned_record(const partitioned_record&) = delete;
+    partitioned_record& operator=(const partitioned_record&) = delete;
+
+    /// Atomically load a single field from its domain. See atomic_layout::get.
+    template <typename TField, auto TConfig = bit_field_config{}>
+    auto get(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return slots_[domain_index<TField>].word.template get<TField, TConfig>(order);
+    }
+
+    /// Atomically set one or more fields of the same domain. See atomic_layout::set.
+    ///
+    /// @returns The domain's fields as they were immediately before the update, with every other field zero.
+    template <typename TField, typename... TFields>
+    TLayout set(const auto... values) noexcept requires (sizeof...(values) == 1 + sizeof...(TFields)) {
+        constexpr std::size_t index = domain_index<TField>;
+        static_assert(((domain_index<TFields> == index) && ...), "Fields set together must belong to one domain.");
+        return only(index, slots_[index].word.template set<TField, TFields...>(values...));
+    }
+
+    /// Atomically apply an arbitrary update to the fields of one domain. See atomic_layout::modify. The function is
+    /// called with a TLayout holding the domain's current fields, with every other field zero, and changes it makes to
+    /// fields outside the domain are discarded.
+    ///
+    /// @tparam NDomain The index of the domain, such as domain_index<layout::name> for a field of the domain.
+    ///
+    /// @returns The domain's fields as they were immediately before the update, with every other field zero.
+    template <std::size_t NDomain>
+        requires (NDomain < domain_count)
+    TLayout modify(auto&& fn) noexcept(noexcept(fn(std::declval<TLayout&>()))) {
+        // The other bits of the word are zero, but for the version, which atomic_layout replaces anyway.
+        const TLayout previous = slots_[NDomain].word.modify([&](TLayout& value) {
+            value = only(NDomain, value);
+            if constexpr (std::is_same_v<decltype(fn(value)), bool>) {
+                const bool result = fn(value);
+                value = only(NDomain, value);
+                return result;
+            } else {
+                fn(value);
+                value = only(NDomain, value);
+            }
+        });
+        return only(NDomain, previous);
+    }
+
+    /// Take a consistent snapshot of every field. The domains' words are read repeatedly until two passes in a row
+    /// agree, which means there was an instant between them at which every domain held the returned value. This is
+    /// lock free but not wait free: a reader can be held off indefinitely by writers which never pause.
+    ///
+    /// If a domain's value can change and then change back between two passes, the passes may agree on a state which
+    /// never existed as a whole. Giving the layout a version field (see BIT_FIELD_VERSION) rules this out.
+    ///
+    /// @returns The fields of every domain, as one layout.
+    TLayout snapshot() const noexcept {
+        constexpr auto indices = std::make_index_sequence<domain_count>{};
+        std::array<value_type, domain_count> previous = collect(indices);
+        if constexpr (domain_count > 1) {
+            for (std::array<value_type, domain_count> current = collect(indices); current != previous;
+                 current = collect(indices)) {
+                previous = current;
+            }
+        }
+        return merge(previous, indices);
+    }
+
+private:
+    /// One domain's word, alone on its cache line.
+    struct alignas(BIT_FIELD_CACHE_LINE_SIZE) slot {
+        atomic_layout<TLayout> word;
+    };
+
+    /// Keep only the fields of one domain.
+    static constexpr TLayout only(const std::size_t index, TLayout layout) noexcept {
+        layout.raw_value = static_cast<value_type>(layout.raw_value & domain_masks[index]);
+        return layout;
+    }
+
+    template <std::size_t... NIndices>
+    std::array<value_type, domain_count> collect(std::index_sequence<NIndices...>) const noexcept {
+        return { slots_[NIndices].word.load(std::memory_order_acquire).raw_value... };
+    }
+
+    /// Combine the fields of every domain's word into one layout.
+    template <std::size_t... NIndices>
+    static constexpr TLayout merge(const std::array<value_type, domain_count>& words,
+                                   std::index_sequence<NIndices...>) noexcept {
+        TLayout result{};
+        result.raw_value = static_cast<value_type>((value_type{0} | ... | (words[NIndices] & domain_masks[NIndices])));
+        return result;
+    }
+
+    std::array<slot, domain_count> slots_{};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // PARTITIONED_RECORD_HPP
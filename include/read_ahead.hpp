@@ -0,0 +1,210 @@
+/// Scanning files of layout records with reads running ahead of the computation.
+#ifndef READ_AHEAD_HPP
+#define READ_AHEAD_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/types.h>
+#  include <unistd.h>
+#endif
+
+#include "bit_field_builder.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Options for scan_records.
+struct read_ahead_options {
+    /// The number of bytes read at once, and handed to the scan function at once. Rounded up to a multiple of the
+    /// alignment.
+    std::size_t chunk_size = std::size_t{1} << 20;
+
+    /// The number of chunk buffers. While the scan function works on one, the rest are being filled.
+    std::size_t depth = 3;
+
+    /// The number of threads reading chunks. More than one keeps several reads in flight at once, which helps devices
+    /// such as NVMe drives which serve requests in parallel.
+    std::size_t readers = 1;
+
+    /// The alignment of the buffers, of the chunk size, and of every read offset, as required by O_DIRECT. Must be a
+    /// power of two.
+    std::size_t alignment = 4096;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+/// A source for scan_records reading from a file descriptor with pread, which may be opened with O_DIRECT.
+struct pread_source {
+    int descriptor;
+
+    /// The offset in the file of the first record.
+    std::uint64_t base{0};
+
+    std::ptrdiff_t operator()(const std::span<std::byte> buffer, const std::uint64_t offset) const noexcept {
+        return ::pread(descriptor, buffer.data(), buffer.size(), static_cast<off_t>(base + offset));
+    }
+};
+#endif
+
+/// Scan a file of records, such as one written by copying an array of layouts, reading ahead of the scan. Reader
+/// threads fill a ring of aligned chunk buffers while the calling thread hands each filled chunk to a bulk operation,
+/// so reading and computing overlap instead of taking turns as with a loop of read calls.
+///
+/// @tparam TLayout The layout of the records, which are stored as their raw values in native byte order.
+///
+/// @param source  Reads the bytes of the file. Called as source(buffer, offset) with a std::span<std::byte> and a
+///                std::uint64_t byte offset, possibly from several reader threads at once, and returns the number of
+///                bytes read, zero at the end of the file, or a negative number on error, like pread. See pread_source.
+/// @param fn      Called on the calling thread with a std::span<const TLayout> of each chunk's records, in order. If
+///                it returns bool, returning false stops the scan.
+/// @param options The chunk size, read-ahead depth, and number of readers.
+///
+/// If fn throws, the readers are stopped and joined before the exception propagates.
+///
+/// @returns The number of records scanned, or an empty optional if the source returned an error or the alignment is
+///          not a power of two. Bytes after the last whole record are ignored.
+template <bit_field_layout TLayout>
+std::optional<std::uint64_t> scan_records(auto&& source, auto&& fn, const read_ahead_options options = {}) {
+    static_assert(sizeof(TLayout) == sizeof(typename TLayout::value_type) && std::is_trivially_copyable_v<TLayout>,
+                  "Records must be stored as their raw values.");
+
+    const std::size_t alignment = std::max<std::size_t>(options.alignment, alignof(TLayout));
+    if (!std::has_single_bit(alignment)) {
+        return std::nullopt;
+    }
+    const std::size_t chunk_size =
+        std::max<std::size_t>((options.chunk_size + alignment - 1) / alignment * alignment, alignment);
+    const std::size_t depth = std::max<std::size_t>(options.depth, 1);
+    const std::size_t readers = std::clamp<std::size_t>(options.readers, 1, depth);
+
+    struct buffer_deleter {
+        std::align_val_t alignment;
+        void operator()(std::byte* const buffer) const noexcept {
+            ::operator delete[](buffer, alignment);
+        }
+    };
+    const std::unique_ptr<std::byte[], buffer_deleter> buffers{
+        static_cast<std::byte*>(::operator new[](chunk_size * depth, std::align_val_t{ alignment })),
+        buffer_deleter{ std::align_val_t{ alignment } }
+    };
+
+    // Chunk i goes in slot i % depth on lap i / depth. A slot's state is 2 * lap while it waits to be filled on that
+    // lap, and 2 * lap + 1 once filled. The scan sets every state to closed to release the readers when it stops.
+    constexpr std::uint64_t closed = ~std::uint64_t{0};
+    constexpr std::size_t failed = ~std::size_t{0};
+    struct slot {
+        alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> state{0};
+        std::size_t size{0};
+    };
+    std::vector<slot> slots(depth);
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<bool> finished{false};
+
+    const auto wait_for = [&](std::atomic<std::uint64_t>& state, const std::uint64_t target) {
+        for (std::uint64_t value = state.load(std::memory_order_acquire); value != target;
+             value = state.load(std::memory_order_acquire)) {
+            if (value == closed) {
+                return false;
+            }
+            state.wait(value, std::memory_order_acquire);
+        }
+        return true;
+    };
+
+    const auto read_chunks = [&] {
+        while (!finished.load(std::memory_order_relaxed)) {
+            const std::uint64_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            slot& target = slots[chunk % depth];
+            if (!wait_for(target.state, 2 * (chunk / depth))) {
+                return;
+            }
+            const std::span<std::byte> buffer{ buffers.get() + chunk % depth * chunk_size, chunk_size };
+            std::size_t filled = 0;
+            while (filled < chunk_size) {
+                const std::ptrdiff_t result = source(buffer.subspan(filled), chunk * chunk_size + filled);
+                if (result <= 0) {
+                    filled = result < 0 ? failed : filled;
+                    break;
+                }
+                filled += static_cast<std::size_t>(result);
+            }
+            if (filled != chunk_size) {
+                // Nothing after a short chunk needs reading.
+                finished.store(true, std::memory_order_relaxed);
+            }
+            target.size = filled;
+            // Publish the chunk, unless the scan has stopped and closed the slot in the meantime.
+            std::uint64_t expected = 2 * (chunk / depth);
+            target.state.compare_exchange_strong(expected, expected + 1, std::memory_order_release,
+                                                 std::memory_order_relaxed);
+            target.state.notify_all();
+        }
+    };
+
+    // However the scan ends, including by an exception from fn or from starting a thread, release the readers and
+    // join them, since destroying a std::thread which is still joinable terminates the program.
+    std::vector<std::thread> threads;
+    struct stop_readers {
+        std::atomic<bool>& finished;
+        std::vector<slot>& slots;
+        std::vector<std::thread>& threads;
+
+        ~stop_readers() {
+            finished.store(true, std::memory_order_relaxed);
+            for (slot& each : slots) {
+                each.state.store(closed, std::memory_order_release);
+                each.state.notify_all();
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+    } const stop{ finished, slots, threads };
+    threads.reserve(readers);
+    for (std::size_t i = 0; i < readers; ++i) {
+        threads.emplace_back(read_chunks);
+    }
+
+    std::optional<std::uint64_t> scanned{ 0 };
+    for (std::uint64_t chunk = 0;; ++chunk) {
+        slot& current = slots[chunk % depth];
+        wait_for(current.state, 2 * (chunk / depth) + 1);
+        const std::size_t size = current.size;
+        if (size == failed) {
+            scanned.reset();
+            break;
+        }
+        const std::span<const TLayout> records{
+            std::launder(reinterpret_cast<const TLayout*>(buffers.get() + chunk % depth * chunk_size)),
+            size / sizeof(TLayout)
+        };
+        *scanned += records.size();
+        bool proceed = size == chunk_size;
+        if constexpr (std::is_same_v<decltype(fn(records)), bool>) {
+            proceed = fn(records) && proceed;
+        } else {
+            fn(records);
+        }
+        if (!proceed) {
+            break;
+        }
+        current.state.store(2 * (chunk / depth + 1), std::memory_order_release);
+        current.state.notify_all();
+    }
+    return scanned;
+}
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // READ_AHEAD_HPP
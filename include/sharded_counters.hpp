@@ -0,0 +1,218 @@
+/// Packed statistics counters sharded per thread, updated without atomic read-modify-writes and summed on read.
+#ifndef SHARDED_COUNTERS_HPP
+#define SHARDED_COUNTERS_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "bit_field.hpp"
+#include "bit_field_builder.hpp"
+#include "bits.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+namespace detail {
+
+/// Hands out small integers identifying threads. A thread's index is returned to the pool when the thread exits, and
+/// the smallest free index is always handed out first, so that a program's live threads keep to the lowest indexes.
+class thread_index_pool {
+public:
+    std::size_t acquire() {
+        const std::lock_guard<std::mutex> lock{ mutex_ };
+        if (free_.empty()) {
+            return next_++;
+        }
+        const auto smallest = std::min_element(free_.begin(), free_.end());
+        const std::size_t index = *smallest;
+        free_.erase(smallest);
+        return index;
+    }
+
+    void release(const std::size_t index) {
+        const std::lock_guard<std::mutex> lock{ mutex_ };
+        free_.push_back(index);
+    }
+
+    static thread_index_pool& instance() {
+        static thread_index_pool pool;
+        return pool;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::size_t> free_;
+    std::size_t next_{0};
+};
+
+/// Holds the calling thread's index for as long as the thread runs.
+struct thread_index_holder {
+    thread_index_holder() : pool(thread_index_pool::instance()), index(pool.acquire()) {
+    }
+
+    ~thread_index_holder() {
+        pool.release(index);
+    }
+
+    thread_index_holder(const thread_index_holder&) = delete;
+    thread_index_holder& operator=(const thread_index_holder&) = delete;
+
+    thread_index_pool& pool;
+    const std::size_t index;
+};
+
+/// A small integer identifying the calling thread. No two running threads have the same index.
+inline std::size_t thread_index() {
+    thread_local const thread_index_holder holder;
+    return holder.index;
+}
+
+} // End namespace detail.
+
+/// A bit_field_builder layout of counters, such as a subsystem's statistics, with a private copy (a shard) for each of
+/// NShards threads and one shared shard for any others. Each shard is on its own cache line. Threads are given small
+/// indexes which are reused when they exit, and a thread whose index is below NShards uses that shard.
+///
+/// A thread with its own shard adds to a field with a plain load, add, and store; no atomic read-modify-write is
+/// needed because nothing else writes that shard. Each field in a shard is kept below 2^(bits - headroom_bits), and
+/// when an add would reach that limit the field's value is moved into a 64-bit accumulator for the field instead. This
+/// leaves enough headroom in every field that the words of all of the shards can be summed with ordinary integer adds,
+/// which add every field at once without any carry crossing into the next field (a SWAR add.) A read is then one add
+/// per shard for the whole layout, plus the accumulators of the fields being read.
+///
+/// Reads taken while other threads are adding are approximate: an add which is moving a field into its accumulator
+/// may be missed or counted twice. Once the writers are quiet, reads are exact.
+///
+/// @tparam TLayout The layout. Its storage must be an unsigned integer of at most 64 bits.
+/// @tparam NShards The number of threads which get a shard of their own.
+template <bit_field_layout TLayout, std::size_t NShards = 16>
+    requires (NShards > 0 && std::is_unsigned_v<typename TLayout::value_type> &&
+              sizeof(typename TLayout::value_type) <= sizeof(std::uint64_t))
+class sharded_counters {
+public:
+    using layout_type = TLayout;
+    using value_type = typename TLayout::value_type;
+
+    /// The number of shards, including the one shared by threads without a shard of their own.
+    static constexpr std::size_t shard_count = NShards + 1;
+
+    /// The number of high bits of each field kept clear in every shard so that the shards can be summed.
+    static constexpr unsigned headroom_bits = static_cast<unsigned>(std::bit_width(shard_count - 1));
+
+    constexpr sharded_counters() noexcept = default;
+
+    sharded_counters(const sharded_counters&) = delete;
+    sharded_counters& operator=(const sharded_counters&) = delete;
+
+    /// Add to a field in the calling thread's shard.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param amount The amount to add.
+    template <typename TField>
+    void add(const std::uint64_t amount = 1) {
+        add_at<TField>(detail::thread_index(), amount);
+    }
+
+    /// Add to a field in a particular shard, for callers which already have a small, unique worker index.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param worker The index of the calling worker. Workers from 0 to NShards - 1 must each be used by only one
+    ///               thread at a time. Larger indexes use the shared shard.
+    /// @param amount The amount to add.
+    template <typename TField>
+    void add_at(const std::size_t worker, const std::uint64_t amount = 1) noexcept {
+        static_assert(TField::bits > headroom_bits, "The field is too narrow to sum this many shards.");
+        constexpr std::uint64_t limit = std::uint64_t{1} << (TField::bits - headroom_bits);
+
+        if (worker < NShards) {
+            shard& owned = shards_[worker];
+            value_type word = owned.word.load(std::memory_order_relaxed);
+            std::uint64_t sum = TField::template get<count_config>(word) + amount;
+            if (sum >= limit) {
+                std::atomic<std::uint64_t>& overflow = owned.accumulators[TField::offset];
+                overflow.store(overflow.load(std::memory_order_relaxed) + sum, std::memory_order_relaxed);
+                sum = 0;
+            }
+            TField::template set<store_config>(word, static_cast<value_type>(sum));
+            owned.word.store(word, std::memory_order_relaxed);
+        } else {
+            shard& shared = shards_[NShards];
+            value_type word = shared.word.load(std::memory_order_relaxed);
+            value_type desired{};
+            std::uint64_t sum = 0;
+            do {
+                desired = word;
+                sum = TField::template get<count_config>(word) + amount;
+                TField::template set<store_config>(desired, static_cast<value_type>(sum >= limit ? 0 : sum));
+            } while (!shared.word.compare_exchange_weak(word, desired, std::memory_order_relaxed));
+            if (sum >= limit) {
+                shared.accumulators[TField::offset].fetch_add(sum, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Read the total of one field across every shard.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @returns The total.
+    template <typename TField>
+    std::uint64_t read() const noexcept {
+        return read_all<TField>()[0];
+    }
+
+    /// Read the totals of several fields across every shard, summing the shards' words only once.
+    ///
+    /// @tparam TFields The fields.
+    ///
+    /// @returns The total of each field, in the same order as TFields.
+    template <typename... TFields>
+        requires (sizeof...(TFields) > 0)
+    std::array<std::uint64_t, sizeof...(TFields)> read_all() const noexcept {
+        static_assert(((TFields::bits > headroom_bits) && ...), "A field is too narrow to sum this many shards.");
+        std::uint64_t words = 0;
+        for (const shard& each : shards_) {
+            words += each.word.load(std::memory_order_relaxed);
+        }
+        std::array<std::uint64_t, sizeof...(TFields)> totals{
+            TFields::template get<count_config>(static_cast<value_type>(words))...
+        };
+        std::size_t i = 0;
+        ((totals[i++] += accumulated(TFields::offset)), ...);
+        return totals;
+    }
+
+private:
+    static constexpr auto count_config = bit_field_config<std::uint64_t>{};
+    static constexpr auto store_config = bit_field_config{ .strategy = bit_field_assignment_strategy::unchecked };
+
+    /// One thread's copy of the layout, and an accumulator for each bit offset at which a field may start.
+    struct alignas(BIT_FIELD_CACHE_LINE_SIZE) shard {
+        std::atomic<value_type> word{0};
+        std::array<std::atomic<std::uint64_t>, bits<value_type>> accumulators{};
+    };
+
+    std::uint64_t accumulated(const std::size_t offset) const noexcept {
+        std::uint64_t total = 0;
+        for (const shard& each : shards_) {
+            total += each.accumulators[offset].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::array<shard, shard_count> shards_{};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // SHARDED_COUNTERS_HPP
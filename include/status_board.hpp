@@ -0,0 +1,267 @@
+/// Tables of atomic layout records placed in memory shared between processes.
+#ifndef STATUS_BOARD_HPP
+#define STATUS_BOARD_HPP
+
+#include "config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define BIT_FIELD_HAS_POSIX_SHARED_MEMORY 1
+#else
+#  define BIT_FIELD_HAS_POSIX_SHARED_MEMORY 0
+#endif
+
+#include "atomic_layout.hpp"
+#include "bit_field_builder.hpp"
+#include "layout_diff.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// Why a block of memory could not be attached as a status_board.
+enum class status_board_error {
+    none,            ///< The board is valid.
+    too_small,       ///< The memory is too small for the header, or for the records the header describes.
+    not_initialized, ///< No board has been created in the memory yet.
+    layout_mismatch, ///< The board was created for a different layout, record count, or cache line size.
+};
+
+/// A table of atomic layout records, one per worker for example, in a block of memory which may be shared between
+/// processes, such as a mapping from shared_memory. Readers in other processes see each record change with ordinary
+/// atomic loads instead of polling each worker over a socket.
+///
+/// The memory starts with a header holding a magic number, the layout_hash of the layout, the number of records, and
+/// the distance between records, followed by the records. Records are found by their offset from the start of the
+/// memory, so the memory may be mapped at a different address in every process. Each record is an atomic_layout on its
+/// own cache line, so workers updating their own records do not slow each other down, and updates are lock free.
+///
+/// The board itself is only a view of the memory, and may be copied freely.
+///
+/// @tparam TLayout The layout of a record. Its atomic_layout must be lock free, since a lock could not be shared
+///                 between processes.
+/// @tparam NTag    Mixed into the layout hash. See layout_hash.
+template <bit_field_layout TLayout, std::uint64_t NTag = 0>
+class status_board {
+public:
+    using record_type = atomic_layout<TLayout>;
+
+    static_assert(record_type::is_always_lock_free, "Shared records must be lock free.");
+
+    /// The hash stored in the header, which attaching processes must match.
+    static constexpr std::uint64_t hash = layout_hash<TLayout, NTag>;
+
+    /// The distance in bytes between consecutive records, and the size of the header.
+    static constexpr std::size_t stride = (sizeof(record_type) + BIT_FIELD_CACHE_LINE_SIZE - 1) /
+                                          BIT_FIELD_CACHE_LINE_SIZE * BIT_FIELD_CACHE_LINE_SIZE;
+
+    /// The number of bytes of memory needed for a board with a number of records.
+    static constexpr std::size_t bytes_for(const std::size_t records) noexcept {
+        return header_size + records * stride;
+    }
+
+    /// Create a board in a block of memory, with every record zero. No other process may use the memory until this
+    /// returns, after which they may attach to it.
+    ///
+    /// @param memory  The memory. Must be aligned to BIT_FIELD_CACHE_LINE_SIZE, as memory from mmap is.
+    /// @param records The number of records.
+    ///
+    /// @returns The board, or an empty optional if the memory is too small.
+    static std::optional<status_board> create(const std::span<std::byte> memory, const std::size_t records) noexcept {
+        if (!fits(memory, records)) {
+            return std::nullopt;
+        }
+        header* const head = ::new (memory.data()) header{};
+        head->layout_hash = hash;
+        head->record_count = records;
+        head->record_stride = stride;
+        for (std::size_t i = 0; i < records; ++i) {
+            ::new (memory.data() + header_size + i * stride) record_type{};
+        }
+        head->magic.store(magic, std::memory_order_release);
+        return status_board{ memory.data(), records };
+    }
+
+    /// Check whether a block of memory holds a board created for this layout.
+    ///
+    /// @param memory The memory.
+    ///
+    /// @returns Why the memory cannot be attached, or status_board_error::none if it can.
+    static status_board_error check(const std::span<std::byte> memory) noexcept {
+        if (memory.size() < header_size) {
+            return status_board_error::too_small;
+        }
+        const header* const head = std::launder(reinterpret_cast<const header*>(memory.data()));
+        if (head->magic.load(std::memory_order_acquire) != magic) {
+            return status_board_error::not_initialized;
+        }
+        if (head->layout_hash != hash || head->record_stride != stride) {
+            return status_board_error::layout_mismatch;
+        }
+        // The count comes from shared memory, so it is compared without computing bytes_for, which could overflow.
+        if (!fits(memory, head->record_count)) {
+            return status_board_error::too_small;
+        }
+        return status_board_error::none;
+    }
+
+    /// Attach to a board created in a block of memory, possibly by another process.
+    ///
+    /// @param memory The memory.
+    ///
+    /// @returns The board, or an empty optional if check reports an error.
+    static std::optional<status_board> attach(const std::span<std::byte> memory) noexcept {
+        if (check(memory) != status_board_error::none) {
+            return std::nullopt;
+        }
+        const header* const head = std::launder(reinterpret_cast<const header*>(memory.data()));
+        return status_board{ memory.data(), static_cast<std::size_t>(head->record_count) };
+    }
+
+    /// The number of records.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Access a record, to get, set, or modify its fields atomically.
+    ///
+    /// @param index The index of the record. Not bounds checked.
+    record_type& operator[](const std::size_t index) const noexcept {
+        return *std::launder(reinterpret_cast<record_type*>(base_ + header_size + index * stride));
+    }
+
+    /// Load every record. Each record is loaded atomically, but records may change while the others are loaded.
+    ///
+    /// @param output Receives the records. Must be at least size() records long.
+    void snapshot(const std::span<TLayout> output,
+                  const std::memory_order order = std::memory_order_acquire) const noexcept {
+        for (std::size_t i = 0; i < size_; ++i) {
+            output[i] = (*this)[i].load(order);
+        }
+    }
+
+private:
+    static constexpr std::uint64_t magic = 0x4246'5354'4154'5553u;
+
+    struct header {
+        std::atomic<std::uint64_t> magic{0};
+        std::uint64_t layout_hash{0};
+        std::uint64_t record_count{0};
+        std::uint64_t record_stride{0};
+    };
+
+    static constexpr std::size_t header_size = (sizeof(header) + stride - 1) / stride * stride;
+
+    /// Returns true if a block of memory has room for a number of records.
+    static constexpr bool fits(const std::span<std::byte> memory, const std::uint64_t records) noexcept {
+        return memory.size() >= header_size && records <= (memory.size() - header_size) / stride;
+    }
+
+    status_board(std::byte* const base, const std::size_t size) noexcept
+        : base_(base), size_(size) {
+    }
+
+    std::byte* base_;
+    std::size_t size_;
+};
+
+#if BIT_FIELD_HAS_POSIX_SHARED_MEMORY
+/// A named POSIX shared memory object (shm_open) mapped into this process (mmap), for holding a status_board. The
+/// mapping is removed when this is destroyed, but the object itself lasts until unlink is called.
+class shared_memory {
+public:
+    /// Create a shared memory object, or open it if it already exists, and make it at least a given size.
+    ///
+    /// @param name  The name, such as "/workers". See shm_open.
+    /// @param bytes The size.
+    ///
+    /// @returns The mapping, or an empty optional if any system call failed.
+    static std::optional<shared_memory> create(const char* const name, const std::size_t bytes) noexcept {
+        const int descriptor = ::shm_open(name, O_CREAT | O_RDWR, 0600);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        struct stat status{};
+        const bool grow = ::fstat(descriptor, &status) == 0 && static_cast<std::size_t>(status.st_size) < bytes;
+        if ((grow && ::ftruncate(descriptor, static_cast<off_t>(bytes)) != 0) || (!grow && status.st_size <= 0)) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        return map(descriptor, bytes);
+    }
+
+    /// Open an existing shared memory object, mapping all of it.
+    ///
+    /// @param name The name.
+    ///
+    /// @returns The mapping, or an empty optional if the object does not exist or any system call failed.
+    static std::optional<shared_memory> open(const char* const name) noexcept {
+        const int descriptor = ::shm_open(name, O_RDWR, 0600);
+        if (descriptor < 0) {
+            return std::nullopt;
+        }
+        struct stat status{};
+        if (::fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        return map(descriptor, static_cast<std::size_t>(status.st_size));
+    }
+
+    /// Remove a shared memory object's name. Existing mappings stay valid.
+    ///
+    /// @returns True on success.
+    static bool unlink(const char* const name) noexcept {
+        return ::shm_unlink(name) == 0;
+    }
+
+    shared_memory(shared_memory&& other) noexcept
+        : memory_(std::exchange(other.memory_, {})) {
+    }
+
+    shared_memory& operator=(shared_memory&& other) noexcept {
+        std::swap(memory_, other.memory_);
+        return *this;
+    }
+
+    ~shared_memory() {
+        if (!memory_.empty()) {
+            ::munmap(memory_.data(), memory_.size());
+        }
+    }
+
+    /// The mapped memory.
+    std::span<std::byte> bytes() const noexcept {
+        return memory_;
+    }
+
+private:
+    explicit shared_memory(const std::span<std::byte> memory) noexcept
+        : memory_(memory) {
+    }
+
+    static std::optional<shared_memory> map(const int descriptor, const std::size_t bytes) noexcept {
+        void* const address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (address == MAP_FAILED) {
+            return std::nullopt;
+        }
+        return shared_memory{ std::span<std::byte>{ static_cast<std::byte*>(address), bytes } };
+    }
+
+    std::span<std::byte> memory_;
+};
+#endif
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // STATUS_BOARD_HPP
@@ -0,0 +1,284 @@
+/// Binary event tracing into per-thread ring buffers, with event headers described by bit field layouts.
+#ifndef TRACE_BUFFER_HPP
+#define TRACE_BUFFER_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "bit_field_builder.hpp"
+#include "byte_order.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A layout usable as the header of trace events. It names three of its fields with member aliases: delta_field, the
+/// time since the previous event, type_field, the event type, and length_field, the number of payload bytes following
+/// the header.
+template <typename T>
+concept trace_header_layout = bit_field_layout<T> && std::unsigned_integral<typename T::value_type> && requires {
+    typename T::delta_field;
+    typename T::type_field;
+    typename T::length_field;
+};
+
+/// One decoded trace event.
+struct trace_event {
+    /// The absolute time of the event, in whatever unit the timestamps given to trace_buffer::record were.
+    std::uint64_t timestamp;
+
+    /// The event type.
+    unsigned type;
+
+    /// The payload bytes. Points into the decoded dump.
+    std::span<const std::byte> payload;
+};
+
+namespace detail {
+
+/// Properties of trace events shared by the buffer and the decoder.
+template <trace_header_layout THeader>
+struct trace_format {
+    using value_type = typename THeader::value_type;
+    using delta_field = typename THeader::delta_field;
+    using type_field = typename THeader::type_field;
+    using length_field = typename THeader::length_field;
+
+    static constexpr std::size_t header_size = sizeof(value_type);
+
+    static constexpr std::uint64_t max_delta = (std::uint64_t{1} << delta_field::bits) - 1;
+    static constexpr std::size_t max_payload = (std::size_t{1} << length_field::bits) - 1;
+
+    /// The largest event type, which is reserved for rebase events. A rebase event's payload is the absolute timestamp
+    /// as eight little-endian bytes, and later deltas are relative to it.
+    static constexpr unsigned rebase_type = (1u << type_field::bits) - 1;
+
+    static_assert(delta_field::bits < 64 && type_field::bits < 32, "Trace header fields are too wide.");
+    static_assert(max_payload >= 8, "The length field must hold the eight byte payload of a rebase event.");
+
+    static constexpr auto get_config = bit_field_config<std::uint64_t>{};
+    static constexpr auto set_config = bit_field_config{ .strategy = bit_field_assignment_strategy::unchecked };
+
+    /// Build an event header. The fields are combined in a register, so writing the header is a single store.
+    static constexpr THeader make_header(const std::uint64_t delta, const unsigned type,
+                                         const std::size_t length) noexcept {
+        THeader header{};
+        delta_field::template set<set_config>(header.raw_value, static_cast<value_type>(delta));
+        type_field::template set<set_config>(header.raw_value, static_cast<value_type>(type));
+        length_field::template set<set_config>(header.raw_value, static_cast<value_type>(length));
+        return header;
+    }
+};
+
+} // End namespace detail.
+
+/// A ring buffer of binary trace events, written by one thread and drained by one other thread at a time, such as a
+/// thread_local buffer per traced thread and a collector which periodically writes the drained bytes to a file.
+///
+/// Each event is a THeader layout stored little-endian, followed by its payload bytes. The header is built in a
+/// register and written with one store, so recording an event costs a few instructions instead of formatting text.
+/// The delta field holds the time since the previous event; when a delta does not fit, or the first time, or after
+/// events were dropped, a rebase event holding the full timestamp is recorded first. When the buffer is full, events
+/// are dropped and counted rather than overwriting events the collector has not drained.
+///
+/// @tparam THeader   The header layout. See trace_header_layout.
+/// @tparam NCapacity The size of the ring in bytes. Must be a power of two.
+template <trace_header_layout THeader, std::size_t NCapacity = 65536>
+class trace_buffer {
+    using format = detail::trace_format<THeader>;
+
+public:
+    static constexpr std::size_t capacity = NCapacity;
+    static constexpr std::size_t header_size = format::header_size;
+    static constexpr std::size_t max_payload = format::max_payload;
+    static constexpr unsigned rebase_type = format::rebase_type;
+
+    static_assert(std::has_single_bit(capacity), "The capacity must be a power of two.");
+    static_assert(capacity >= 2 * (header_size + max_payload), "The capacity must hold at least two events.");
+
+    /// Record an event.
+    ///
+    /// @param timestamp The time of the event. Should not decrease from one event to the next; if it does, a rebase
+    ///                  event is recorded.
+    /// @param type      The event type. Must be less than rebase_type.
+    /// @param payload   The payload. Must be at most max_payload bytes.
+    ///
+    /// @returns True if the event was recorded, or false if the buffer was full and it was dropped, or if the type or
+    ///          the payload size does not fit the header, in which case nothing is recorded and nothing is counted.
+    bool record(const std::uint64_t timestamp, const unsigned type,
+                const std::span<const std::byte> payload = {}) noexcept {
+        // The header is built with the unchecked strategy, and write stages an event of at most max_payload bytes.
+        if (type >= rebase_type || payload.size() > max_payload) {
+            return false;
+        }
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        std::uint64_t delta = timestamp - last_timestamp_;
+        const bool rebase = rebase_needed_ || delta > format::max_delta;
+        const std::size_t size = header_size + payload.size() + (rebase ? header_size + 8 : 0);
+        if (head + size - cached_tail_ > capacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head + size - cached_tail_ > capacity) {
+                ++dropped_;
+                rebase_needed_ = true;
+                return false;
+            }
+        }
+
+        std::uint64_t position = head;
+        if (rebase) {
+            std::byte timestamp_bytes[8];
+            store_bytes<std::endian::little>(timestamp_bytes, timestamp);
+            position = write(position, format::make_header(0, rebase_type, 8), timestamp_bytes);
+            rebase_needed_ = false;
+            delta = 0;
+        }
+        last_timestamp_ = timestamp;
+        position = write(position, format::make_header(delta, type, payload.size()), payload);
+        head_.store(position, std::memory_order_release);
+        return true;
+    }
+
+    /// Copy recorded events out of the buffer, oldest first, freeing their space. Only whole events are copied.
+    ///
+    /// @param output Receives the events, in the format trace_decoder reads.
+    ///
+    /// @returns The number of bytes copied.
+    std::size_t drain(const std::span<std::byte> output) noexcept {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t end = tail;
+        if (head - tail <= output.size()) {
+            end = head;
+        } else {
+            // Stop at the last event boundary which fits.
+            while (end != head) {
+                std::byte bytes[header_size];
+                read(end, bytes);
+                const std::uint64_t size = header_size + format::length_field::template get<format::get_config>(
+                    load_layout<THeader, std::endian::little>(bytes).raw_value);
+                if (end + size - tail > output.size()) {
+                    break;
+                }
+                end += size;
+            }
+        }
+        read(tail, output.first(static_cast<std::size_t>(end - tail)));
+        tail_.store(end, std::memory_order_release);
+        return static_cast<std::size_t>(end - tail);
+    }
+
+    /// The number of bytes recorded but not drained yet.
+    std::size_t size() const noexcept {
+        return static_cast<std::size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+    }
+
+    /// The number of events dropped because the buffer was full. Only the recording thread may call this.
+    std::uint64_t dropped() const noexcept {
+        return dropped_;
+    }
+
+private:
+    static constexpr std::size_t index_mask = capacity - 1;
+
+    /// Write a header and a payload at a position, wrapping around the end of the ring.
+    ///
+    /// @returns The position after the event.
+    std::uint64_t write(const std::uint64_t position, const THeader header,
+                        const std::span<const std::byte> payload) noexcept {
+        const std::size_t index = static_cast<std::size_t>(position) & index_mask;
+        const std::size_t size = header_size + payload.size();
+        if (index + size <= capacity) {
+            store_layout<std::endian::little>(ring_ + index, header);
+            if (!payload.empty()) {
+                std::memcpy(ring_ + index + header_size, payload.data(), payload.size());
+            }
+        } else {
+            std::byte event[header_size + max_payload];
+            store_layout<std::endian::little>(event, header);
+            if (!payload.empty()) {
+                std::memcpy(event + header_size, payload.data(), payload.size());
+            }
+            const std::size_t first = capacity - index;
+            std::memcpy(ring_ + index, event, first);
+            std::memcpy(ring_, event + first, size - first);
+        }
+        return position + size;
+    }
+
+    /// Copy bytes out of the ring from a position, wrapping around the end of the ring.
+    void read(const std::uint64_t position, const std::span<std::byte> output) const noexcept {
+        const std::size_t index = static_cast<std::size_t>(position) & index_mask;
+        const std::size_t first = std::min(output.size(), capacity - index);
+        std::memcpy(output.data(), ring_ + index, first);
+        std::memcpy(output.data() + first, ring_, output.size() - first);
+    }
+
+    // Written by the recording thread.
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+    std::uint64_t cached_tail_{0};
+    std::uint64_t last_timestamp_{0};
+    std::uint64_t dropped_{0};
+    bool rebase_needed_{true};
+
+    // Written by the draining thread.
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail_{0};
+
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::byte ring_[capacity];
+};
+
+/// Decodes the bytes drained from a trace_buffer, using the same header layout. Dumps drained one after another from
+/// the same buffer must be decoded in order by the same decoder, since deltas continue from one dump to the next.
+///
+/// @tparam THeader The header layout the events were recorded with.
+template <trace_header_layout THeader>
+class trace_decoder {
+    using format = detail::trace_format<THeader>;
+
+public:
+    /// Decode events.
+    ///
+    /// @param dump The bytes drained from a trace_buffer.
+    /// @param fn   Called with each trace_event, in order. Rebase events are consumed and not passed on.
+    ///
+    /// @returns The number of bytes decoded. Less than the size of the dump if it ends with a partial event.
+    constexpr std::size_t decode(const std::span<const std::byte> dump, auto&& fn) {
+        std::size_t position = 0;
+        while (dump.size() - position >= format::header_size) {
+            const THeader header = load_layout<THeader, std::endian::little>(dump.data() + position);
+            const auto raw = header.raw_value;
+            const auto length = static_cast<std::size_t>(
+                format::length_field::template get<format::get_config>(raw));
+            if (dump.size() - position - format::header_size < length) {
+                break;
+            }
+            const std::span<const std::byte> payload = dump.subspan(position + format::header_size, length);
+            const auto type = static_cast<unsigned>(format::type_field::template get<format::get_config>(raw));
+            position += format::header_size + length;
+            if (type == format::rebase_type && length == 8) {
+                timestamp_ = load_bytes<std::uint64_t, std::endian::little>(payload.data());
+                continue;
+            }
+            timestamp_ += format::delta_field::template get<format::get_config>(raw);
+            fn(trace_event{ .timestamp = timestamp_, .type = type, .payload = payload });
+        }
+        return position;
+    }
+
+    /// The timestamp of the last decoded event.
+    constexpr std::uint64_t timestamp() const noexcept {
+        return timestamp_;
+    }
+
+private:
+    std::uint64_t timestamp_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // TRACE_BUFFER_HPP
@@ -0,0 +1,286 @@
+/// Per-block field statistics over arrays of layout records, for skipping blocks which cannot match a scan.
+#ifndef ZONE_MAP_HPP
+#define ZONE_MAP_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bit_field_builder.hpp"
+#include "layout_diff.hpp"
+
+namespace BIT_FIELD_NAMESPACE {
+
+/// A zone map over an array of layout records: for every block of NBlock records, the smallest and largest value of
+/// each field, and for fields of 8 bits or fewer, the set of values present, which for a 2-bit field is just 4 bits.
+/// Scans consult the map first and skip every block whose statistics rule out a match, so a search for a rare value
+/// only reads the few blocks which might hold it.
+///
+/// Field values are the raw bits of each field, zero-extended to 64 bits and compared as unsigned numbers. The records
+/// themselves are not stored; the map must be given the same records it was built from.
+///
+/// @tparam TLayout The layout of the records.
+/// @tparam NBlock  The number of records in each block.
+template <bit_field_layout TLayout, std::size_t NBlock = 4096>
+    requires (bits<typename TLayout::value_type> <= 64 && NBlock > 0)
+class zone_map {
+    using fields = layout_fields<TLayout>;
+
+public:
+    static constexpr std::size_t block_size = NBlock;
+
+    /// The widest field whose present values are recorded.
+    static constexpr unsigned max_presence_width = 8;
+
+    constexpr zone_map() = default;
+
+    /// Build a map of records.
+    ///
+    /// @param records The records.
+    constexpr explicit zone_map(const std::span<const TLayout> records) {
+        append(records);
+    }
+
+    /// Add records to the end of the map, as they are appended to the array it describes.
+    ///
+    /// @param records The new records.
+    constexpr void append(std::span<const TLayout> records) {
+        while (!records.empty()) {
+            if (size_ % NBlock == 0) {
+                zones_.push_back(empty_zone());
+            }
+            const std::size_t count = std::min(records.size(), NBlock - size_ % NBlock);
+            add_block(zones_.back(), records.first(count), std::make_index_sequence<fields::count>{});
+            records = records.subspan(count);
+            size_ += count;
+        }
+    }
+
+    /// Add one record to the end of the map.
+    constexpr void append(const TLayout& record) {
+        append(std::span<const TLayout>{ &record, 1 });
+    }
+
+    /// The number of records described.
+    constexpr std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// The number of blocks.
+    constexpr std::size_t block_count() const noexcept {
+        return zones_.size();
+    }
+
+    /// The smallest value of a field in a block.
+    template <typename TField>
+    constexpr std::uint64_t min(const std::size_t block) const noexcept {
+        return zones_[block].min[fields::template index_of<TField>];
+    }
+
+    /// The largest value of a field in a block.
+    template <typename TField>
+    constexpr std::uint64_t max(const std::size_t block) const noexcept {
+        return zones_[block].max[fields::template index_of<TField>];
+    }
+
+    /// Returns false if no record in a block can have a field in a range of values.
+    ///
+    /// @tparam TField The field, such as "layout::name" for a field defined with BIT_FIELD.
+    ///
+    /// @param block The block index.
+    /// @param low   The smallest value of the range.
+    /// @param high  The largest value of the range.
+    template <typename TField>
+    constexpr bool may_contain(const std::size_t block, const std::uint64_t low,
+                               const std::uint64_t high) const noexcept {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        const zone& statistics = zones_[block];
+        if (low > high || high < statistics.min[field] || low > statistics.max[field]) {
+            return false;
+        }
+        if constexpr (fields::width_of(field) <= max_presence_width) {
+            // Look for any present value in the range, one word of the presence set at a time.
+            constexpr std::size_t first_word = presence_offsets[field];
+            const std::uint64_t from = std::max(low, statistics.min[field]);
+            const std::uint64_t to = std::min(high, statistics.max[field]);
+            for (std::uint64_t word = from / 64; word <= to / 64; ++word) {
+                const std::uint64_t above = ~std::uint64_t{0} << (word == from / 64 ? from % 64 : 0);
+                const std::uint64_t below = ~std::uint64_t{0} >> (word == to / 64 ? 63 - to % 64 : 0);
+                if ((statistics.presence[first_word + word] & above & below) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        } else {
+            return true;
+        }
+    }
+
+    /// Returns false if no record in a block can have a field equal to a value.
+    template <typename TField>
+    constexpr bool may_contain(const std::size_t block, const std::uint64_t value) const noexcept {
+        return may_contain<TField>(block, value, value);
+    }
+
+    /// Find the records whose field lies in a range of values, skipping blocks which cannot hold any.
+    ///
+    /// @tparam TField The field.
+    ///
+    /// @param records The records the map describes.
+    /// @param low     The smallest value of the range.
+    /// @param high    The largest value of the range.
+    /// @param fn      Called with the index of each matching record, in order.
+    ///
+    /// @returns The number of matching records.
+    template <typename TField>
+    constexpr std::size_t find(const std::span<const TLayout> records, const std::uint64_t low,
+                               const std::uint64_t high, auto&& fn) const {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        std::size_t matches = 0;
+        for (std::size_t block = 0; block < zones_.size(); ++block) {
+            if (!may_contain<TField>(block, low, high)) {
+                continue;
+            }
+            const std::size_t first = block * NBlock;
+            const std::size_t last = std::min(first + NBlock, records.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint64_t value = field_value<field>(records[i]);
+                if (value >= low && value <= high) {
+                    fn(i);
+                    ++matches;
+                }
+            }
+        }
+        return matches;
+    }
+
+    /// Find the records whose field equals a value, skipping blocks which cannot hold any.
+    template <typename TField>
+    constexpr std::size_t find(const std::span<const TLayout> records, const std::uint64_t value, auto&& fn) const {
+        return find<TField>(records, value, value, fn);
+    }
+
+    /// Count the records whose field lies in a range of values, skipping blocks which cannot hold any.
+    template <typename TField>
+    constexpr std::size_t count_matches(const std::span<const TLayout> records, const std::uint64_t low,
+                                        const std::uint64_t high) const {
+        constexpr std::size_t field = fields::template index_of<TField>;
+        std::size_t matches = 0;
+        for (std::size_t block = 0; block < zones_.size(); ++block) {
+            if (!may_contain<TField>(block, low, high)) {
+                continue;
+            }
+            const std::size_t first = block * NBlock;
+            const std::size_t last = std::min(first + NBlock, records.size());
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint64_t value = field_value<field>(records[i]);
+                matches += (value >= low && value <= high) ? 1 : 0;
+            }
+        }
+        return matches;
+    }
+
+private:
+    using unsigned_type = detail::uint_least_t<bits<typename TLayout::value_type>>;
+
+    /// The index of the first word of each narrow field's presence set, and the number of words in all of them.
+    static constexpr std::array<std::size_t, fields::count + 1> presence_offsets = []() constexpr {
+        std::array<std::size_t, fields::count + 1> result{};
+        for (std::size_t field = 0; field < fields::count; ++field) {
+            const unsigned width = fields::width_of(field);
+            const std::size_t words = width <= max_presence_width ? ((std::size_t{1} << width) + 63) / 64 : 0;
+            result[field + 1] = result[field] + words;
+        }
+        return result;
+    }();
+
+    struct zone {
+        std::array<std::uint64_t, fields::count> min;
+        std::array<std::uint64_t, fields::count> max;
+        std::array<std::uint64_t, presence_offsets[fields::count]> presence;
+    };
+
+    static constexpr zone empty_zone() noexcept {
+        zone result{};
+        result.min.fill(~std::uint64_t{0});
+        return result;
+    }
+
+    template <std::size_t NField>
+    static constexpr std::uint64_t field_value(const TLayout& record) noexcept {
+        constexpr unsigned width = fields::width_of(NField);
+        constexpr std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+        return (static_cast<std::uint64_t>(static_cast<unsigned_type>(record.raw_value)) >> fields::offsets[NField]) &
+               mask;
+    }
+
+    /// Fold a run of records from one block into its statistics. Each field is a separate loop of independent
+    /// reductions over the block, which is small enough to stay in cache, so the records are read from memory once and
+    /// each loop vectorizes.
+    template <std::size_t... NFields>
+    static constexpr void add_block(zone& statistics, const std::span<const TLayout> records,
+                                    std::index_sequence<NFields...>) noexcept {
+        (add_field<NFields>(statistics, records), ...);
+    }
+
+    template <std::size_t NField>
+    static constexpr void add_field(zone& statistics, const std::span<const TLayout> records) noexcept {
+        constexpr unsigned width = fields::width_of(NField);
+        constexpr std::size_t first_word = presence_offsets[NField];
+        if constexpr (width <= 6) {
+            // The smallest and largest values are the lowest and highest bits of the presence set.
+            using set_type = std::conditional_t<width <= 5, std::uint32_t, std::uint64_t>;
+            set_type present{0};
+            for (const TLayout& record : records) {
+                present |= static_cast<set_type>(set_type{1} << field_value<NField>(record));
+            }
+            statistics.presence[first_word] |= present;
+            statistics.min[NField] = static_cast<std::uint64_t>(std::countr_zero(statistics.presence[first_word]));
+            statistics.max[NField] = static_cast<std::uint64_t>(63 - std::countl_zero(statistics.presence[first_word]));
+        } else if constexpr (width <= max_presence_width) {
+            std::uint64_t* const present = statistics.presence.data() + first_word;
+            for (const TLayout& record : records) {
+                const std::uint64_t value = field_value<NField>(record);
+                present[value / 64] |= std::uint64_t{1} << (value % 64);
+            }
+            constexpr std::size_t words = presence_offsets[NField + 1] - first_word;
+            std::size_t low = 0;
+            std::size_t high = words - 1;
+            while (present[low] == 0) {
+                ++low;
+            }
+            while (present[high] == 0) {
+                --high;
+            }
+            statistics.min[NField] = low * 64 + static_cast<std::uint64_t>(std::countr_zero(present[low]));
+            statistics.max[NField] = high * 64 + static_cast<std::uint64_t>(63 - std::countl_zero(present[high]));
+        } else {
+            // Reduce in the narrowest type holding the field, which vectorizes best.
+            using value_type = detail::uint_least_t<width>;
+            auto low = static_cast<value_type>(statistics.min[NField]);
+            auto high = static_cast<value_type>(statistics.max[NField]);
+            for (const TLayout& record : records) {
+                const auto value = static_cast<value_type>(field_value<NField>(record));
+                low = std::min(low, value);
+                high = std::max(high, value);
+            }
+            statistics.min[NField] = low;
+            statistics.max[NField] = high;
+        }
+    }
+
+    std::vector<zone> zones_;
+    std::size_t size_{0};
+};
+
+} // End namespace BIT_FIELD_NAMESPACE.
+
+#endif // ZONE_MAP_HPP
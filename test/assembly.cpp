@@ -2,9 +2,9 @@
 // performing the bit shifting in a very straightforward way. Several bit_field_config options are tested. Each config
 // is placed in its own namespace, and within each of those namespaces there are two other namespaces -- using_bf and
 // using_manual. Within each of those namespaces there are get and set functions for each of the three fields, address,
-// channel, and direction. In total, this makes thirty pairs of functions which can be compared to each other to ensure
-// that the assembly generated by the bit_field library is equivalent to the assembly generated by doing things
-// manually as efficiently as possible.
+// channel, and direction. In total, this makes thirty pairs of functions, plus two pairs for narrow stores at the end,
+// which can be compared to each other to ensure that the assembly generated by the bit_field library is equivalent to
+// the assembly generated by doing things manually as efficiently as possible.
 //
 // Here is the full list of generated function pairs which should be compared:
 //
@@ -38,6 +38,8 @@
 //       exception_strategy::using_bf::set_channel   /   exception_strategy::using_manual::set_channel
 //       exception_strategy::using_bf::get_direction /   exception_strategy::using_manual::get_direction
 //       exception_strategy::using_bf::set_direction /   exception_strategy::using_manual::set_direction
+//             narrow_store::using_bf::set_kind      /         narrow_store::using_manual::set_kind
+//             narrow_store::using_bf::set_length    /         narrow_store::using_manual::set_length
 //
 // The assembly-level comparison can likely be done automatically with some objdump magic, but presently it is manually
 // verified by pasting the contents of this file into godbolt.org with the appropriate #include.
@@ -328,3 +330,40 @@ void set_direction(std::uint8_t& input, m_sequence_control::transmission_directi
 } // End namespace using_manual.
 
 } // End namespace exception_strategy.
+
+// Narrow stores. Each byte-aligned field of a 32-bit value is written with a single store of just its bytes, instead of
+// a load, mask, and store of the whole value. The manual versions assume a little-endian target.
+namespace narrow_store {
+
+struct packet_header : bf::bit_field_builder<packet_header, std::uint32_t,
+                                             bf::bit_field_config{ .store_width = bf::bit_field_store_width::narrow }> {
+    BIT_FIELD(flags,  8);
+    BIT_FIELD(kind,   8);
+    BIT_FIELD(length, 16);
+};
+
+namespace using_bf {
+
+void set_kind(std::uint32_t& input, std::uint8_t value) {
+    packet_header::kind::set(input, value);
+}
+
+void set_length(std::uint32_t& input, std::uint16_t value) {
+    packet_header::length::set(input, value);
+}
+
+} // End namespace using_bf.
+
+namespace using_manual {
+
+void set_kind(std::uint32_t& input, std::uint8_t value) {
+    std::memcpy(reinterpret_cast<unsigned char*>(&input) + 1, &value, sizeof(value));
+}
+
+void set_length(std::uint32_t& input, std::uint16_t value) {
+    std::memcpy(reinterpret_cast<unsigned char*>(&input) + 2, &value, sizeof(value));
+}
+
+} // End namespace using_manual.
+
+} // End namespace narrow_store.
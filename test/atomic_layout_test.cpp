@@ -0,0 +1,128 @@
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "atomic_layout.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct slot_state : bit_field_builder<slot_state, std::uint32_t> {
+    BIT_FIELD(index, 20);
+    BIT_FIELD(busy, 1, bit_field_config<bool>{});
+    BIT_FIELD(owner, 11);
+};
+
+static_assert(std::is_same_v<atomic_layout<slot_state>::value_type, std::uint32_t>);
+static_assert(atomic_layout<slot_state>::is_always_lock_free);
+static_assert(!std::is_copy_constructible_v<atomic_layout<slot_state>>);
+
+// A versioned word with the version in the middle, so that its carry must be masked off, and one with the version at
+// the top, where the carry simply falls off the end of the word.
+struct versioned_slot : bit_field_builder<versioned_slot, std::uint32_t> {
+    BIT_FIELD(index, 20);
+    BIT_FIELD_VERSION(version, 4);
+    BIT_FIELD(owner, 8);
+};
+
+struct top_versioned_slot : bit_field_builder<top_versioned_slot, std::uint64_t> {
+    BIT_FIELD(index, 48);
+    BIT_FIELD_VERSION(version, 16);
+};
+
+static_assert(!versioned_layout<slot_state>);
+static_assert(versioned_layout<versioned_slot>);
+static_assert(versioned_layout<top_versioned_slot>);
+static_assert(!atomic_layout<slot_state>::is_versioned);
+static_assert(atomic_layout<versioned_slot>::is_versioned);
+static_assert(std::is_same_v<versioned_slot::version_field, versioned_slot::version>);
+static_assert(versioned_slot::is_complete() && top_versioned_slot::is_complete());
+
+// A node whose reference count is protected by a lock in the same word, and a table whose size is protected by a
+// reader-writer lock with room for 255 readers.
+struct locked_node : bit_field_builder<locked_node, std::uint64_t> {
+    BIT_FIELD_LOCK(lock);
+    BIT_FIELD(refs, 30);
+    BIT_FIELD(next, 32);
+};
+
+struct shared_table : bit_field_builder<shared_table, std::uint32_t> {
+    BIT_FIELD(size, 22);
+    BIT_FIELD_SHARED_LOCK(lock, 10);
+};
+
+static_assert(std::is_same_v<locked_node::lock_field, locked_node::lock>);
+static_assert(locked_node::lock::bits == 2 && locked_node::refs::offset == 2);
+static_assert(std::is_same_v<shared_table::shared_lock_field, shared_table::lock>);
+static_assert(shared_table::is_complete());
+static_assert(atomic_layout<locked_node>::has_lock && !atomic_layout<locked_node>::has_shared_lock);
+static_assert(!atomic_layout<shared_table>::has_lock && atomic_layout<shared_table>::has_shared_lock);
+static_assert(!atomic_layout<slot_state>::has_lock && !atomic_layout<slot_state>::has_shared_lock);
+
+#if defined(__SIZEOF_INT128__)
+// A tagged pointer: a 64-bit pointer, a 48-bit version, and 16 bits of flags, updated together.
+struct tagged_pointer : bit_field_builder<tagged_pointer, uint128_t> {
+    BIT_FIELD(pointer, 64, bit_field_config<std::uint64_t>{});
+    BIT_FIELD(version, 48, bit_field_config<std::uint64_t>{});
+    BIT_FIELD(flags,   16, bit_field_config<std::uint16_t>{});
+};
+
+static_assert(tagged_pointer::is_complete());
+static_assert(std::is_same_v<atomic_layout<tagged_pointer>::value_type, uint128_t>);
+static_assert(alignof(atomic_layout<tagged_pointer>) == 16);
+
+static_assert([]{
+    tagged_pointer value{};
+    value.set_pointer(0x7FFF'1234'5678ull);
+    value.set_version(0xFFFF'FFFF'FFFFull);
+    value.set_flags(0x8001);
+    return value.get_pointer() == 0x7FFF'1234'5678ull && value.get_version() == 0xFFFF'FFFF'FFFFull &&
+           value.get_flags() == 0x8001;
+}());
+#endif
+
+// The atomic operations cannot be constant evaluated, so these only need to compile.
+[[maybe_unused]] static bool use_atomic_layout(atomic_layout<slot_state>& state) {
+    const slot_state previous = state.set<slot_state::index, slot_state::owner>(42u, 7u);
+    const auto busy = state.get<slot_state::busy>(std::memory_order_acquire);
+    state.modify([](slot_state& value) { value.set_busy(true); });
+    state.modify([](slot_state& value) { return !value.get_busy(); });
+    slot_state expected = state.load();
+    return previous.get_index() == 0 && busy && state.compare_exchange_strong(expected, slot_state{});
+}
+
+[[maybe_unused]] static bool use_versioned_layout(atomic_layout<versioned_slot>& state) {
+    const auto version = state.read_begin();
+    const versioned_slot previous = state.set<versioned_slot::index>(42u);
+    state.modify([](versioned_slot& value) { value.set_owner(3u); });
+    state.bump_version();
+    return previous.get_version() == version && !state.validate(version);
+}
+
+[[maybe_unused]] static bool use_locks(atomic_layout<locked_node>& node, atomic_layout<shared_table>& table) {
+    {
+        const std::lock_guard<atomic_layout<locked_node>> guard{ node };
+        node.set<locked_node::refs>(1u);
+    }
+    {
+        const std::shared_lock<atomic_layout<shared_table>> guard{ table };
+        static_cast<void>(table.get<shared_table::size>());
+    }
+    {
+        const std::unique_lock<atomic_layout<shared_table>> guard{ table };
+        table.set<shared_table::size>(2u);
+        // Replacing the whole word while holding the lock keeps the lock held.
+        table.store(shared_table{});
+        table.modify([](shared_table& value) { value.set_size(3u); });
+    }
+    const bool locked = node.try_lock();
+    if (locked) {
+        node.unlock();
+    }
+    return locked && !node.is_locked() && !table.is_locked();
+}
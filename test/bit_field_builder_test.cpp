@@ -104,3 +104,40 @@ static_assert(set_direction<m_sequence_control::transmission_direction::write>()
                             m_sequence_control::transmission_direction::write);
 static_assert(set_direction<m_sequence_control::transmission_direction::read>().get_direction() ==
                             m_sequence_control::transmission_direction::read);
+
+// A class-wide narrow store width applies to every field that can use it, and can be overridden per field.
+constexpr auto narrow = BIT_FIELD_NAMESPACE::bit_field_config{
+    .store_width = BIT_FIELD_NAMESPACE::bit_field_store_width::narrow };
+constexpr auto full = BIT_FIELD_NAMESPACE::bit_field_config{
+    .store_width = BIT_FIELD_NAMESPACE::bit_field_store_width::full };
+
+struct narrow_record : BIT_FIELD_NAMESPACE::bit_field_builder<narrow_record, std::uint32_t, narrow> {
+    BIT_FIELD(flags,  8);
+    BIT_FIELD(kind,   8, full);
+    BIT_FIELD(length, 16);
+};
+
+static_assert(narrow_record::flags::uses_narrow_store<BIT_FIELD_NAMESPACE::bit_field_config{}, std::uint32_t>);
+static_assert(!narrow_record::kind::uses_narrow_store<BIT_FIELD_NAMESPACE::bit_field_config{}, std::uint32_t>);
+static_assert(narrow_record::length::uses_narrow_store<BIT_FIELD_NAMESPACE::bit_field_config{}, std::uint32_t>);
+
+static_assert([]{
+    narrow_record value{};
+    value.set_flags(0xA5);
+    value.set_kind(0x3C);
+    value.set_length(0xBEEF);
+    return value.raw_value == 0xBEEF3CA5;
+}());
+
+// Narrow stores are only made outside constant evaluation, where the assertions above fall back to full width stores,
+// so this only needs to compile.
+[[maybe_unused]] static bool use_narrow_stores() {
+    narrow_record value{};
+    value.raw_value = 0xFFFF'FFFF;
+    value.set_flags(0xA5);
+    value.set_kind(0x3C);
+    value.set_length(0xBEEF);
+    value.set_flags<BIT_FIELD_NAMESPACE::bit_field_config{
+        .strategy = BIT_FIELD_NAMESPACE::bit_field_assignment_strategy::mask }>(0x1C3);
+    return value.raw_value == 0xBEEF3CC3 && value.get_flags() == 0xC3 && value.get_length() == 0xBEEF;
+}
@@ -123,3 +123,25 @@ static_assert([]{
 }());
 #endif // 0
 #endif // BIT_FIELD_EXCEPTIONS_ENABLED
+
+// Narrow stores apply only to whole, naturally aligned bytes of a wider storage type.
+constexpr auto narrow_config = bit_field_config{ .store_width = bit_field_store_width::narrow };
+static_assert(bit_field<8, 8, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(bit_field<16, 16, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(bit_field<32, 32, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint64_t>);
+static_assert(!bit_field<8, 8>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(!bit_field<8, 4, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(!bit_field<16, 8, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(!bit_field<7, 8, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint32_t>);
+static_assert(!bit_field<8, 0, narrow_config>::uses_narrow_store<bit_field_config{}, std::uint8_t>);
+static_assert(bit_field<8, 8>::uses_narrow_store<narrow_config, std::uint32_t>);
+static_assert(!bit_field<8, 8, narrow_config>::uses_narrow_store<
+    bit_field_config{ .store_width = bit_field_store_width::full }, std::uint32_t>);
+
+// Setting with a narrow store gives the same result as a full width store.
+static_assert([]{
+    std::uint32_t value{0xAABBCCDD};
+    bit_field<8, 8, narrow_config>::set(value, 0x1FF);
+    bit_field<16, 16, narrow_config>::set(value, 0x1234);
+    return value == 0x1234FFDD;
+}());
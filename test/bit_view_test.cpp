@@ -0,0 +1,98 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "bit_view.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+// A thirteen bit telemetry header.
+struct header : bit_field_builder<header, std::uint16_t> {
+    BIT_FIELD(kind, 4);
+    BIT_FIELD(length, 9);
+};
+
+// A layout using all 64 bits, which can span nine bytes.
+struct wide : bit_field_builder<wide, std::uint64_t> {
+    BIT_FIELD(low, 8);
+    BIT_FIELD(middle, 48);
+    BIT_FIELD(high, 8);
+};
+
+static_assert(header::allocated_bits() == 13);
+static_assert(bit_view<header>::width == 13);
+static_assert(bit_view<wide>::width == 64);
+
+// Fitting.
+static_assert(bit_view<header>::fits(std::array<std::byte, 2>{}, 3));
+static_assert(!bit_view<header>::fits(std::array<std::byte, 2>{}, 4));
+static_assert(!bit_view<header>::fits(std::array<std::byte, 2>{}, 100));
+static_assert(bit_view<wide>::fits(std::array<std::byte, 9>{}, 7));
+
+// Loading a header starting at bit 3 of byte 17. The header is kind 0xA and length 0x155, so its bits are
+// 1'0101'0101'1010, which shifted left by three is 0b1010'1010'1101'0000.
+static_assert([]{
+    std::array<std::byte, 20> buffer{};
+    buffer[17] = std::byte{0b1101'0111};   // The low three bits belong to something else.
+    buffer[18] = std::byte{0b1010'1010};
+    const header value = load_layout_at_bit<header>(buffer, 17 * 8 + 3);
+    return value.get_kind() == 0xA && value.get_length() == 0x155 && value.raw_value == 0x155A;
+}());
+
+// Storing preserves the neighboring bits.
+static_assert([]{
+    std::array<std::byte, 4> buffer{ std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF} };
+    header value{};
+    store_layout_at_bit(std::span{ buffer }, 5, value);
+    // Bits 5 through 17 are cleared.
+    return buffer[0] == std::byte{0b0001'1111} && buffer[1] == std::byte{0x00} && buffer[2] == std::byte{0b1111'1100} &&
+           buffer[3] == std::byte{0xFF};
+}());
+
+// Bits of the layout value above its width are not stored.
+static_assert([]{
+    std::array<std::byte, 3> buffer{};
+    header value{};
+    value.raw_value = 0xFFFF;
+    store_layout_at_bit(std::span{ buffer }, 0, value);
+    return buffer[0] == std::byte{0xFF} && buffer[1] == std::byte{0x1F} && buffer[2] == std::byte{0x00};
+}());
+
+// Round trips at every bit offset, including the nine byte case of the wide layout.
+static_assert([]{
+    for (std::size_t offset = 0; offset < 16; ++offset) {
+        std::array<std::byte, 12> buffer{};
+        buffer.fill(std::byte{0x5A});
+        wide value{};
+        value.set_low(0x81);
+        value.set_middle(0x1234'5678'9ABCull);
+        value.set_high(0xC3);
+        bit_view<wide> view{ buffer, offset };
+        view.store(value);
+        if (view.load().raw_value != value.raw_value || view.end_bit_offset() != offset + 64) {
+            return false;
+        }
+        // The bits before the layout are untouched.
+        for (std::size_t bit = 0; bit < offset; ++bit) {
+            if (((static_cast<unsigned>(buffer[bit / 8]) >> (bit % 8)) & 1u) != ((0x5Au >> (bit % 8)) & 1u)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}());
+
+// Modifying a single field.
+static_assert([]{
+    std::array<std::byte, 3> buffer{};
+    bit_view<header> view{ buffer, 7 };
+    view.modify([](header& value) { value.set_length(0x1FF); });
+    view.modify([](header& value) { value.set_kind(0x3); });
+    const header value = view.load();
+    return value.get_kind() == 0x3 && value.get_length() == 0x1FF;
+}());
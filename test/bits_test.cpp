@@ -18,6 +18,8 @@ static_assert(bit_mask<std::uint8_t, 0, 2> == 0b00000011);
 static_assert(bit_mask<std::uint8_t, 0, 3> == 0b00000111);
 static_assert(bit_mask<std::uint8_t, 2, 3> == 0b00011100);
 static_assert(bit_mask<std::uint8_t, 7, 1> == 0b10000000);
+static_assert(bit_mask<std::uint64_t, 31, 2> == 0x0000000180000000);
+static_assert(bit_mask<std::uint64_t, 56, 8> == 0xFF00000000000000);
 
 static_assert(extract_bits<1, 0, std::uint8_t>(0) == std::uint8_t{0});
 static_assert(extract_bits<1, 0, std::uint8_t>(1) == std::uint8_t{1});
@@ -0,0 +1,92 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "byte_order.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+constexpr std::array<std::byte, 4> bytes{ std::byte{0x12}, std::byte{0x34}, std::byte{0x56}, std::byte{0x78} };
+
+// Loading.
+static_assert(load_bytes<std::uint32_t, std::endian::big>(bytes.data()) == 0x12345678u);
+static_assert(load_bytes<std::uint32_t, std::endian::little>(bytes.data()) == 0x78563412u);
+static_assert(load_bytes<std::uint16_t, std::endian::big>(bytes.data() + 1) == 0x3456u);
+static_assert(load_bytes<std::uint8_t, std::endian::big>(bytes.data() + 3) == 0x78u);
+static_assert(load_bytes<std::int16_t, std::endian::big>(bytes.data()) == 0x1234);
+static_assert(load_bytes<std::byte>(bytes.data() + 2) == std::byte{0x56});
+
+// Storing.
+static_assert([]{
+    std::array<std::byte, 4> out{};
+    store_bytes<std::endian::big>(out.data(), std::uint32_t{0x12345678u});
+    return out == bytes;
+}());
+static_assert([]{
+    std::array<std::byte, 4> out{};
+    store_bytes<std::endian::little>(out.data(), std::uint32_t{0x78563412u});
+    return out == bytes;
+}());
+static_assert([]{
+    std::array<std::byte, 2> out{};
+    store_bytes<std::endian::big>(out.data(), std::int16_t{-2});
+    return out[0] == std::byte{0xFF} && out[1] == std::byte{0xFE};
+}());
+
+// Layouts.
+struct word : bit_field_builder<word, std::uint16_t> {
+    BIT_FIELD(low, 4);
+    BIT_FIELD(high, 12);
+};
+
+static_assert(bit_field_layout<word>);
+static_assert(!bit_field_layout<std::uint16_t>);
+
+static_assert(load_layout<word, std::endian::big>(bytes.data()).get_low() == 0x4);
+static_assert(load_layout<word, std::endian::big>(bytes.data()).get_high() == 0x123);
+static_assert(load_layout<word, std::endian::little>(bytes.data()).get_high() == 0x341);
+static_assert([]{
+    word value{};
+    value.set_low(0x4);
+    value.set_high(0x123);
+    std::array<std::byte, 2> out{};
+    store_layout<std::endian::big>(out.data(), value);
+    return out[0] == std::byte{0x12} && out[1] == std::byte{0x34};
+}());
+
+#if defined(__SIZEOF_INT128__)
+// 128-bit layouts are moved through a 128-bit integer, in both byte orders.
+struct wide : bit_field_builder<wide, uint128_t> {
+    BIT_FIELD(low, 64, bit_field_config<std::uint64_t>{});
+    BIT_FIELD(high, 64, bit_field_config<std::uint64_t>{});
+};
+
+static_assert([]{
+    wide value{};
+    value.set_low(0x0011'2233'4455'6677u);
+    value.set_high(0x8899'AABB'CCDD'EEFFu);
+    std::array<std::byte, 16> out{};
+    store_layout<std::endian::big>(out.data(), value);
+    const wide loaded = load_layout<wide, std::endian::big>(out.data());
+    return out[0] == std::byte{0x88} && out[15] == std::byte{0x77} && loaded.raw_value == value.raw_value &&
+           load_layout<wide, std::endian::little>(out.data()).get_low() == 0xFFEE'DDCC'BBAA'9988u;
+}());
+
+// The run-time path copies all sixteen bytes with memcpy and swaps them, which constant evaluation does not reach.
+[[maybe_unused]] static bool use_wide_layouts() {
+    wide value{};
+    value.set_low(0x0011'2233'4455'6677u);
+    value.set_high(0x8899'AABB'CCDD'EEFFu);
+    std::byte out[16]{};
+    store_layout<std::endian::big>(out, value);
+    const wide big = load_layout<wide, std::endian::big>(out);
+    const wide little = load_layout<wide, std::endian::little>(out);
+    return out[0] == std::byte{0x88} && out[15] == std::byte{0x77} && big.raw_value == value.raw_value &&
+           little.get_low() == 0xFFEE'DDCC'BBAA'9988u;
+}
+#endif
@@ -0,0 +1,84 @@
+#include <array>
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "code_table.hpp"
+#  include "codec_field.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+// A logarithmic four bit code.
+constexpr std::array<std::uint16_t, 16> log_values{
+    0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384
+};
+using log_code = code_table<4, log_values>;
+
+static_assert(log_code::bits == 4);
+static_assert(std::is_same_v<log_code::raw_type, std::uint8_t>);
+static_assert(std::is_same_v<log_code::value_type, std::uint16_t>);
+static_assert(field_codec<log_code>);
+
+static_assert(log_code::decode(0) == 0);
+static_assert(log_code::decode(5) == 16);
+static_assert(log_code::decode(15) == 16384);
+static_assert(log_code::decode(0xF5) == 16); // Bits above the code width are ignored.
+
+static_assert(log_code::encode(0) == 0);
+static_assert(log_code::encode(16) == 5);
+static_assert(log_code::encode(20) == 5);      // Nearest.
+static_assert(log_code::encode(24) == 5);      // Tie, prefers the smaller value.
+static_assert(log_code::encode(25) == 6);      // Nearest.
+static_assert(log_code::encode(65535) == 15);  // Above the table.
+
+// A table which is not monotonic, with negative values.
+constexpr std::array<std::int8_t, 4> shuffled_values{ 10, -10, 0, 5 };
+using shuffled_code = code_table<2, shuffled_values>;
+
+static_assert(shuffled_code::encode(-100) == 1);
+static_assert(shuffled_code::encode(-4) == 2);
+static_assert(shuffled_code::encode(3) == 3);
+static_assert(shuffled_code::encode(8) == 0);
+static_assert(shuffled_code::encode(100) == 0);
+
+// Floating point values.
+constexpr std::array<float, 4> float_values{ 0.0f, 0.5f, 1.0f, 2.0f };
+static_assert(code_table<2, float_values>::decode(3) == 2.0f);
+static_assert(code_table<2, float_values>::encode(0.8f) == 2);
+
+// A-law.
+static_assert(alaw::decode(0xD5) == 8);
+static_assert(alaw::decode(0x55) == -8);
+static_assert(alaw::decode(0xAA) == 32256);
+static_assert(alaw::decode(0x2A) == -32256);
+static_assert(alaw::encode(8) == 0xD5);
+static_assert(alaw::encode(-32768) == 0x2A);
+static_assert([]{
+    for (std::size_t code = 0; code < 256; ++code) {
+        if (alaw::encode(alaw::decode(static_cast<std::uint8_t>(code))) != code) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Code table fields in a bit field.
+struct sensor_sample : bit_field_builder<sensor_sample, std::uint16_t> {
+    BIT_FIELD_CODEC(pressure, code_table<4, log_values>);
+    BIT_FIELD_CODEC(audio, alaw);
+    BIT_FIELD(channel, 4);
+};
+
+static_assert(sensor_sample::is_complete());
+static_assert(sensor_sample::audio::offset == 4);
+
+static_assert([]{
+    sensor_sample sample{0};
+    sample.set_pressure(1000);
+    sample.set_audio(-8);
+    sample.set_channel(3);
+    return sample.get_pressure() == 1024 && sample.get_audio() == -8 && sample.get_channel() == 3 &&
+           sample.raw_value == 0x355B;
+}());
@@ -0,0 +1,67 @@
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "codec_field.hpp"
+#  include "mini_float.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+// A feature record storing a half float and a ten bit unsigned float next to some ordinary fields.
+struct feature : bit_field_builder<feature, std::uint32_t> {
+    BIT_FIELD_CODEC(weight, half_float);
+    BIT_FIELD_CODEC(scale, mini_float<5, 5, false>);
+    BIT_FIELD(flags, 6);
+};
+
+static_assert(feature::is_complete());
+static_assert(feature::weight::offset == 0);
+static_assert(feature::weight::bits == 16);
+static_assert(feature::scale::offset == 16);
+static_assert(feature::scale::bits == 10);
+static_assert(feature::flags::offset == 26);
+
+// Static get.
+static_assert(feature::weight::get(std::uint32_t{0x00003C00}) == 1.0f);
+static_assert(feature::scale::get(std::uint32_t{0b01111'00000u << 16}) == 1.0f);
+
+// Member get and set.
+static_assert([]{
+    feature value{0};
+    value.set_flags(0b111111);
+    value.set_weight(-2.0f);
+    value.set_scale(0.5f);
+    return value.get_weight() == -2.0f && value.get_scale() == 0.5f && value.get_flags() == 0b111111 &&
+           value.raw_value == ((0b111111u << 26) | (0b01110'00000u << 16) | 0xC000u);
+}());
+
+// Setting a value that rounds away its low bits never disturbs the neighboring fields.
+static_assert([]{
+    feature value{0xFFFFFFFF};
+    value.set_weight(1.0f);
+    return value.raw_value == 0xFFFF3C00;
+}());
+
+// A user defined codec storing a value with a fixed offset.
+struct offset_codec {
+    using raw_type = std::uint8_t;
+    using value_type = int;
+    static constexpr std::size_t bits = 4;
+    static constexpr int decode(const raw_type raw) noexcept { return raw - 8; }
+    static constexpr raw_type encode(const int value) noexcept { return static_cast<raw_type>((value + 8) & 0xF); }
+};
+
+static_assert(field_codec<offset_codec>);
+static_assert(field_codec<half_float>);
+static_assert(!field_codec<int>);
+
+using offset_field = codec_field<bit_field<4, 2>, offset_codec>;
+static_assert(offset_field::get(std::uint8_t{0b00000000}) == -8);
+static_assert(offset_field::get(std::uint8_t{0b00100000}) == 0);
+static_assert([]{
+    std::uint8_t value{0b11000011};
+    offset_field::set(value, 7);
+    return value == 0b11111111;
+}());
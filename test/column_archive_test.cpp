@@ -0,0 +1,113 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "column_archive.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct trade : bit_field_builder<trade, std::uint64_t> {
+    BIT_FIELD(price,  24);
+    BIT_FIELD(side,    1);
+    BIT_FIELD(venue,   7);
+    BIT_FIELD(volume, 32);
+};
+
+struct other_trade : bit_field_builder<other_trade, std::uint64_t> {
+    BIT_FIELD(price,  20);
+    BIT_FIELD(side,    1);
+    BIT_FIELD(venue,  11);
+    BIT_FIELD(volume, 32);
+};
+
+constexpr std::vector<trade> make_trades(const std::size_t count) {
+    std::vector<trade> trades(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        trades[i].set_price(static_cast<std::uint32_t>(100'000 + i * 37 % 1000));
+        trades[i].set_side(i % 3 == 0);
+        trades[i].set_venue(12);
+        trades[i].set_volume(static_cast<std::uint32_t>(i * 2'654'435'761u));
+    }
+    return trades;
+}
+
+// Every record survives the round trip, with and without compression, including a partial last page.
+static_assert([]() constexpr {
+    const std::vector<trade> trades = make_trades(45);
+    for (const bool compress : { false, true }) {
+        const std::vector<std::byte> bytes =
+            write_column_archive<trade>(trades, { .page_records = 16, .compress = compress });
+        const std::optional<column_archive<trade>> archive = column_archive<trade>::open(bytes);
+        if (!archive || archive->size() != 45 || archive->page_count() != 3 || archive->page_size(2) != 13) {
+            return false;
+        }
+        std::vector<trade> records(40);
+        archive->read_records(5, records);
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (records[i].raw_value != trades[i + 5].raw_value) {
+                return false;
+            }
+        }
+        if (archive->record(44).raw_value != trades[44].raw_value || archive->value<trade::side>(3) != 1) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Compression stores the 1000 distinct prices of a page in 10 bits, and the constant venue in none.
+static_assert([]() constexpr {
+    const std::vector<trade> trades = make_trades(1000);
+    const std::vector<std::byte> packed = write_column_archive<trade>(trades, { .compress = false });
+    const std::vector<std::byte> compressed = write_column_archive<trade>(trades);
+    const auto plain = column_archive<trade>::open(packed);
+    const auto small = column_archive<trade>::open(compressed);
+    return plain->column_bytes<trade::price>() == (24'000 / 64 + 1) * 8 &&
+           small->column_bytes<trade::price>() == ((10'000 + 63) / 64 + 1) * 8 &&
+           small->column_bytes<trade::venue>() == 8 && compressed.size() < packed.size();
+}());
+
+// A column is scanned page by page.
+static_assert([]() constexpr {
+    const std::vector<trade> trades = make_trades(100);
+    const std::vector<std::byte> bytes = write_column_archive<trade>(trades, { .page_records = 32 });
+    std::uint64_t sells = 0;
+    std::size_t next = 0;
+    bool in_order = true;
+    column_archive<trade>::open(bytes)->scan<trade::side>(
+        [&](const std::size_t first, const std::span<const std::uint64_t> values) {
+            in_order = in_order && first == next;
+            next += values.size();
+            for (const std::uint64_t side : values) {
+                sells += side;
+            }
+        });
+    return in_order && next == 100 && sells == 34;
+}());
+
+// Archives written with another layout, truncated, with a page base too large for its field, or empty are handled.
+static_assert([]() constexpr {
+    const std::vector<trade> trades = make_trades(10);
+    std::vector<std::byte> bytes = write_column_archive<trade>(trades);
+    const bool mismatch = !column_archive<other_trade>::open(bytes);
+    const bool truncated = !column_archive<trade>::open(std::span{ bytes }.subspan(8));
+    // The base of the first price page, the third word of the first page entry after the five header words of the
+    // footer. Prices of the page differ by up to 333, so the page needs 9 bits and its base may be at most 2^24 - 512.
+    const auto footer = static_cast<std::size_t>(load_bytes<std::uint64_t, std::endian::little>(
+        bytes.data() + bytes.size() - 16));
+    std::byte* const base = bytes.data() + footer + 7 * 8;
+    store_bytes<std::endian::little>(base, std::uint64_t{(1u << 24) - 512});
+    const bool largest_base = column_archive<trade>::open(bytes).has_value();
+    store_bytes<std::endian::little>(base, std::uint64_t{(1u << 24) - 511});
+    const bool overflowing_base = !column_archive<trade>::open(bytes);
+    const std::vector<std::byte> empty = write_column_archive<trade>(std::span<const trade>{});
+    const auto empty_archive = column_archive<trade>::open(empty);
+    return mismatch && truncated && largest_base && overflowing_base && empty_archive && empty_archive->size() == 0 &&
+           empty_archive->page_count() == 0;
+}());
@@ -0,0 +1,41 @@
+#include <cstdint>
+#include <type_traits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "concurrent_packed_array.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+// Elements never span two words, so 3-bit elements leave one bit of each 64-bit word unused.
+static_assert(concurrent_packed_array<1>::elements_per_word == 64);
+static_assert(concurrent_packed_array<2>::elements_per_word == 32);
+static_assert(concurrent_packed_array<3>::elements_per_word == 21);
+static_assert(concurrent_packed_array<64>::elements_per_word == 1);
+static_assert(concurrent_packed_array<5, std::uint8_t>::elements_per_word == 1);
+static_assert(concurrent_packed_array<3>::words_for(0) == 0);
+static_assert(concurrent_packed_array<3>::words_for(21) == 1);
+static_assert(concurrent_packed_array<3>::words_for(22) == 2);
+
+static_assert(std::is_same_v<concurrent_packed_array<2>::value_type, std::uint8_t>);
+static_assert(std::is_same_v<concurrent_packed_array<33>::value_type, std::uint64_t>);
+static_assert(concurrent_packed_array<2>::max_value == 3);
+static_assert(concurrent_packed_array<64>::max_value == 0xFFFF'FFFF'FFFF'FFFFu);
+static_assert(!std::is_copy_constructible_v<concurrent_packed_array<2>>);
+
+// The atomic operations cannot be constant evaluated, so these only need to compile.
+[[maybe_unused]] static bool use_concurrent_packed_array() {
+    concurrent_packed_array<2> states{ 100 };
+    concurrent_packed_array<1, std::uint32_t> visited{ 100 };
+    states.store(3, 2);
+    std::uint8_t expected = 2;
+    const bool exchanged = states.compare_exchange(3, expected, 1);
+    states.fetch_add(4, 3);
+    states.fetch_or(5, 1);
+    states.fetch_and(5, 2);
+    states.update(6, std::memory_order_relaxed, [](const std::uint8_t value) { return value ^ 1; });
+    return exchanged && !visited.test_and_set(99) && visited.test_and_set(99) && states.load(3) == 1 &&
+           states.words().size() == 4;
+}
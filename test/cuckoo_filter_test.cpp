@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "cuckoo_filter.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct narrow_bucket : bit_field_builder<narrow_bucket, std::uint32_t> {
+    BIT_FIELD(slot0, 8);
+    BIT_FIELD(slot1, 8);
+    BIT_FIELD(slot2, 8);
+    BIT_FIELD(slot3, 8);
+};
+
+struct packed_bucket : bit_field_builder<packed_bucket, std::uint64_t> {
+    BIT_FIELD(slot0, 12);
+    BIT_FIELD(slot1, 12);
+    BIT_FIELD(slot2, 12);
+    BIT_FIELD(slot3, 12);
+    BIT_FIELD(slot4, 12);
+};
+
+// The slots are the fields of the bucket layout, and the filter is sized for its capacity at a load of 95%.
+static_assert(cuckoo_filter<narrow_bucket>::slots_per_bucket == 4 &&
+              cuckoo_filter<narrow_bucket>::fingerprint_bits == 8);
+static_assert(cuckoo_filter<packed_bucket>::slots_per_bucket == 5 &&
+              cuckoo_filter<packed_bucket>::fingerprint_bits == 12);
+static_assert(cuckoo_filter<packed_bucket>{ 1000 }.bucket_count() == 256 &&
+              cuckoo_filter<packed_bucket>{ 1000 }.memory_size() == 2048 &&
+              cuckoo_filter<narrow_bucket>{ 100 }.slot_count() == 128);
+
+// Every key added is found, including after other keys are removed, and few keys not added are.
+template <typename TBucket>
+constexpr bool keeps_keys() {
+    cuckoo_filter<TBucket> filter{ 500 };
+    for (std::uint64_t key = 0; key < 500; ++key) {
+        if (!filter.insert(key * 7919)) {
+            return false;
+        }
+    }
+    for (std::uint64_t key = 0; key < 500; key += 2) {
+        if (!filter.erase(key * 7919)) {
+            return false;
+        }
+    }
+    std::size_t false_positives = 0;
+    for (std::uint64_t key = 0; key < 500; ++key) {
+        if (key % 2 == 1 && !filter.contains(key * 7919)) {
+            return false;
+        }
+        false_positives += filter.contains(key * 7919 + 1) ? 1u : 0u;
+    }
+    // About 2 * slots / 2^bits of 500 keys are expected, at most 16 for 8-bit fingerprints.
+    return filter.size() == 250 && false_positives < (TBucket::allocated_bits() == 32 ? 32u : 4u);
+}
+static_assert(keeps_keys<narrow_bucket>());
+static_assert(keeps_keys<packed_bucket>());
+
+// Keys added twice are removed twice, and removing a key not added fails.
+static_assert([]() constexpr {
+    cuckoo_filter<packed_bucket> filter{ 16 };
+    filter.insert(42);
+    filter.insert(42);
+    const bool twice = filter.erase(42) && filter.contains(42) && filter.erase(42);
+    return twice && !filter.contains(42) && !filter.erase(42) && filter.size() == 0;
+}());
+
+// A full filter refuses further keys and is left as it was, and removing a key makes room again.
+static_assert([]() constexpr {
+    cuckoo_filter<narrow_bucket> filter{ 8 };
+    std::uint64_t taken = 0;
+    while (filter.insert(taken)) {
+        ++taken;
+    }
+    for (std::uint64_t key = 0; key < taken; ++key) {
+        if (!filter.contains(key)) {
+            return false;
+        }
+    }
+    return filter.size() == taken && taken <= filter.slot_count() && filter.erase(0) && filter.insert(taken) &&
+           filter.contains(taken) && filter.size() == taken;
+}());
+
+// An empty filter holds nothing.
+static_assert(!cuckoo_filter<narrow_bucket>{}.contains(0) && !cuckoo_filter<narrow_bucket>{}.insert(0));
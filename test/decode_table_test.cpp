@@ -0,0 +1,83 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "decode_table.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct control : bit_field_builder<control, std::uint8_t> {
+    enum class channel_type : std::uint8_t { process, page, diagnosis, isdu };
+    enum class direction_type : std::uint8_t { write, read };
+
+    BIT_FIELD(address,   5);
+    BIT_FIELD(channel,   2, bit_field_config<channel_type>{});
+    BIT_FIELD(direction, 1, bit_field_config<direction_type>{});
+};
+
+struct decoded_control {
+    std::uint8_t address;
+    control::channel_type channel;
+    control::direction_type direction;
+};
+
+constexpr decoded_control decode_control(const control& layout) {
+    return { layout.get_address(), layout.get_channel(), layout.get_direction() };
+}
+
+using control_table = decode_table<control, &decode_control>;
+
+static_assert(control_table::size == 256);
+static_assert(sizeof(control_table::entries) == 256 * sizeof(decoded_control));
+
+// Every entry matches decoding the fields one at a time.
+static_assert([]() constexpr {
+    for (unsigned raw = 0; raw < 256; ++raw) {
+        const control layout{ static_cast<std::uint8_t>(raw) };
+        const decoded_control& decoded = control_table::decode(layout);
+        if (decoded.address != layout.get_address() || decoded.channel != layout.get_channel() ||
+            decoded.direction != layout.get_direction()) {
+            return false;
+        }
+    }
+    return control_table::decode(std::uint8_t{0xA2}).address == 2 &&
+           control_table::decode(std::uint8_t{0xA2}).channel == control::channel_type::page &&
+           control_table::decode(std::uint8_t{0xA2}).direction == control::direction_type::read;
+}());
+
+// A 12-bit reading: a status enum and a signed, scaled temperature. Only the allocated bits index the table.
+struct reading : bit_field_builder<reading, std::uint16_t> {
+    BIT_FIELD(status,      3, bit_field_config<std::uint8_t>{});
+    BIT_FIELD(temperature, 9);
+};
+
+struct decoded_reading {
+    std::uint8_t status;
+    double celsius;
+};
+
+constexpr auto decode_reading = [](const reading& layout) constexpr {
+    const auto raw = static_cast<int>(layout.get_temperature());
+    return decoded_reading{ layout.get_status(), (raw >= 256 ? raw - 512 : raw) * 0.5 };
+};
+
+using reading_table = decode_table<reading, decode_reading>;
+
+static_assert(reading_table::size == 4096);
+static_assert(reading_table::decode(std::uint16_t{0x0015}).status == 5);
+static_assert(reading_table::decode(std::uint16_t{0x0015}).celsius == 1.0);
+static_assert(reading_table::decode(std::uint16_t{0x0FF8}).celsius == -0.5);
+static_assert(reading_table::decode(std::uint16_t{0xF800}).celsius == -128.0);
+
+// Batches decode each layout in turn.
+static_assert([]() constexpr {
+    const std::array<reading, 3> layouts{ reading{ 0x0015 }, reading{ 0x0FF8 }, reading{ 0x0001 } };
+    std::array<decoded_reading, 3> decoded{};
+    reading_table::decode(layouts, decoded);
+    return decoded[0].celsius == 1.0 && decoded[1].celsius == -0.5 && decoded[2].status == 1 &&
+           decoded[2].celsius == 0.0;
+}());
@@ -0,0 +1,85 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "elias_fano.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+constexpr std::array<std::uint64_t, 8> postings{ 3, 4, 7, 13, 14, 15, 21, 43 };
+
+// The low bits take floor(log2(43 / 8)) = 2 bits, and every value reads back.
+static_assert([]() constexpr {
+    const elias_fano sequence{ postings };
+    for (std::size_t i = 0; i < postings.size(); ++i) {
+        if (sequence[i] != postings[i]) {
+            return false;
+        }
+    }
+    return sequence.size() == 8 && !sequence.empty() && sequence.low_bits() == 2;
+}());
+
+// The first value at or above a target, including targets between values, equal to values, and past the end.
+static_assert([]() constexpr {
+    const elias_fano sequence{ postings };
+    return sequence.next_geq(0) == 0 && sequence.next_geq(4) == 1 && sequence.next_geq(5) == 2 &&
+           sequence.next_geq(16) == 6 && sequence.next_geq(43) == 7 && sequence.next_geq(44) == 8;
+}());
+
+// Long sequences with repeated values, runs of equal high bits, and large gaps cross many words and samples.
+static_assert([]() constexpr {
+    std::vector<std::uint64_t> values(2000);
+    std::uint32_t state = 12345;
+    std::uint64_t value = 5;
+    for (std::uint64_t& each : values) {
+        state = state * 1'103'515'245u + 12'345u;
+        const std::uint32_t draw = state >> 16;
+        value += draw % 8 == 0 ? draw % 5000 : draw % 40 < 10 ? 0 : draw % 40;
+        each = value;
+    }
+    const elias_fano sequence{ values };
+    std::vector<std::uint64_t> decoded(values.size() - 100);
+    sequence.decode(100, decoded);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (sequence[i] != values[i] || (i >= 100 && decoded[i - 100] != values[i])) {
+            return false;
+        }
+    }
+    std::size_t expected = 0;
+    for (std::uint64_t target = 0; target <= values.back() + 1; target += 97) {
+        while (expected < values.size() && values[expected] < target) {
+            ++expected;
+        }
+        if (sequence.next_geq(target) != expected) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Sequences of all zeros, and of values no larger than their count, keep no low bits.
+static_assert([]() constexpr {
+    const std::array<std::uint64_t, 3> zeros{ 0, 0, 0 };
+    const std::array<std::uint64_t, 4> dense{ 0, 1, 2, 3 };
+    const elias_fano zero_sequence{ zeros };
+    const elias_fano dense_sequence{ dense };
+    return zero_sequence.low_bits() == 0 && zero_sequence[2] == 0 && zero_sequence.next_geq(0) == 0 &&
+           zero_sequence.next_geq(1) == 3 && dense_sequence.low_bits() == 0 && dense_sequence[3] == 3 &&
+           dense_sequence.next_geq(2) == 2;
+}());
+
+// Values using all 64 bits.
+static_assert([]() constexpr {
+    const std::array<std::uint64_t, 2> wide{ 1, ~std::uint64_t{0} };
+    const elias_fano sequence{ wide };
+    return sequence.low_bits() == 62 && sequence[0] == 1 && sequence[1] == ~std::uint64_t{0} &&
+           sequence.next_geq(2) == 1;
+}());
+
+// An empty sequence has no values to find.
+static_assert(elias_fano{}.empty() && elias_fano{}.next_geq(0) == 0);
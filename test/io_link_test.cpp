@@ -0,0 +1,135 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "io_link.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+static_assert(io_link::m_sequence_control::is_complete());
+static_assert(io_link::checksum_type::is_complete());
+static_assert(io_link::checksum_status::is_complete());
+
+static_assert(io_link::type_2_5.master_size(io_link::transmission_direction::write) == 4);
+static_assert(io_link::type_2_5.master_size(io_link::transmission_direction::read) == 3);
+static_assert(io_link::type_2_5.device_size(io_link::transmission_direction::write) == 2);
+static_assert(io_link::type_2_5.device_size(io_link::transmission_direction::read) == 3);
+
+constexpr io_link::m_sequence_control make_control(const io_link::transmission_direction direction,
+                                                   const io_link::communication_channel channel,
+                                                   const std::uint8_t address) {
+    io_link::m_sequence_control control{};
+    control.set_direction(direction);
+    control.set_channel(channel);
+    control.set_address(address);
+    return control;
+}
+
+// Reading the MinCycleTime (page address 2) with TYPE_0. The seed cancels against the control octet.
+static_assert([]() constexpr {
+    std::array<std::byte, 2> frame{};
+    const auto control = make_control(io_link::transmission_direction::read, io_link::communication_channel::page, 2);
+    return io_link::encode_master(io_link::type_0, { control, {}, {} }, frame) == 2 &&
+           frame == std::array{ std::byte{0xA2}, std::byte{0x00} };
+}());
+
+// A TYPE_2_5 read of page address 0x11 with one octet of output process data. The octets XOR with the seed to 0x39,
+// which compresses to a checksum of 0b000011. The device answers with an event pending, and its octets XOR with the
+// seed to 0xF4, which compresses to 0b010010.
+constexpr auto read_control = make_control(io_link::transmission_direction::read, io_link::communication_channel::page,
+                                           0x11);
+constexpr std::array master_frame{ std::byte{0xB1}, std::byte{0x83}, std::byte{0x5A} };
+constexpr std::array device_frame{ std::byte{0x12}, std::byte{0x34}, std::byte{0x92} };
+
+static_assert([]() constexpr {
+    std::array<std::byte, 8> frame{};
+    const std::array output{ std::byte{0x5A} };
+    return io_link::encode_master(io_link::type_2_5, { read_control, output, {} }, frame) == 3 &&
+           frame[0] == master_frame[0] && frame[1] == master_frame[1] && frame[2] == master_frame[2];
+}());
+static_assert([]() constexpr {
+    const auto message = io_link::decode_master(io_link::type_2_5, master_frame);
+    return message && message->control.get_address() == 0x11 &&
+           message->control.get_channel() == io_link::communication_channel::page &&
+           message->process_data.size() == 1 && message->process_data[0] == std::byte{0x5A} &&
+           message->on_request_data.empty();
+}());
+static_assert([]() constexpr {
+    std::array<std::byte, 3> frame{};
+    const std::array on_request{ std::byte{0x12} };
+    const std::array input{ std::byte{0x34} };
+    return io_link::encode_device(io_link::type_2_5, read_control, { on_request, input, true, false }, frame) == 3 &&
+           frame == device_frame;
+}());
+static_assert([]() constexpr {
+    const auto message = io_link::decode_device(io_link::type_2_5, read_control, device_frame);
+    return message && message->event && !message->process_data_invalid && message->on_request_data.size() == 1 &&
+           message->on_request_data[0] == std::byte{0x12} && message->process_data.size() == 1 &&
+           message->process_data[0] == std::byte{0x34};
+}());
+
+// Corrupted octets, the wrong M-sequence type, and the wrong size are rejected.
+static_assert([]() constexpr {
+    auto corrupted = master_frame;
+    corrupted[2] ^= std::byte{0x04};
+    auto wrong_type = device_frame;
+    wrong_type[1] ^= std::byte{0x01};
+    return !io_link::decode_master(io_link::type_2_5, corrupted) &&
+           !io_link::decode_master(io_link::type_1_v(1), master_frame) &&
+           !io_link::decode_master(io_link::type_2_v(2, 1, 1), master_frame) &&
+           !io_link::decode_master(io_link::type_2_5, std::span{ master_frame }.first(1)) &&
+           !io_link::decode_device(io_link::type_2_5, read_control, wrong_type) &&
+           !io_link::decode_device(io_link::type_2_2, read_control, device_frame);
+}());
+
+// Data which does not match the format is not encoded.
+static_assert([]() constexpr {
+    std::array<std::byte, 8> frame{};
+    const std::array output{ std::byte{0x5A}, std::byte{0x5B} };
+    const auto write_control =
+        make_control(io_link::transmission_direction::write, io_link::communication_channel::isdu, 0);
+    return io_link::encode_master(io_link::type_2_5, { read_control, output, {} }, frame) == 0 &&
+           io_link::encode_master(io_link::type_2_5, { write_control, std::span{ output }.first(1), {} }, frame) == 0 &&
+           io_link::encode_master(io_link::type_2_5, { read_control, std::span{ output }.first(1), {} },
+                                  std::span{ frame }.first(2)) == 0;
+}());
+
+// A gateway encodes every port's master message into one buffer and decodes every reply from another.
+static_assert([]() constexpr {
+    const std::array formats{ io_link::type_0, io_link::type_2_5, io_link::type_2_v(4, 4, 2) };
+    const auto write_control =
+        make_control(io_link::transmission_direction::write, io_link::communication_channel::isdu, 0x10);
+    const std::array<std::byte, 4> data{ std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4} };
+    const std::array<io_link::master_message, 3> messages{ {
+        { write_control, {}, std::span{ data }.first(1) },
+        { read_control, std::span{ data }.first(1), {} },
+        { write_control, data, std::span{ data }.first(2) },
+    } };
+    std::array<std::byte, 16> master_frames{};
+    if (io_link::encode_master_messages(formats, messages, master_frames) != 3 + 3 + 8) {
+        return false;
+    }
+    const auto second = io_link::decode_master(formats[1], std::span{ master_frames }.subspan(3, 3));
+
+    const std::array controls{ write_control, read_control, write_control };
+    std::array<std::byte, 16> device_frames{};
+    std::size_t offset = 0;
+    for (std::size_t port = 0; port < formats.size(); ++port) {
+        const std::size_t on_request = port == 1 ? formats[port].on_request_data : 0;
+        offset += io_link::encode_device(formats[port], controls[port],
+                                         { std::span{ data }.first(on_request),
+                                           std::span{ data }.first(formats[port].process_data_in), false, port == 2 },
+                                         std::span{ device_frames }.subspan(offset));
+    }
+    device_frames[offset - 2] ^= std::byte{0x01};
+    std::array<std::optional<io_link::device_message>, 3> replies{};
+    return second && second->process_data[0] == std::byte{1} && offset == 1 + 3 + 5 &&
+           io_link::decode_device_messages(formats, controls, device_frames, replies) == 2 &&
+           replies[0] && replies[1] && replies[1]->on_request_data[0] == std::byte{1} && !replies[2];
+}());
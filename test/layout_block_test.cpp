@@ -0,0 +1,130 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "layout_block.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct message_type : bit_field_builder<message_type, std::uint8_t> {
+    BIT_FIELD(version, 2);
+    BIT_FIELD(kind,    6);
+};
+
+struct message_length : bit_field_builder<message_length, std::uint16_t> {
+    BIT_FIELD(words,   12);
+    BIT_FIELD(flags,    4);
+};
+
+struct message_id : bit_field_builder<message_id, std::uint32_t> {
+    BIT_FIELD(source,  16);
+    BIT_FIELD(serial,  16);
+};
+
+// A type byte, a big-endian length at offset 2, and a little-endian identifier at offset 4.
+using header = layout_block<
+    block_member<0, message_type>,
+    block_member<2, message_length, std::endian::big>,
+    block_member<4, message_id, std::endian::little>>;
+
+static_assert(header::size == 8);
+static_assert(header::member_count == 3);
+static_assert(header::index_of<message_length> == 1);
+static_assert(header::alignment == 1);
+static_assert(header::plain_memory);
+
+// Members are found by layout type only when exactly one member has it.
+template <typename TBlock, typename TLayout>
+concept has_index = requires { TBlock::template index_of<TLayout>; };
+
+using repeated = layout_block<block_member<0, message_type>, block_member<1, message_type>, block_member<2, message_id>>;
+
+static_assert(has_index<repeated, message_id> && repeated::index_of<message_id> == 2);
+static_assert(!has_index<repeated, message_type>);
+static_assert(!has_index<header, std::uint8_t>);
+
+// Members are decoded at their offsets, in their own byte order.
+static_assert([]() constexpr {
+    std::array<std::byte, 8> bytes{
+        std::byte{0x4D}, std::byte{0xEE}, std::byte{0xA0}, std::byte{0x05},
+        std::byte{0x34}, std::byte{0x12}, std::byte{0x78}, std::byte{0x56},
+    };
+    const block_view<header> view{ bytes };
+    return view.load<0>().get_version() == 1 && view.load<message_type>().get_kind() == 0x13 &&
+           view.load<message_length>().get_words() == 5 && view.load<message_length>().get_flags() == 0xA &&
+           view.load<2>().get_source() == 0x1234 && view.load<2>().get_serial() == 0x5678;
+}());
+
+// Stores touch only their own bytes, and whole blocks are copied and compared member by member.
+static_assert([]() constexpr {
+    std::array<std::byte, 8> bytes{};
+    bytes[1] = std::byte{0xEE};
+    const block_view<header> view{ bytes };
+    view.modify<message_length>([](message_length& length) { length.set_words(0x123); });
+    message_id id{};
+    id.set_source(7);
+    view.store(id);
+
+    std::array<std::byte, 8> copy{};
+    const block_view<header> copied{ copy };
+    copied.copy_from(block_view<header, const std::byte>{ bytes });
+    const bool same = copied.equals(view) && copy[1] == std::byte{0} && bytes[1] == std::byte{0xEE};
+    copied.modify<0>([](message_type& type) { type.set_kind(1); });
+    return same && !copied.equals(view) && bytes[2] == std::byte{0x01} && bytes[3] == std::byte{0x23} &&
+           bytes[4] == std::byte{7} && std::get<1>(view.load_all()).get_words() == 0x123;
+}());
+
+// The run-time copy of plain memory is a memcpy of each member, which constant evaluation does not reach, so this
+// only needs to compile. Like the constant evaluated copy, it leaves the byte between the first two members alone.
+[[maybe_unused]] static bool use_header_copy() {
+    std::array<std::byte, header::size> bytes{};
+    bytes.fill(std::byte{0xEE});
+    std::array<std::byte, header::size> copy{};
+    const block_view<header> copied{ copy };
+    copied.copy_from(block_view<header, const std::byte>{ bytes });
+    return copy[1] == std::byte{0} && copy[0] == std::byte{0xEE} && copied.equals(block_view<header>{ bytes });
+}
+
+struct control_register : bit_field_builder<control_register, std::uint32_t> {
+    BIT_FIELD(enable,    1);
+    BIT_FIELD(mode,      3);
+    BIT_FIELD(divider,  12);
+    BIT_FIELD_PAD(16);
+};
+
+struct status_register : bit_field_builder<status_register, std::uint16_t> {
+    BIT_FIELD(ready,     1);
+    BIT_FIELD(errors,   15);
+};
+
+struct data_register : bit_field_builder<data_register, std::uint32_t> {
+    BIT_FIELD(sample,   24);
+    BIT_FIELD(channel,   8);
+};
+
+using device_registers = layout_block<
+    block_member<0x0, control_register, std::endian::native, block_access::exact>,
+    block_member<0x4, status_register, std::endian::native, block_access::exact>,
+    block_member<0x8, data_register, std::endian::big, block_access::exact>>;
+
+static_assert(device_registers::size == 12);
+static_assert(device_registers::alignment == 4);
+static_assert(!device_registers::plain_memory);
+
+// Exact access uses volatile loads and stores, which cannot be constant evaluated, so this only needs to compile.
+[[maybe_unused]] static bool use_device_registers() {
+    alignas(device_registers::alignment) std::array<std::byte, device_registers::size> registers{};
+    const block_view<device_registers> device{ registers.data() };
+    device.modify<control_register>([](control_register& control) {
+        control.set_enable(true);
+        control.set_divider(100);
+    });
+    std::array<std::byte, device_registers::size> saved{};
+    block_view<device_registers>{ saved }.copy_from(device);
+    return device.load<status_register>().get_ready() == 0 && device.equals(block_view<device_registers>{ saved });
+}
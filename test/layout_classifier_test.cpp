@@ -0,0 +1,113 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "layout_classifier.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct frame : bit_field_builder<frame, std::uint32_t> {
+    BIT_FIELD(direction, 1);
+    BIT_FIELD(channel,   2);
+    BIT_FIELD(kind,      6);
+    BIT_FIELD(address,  16);
+    BIT_FIELD(port,      7);
+};
+
+constexpr frame make_frame(const std::uint32_t direction, const std::uint32_t channel, const std::uint32_t address) {
+    frame result{};
+    result.set_direction(direction);
+    result.set_channel(channel);
+    result.set_address(address);
+    return result;
+}
+
+constexpr std::array<classifier_rule<frame>, 4> priority_rules = []() constexpr {
+    std::array<classifier_rule<frame>, 4> result{};
+    result[0].where<frame::channel>(1).where<frame::address>(100, 199).where<frame::direction>(1);
+    result[1].where<frame::channel>(1).where<frame::address>(150, 300);
+    result[2].where<frame::address>(1000, 900);
+    result[3].where<frame::direction>(0);
+    return result;
+}();
+
+// Rules keep the intersection of repeated restrictions, and know which fields they restrict.
+static_assert([]() constexpr {
+    classifier_rule<frame> rule;
+    rule.where<frame::address>(10, 100).where<frame::address>(50, 500);
+    return rule.low(3) == 50 && rule.high(3) == 100 && rule.restricts(3) && !rule.restricts(0) &&
+           rule.satisfiable() && !priority_rules[2].satisfiable() &&
+           priority_rules[0].matches(make_frame(1, 1, 150)) && !priority_rules[0].matches(make_frame(0, 1, 150));
+}());
+
+// The first matching rule wins, and unsatisfiable rules never match.
+static_assert([]() constexpr {
+    const layout_classifier<frame> classifier{ priority_rules };
+    return classifier.rule_count() == 4 && classifier.word_count() == 1 && classifier.dimension_count() == 3 &&
+           classifier.classify(make_frame(1, 1, 150)) == 0 && classifier.classify(make_frame(0, 1, 150)) == 1 &&
+           classifier.classify(make_frame(1, 1, 250)) == 1 && classifier.classify(make_frame(0, 2, 950)) == 3 &&
+           classifier.classify(make_frame(1, 2, 950)) == layout_classifier<frame>::no_match &&
+           classifier.classify(make_frame(1, 1, 301)) == layout_classifier<frame>::no_match;
+}());
+
+// Every matching rule is reported.
+static_assert([]() constexpr {
+    const layout_classifier<frame> classifier{ priority_rules };
+    std::array<std::uint64_t, 1> matches{};
+    classifier.match_all(make_frame(0, 1, 160), matches);
+    return matches[0] == 0b1010;
+}());
+
+// Classification agrees with testing the rules in order, across more than one word of rules, for single records and
+// for batches.
+static_assert([]() constexpr {
+    std::vector<classifier_rule<frame>> many(150);
+    std::uint32_t state = 12345;
+    const auto next = [&state] {
+        state = state * 1'103'515'245u + 12'345u;
+        return state >> 8;
+    };
+    for (classifier_rule<frame>& rule : many) {
+        const std::uint32_t low = next() % 4096;
+        rule.where<frame::address>(low, low + next() % 512);
+        if (next() % 2 == 0) {
+            rule.where<frame::channel>(next() % 4);
+        }
+        if (next() % 4 == 0) {
+            rule.where<frame::direction>(next() % 2);
+        }
+        if (next() % 8 == 0) {
+            const std::uint32_t kind = next() % 64;
+            rule.where<frame::kind>(kind, kind + 8);
+        }
+    }
+    const layout_classifier<frame> classifier{ many };
+    std::vector<frame> records(300);
+    for (frame& record : records) {
+        record = make_frame(next() % 2, next() % 4, next() % 4608);
+        record.set_kind(next() % 64);
+    }
+    std::vector<std::size_t> results(records.size());
+    classifier.classify(records, results);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        std::size_t expected = layout_classifier<frame>::no_match;
+        for (std::size_t rule = 0; rule < many.size(); ++rule) {
+            if (many[rule].matches(records[i])) {
+                expected = rule;
+                break;
+            }
+        }
+        if (classifier.classify(records[i]) != expected || results[i] != expected) {
+            return false;
+        }
+    }
+    return classifier.word_count() == 3;
+}());
+
+// A classifier without rules matches nothing.
+static_assert(layout_classifier<frame>{}.classify(make_frame(0, 0, 0)) == layout_classifier<frame>::no_match);
@@ -0,0 +1,122 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "layout_cursor.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+template <std::size_t NSize>
+constexpr std::array<std::byte, NSize> make_bytes(const std::array<std::uint8_t, NSize>& values) {
+    std::array<std::byte, NSize> result{};
+    for (std::size_t i = 0; i < NSize; ++i) {
+        result[i] = static_cast<std::byte>(values[i]);
+    }
+    return result;
+}
+
+// The first two words of an IPv4 header, loaded big-endian, so fields are listed from the least significant bit.
+struct ipv4_word0 : bit_field_builder<ipv4_word0, std::uint32_t> {
+    BIT_FIELD(total_length, 16);
+    BIT_FIELD(ecn, 2);
+    BIT_FIELD(dscp, 6);
+    BIT_FIELD(ihl, 4);
+    BIT_FIELD(version, 4);
+};
+
+struct ipv4_word1 : bit_field_builder<ipv4_word1, std::uint32_t> {
+    BIT_FIELD(fragment_offset, 13);
+    BIT_FIELD(flags, 3);
+    BIT_FIELD(identification, 16);
+};
+
+using ipv4_header = segment<std::endian::big, length_from<0, ipv4_word0::ihl, 4>, ipv4_word0, ipv4_word1>;
+
+static_assert(ipv4_header::prefix_size == 8);
+
+// An IPv4 header with one word of options (IHL of 6), followed by two bytes of payload.
+constexpr auto packet = make_bytes<26>({
+    0x46, 0x00, 0x00, 0x1A, 0xAB, 0xCD, 0x40, 0x00,
+    0x40, 0x06, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x01,
+    0x0A, 0x00, 0x00, 0x02, 0x01, 0x01, 0x01, 0x00,
+    0xEE, 0xFF,
+});
+
+static_assert([]{
+    layout_cursor cursor{ packet };
+    const auto header = cursor.next<ipv4_header>();
+    return header && header->get<0>().get_version() == 4 && header->get<0>().get_ihl() == 6 &&
+           header->get<0>().get_total_length() == 26 && header->get<1>().get_identification() == 0xABCD &&
+           header->get<1>().get_flags() == 0b010 && header->bytes.size() == 24 && header->body().size() == 16 &&
+           cursor.position() == 24 && cursor.remaining().size() == 2 && cursor.remaining()[0] == std::byte{0xEE};
+}());
+
+// An IHL below the fixed prefix, or running past the end of the buffer, is rejected without moving the cursor.
+static_assert([]{
+    auto bad = packet;
+    bad[0] = std::byte{0x41};
+    layout_cursor cursor{ bad };
+    return !cursor.next<ipv4_header>() && cursor.position() == 0;
+}());
+static_assert([]{
+    layout_cursor cursor{ std::span{ packet }.first(23) };
+    return !cursor.next<ipv4_header>() && cursor.position() == 0;
+}());
+static_assert([]{
+    layout_cursor cursor{ std::span{ packet }.first(7) };
+    return !cursor.next<ipv4_header>() && !cursor.peek<ipv4_header>().valid();
+}());
+
+// Reading single layouts and skipping.
+static_assert([]{
+    layout_cursor cursor{ packet };
+    const auto word0 = cursor.read<ipv4_word0, std::endian::big>();
+    const bool skipped = cursor.skip(20);
+    return word0 && word0->get_ihl() == 6 && skipped && cursor.remaining().size() == 2 && !cursor.skip(3) &&
+           !cursor.read<ipv4_word0, std::endian::big>() && cursor.skip(2) && cursor.empty();
+}());
+
+// TLV records with a one byte type and a one byte length counting only the value.
+struct tlv_prefix : bit_field_builder<tlv_prefix, std::uint16_t> {
+    BIT_FIELD(length, 8);
+    BIT_FIELD(type, 8);
+};
+
+using tlv = segment<std::endian::big, length_from<0, tlv_prefix::length, 1, 2>, tlv_prefix>;
+
+constexpr auto records = make_bytes<9>({ 0x01, 0x02, 0xAA, 0xBB, 0x02, 0x00, 0x03, 0x01, 0xCC });
+
+static_assert([]{
+    std::size_t count = 0;
+    std::size_t type_sum = 0;
+    const std::size_t consumed = for_each_segment<tlv>(std::span{ records }, [&](const segment_view<tlv>& record) {
+        ++count;
+        type_sum += record.get<0>().get_type();
+    });
+    return consumed == records.size() && count == 3 && type_sum == 6;
+}());
+
+// A truncated final record stops the walk, and a false return from the callback stops it early.
+static_assert(for_each_segment<tlv>(std::span{ records }.first(8), [](const auto&) {}) == 6);
+static_assert(for_each_segment<tlv>(std::span{ records }, [](const auto&) { return false; }) == 4);
+
+// Batch decoding.
+static_assert([]{
+    const std::array<std::span<const std::byte>, 3> frames{
+        std::span{ packet }, std::span{ packet }.first(10), std::span{ records } };
+    std::array<segment_view<tlv>, 3> output{};
+    const std::size_t valid = decode_segments<tlv>(frames, output);
+    return valid == 3 && output[0].get<0>().get_length() == 0x00 && output[2].body().size() == 2;
+}());
+static_assert([]{
+    const std::array<std::span<const std::byte>, 2> frames{ std::span{ packet }, std::span{ packet }.first(10) };
+    std::array<segment_view<ipv4_header>, 2> output{};
+    return decode_segments<ipv4_header>(frames, output) == 1 && output[0].valid() && !output[1].valid();
+}());
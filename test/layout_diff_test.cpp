@@ -0,0 +1,97 @@
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "layout_diff.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct player_state : bit_field_builder<player_state, std::uint32_t> {
+    BIT_FIELD(x, 10);
+    BIT_FIELD(y, 10);
+    BIT_FIELD(alive, 1, bit_field_config<bool>{});
+    BIT_FIELD_PAD(3);
+    BIT_FIELD(health, 8);
+};
+
+using player_fields = layout_fields<player_state>;
+
+// The fields are recovered from the layout, with padding counted as a field.
+static_assert(player_fields::count == 5);
+static_assert(player_fields::offsets == std::array<unsigned, 5>{ 0, 10, 20, 21, 24 });
+static_assert(player_fields::width_of(2) == 1 && player_fields::width_of(4) == 8);
+static_assert(player_fields::index_of<player_state::alive> == 2);
+static_assert(player_fields::index_of<player_state::health> == 4);
+static_assert(player_fields::bit<player_state::health> == 0b10000);
+static_assert(std::is_same_v<player_fields::mask_type, std::uint8_t>);
+static_assert(player_fields::low_bits == 0x0130'0401u);
+static_assert(player_fields::high_bits == 0x8098'0200u);
+
+// An incomplete layout only has the fields allocated so far.
+struct partial : bit_field_builder<partial, std::uint64_t> {
+    BIT_FIELD(a, 1);
+    BIT_FIELD(b, 63);
+};
+
+static_assert(layout_fields<partial>::count == 2);
+static_assert(layout_fields<partial>::high_bits == 0x8000'0000'0000'0001u);
+
+static_assert([]{
+    player_state before{};
+    before.set_x(100u);
+    before.set_y(200u);
+    before.set_alive(true);
+    before.set_health(50u);
+    player_state after = before;
+    after.set_y(201u);
+    after.set_health(0u);
+    after.set_alive(false);
+    return changed_fields(before, after) == (player_fields::bit<player_state::y> |
+                                             player_fields::bit<player_state::alive> |
+                                             player_fields::bit<player_state::health>) &&
+           changed_fields(before, before) == 0;
+}());
+
+// A change in any bit of a field is reported, and never spills into the next field.
+static_assert([]{
+    for (unsigned bit = 0; bit < 32; ++bit) {
+        const auto mask = changed_fields<player_state>(0u, 1u << bit);
+        const unsigned field = bit < 10 ? 0 : bit < 20 ? 1 : bit < 21 ? 2 : bit < 24 ? 3 : 4;
+        if (mask != 1u << field) {
+            return false;
+        }
+    }
+    return changed_fields<player_state>(0u, 0xFFFF'FFFFu) == 0b11111;
+}());
+
+static_assert([]{
+    player_state target{};
+    target.set_x(1u);
+    target.set_health(2u);
+    player_state source{};
+    source.set_x(1000u);
+    source.set_y(1000u);
+    source.set_alive(true);
+    source.set_health(255u);
+    apply_patch(target, source, player_fields::bit<player_state::y> | player_fields::bit<player_state::alive>);
+    return target.get_x() == 1 && target.get_y() == 1000 && target.get_alive() && target.get_health() == 2;
+}());
+
+// Replicating a table: the patch of each record turns the old snapshot into the new one.
+static_assert([]{
+    std::array<player_state, 3> before{};
+    std::array<player_state, 3> after{};
+    after[1].set_health(9u);
+    after[2].set_x(3u);
+    after[2].set_alive(true);
+    std::array<player_fields::mask_type, 3> changes{};
+    const std::size_t changed = changed_fields<player_state>(before, after, changes);
+    apply_patch<player_state>(before, after, changes);
+    return changed == 2 && changes[0] == 0 && changes[1] == player_fields::bit<player_state::health> &&
+           before[1].raw_value == after[1].raw_value && before[2].raw_value == after[2].raw_value;
+}());
@@ -0,0 +1,113 @@
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "mini_float.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+static_assert(half_float::bits == 16);
+static_assert(half_float::bias == 15);
+static_assert(half_float::is_ieee_half);
+static_assert(std::is_same_v<half_float::raw_type, std::uint16_t>);
+static_assert(mini_float<5, 5, false>::bits == 10);
+static_assert(std::is_same_v<mini_float<4, 3>::raw_type, std::uint8_t>);
+
+// IEEE binary16 decoding.
+static_assert(half_float::decode(0x0000) == 0.0f);
+static_assert(std::bit_cast<std::uint32_t>(half_float::decode(0x8000)) == 0x80000000u);
+static_assert(half_float::decode(0x3C00) == 1.0f);
+static_assert(half_float::decode(0xC000) == -2.0f);
+static_assert(half_float::decode(0x7BFF) == 65504.0f);
+static_assert(half_float::decode(0x0001) == 0x1p-24f);
+static_assert(half_float::decode(0x03FF) == 0x3FFp-24f);
+static_assert(half_float::decode(0x7C00) == std::numeric_limits<float>::infinity());
+static_assert(half_float::decode(0xFC00) == -std::numeric_limits<float>::infinity());
+static_assert(half_float::decode(0x7E00) != half_float::decode(0x7E00));
+
+// IEEE binary16 encoding.
+static_assert(half_float::encode(0.0f) == 0x0000);
+static_assert(half_float::encode(-0.0f) == 0x8000);
+static_assert(half_float::encode(1.0f) == 0x3C00);
+static_assert(half_float::encode(-2.0f) == 0xC000);
+static_assert(half_float::encode(65504.0f) == 0x7BFF);
+static_assert(half_float::encode(0x1p-24f) == 0x0001);
+static_assert(half_float::encode(std::numeric_limits<float>::infinity()) == 0x7C00);
+static_assert(half_float::encode(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+
+// Round to nearest, ties to even.
+static_assert(half_float::encode(1.0f + 0x1p-11f) == 0x3C00);           // Tie, rounds down to even.
+static_assert(half_float::encode(1.0f + 0x3p-11f) == 0x3C02);           // Tie, rounds up to even.
+static_assert(half_float::encode(1.0f + 0x1p-11f + 0x1p-20f) == 0x3C01); // Above the tie.
+static_assert(half_float::encode(65519.0f) == 0x7BFF);                  // Just below the overflow threshold.
+static_assert(half_float::encode(65520.0f) == 0x7C00);                  // Rounds up to infinity.
+static_assert(half_float::encode(0x1p-25f) == 0x0000);                  // Tie between zero and the smallest subnormal.
+static_assert(half_float::encode(0x3p-26f) == 0x0001);                  // Above the tie.
+static_assert(half_float::encode(0x1p-26f) == 0x0000);                  // Underflows to zero.
+static_assert(half_float::encode(0x7FFp-25f) == 0x0400);                // Rounds up into the smallest normal.
+static_assert(half_float::encode(0x1p-140f) == 0x0000);                 // Float normal, far below the format.
+static_assert(half_float::encode(0x1p-149f) == 0x0000);                 // Float subnormal.
+
+// Every binary16 value survives a round trip.
+static_assert([]{
+    for (std::uint32_t i = 0; i < 0x10000; ++i) {
+        const auto raw = static_cast<std::uint16_t>(i);
+        const bool is_nan = (raw & 0x7C00) == 0x7C00 && (raw & 0x03FF) != 0;
+        if (!is_nan && half_float::encode(half_float::decode(raw)) != raw) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// bfloat16 is the upper half of a float, with rounding.
+static_assert(brain_float::decode(0x3F80) == 1.0f);
+static_assert(brain_float::encode(3.0f) == 0x4040);
+static_assert(brain_float::encode(std::bit_cast<float>(0x3F808000u)) == 0x3F80);
+static_assert(brain_float::encode(std::bit_cast<float>(0x3F818000u)) == 0x3F82);
+static_assert(brain_float::encode(0x1p-149f) == 0x0000);
+static_assert(brain_float::encode(0x1p-133f) == 0x0001);
+
+// bfloat16 subnormals are float subnormals, and every bfloat16 value decodes to the float with the same upper half.
+static_assert(brain_float::decode(0x0001) == 0x1p-133f);
+static_assert(brain_float::decode(0x007F) == 0x7Fp-133f);
+static_assert(brain_float::decode(0x807F) == -0x7Fp-133f);
+static_assert([]{
+    for (std::uint32_t i = 0; i < 0x10000; ++i) {
+        const auto raw = static_cast<std::uint16_t>(i);
+        const std::uint32_t expected = i << 16;
+        const bool is_nan = (expected & 0x7FFFFFFFu) > 0x7F800000u;
+        if (!is_nan && std::bit_cast<std::uint32_t>(brain_float::decode(raw)) != expected) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Unsigned ten bit format with five exponent bits and five mantissa bits.
+using unsigned_float = mini_float<5, 5, false>;
+static_assert(unsigned_float::decode(0b01111'00000) == 1.0f);
+static_assert(unsigned_float::decode(0b11110'11111) == 0x3Fp-5f * 0x1p15f);
+static_assert(unsigned_float::encode(1.0f) == 0b01111'00000);
+static_assert(unsigned_float::encode(-1.0f) == 0);
+static_assert(unsigned_float::encode(std::numeric_limits<float>::infinity()) == 0b11111'00000);
+
+// Eight bit formats decode through a table, which matches the computed values.
+using tiny_float = mini_float<4, 3>;
+static_assert(tiny_float::decode(0b0'0111'000) == 1.0f);
+static_assert(tiny_float::decode(0b1'1110'111) == -240.0f);
+static_assert(tiny_float::decode(0b0'0000'001) == 0x1p-9f);
+static_assert([]{
+    for (std::uint32_t i = 0; i < 0x100; ++i) {
+        const auto raw = static_cast<std::uint8_t>(i);
+        const bool is_nan = (raw & 0x78) == 0x78 && (raw & 0x07) != 0;
+        if (!is_nan && tiny_float::encode(tiny_float::decode(raw)) != raw) {
+            return false;
+        }
+    }
+    return true;
+}());
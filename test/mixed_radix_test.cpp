@@ -0,0 +1,83 @@
+#include <cstdint>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "mixed_radix.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+using three_fives = mixed_radix<5, 5, 5>;
+
+static_assert(three_fives::count == 3);
+static_assert(three_fives::states == 125);
+static_assert(three_fives::bits == 7);
+static_assert(std::is_same_v<three_fives::raw_type, std::uint8_t>);
+static_assert(three_fives::weight<0> == 1);
+static_assert(three_fives::weight<1> == 5);
+static_assert(three_fives::weight<2> == 25);
+
+static_assert(mixed_radix<2>::bits == 1);
+static_assert(mixed_radix<3>::bits == 2);
+static_assert(mixed_radix<4>::bits == 2);
+static_assert(mixed_radix<3, 3, 3, 3, 3>::bits == 8);       // 243 states, where five 2-bit fields need 10 bits.
+static_assert(mixed_radix<10, 10, 10, 10>::bits == 14);     // 10000 states, where four 4-bit fields need 16 bits.
+static_assert(std::is_same_v<mixed_radix<10, 10, 10, 10>::raw_type, std::uint16_t>);
+
+// Get.
+static_assert(three_fives::get<0>(0) == 0);
+static_assert(three_fives::get<0>(3 + 5 * (4 + 5 * 2)) == 3);
+static_assert(three_fives::get<1>(3 + 5 * (4 + 5 * 2)) == 4);
+static_assert(three_fives::get<2>(3 + 5 * (4 + 5 * 2)) == 2);
+static_assert(three_fives::get<2>(124) == 4);
+
+// Set.
+static_assert(three_fives::set<0>(3 + 5 * (4 + 5 * 2), 1) == 1 + 5 * (4 + 5 * 2));
+static_assert(three_fives::set<1>(3 + 5 * (4 + 5 * 2), 0) == 3 + 5 * (0 + 5 * 2));
+static_assert(three_fives::set<2>(3 + 5 * (4 + 5 * 2), 4) == 3 + 5 * (4 + 5 * 4));
+static_assert(three_fives::set<1>(0, 7) == 5 * 2); // Reduced modulo the radix.
+
+// Pack and unpack round trip every state.
+static_assert(three_fives::pack({ 3, 4, 2 }) == 3 + 5 * (4 + 5 * 2));
+static_assert([]{
+    for (std::uint8_t packed = 0; packed < three_fives::states; ++packed) {
+        const auto digits = three_fives::unpack(packed);
+        if (three_fives::pack({ digits[0], digits[1], digits[2] }) != packed) {
+            return false;
+        }
+    }
+    return true;
+}());
+
+// Mixed-radix groups inside a bit field.
+struct game_cell : bit_field_builder<game_cell, std::uint16_t> {
+    BIT_FIELD(owner, 4);
+    BIT_FIELD_MIXED_RADIX(terrain, 5, 5, 5);
+    BIT_FIELD_RADIX_DIGIT(terrain, ground, 0);
+    BIT_FIELD_RADIX_DIGIT(terrain, cover, 1);
+    BIT_FIELD_RADIX_DIGIT(terrain, weather, 2);
+    BIT_FIELD(visible, 1);
+};
+
+static_assert(game_cell::terrain::offset == 4);
+static_assert(game_cell::terrain::bits == 7);
+static_assert(game_cell::visible::offset == 11);
+
+static_assert([]{
+    game_cell cell{0b1111100000001111};
+    cell.set_owner(3);
+    cell.set_ground(1);
+    cell.set_cover(2);
+    cell.set_weather(4);
+    cell.set_visible(0);
+    return cell.get_owner() == 3 && cell.get_ground() == 1 && cell.get_cover() == 2 && cell.get_weather() == 4 &&
+           cell.get_terrain<1>() == 2 && cell.get_visible() == 0 &&
+           cell.raw_value == (0xF000 | ((1 + 5 * (2 + 5 * 4)) << 4) | 3);
+}());
+
+static_assert([]{
+    game_cell cell{0};
+    cell.set_terrain<2>(3);
+    return game_cell::terrain::get<2>(cell.raw_value) == 3 && cell.raw_value == (75 << 4);
+}());
@@ -0,0 +1,125 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "network_headers.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+template <std::size_t NSize>
+constexpr std::array<std::byte, NSize> make_bytes(const std::array<std::uint8_t, NSize>& values) {
+    std::array<std::byte, NSize> result{};
+    for (std::size_t i = 0; i < NSize; ++i) {
+        result[i] = static_cast<std::byte>(values[i]);
+    }
+    return result;
+}
+
+static_assert(net::ethernet_header::size == net::ethernet_header_size);
+static_assert(net::vlan_tag::size == net::vlan_tag_size);
+static_assert(net::ipv4_header::size == 20);
+static_assert(net::ipv4_segment::prefix_size == 20);
+static_assert(net::tcp_header::size == 20);
+static_assert(net::tcp_segment::prefix_size == 20);
+static_assert(net::udp_header::size == 8);
+static_assert(net::ipv6_header::size == 8);
+
+// A VLAN-tagged TCP SYN from 192.168.0.1:12345 to 192.168.0.199:80, with DSCP EF.
+constexpr auto tcp_packet = make_bytes<58>({
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0x81, 0x00,
+    0xA0, 0x64, 0x08, 0x00,
+    0x45, 0xB8, 0x00, 0x28, 0x1C, 0x46, 0x40, 0x00, 0x40, 0x06, 0xB1, 0xE6,
+    0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0xC7,
+    0x30, 0x39, 0x00, 0x50, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x50, 0x02, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+});
+
+// Every header is viewed in place, with fields numbered as on the wire.
+static_assert([]() constexpr {
+    const std::span<const std::byte> bytes{ tcp_packet };
+    const block_view<net::ethernet_header, const std::byte> ethernet{ bytes };
+    const block_view<net::vlan_tag, const std::byte> vlan{ bytes.subspan(net::ethernet_header_size) };
+    const auto tci = vlan.load<net::vlan_tci>();
+    const block_view<net::ipv4_header, const std::byte> ip{ bytes.subspan(18) };
+    const auto word0 = ip.load<net::ipv4_word0>();
+    const auto word1 = ip.load<net::ipv4_word1>();
+    const auto word2 = ip.load<net::ipv4_word2>();
+    const block_view<net::tcp_header, const std::byte> tcp{ bytes.subspan(38) };
+    const auto control = tcp.load<net::tcp_control>();
+    return net::load_mac(bytes.data()) == 0x001122334455 && net::load_mac(bytes.data() + 6) == 0x66778899AABB &&
+           ethernet.load<net::ethernet_type>().get_type() == net::ether_type::vlan &&
+           tci.get_pcp() == 5 && !tci.get_dei() && tci.get_vid() == 100 &&
+           vlan.load<1>().get_type() == net::ether_type::ipv4 &&
+           word0.get_version() == 4 && word0.get_ihl() == 5 && word0.get_dscp() == 46 && word0.get_ecn() == 0 &&
+           word0.get_total_length() == 40 && word1.get_identification() == 0x1C46 && word1.get_dont_fragment() &&
+           !word1.get_more_fragments() && word1.get_fragment_offset() == 0 && word2.get_ttl() == 64 &&
+           word2.get_protocol() == net::ip_protocol::tcp && word2.get_checksum() == 0xB1E6 &&
+           ip.load<net::ipv4_source>().get_address() == 0xC0A80001 &&
+           ip.load<net::ipv4_destination>().get_address() == 0xC0A800C7 &&
+           tcp.load<net::transport_ports>().get_source_port() == 12345 &&
+           tcp.load<net::transport_ports>().get_destination_port() == 80 &&
+           tcp.load<net::tcp_sequence>().get_number() == 1 && control.get_data_offset() == 5 && control.get_syn() &&
+           !control.get_ack() && !control.get_fin() && control.get_window() == 0xFFFF;
+}());
+
+// The IPv4 and TCP segments take their lengths from the IHL and data offset, so options are skipped.
+static_assert([]{
+    auto bytes = make_bytes<32>({
+        0x46, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x40, 0x11, 0x00, 0x00,
+        0x0A, 0x00, 0x00, 0x01, 0x0A, 0x00, 0x00, 0x02, 0x94, 0x04, 0x00, 0x00,
+        0x00, 0x35, 0xD4, 0x31, 0x00, 0x08, 0x00, 0x00,
+    });
+    layout_cursor cursor{ std::span<const std::byte>{ bytes } };
+    const auto ip = cursor.next<net::ipv4_segment>();
+    if (!ip || ip->bytes.size() != 24 || ip->get<2>().get_protocol() != net::ip_protocol::udp) {
+        return false;
+    }
+    const block_view<net::udp_header, const std::byte> udp{ cursor.remaining() };
+    return udp.load<net::transport_ports>().get_source_port() == 53 &&
+           udp.load<net::transport_ports>().get_destination_port() == 54321 &&
+           udp.load<net::udp_length>().get_length() == 8;
+}());
+static_assert([]{
+    auto bytes = make_bytes<24>({
+        0x30, 0x39, 0x00, 0x50, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x60, 0x12, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x05, 0xB4,
+    });
+    layout_cursor cursor{ std::span<const std::byte>{ bytes } };
+    const auto tcp = cursor.next<net::tcp_segment>();
+    return tcp && tcp->bytes.size() == 24 && tcp->get<3>().get_syn() && tcp->get<3>().get_ack() &&
+           tcp->get<3>().get_window() == 0x0100 && cursor.empty() && !cursor.next<net::tcp_segment>();
+}());
+
+// An IPv6 header, with its addresses viewed as bytes.
+static_assert([]() constexpr {
+    const auto bytes = make_bytes<40>({
+        0x6B, 0x8A, 0xBC, 0xDE, 0x00, 0x08, 0x11, 0x40,
+        0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    });
+    const block_view<net::ipv6_header, const std::byte> ip{ bytes };
+    const auto word0 = ip.load<net::ipv6_word0>();
+    const auto word1 = ip.load<net::ipv6_word1>();
+    return word0.get_version() == 6 && word0.get_dscp() == 46 && word0.get_ecn() == 0 &&
+           word0.get_flow_label() == 0xABCDE && word1.get_payload_length() == 8 &&
+           word1.get_next_header() == net::ip_protocol::udp && word1.get_hop_limit() == 64 &&
+           net::ipv6_source(bytes)[0] == std::byte{0x20} && net::ipv6_source(bytes)[15] == std::byte{0x01} &&
+           net::ipv6_destination(bytes)[15] == std::byte{0x02};
+}());
+
+// Headers are written in place for building packets.
+static_assert([]() constexpr {
+    std::array<std::byte, 8> bytes{};
+    const block_view<net::udp_header> udp{ bytes };
+    udp.modify<net::transport_ports>([](net::transport_ports& ports) {
+        ports.set_source_port(0x1234);
+        ports.set_destination_port(0xABCD);
+    });
+    udp.modify<net::udp_length>([](net::udp_length& length) { length.set_length(8); });
+    return bytes == make_bytes<8>({ 0x12, 0x34, 0xAB, 0xCD, 0x00, 0x08, 0x00, 0x00 });
+}());
@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <type_traits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "partitioned_record.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+// A queue's state, with the producer's fields in one domain and the consumer's fields in another.
+struct queue_state : bit_field_builder<queue_state, std::uint64_t> {
+    BIT_FIELD(head, 24);
+    BIT_FIELD(closed, 1, bit_field_config<bool>{});
+    BIT_FIELD(tail, 24);
+    BIT_FIELD(waiting, 1, bit_field_config<bool>{});
+    BIT_FIELD_PAD(2);
+    BIT_FIELD_VERSION(version, 12);
+};
+
+using producer = domain<queue_state::head, queue_state::closed>;
+using consumer = domain<queue_state::tail, queue_state::waiting>;
+using queue = partitioned_record<queue_state, producer, consumer>;
+
+static_assert(queue::domain_count == 2);
+static_assert(queue::domain_index<queue_state::closed> == 0);
+static_assert(queue::domain_index<queue_state::tail> == 1);
+static_assert(queue::domain_masks[0] == 0x1FF'FFFF && queue::domain_masks[1] == 0x3'FFFF'FE00'0000);
+static_assert(std::is_same_v<queue::layout_type, queue_state>);
+static_assert(queue::is_always_lock_free);
+static_assert(!std::is_copy_constructible_v<queue>);
+
+// Every domain gets a cache line of its own.
+static_assert(alignof(queue) == BIT_FIELD_CACHE_LINE_SIZE);
+static_assert(sizeof(queue) == 2 * BIT_FIELD_CACHE_LINE_SIZE);
+
+// Fields which belong to no domain, such as the version, have no owner.
+template <typename TRecord, typename TField>
+concept has_owner = requires { TRecord::template domain_index<TField>; };
+
+static_assert(!has_owner<queue, queue_state::version>);
+static_assert(has_owner<queue, queue_state::waiting>);
+
+// The atomic operations cannot be constant evaluated, so this only needs to compile.
+[[maybe_unused]] static bool use_partitioned_record(queue& state) {
+    const queue_state previous = state.set<queue_state::head, queue_state::closed>(42u, true);
+    state.modify<queue::domain_index<queue_state::tail>>([](queue_state& value) { value.set_waiting(true); });
+    state.modify<1>([](queue_state& value) { return !value.get_waiting(); });
+    const queue_state snapshot = state.snapshot();
+    return previous.get_head() == 0 && state.get<queue_state::waiting>() && snapshot.get_head() == 42 &&
+           snapshot.get_closed() && snapshot.get_version() == 0;
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "read_ahead.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct sample : bit_field_builder<sample, std::uint64_t> {
+    BIT_FIELD(channel,  8);
+    BIT_FIELD(reading, 24);
+    BIT_FIELD(time,    32);
+};
+
+static_assert(read_ahead_options{}.chunk_size % read_ahead_options{}.alignment == 0);
+static_assert(read_ahead_options{}.depth >= 2);
+
+// Scanning starts threads and cannot be constant evaluated, so this only needs to compile.
+[[maybe_unused]] static bool use_scan_records() {
+    static sample file[1000]{};
+    const auto source = [](const std::span<std::byte> buffer, const std::uint64_t offset) -> std::ptrdiff_t {
+        const std::size_t size = sizeof(file) - std::min<std::size_t>(offset, sizeof(file));
+        const std::size_t count = std::min(size, buffer.size());
+        std::memcpy(buffer.data(), reinterpret_cast<const std::byte*>(file) + offset, count);
+        return static_cast<std::ptrdiff_t>(count);
+    };
+    std::uint64_t total = 0;
+    const std::optional<std::uint64_t> scanned = scan_records<sample>(source, [&](const std::span<const sample> chunk) {
+        for (const sample& record : chunk) {
+            total += record.get_reading();
+        }
+    }, { .chunk_size = 4096, .depth = 2 });
+    std::size_t chunks = 0;
+    scan_records<sample>(source, [&](std::span<const sample>) { return ++chunks < 2; }, { .chunk_size = 4096 });
+    const bool misaligned = !scan_records<sample>(source, [](std::span<const sample>) {}, { .alignment = 3000 });
+    return scanned == 1000 && total == 0 && chunks == 2 && misaligned;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+[[maybe_unused]] static bool use_pread_source(const int descriptor) {
+    return scan_records<sample>(pread_source{ descriptor }, [](std::span<const sample>) {}).has_value();
+}
+#endif
@@ -0,0 +1,37 @@
+#include <cstdint>
+#include <type_traits>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "sharded_counters.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct request_stats : bit_field_builder<request_stats, std::uint64_t> {
+    BIT_FIELD(accepted, 16);
+    BIT_FIELD(rejected, 8);
+    BIT_FIELD(timeouts, 8);
+    BIT_FIELD(bytes, 32);
+};
+
+// 16 private shards and the shared one need five bits of headroom; 1 private shard and the shared one need one.
+static_assert(sharded_counters<request_stats>::shard_count == 17);
+static_assert(sharded_counters<request_stats>::headroom_bits == 5);
+static_assert(sharded_counters<request_stats, 1>::headroom_bits == 1);
+static_assert(sharded_counters<request_stats, 15>::headroom_bits == 4);
+static_assert(!std::is_copy_constructible_v<sharded_counters<request_stats>>);
+
+// Every shard is on its own cache line.
+static_assert(alignof(sharded_counters<request_stats>) == BIT_FIELD_CACHE_LINE_SIZE);
+static_assert(sizeof(sharded_counters<request_stats>) % BIT_FIELD_CACHE_LINE_SIZE == 0);
+
+// The atomic operations cannot be constant evaluated, so these only need to compile.
+[[maybe_unused]] static bool use_sharded_counters(sharded_counters<request_stats>& stats) {
+    stats.add<request_stats::accepted>();
+    stats.add<request_stats::bytes>(1500);
+    stats.add_at<request_stats::rejected>(3);
+    const auto totals = stats.read_all<request_stats::accepted, request_stats::bytes>();
+    return totals[0] == 1 && totals[1] == 1500 && stats.read<request_stats::rejected>() == 1;
+}
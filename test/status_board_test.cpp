@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "status_board.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct worker_status : bit_field_builder<worker_status, std::uint64_t> {
+    BIT_FIELD(state,     4);
+    BIT_FIELD(load,     12);
+    BIT_FIELD(heartbeat, 48);
+};
+
+struct wider_load : bit_field_builder<wider_load, std::uint64_t> {
+    BIT_FIELD(state,     4);
+    BIT_FIELD(load,     16);
+    BIT_FIELD(heartbeat, 44);
+};
+
+struct renamed_status : bit_field_builder<renamed_status, std::uint64_t> {
+    BIT_FIELD(phase,    4);
+    BIT_FIELD(busy,    12);
+    BIT_FIELD(seen,    48);
+};
+
+// The hash follows the shape of the layout, not its names, and the tag tells apart layouts of the same shape.
+static_assert(layout_hash<worker_status> != layout_hash<wider_load>);
+static_assert(layout_hash<worker_status> == layout_hash<renamed_status>);
+static_assert(layout_hash<worker_status, 1> != layout_hash<worker_status>);
+
+// Every record, and the header, gets its own cache line.
+static_assert(status_board<worker_status>::stride == BIT_FIELD_CACHE_LINE_SIZE);
+static_assert(status_board<worker_status>::bytes_for(0) == BIT_FIELD_CACHE_LINE_SIZE);
+static_assert(status_board<worker_status>::bytes_for(4) == 5 * BIT_FIELD_CACHE_LINE_SIZE);
+
+// The atomic operations cannot be constant evaluated, so these only need to compile.
+[[maybe_unused]] static bool use_status_board() {
+    alignas(BIT_FIELD_CACHE_LINE_SIZE) std::byte memory[status_board<worker_status>::bytes_for(4)]{};
+    const std::span<std::byte> bytes{ memory };
+    const std::optional<status_board<worker_status>> writer = status_board<worker_status>::create(bytes, 4);
+    const std::optional<status_board<worker_status>> reader = status_board<worker_status>::attach(bytes);
+    if (!writer || !reader || status_board<wider_load>::check(bytes) != status_board_error::layout_mismatch) {
+        return false;
+    }
+    // A record count too large for the memory, even one which would overflow the size computation, is refused. The
+    // count follows the magic number and the layout hash in the header.
+    std::uint64_t record_count = 5;
+    std::memcpy(memory + 16, &record_count, sizeof(record_count));
+    const status_board_error too_many = status_board<worker_status>::check(bytes);
+    record_count = ~std::uint64_t{0} / BIT_FIELD_CACHE_LINE_SIZE + 1;
+    std::memcpy(memory + 16, &record_count, sizeof(record_count));
+    const status_board_error overflowing = status_board<worker_status>::check(bytes);
+    record_count = 4;
+    std::memcpy(memory + 16, &record_count, sizeof(record_count));
+    if (too_many != status_board_error::too_small || overflowing != status_board_error::too_small ||
+        status_board<worker_status>::create(bytes, ~std::size_t{0})) {
+        return false;
+    }
+    (*writer)[2].set<worker_status::state, worker_status::load>(3, 700);
+    (*writer)[2].modify([](worker_status& status) { status.set_heartbeat(status.get_heartbeat() + 1); });
+    worker_status statuses[4]{};
+    reader->snapshot(statuses);
+    return reader->size() == 4 && statuses[2].get_load() == 700 && (*reader)[2].get<worker_status::heartbeat>() == 1;
+}
+
+#if BIT_FIELD_HAS_POSIX_SHARED_MEMORY
+[[maybe_unused]] static bool use_shared_memory() {
+    std::optional<shared_memory> mapping = shared_memory::create("/bit_field_status", 4096);
+    std::optional<shared_memory> other = shared_memory::open("/bit_field_status");
+    shared_memory::unlink("/bit_field_status");
+    return mapping && other && status_board<worker_status>::create(mapping->bytes(), 8) &&
+           status_board<worker_status>::attach(other->bytes());
+}
+#endif
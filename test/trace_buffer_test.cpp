@@ -0,0 +1,77 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "trace_buffer.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct event_header : bit_field_builder<event_header, std::uint32_t> {
+    BIT_FIELD(delta, 20);
+    BIT_FIELD(type,   8);
+    BIT_FIELD(length, 4);
+
+    using delta_field = delta;
+    using type_field = type;
+    using length_field = length;
+};
+
+struct no_length : bit_field_builder<no_length, std::uint32_t> {
+    BIT_FIELD(delta, 24);
+    BIT_FIELD(type,   8);
+
+    using delta_field = delta;
+    using type_field = type;
+};
+
+static_assert(trace_header_layout<event_header>);
+static_assert(!trace_header_layout<no_length>);
+
+static_assert(trace_buffer<event_header>::header_size == 4);
+static_assert(trace_buffer<event_header>::max_payload == 15);
+static_assert(trace_buffer<event_header>::rebase_type == 255);
+
+// A rebase to 1000, an event 5 later with a two byte payload, and an event 0x12345 after that.
+static_assert([]() constexpr {
+    constexpr std::array<std::uint8_t, 26> bytes{
+        0x00, 0x00, 0xF0, 0x8F, 0xE8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x05, 0x00, 0x70, 0x20, 0xAB, 0xCD,
+        0x45, 0x23, 0x21, 0x00,
+        0x00, 0x00, 0x00, 0x20,
+    };
+    std::array<std::byte, bytes.size()> dump{};
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        dump[i] = static_cast<std::byte>(bytes[i]);
+    }
+
+    std::array<trace_event, 2> events{};
+    std::size_t count = 0;
+    trace_decoder<event_header> decoder;
+    // The last four bytes are a header promising two payload bytes which are missing.
+    const std::size_t decoded = decoder.decode(dump, [&](const trace_event& event) { events[count++] = event; });
+    return decoded == 22 && count == 2 && events[0].timestamp == 1005 && events[0].type == 7 &&
+           events[0].payload.size() == 2 && events[0].payload[1] == std::byte{0xCD} &&
+           events[1].timestamp == 1005 + 0x12345 && events[1].type == 2 && events[1].payload.empty();
+}());
+
+// The ring buffer uses atomics and cannot be constant evaluated, so this only needs to compile.
+[[maybe_unused]] static bool use_trace_buffer() {
+    static trace_buffer<event_header, 256> buffer;
+    const std::byte payload[3]{};
+    buffer.record(100, 1);
+    buffer.record(100 + (1 << 20), 2, payload);
+    std::byte dump[256];
+    const std::size_t size = buffer.drain(dump);
+    std::size_t count = 0;
+    trace_decoder<event_header>{}.decode(std::span{ dump }.first(size), [&](const trace_event&) { ++count; });
+    // Events whose type is reserved or whose payload is too long for the length field are refused.
+    const std::byte oversized[trace_buffer<event_header, 256>::max_payload + 1]{};
+    const bool refused = !buffer.record(200, trace_buffer<event_header, 256>::rebase_type) &&
+                         !buffer.record(200, 1, oversized);
+    return count == 2 && refused && buffer.dropped() == 0 && buffer.size() == 0;
+}
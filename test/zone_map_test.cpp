@@ -0,0 +1,66 @@
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#ifdef BIT_FIELD_TEST_SINGLE_HEADER
+#  include "bit_field.hpp"
+#else
+#  include "zone_map.hpp"
+#endif
+
+using namespace BIT_FIELD_NAMESPACE;
+
+struct reading : bit_field_builder<reading, std::uint64_t> {
+    BIT_FIELD(status,    2);
+    BIT_FIELD(sensor,    8);
+    BIT_FIELD(level,    22);
+    BIT_FIELD(timestamp, 32);
+};
+
+constexpr std::vector<reading> make_readings(const std::size_t count) {
+    std::vector<reading> readings(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        // Status 3 only appears in record 70, and sensor 200 only in records 20 and 21.
+        readings[i].set_status(i == 70 ? 3 : i % 3);
+        readings[i].set_sensor(i / 20 == 1 && i % 20 < 2 ? 200 : static_cast<std::uint8_t>(i % 7 * 30));
+        readings[i].set_level(static_cast<std::uint32_t>(1000 + i));
+        readings[i].set_timestamp(static_cast<std::uint32_t>(i * 10));
+    }
+    return readings;
+}
+
+// Statistics of each block, including a partial last block.
+static_assert([]() constexpr {
+    const std::vector<reading> readings = make_readings(100);
+    const zone_map<reading, 32> zones{ readings };
+    return zones.size() == 100 && zones.block_count() == 4 && zones.min<reading::level>(1) == 1032 &&
+           zones.max<reading::level>(1) == 1063 && zones.max<reading::timestamp>(3) == 990 &&
+           zones.min<reading::status>(2) == 0 && zones.max<reading::status>(2) == 3;
+}());
+
+// The presence set rules out values between the minimum and maximum which never occur.
+static_assert([]() constexpr {
+    const std::vector<reading> readings = make_readings(100);
+    const zone_map<reading, 32> zones{ readings };
+    return zones.may_contain<reading::status>(2, 3) && !zones.may_contain<reading::status>(1, 3) &&
+           zones.may_contain<reading::sensor>(0, 200) && !zones.may_contain<reading::sensor>(1, 200) &&
+           !zones.may_contain<reading::sensor>(0, 31, 59) && zones.may_contain<reading::sensor>(0, 31, 60) &&
+           !zones.may_contain<reading::level>(0, 2000, 3000) && zones.may_contain<reading::level>(0, 1031, 3000);
+}());
+
+// Scans find the same records as a full scan, and the map grows as records are appended one at a time.
+static_assert([]() constexpr {
+    const std::vector<reading> readings = make_readings(100);
+    zone_map<reading, 16> zones;
+    for (const reading& record : readings) {
+        zones.append(record);
+    }
+    std::vector<std::size_t> found;
+    const std::size_t matches = zones.find<reading::sensor>(readings, 200, [&](const std::size_t i) {
+        found.push_back(i);
+    });
+    return matches == 2 && found.size() == 2 && found[0] == 20 && found[1] == 21 && zones.block_count() == 7 &&
+           zones.count_matches<reading::status>(readings, 3, 3) == 1 &&
+           zones.count_matches<reading::level>(readings, 1010, 1019) == 10;
+}());